@@ -73,3 +73,30 @@ the LICENSE file.
     #define EMC_SIZE_POOL_ELEMENTS 128
   #endif
 #endif
+
+#ifndef EMC_USE_PACKET_POOL
+#define EMC_USE_PACKET_POOL 0
+#endif
+
+#if EMC_USE_PACKET_POOL
+  // small: acks and plain state topics, medium: JSON state, large: discovery and config documents
+  // packets larger than the large class (keypad, auth log) or exceeding a full pool use the heap
+  #ifndef EMC_PACKET_POOL_SMALL_SIZE
+    #define EMC_PACKET_POOL_SMALL_SIZE 128
+  #endif
+  #ifndef EMC_PACKET_POOL_SMALL_COUNT
+    #define EMC_PACKET_POOL_SMALL_COUNT 32
+  #endif
+  #ifndef EMC_PACKET_POOL_MEDIUM_SIZE
+    #define EMC_PACKET_POOL_MEDIUM_SIZE 512
+  #endif
+  #ifndef EMC_PACKET_POOL_MEDIUM_COUNT
+    #define EMC_PACKET_POOL_MEDIUM_COUNT 8
+  #endif
+  #ifndef EMC_PACKET_POOL_LARGE_SIZE
+    #define EMC_PACKET_POOL_LARGE_SIZE 1280
+  #endif
+  #ifndef EMC_PACKET_POOL_LARGE_COUNT
+    #define EMC_PACKET_POOL_LARGE_COUNT 6
+  #endif
+#endif
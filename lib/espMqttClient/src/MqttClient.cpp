@@ -51,6 +51,7 @@ MqttClient::MqttClient(espMqttClientTypes::UseInternalTask useInternalTask, uint
 , _parser()
 , _lastClientActivity(0)
 , _lastServerActivity(0)
+, _tcpConnectedTime(0)
 , _pingSent(false)
 , _disconnectReason(DisconnectReason::TCP_DISCONNECTED)
 #if defined(ARDUINO_ARCH_ESP32) && ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
@@ -197,6 +198,10 @@ const char* MqttClient::getClientId() const {
   return _clientId;
 }
 
+uint32_t MqttClient::tcpConnectedTime() const {
+  return _tcpConnectedTime;
+}
+
 size_t MqttClient::queueSize() {
   size_t ret = 0;
   EMC_SEMAPHORE_TAKE();
@@ -227,7 +232,7 @@ void MqttClient::loop() {
     case State::connectingTcp2:
       if (_transport->connected()) {
         _parser.reset();
-        _lastClientActivity = _lastServerActivity = millis();
+        _lastClientActivity = _lastServerActivity = _tcpConnectedTime = millis();
         _setState(State::connectingMqtt);
       }  else if (_transport->disconnected()) {  // sync: implemented as "not connected"; async: depending on state of pcb in underlying lib
         _setState(State::disconnectingTcp1);
@@ -67,6 +67,7 @@ class MqttClient {
   uint16_t publish(const char* topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadCallback callback, size_t length);
   void clearQueue(bool deleteSessionData = false);  // Not MQTT compliant and may cause unpredictable results when `deleteSessionData` = true!
   const char* getClientId() const;
+  uint32_t tcpConnectedTime() const;  // millis() when the last TCP connection was established, 0 if none
   size_t queueSize();  // No const because of mutex
   void loop();
 
@@ -143,6 +144,7 @@ class MqttClient {
   espMqttClientInternals::Parser _parser;
   uint32_t _lastClientActivity;
   uint32_t _lastServerActivity;
+  uint32_t _tcpConnectedTime;
   bool _pingSent;
   espMqttClientTypes::DisconnectReason _disconnectReason;
 
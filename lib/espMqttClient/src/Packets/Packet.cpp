@@ -17,6 +17,8 @@ MemoryPool::Variable<EMC_NUM_POOL_ELEMENTS, EMC_SIZE_POOL_ELEMENTS> Packet::_mem
 Packet::~Packet() {
   #if EMC_USE_MEMPOOL
   _memPool.free(_data);
+  #elif EMC_USE_PACKET_POOL
+  PacketPool::free(_data);
   #else
   free(_data);
   #endif
@@ -320,6 +322,8 @@ bool Packet::_allocate(size_t remainingLength, bool check) {
   _size = 1 + remainingLengthLength(remainingLength) + remainingLength;
   #if EMC_USE_MEMPOOL
   _data = reinterpret_cast<uint8_t*>(_memPool.malloc(_size));
+  #elif EMC_USE_PACKET_POOL
+  _data = reinterpret_cast<uint8_t*>(PacketPool::malloc(_size));
   #else
   _data = reinterpret_cast<uint8_t*>(malloc(_size));
   #endif
@@ -21,6 +21,8 @@ the LICENSE file.
 
 #if EMC_USE_MEMPOOL
   #include "MemoryPool/src/MemoryPool.h"
+#elif EMC_USE_PACKET_POOL
+  #include "PacketPool.h"
 #endif
 
 namespace espMqttClientInternals {
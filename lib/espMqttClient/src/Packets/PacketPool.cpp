@@ -0,0 +1,180 @@
+/*
+Copyright (c) 2022 Bert Melis. All rights reserved.
+
+This work is licensed under the terms of the MIT license.
+For a copy, see <https://opensource.org/licenses/MIT> or
+the LICENSE file.
+*/
+
+#include "PacketPool.h"
+
+#if EMC_USE_PACKET_POOL
+
+#include <stdlib.h>  // malloc, free
+#if _GLIBCXX_HAS_GTHREADS
+#include <mutex>  // NOLINT [build/c++11] std::mutex, std::lock_guard
+#else
+#warning "The packet pool is not thread safe"
+#endif
+
+namespace espMqttClientInternals {
+
+namespace {
+
+class SizeClass {
+ public:
+  SizeClass(unsigned char* buffer, size_t blockSize, size_t blocks)
+  : _buffer(buffer)
+  , _end(buffer + blockSize * blocks)
+  , _head(nullptr)
+  , _blockSize(blockSize)
+  , _blocks(blocks)
+  , _inUse(0)
+  , _peakInUse(0)
+  , _allocations(0)
+  , _exhausted(0)
+  , _heapFallbacks(0) {
+    for (size_t i = blocks; i > 0; --i) {
+      unsigned char* b = buffer + (i - 1) * blockSize;
+      *reinterpret_cast<unsigned char**>(b) = _head;
+      _head = b;
+    }
+  }
+
+  void* take() {
+    if (!_head) {
+      ++_exhausted;
+      return nullptr;
+    }
+    unsigned char* b = _head;
+    _head = *reinterpret_cast<unsigned char**>(_head);
+    ++_inUse;
+    if (_inUse > _peakInUse) _peakInUse = _inUse;
+    ++_allocations;
+    return b;
+  }
+
+  bool owns(const void* ptr) const {
+    return ptr >= _buffer && ptr < _end;
+  }
+
+  void give(void* ptr) {
+    *reinterpret_cast<unsigned char**>(ptr) = _head;
+    _head = reinterpret_cast<unsigned char*>(ptr);
+    --_inUse;
+  }
+
+  void heapFallback() {
+    ++_heapFallbacks;
+  }
+
+  PacketPoolStats stats() const {
+    return PacketPoolStats{_blockSize, _blocks, _inUse, _peakInUse, _allocations, _exhausted, _heapFallbacks};
+  }
+
+  size_t blockSize() const {
+    return _blockSize;
+  }
+
+ private:
+  unsigned char* _buffer;
+  unsigned char* _end;
+  unsigned char* _head;
+  size_t _blockSize;
+  size_t _blocks;
+  size_t _inUse;
+  size_t _peakInUse;
+  uint32_t _allocations;
+  uint32_t _exhausted;
+  uint32_t _heapFallbacks;
+};
+
+#define EMC_PACKET_POOL_BLOCK(size) (((size) + 7) & ~static_cast<size_t>(7))
+
+alignas(8) unsigned char smallBuffer[EMC_PACKET_POOL_BLOCK(EMC_PACKET_POOL_SMALL_SIZE) * EMC_PACKET_POOL_SMALL_COUNT];
+alignas(8) unsigned char mediumBuffer[EMC_PACKET_POOL_BLOCK(EMC_PACKET_POOL_MEDIUM_SIZE) * EMC_PACKET_POOL_MEDIUM_COUNT];
+alignas(8) unsigned char largeBuffer[EMC_PACKET_POOL_BLOCK(EMC_PACKET_POOL_LARGE_SIZE) * EMC_PACKET_POOL_LARGE_COUNT];
+
+SizeClass sizeClasses[] = {
+  SizeClass(smallBuffer, EMC_PACKET_POOL_BLOCK(EMC_PACKET_POOL_SMALL_SIZE), EMC_PACKET_POOL_SMALL_COUNT),
+  SizeClass(mediumBuffer, EMC_PACKET_POOL_BLOCK(EMC_PACKET_POOL_MEDIUM_SIZE), EMC_PACKET_POOL_MEDIUM_COUNT),
+  SizeClass(largeBuffer, EMC_PACKET_POOL_BLOCK(EMC_PACKET_POOL_LARGE_SIZE), EMC_PACKET_POOL_LARGE_COUNT)
+};
+
+constexpr size_t numSizeClasses = sizeof(sizeClasses) / sizeof(sizeClasses[0]);
+
+uint32_t heapAllocationCount = 0;
+size_t heapInUseCount = 0;
+
+#if _GLIBCXX_HAS_GTHREADS
+std::mutex poolMutex;
+#endif
+
+}  // end anonymous namespace
+
+void* PacketPool::malloc(size_t size) {
+  size_t fittingClass = numSizeClasses;
+  {
+    #if _GLIBCXX_HAS_GTHREADS
+    const std::lock_guard<std::mutex> lockGuard(poolMutex);
+    #endif
+    for (size_t i = 0; i < numSizeClasses; ++i) {
+      if (size > sizeClasses[i].blockSize()) continue;
+      if (fittingClass == numSizeClasses) fittingClass = i;
+      void* ptr = sizeClasses[i].take();
+      if (ptr) return ptr;
+    }
+  }
+
+  void* ptr = ::malloc(size);
+  if (ptr) {
+    #if _GLIBCXX_HAS_GTHREADS
+    const std::lock_guard<std::mutex> lockGuard(poolMutex);
+    #endif
+    ++heapAllocationCount;
+    ++heapInUseCount;
+    if (fittingClass < numSizeClasses) sizeClasses[fittingClass].heapFallback();
+  }
+  return ptr;
+}
+
+void PacketPool::free(void* ptr) {
+  if (!ptr) return;
+  {
+    #if _GLIBCXX_HAS_GTHREADS
+    const std::lock_guard<std::mutex> lockGuard(poolMutex);
+    #endif
+    for (size_t i = 0; i < numSizeClasses; ++i) {
+      if (sizeClasses[i].owns(ptr)) {
+        sizeClasses[i].give(ptr);
+        return;
+      }
+    }
+    --heapInUseCount;
+  }
+  ::free(ptr);
+}
+
+size_t PacketPool::numClasses() {
+  return numSizeClasses;
+}
+
+PacketPoolStats PacketPool::classStats(size_t index) {
+  #if _GLIBCXX_HAS_GTHREADS
+  const std::lock_guard<std::mutex> lockGuard(poolMutex);
+  #endif
+  if (index >= numSizeClasses) return PacketPoolStats{0, 0, 0, 0, 0, 0, 0};
+  return sizeClasses[index].stats();
+}
+
+uint32_t PacketPool::heapAllocations() {
+  return heapAllocationCount;
+}
+
+size_t PacketPool::heapInUse() {
+  return heapInUseCount;
+}
+
+}  // end namespace espMqttClientInternals
+
+#endif
@@ -0,0 +1,51 @@
+/*
+Copyright (c) 2022 Bert Melis. All rights reserved.
+
+This work is licensed under the terms of the MIT license.
+For a copy, see <https://opensource.org/licenses/MIT> or
+the LICENSE file.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "../Config.h"
+
+#if EMC_USE_PACKET_POOL
+
+namespace espMqttClientInternals {
+
+struct PacketPoolStats {
+  size_t blockSize;
+  size_t blocks;
+  size_t inUse;
+  size_t peakInUse;
+  uint32_t allocations;
+  uint32_t exhausted;  // requests that fitted this class but found it empty
+  uint32_t heapFallbacks;  // requests for which this was the smallest fitting class that were served from the heap
+};
+
+/**
+ * @brief Packet buffer allocator with a few fixed block size classes
+ *
+ * A request is served from the smallest class that fits it and has a free block. Requests larger than the
+ * largest class, or for which every fitting class is exhausted, fall back to the heap.
+ * The blocks are allocated statically so short lived packets don't fragment the heap.
+ */
+
+class PacketPool {
+ public:
+  static void* malloc(size_t size);
+  static void free(void* ptr);
+
+  static size_t numClasses();
+  static PacketPoolStats classStats(size_t index);
+  static uint32_t heapAllocations();
+  static size_t heapInUse();
+};
+
+}  // end namespace espMqttClientInternals
+
+#endif
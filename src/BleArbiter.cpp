@@ -0,0 +1,40 @@
+#include "BleArbiter.h"
+#include "esp_timer.h"
+
+SemaphoreHandle_t BleArbiter::_mutex = nullptr;
+
+void BleArbiter::initialize()
+{
+    if(_mutex == nullptr) _mutex = xSemaphoreCreateRecursiveMutex();
+}
+
+void BleArbiter::take(LatencyStats& waitStats)
+{
+    if(_mutex == nullptr) return;
+
+    if(xSemaphoreGetMutexHolder(_mutex) == xTaskGetCurrentTaskHandle())
+    {
+        xSemaphoreTakeRecursive(_mutex, portMAX_DELAY);
+        return;
+    }
+
+    int64_t waitStartTs = esp_timer_get_time() / 1000;
+    xSemaphoreTakeRecursive(_mutex, portMAX_DELAY);
+    waitStats.add((esp_timer_get_time() / 1000) - waitStartTs);
+}
+
+void BleArbiter::give()
+{
+    if(_mutex == nullptr) return;
+    xSemaphoreGiveRecursive(_mutex);
+}
+
+BleArbiterGuard::BleArbiterGuard(LatencyStats& waitStats)
+{
+    BleArbiter::take(waitStats);
+}
+
+BleArbiterGuard::~BleArbiterGuard()
+{
+    BleArbiter::give();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "LatencyStats.h"
+
+// Serializes the BLE transactions of the lock and opener worker tasks on the shared NimBLE client.
+// Only held around the NukiBle requests, publishing the results can block on the MQTT queue for seconds.
+// Recursive, so a guarded step may call other guarded steps.
+class BleArbiter
+{
+public:
+    static void initialize();
+    static void take(LatencyStats& waitStats); // records the time spent waiting for the other worker
+    static void give();
+
+private:
+    static SemaphoreHandle_t _mutex;
+};
+
+class BleArbiterGuard
+{
+public:
+    explicit BleArbiterGuard(LatencyStats& waitStats);
+    ~BleArbiterGuard();
+};
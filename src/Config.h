@@ -112,12 +112,32 @@
 #define MQTT_KEEP_ALIVE 60
 #define GPIO_DEBOUNCE_TIME 200
 #define CHAR_BUFFER_SIZE 4096
+#define MQTT_RX_PAYLOAD_BUFFER_SIZE 4096
+#define HASS_DISCOVERY_BURST 10
+#define HASS_DISCOVERY_TOKEN_INTERVAL 50
+#define MQTT_PUBLISH_QUEUE_THRESHOLD 10
+#define MQTT_MAX_PENDING_PUBLISHES 100
+#define MQTT_PUBLISH_BACKPRESSURE_TIMEOUT 5000
+#define WEBCFG_LIVE_STATE_BUFFER_SIZE 512
+#define WEBCFG_API_MAX_BODY_SIZE 256
+#define CONFIG_IMPORT_MAX_VALUE_LENGTH 8192
+#define CONFIG_IMPORT_MAX_STAGED_SIZE 32768
 #define NUKI_TASK_SIZE 8192
+#define NUKI_TASK_MAX_IDLE_TIME 1000
 #define PD_TASK_SIZE 1024
 #define MAX_AUTHLOG 5
+#define AUTHLOG_PAGE_SIZE 5
+#define ROLLING_LOG_DETECT 0xa5c3b00d
+#define JSON_ARENA_SIZE 6144
+#define JSON_ARENA_SIZE_PSRAM 65536
 #define MAX_KEYPAD 10
 #define MAX_TIMECONTROL 10
 #define MAX_AUTH 10
 #endif
 
 #define NETWORK_TASK_SIZE 12288
+#define WIFI_FAST_RECONNECT_DETECT 0x5a17c0de
+#define WIFI_FAST_RECONNECT_TIMEOUT 3000
+#define OTA_DOWNLOAD_BUFFER_SIZE 4096
+#define OTA_MAX_REDIRECTS 5
+#define WEBCFG_MAX_RESPONSES 4
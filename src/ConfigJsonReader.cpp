@@ -0,0 +1,228 @@
+#include "ConfigJsonReader.h"
+
+#define CONFIG_JSON_MAX_KEY_LENGTH 64
+
+static bool isJsonWhitespace(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+ConfigJsonReader::ConfigJsonReader(const size_t maxValueLength)
+: _maxValueLength(maxValueLength)
+{}
+
+bool ConfigJsonReader::feed(const char* data, const size_t length, const MemberCallback& onMember)
+{
+    for(size_t i = 0; i < length && _state != State::Error; i++)
+    {
+        processChar(data[i], onMember);
+    }
+
+    return _state != State::Error;
+}
+
+bool ConfigJsonReader::processChar(const char c, const MemberCallback& onMember)
+{
+    switch(_state)
+    {
+        case State::Start:
+            if(isJsonWhitespace(c)) return true;
+            // UTF-8 byte order mark written by some editors
+            if((uint8_t)c == 0xef || (uint8_t)c == 0xbb || (uint8_t)c == 0xbf) return true;
+            if(c != '{') return fail("Expected '{'");
+            _state = State::ExpectKey;
+            return true;
+        case State::ExpectKey:
+            if(isJsonWhitespace(c)) return true;
+            if(c == '}' && !_memberRequired)
+            {
+                _state = State::Done;
+                return true;
+            }
+            if(c != '"') return fail("Expected key");
+            _key = "";
+            _memberRequired = false;
+            _state = State::Key;
+            return true;
+        case State::Key:
+            if(!_escape && c == '"')
+            {
+                _state = State::ExpectColon;
+                return true;
+            }
+            if(!appendStringChar(c, _key)) return false;
+            if(_key.length() > CONFIG_JSON_MAX_KEY_LENGTH) return fail("Key too long");
+            return true;
+        case State::ExpectColon:
+            if(isJsonWhitespace(c)) return true;
+            if(c != ':') return fail("Expected ':'");
+            _state = State::ExpectValue;
+            return true;
+        case State::ExpectValue:
+            if(isJsonWhitespace(c)) return true;
+            _value = "";
+            if(c == '"')
+            {
+                _state = State::StringValue;
+                return true;
+            }
+            if(c == '{' || c == '[') return fail("Nested values are not supported");
+            if(c == ',' || c == '}' || c == ':') return fail("Expected value");
+            _value.concat(c);
+            _state = State::LiteralValue;
+            return true;
+        case State::StringValue:
+            if(!_escape && c == '"')
+            {
+                emitMember(false, onMember);
+                _state = State::ExpectSeparator;
+                return true;
+            }
+            if(!appendStringChar(c, _value)) return false;
+            if(_value.length() > _maxValueLength) return fail("Value too long");
+            return true;
+        case State::LiteralValue:
+            if(isJsonWhitespace(c) || c == ',' || c == '}')
+            {
+                if(_value == "null") emitMember(true, onMember);
+                else if(_value == "true" || _value == "false" || _value[0] == '-' || isdigit(_value[0])) emitMember(false, onMember);
+                else return fail("Invalid literal");
+
+                _state = State::ExpectSeparator;
+                return isJsonWhitespace(c) ? true : processChar(c, onMember);
+            }
+            _value.concat(c);
+            if(_value.length() > 32) return fail("Invalid literal");
+            return true;
+        case State::ExpectSeparator:
+            if(isJsonWhitespace(c)) return true;
+            if(c == ',')
+            {
+                _memberRequired = true;
+                _state = State::ExpectKey;
+                return true;
+            }
+            if(c == '}')
+            {
+                _state = State::Done;
+                return true;
+            }
+            return fail("Expected ',' or '}'");
+        case State::Done:
+            if(isJsonWhitespace(c) || c == '\0') return true;
+            return fail("Unexpected data after end of object");
+        case State::Error:
+        default:
+            return false;
+    }
+}
+
+bool ConfigJsonReader::appendStringChar(const char c, String& target)
+{
+    if(_unicodeDigits > 0)
+    {
+        uint8_t digit;
+        if(c >= '0' && c <= '9') digit = c - '0';
+        else if(c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if(c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return fail("Invalid unicode escape");
+
+        _unicode = (_unicode << 4) | digit;
+        if(--_unicodeDigits == 0) appendCodepoint(_unicode, target);
+        return true;
+    }
+
+    if(_escape)
+    {
+        _escape = false;
+        switch(c)
+        {
+            case '"':
+            case '\\':
+            case '/':
+                target.concat(c);
+                return true;
+            case 'b':
+                target.concat('\b');
+                return true;
+            case 'f':
+                target.concat('\f');
+                return true;
+            case 'n':
+                target.concat('\n');
+                return true;
+            case 'r':
+                target.concat('\r');
+                return true;
+            case 't':
+                target.concat('\t');
+                return true;
+            case 'u':
+                _unicode = 0;
+                _unicodeDigits = 4;
+                return true;
+            default:
+                return fail("Invalid escape sequence");
+        }
+    }
+
+    if(c == '\\')
+    {
+        _escape = true;
+        return true;
+    }
+    if((uint8_t)c < 0x20) return fail("Control character in string");
+
+    target.concat(c);
+    return true;
+}
+
+void ConfigJsonReader::appendCodepoint(uint16_t codepoint, String& target)
+{
+    // Surrogate pairs are passed through as individual code points, the export never produces them
+    if(codepoint < 0x80)
+    {
+        target.concat((char)codepoint);
+    }
+    else if(codepoint < 0x800)
+    {
+        target.concat((char)(0xc0 | (codepoint >> 6)));
+        target.concat((char)(0x80 | (codepoint & 0x3f)));
+    }
+    else
+    {
+        target.concat((char)(0xe0 | (codepoint >> 12)));
+        target.concat((char)(0x80 | ((codepoint >> 6) & 0x3f)));
+        target.concat((char)(0x80 | (codepoint & 0x3f)));
+    }
+}
+
+void ConfigJsonReader::emitMember(const bool isNull, const MemberCallback& onMember)
+{
+    onMember(_key, _value, isNull);
+    _value = "";
+}
+
+bool ConfigJsonReader::fail(const char* message)
+{
+    _state = State::Error;
+    _errorMessage = message;
+    _key = "";
+    _value = "";
+    return false;
+}
+
+const bool ConfigJsonReader::complete() const
+{
+    return _state == State::Done;
+}
+
+const bool ConfigJsonReader::error() const
+{
+    return _state == State::Error;
+}
+
+const char* ConfigJsonReader::errorMessage() const
+{
+    return _errorMessage;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+
+// Push parser for the flat JSON object produced by the configuration export. Input can be fed in arbitrary
+// chunks as it arrives, every member is reported as soon as its value is complete, so only the current key
+// and value are held in memory. Strings are unescaped, numbers and true / false are reported as their
+// literal text, null is reported with isNull set. Nested objects or arrays are rejected.
+class ConfigJsonReader
+{
+public:
+    typedef std::function<void(const String& key, const String& value, const bool isNull)> MemberCallback;
+
+    explicit ConfigJsonReader(const size_t maxValueLength);
+
+    // Returns false once the input is invalid, further input is ignored
+    bool feed(const char* data, const size_t length, const MemberCallback& onMember);
+
+    const bool complete() const;  // closing brace of the object seen
+    const bool error() const;
+    const char* errorMessage() const;
+
+private:
+    enum class State : uint8_t
+    {
+        Start,
+        ExpectKey,
+        Key,
+        ExpectColon,
+        ExpectValue,
+        StringValue,
+        LiteralValue,
+        ExpectSeparator,
+        Done,
+        Error
+    };
+
+    bool processChar(const char c, const MemberCallback& onMember);
+    bool appendStringChar(const char c, String& target);
+    void appendCodepoint(uint16_t codepoint, String& target);
+    void emitMember(const bool isNull, const MemberCallback& onMember);
+    bool fail(const char* message);
+
+    State _state = State::Start;
+    bool _escape = false;
+    bool _memberRequired = false; // after ',' so {"a": 1,} is rejected
+    uint8_t _unicodeDigits = 0;
+    uint16_t _unicode = 0;
+    size_t _maxValueLength;
+    String _key;
+    String _value;
+    const char* _errorMessage = "";
+};
@@ -0,0 +1,986 @@
+#pragma once
+
+#include "Config.h"
+#include "HassEntity.h"
+#include "MqttTopics.h"
+
+constexpr const char* hassFobActionOptions[] =
+{
+    "No Action",
+    "Unlock",
+    "Lock",
+    "Lock n Go",
+    "Intelligent",
+    nullptr
+};
+
+constexpr const char* hassAdvertisingModeOptions[] =
+{
+    "Automatic",
+    "Normal",
+    "Slow",
+    "Slowest",
+    nullptr
+};
+
+constexpr const char* hassTimezoneOptions[] =
+{
+    "Africa/Cairo",
+    "Africa/Lagos",
+    "Africa/Maputo",
+    "Africa/Nairobi",
+    "America/Anchorage",
+    "America/Argentina/Buenos_Aires",
+    "America/Chicago",
+    "America/Denver",
+    "America/Halifax",
+    "America/Los_Angeles",
+    "America/Manaus",
+    "America/Mexico_City",
+    "America/New_York",
+    "America/Phoenix",
+    "America/Regina",
+    "America/Santiago",
+    "America/Sao_Paulo",
+    "America/St_Johns",
+    "Asia/Bangkok",
+    "Asia/Dubai",
+    "Asia/Hong_Kong",
+    "Asia/Jerusalem",
+    "Asia/Karachi",
+    "Asia/Kathmandu",
+    "Asia/Kolkata",
+    "Asia/Riyadh",
+    "Asia/Seoul",
+    "Asia/Shanghai",
+    "Asia/Tehran",
+    "Asia/Tokyo",
+    "Asia/Yangon",
+    "Australia/Adelaide",
+    "Australia/Brisbane",
+    "Australia/Darwin",
+    "Australia/Hobart",
+    "Australia/Perth",
+    "Australia/Sydney",
+    "Europe/Berlin",
+    "Europe/Helsinki",
+    "Europe/Istanbul",
+    "Europe/London",
+    "Europe/Moscow",
+    "Pacific/Auckland",
+    "Pacific/Guam",
+    "Pacific/Honolulu",
+    "Pacific/Pago_Pago",
+    "None",
+    nullptr
+};
+
+constexpr const char* hassButtonPressActionOptions[] =
+{
+    "No Action",
+    "Intelligent",
+    "Unlock",
+    "Lock",
+    "Unlatch",
+    "Lock n Go",
+    "Show Status",
+    nullptr
+};
+
+constexpr const char* hassBatteryTypeOptions[] =
+{
+    "Alkali",
+    "Accumulators",
+    "Lithium",
+    nullptr
+};
+
+constexpr const char* hassRingEventTypes[] =
+{
+    "ring",
+    "ringlocked",
+    nullptr
+};
+
+constexpr const char* hassOpenerFobActionOptions[] =
+{
+    "No Action",
+    "Toggle RTO",
+    "Activate RTO",
+    "Deactivate RTO",
+    "Open",
+    "Ring",
+    nullptr
+};
+
+constexpr const char* hassOperatingModeOptions[] =
+{
+    "Generic door opener",
+    "Analogue intercom",
+    "Digital intercom",
+    "Siedle",
+    "TCS",
+    "Bticino",
+    "Siedle HTS",
+    "STR",
+    "Ritto",
+    "Fermax",
+    "Comelit",
+    "Urmet BiBus",
+    "Urmet 2Voice",
+    "Golmar",
+    "SKS",
+    "Spare",
+    nullptr
+};
+
+constexpr const char* hassDoorbellSuppressionOptions[] =
+{
+    "Off",
+    "CM",
+    "RTO",
+    "CM & RTO",
+    "Ring",
+    "CM & Ring",
+    "RTO & Ring",
+    "CM & RTO & Ring",
+    nullptr
+};
+
+constexpr const char* hassSoundOptions[] =
+{
+    "No Sound",
+    "Sound 1",
+    "Sound 2",
+    "Sound 3",
+    nullptr
+};
+
+constexpr const char* hassOpenerButtonPressActionOptions[] =
+{
+    "No Action",
+    "Toggle RTO",
+    "Activate RTO",
+    "Deactivate RTO",
+    "Toggle CM",
+    "Activate CM",
+    "Deactivate CM",
+    "Open",
+    nullptr
+};
+
+// Entities of every lock and opener published by publishHASSConfig()
+constexpr HassEntity hassDeviceEntities[] =
+{
+    { "binary_sensor", "battery_low", "_battery_low", "Battery low",
+      "~" mqtt_topic_battery_basic_json, "battery", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "pl_on", "1" },
+        { "pl_off", "0" },
+        { "val_tpl", "{{value_json.critical}}" } } },
+    { "sensor", "battery_voltage", "_battery_voltage", "Battery voltage",
+      "~" mqtt_topic_battery_advanced_json, "voltage", "measurement", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "unit_of_meas", "V" },
+        { "val_tpl", "{{value_json.batteryVoltage}}" } } },
+    { "sensor", "trigger", "_trigger", "Trigger",
+      "~" mqtt_topic_lock_trigger, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" } } },
+    { "binary_sensor", "mqtt_connected", "_mqtt_connected", "MQTT connected",
+      mqtt_topic_mqtt_connection_state, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "pl_on", "online" },
+        { "pl_off", "offline" },
+        { "ic", "mdi:lan-connect" } },
+      nullptr, nullptr, true },
+    { "switch", "reset", "_reset", "Restart Nuki Hub",
+      "~" mqtt_topic_reset, "", "", "diagnostic", "~" mqtt_topic_reset,
+      HassAcl::None, 0,
+      { { "ic", "mdi:restart" },
+        { "pl_on", "1" },
+        { "pl_off", "0" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "sensor", "network_device", "_network_device", "Network device",
+      mqtt_topic_network_device, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" } },
+      nullptr, nullptr, true },
+    { "switch", "webserver", "_webserver", "Nuki Hub webserver enabled",
+      mqtt_topic_webserver_state, "", "", "diagnostic", mqtt_topic_webserver_action,
+      HassAcl::None, 0,
+      { { "pl_on", "1" },
+        { "pl_off", "0" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } },
+      nullptr, nullptr, true },
+    { "sensor", "uptime", "_uptime", "Uptime",
+      mqtt_topic_uptime, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" } },
+      nullptr, nullptr, true },
+    { "sensor", "firmware_version", "_firmware_version", "Firmware version",
+      "~" mqtt_topic_info_firmware_version, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" },
+        { "ic", "mdi:counter" } } },
+    { "sensor", "hardware_version", "_hardware_version", "Hardware version",
+      "~" mqtt_topic_info_hardware_version, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" },
+        { "ic", "mdi:counter" } } },
+    { "sensor", "nuki_hub_version", "_nuki_hub_version", "Nuki Hub version",
+      mqtt_topic_info_nuki_hub_version, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" },
+        { "ic", "mdi:counter" } },
+      nullptr, nullptr, true },
+    { "sensor", "nuki_hub_build", "_nuki_hub_build", "Nuki Hub build",
+      mqtt_topic_info_nuki_hub_build, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" },
+        { "ic", "mdi:counter" } },
+      nullptr, nullptr, true },
+    { "sensor", "nuki_hub_restart_reason", "_nuki_hub_restart_reason", "Nuki Hub restart reason",
+      mqtt_topic_restart_reason_fw, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" } },
+      nullptr, nullptr, true },
+    { "sensor", "nuki_hub_restart_reason_esp", "_nuki_hub_restart_reason_esp", "Nuki Hub restart reason ESP",
+      mqtt_topic_restart_reason_esp, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" } },
+      nullptr, nullptr, true },
+    { "sensor", "nuki_hub_ip", "_nuki_hub_ip", "Nuki Hub IP",
+      mqtt_topic_info_nuki_hub_ip, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" },
+        { "ic", "mdi:ip" } },
+      nullptr, nullptr, true },
+    { "button", "query_lockstate", "_query_lockstate", "Query lock state",
+      "", "", "", "diagnostic", "~" mqtt_topic_query_lockstate,
+      HassAcl::None, 0,
+      { { "en", "false" },
+        { "pl_prs", "1" } } },
+    { "button", "query_config", "_query_config", "Query config",
+      "", "", "", "diagnostic", "~" mqtt_topic_query_config,
+      HassAcl::None, 0,
+      { { "en", "false" },
+        { "pl_prs", "1" } } },
+    { "button", "query_commandresult", "_query_commandresult", "Query lock state command result",
+      "", "", "", "diagnostic", "~" mqtt_topic_query_lockstate_command_result,
+      HassAcl::None, 0,
+      { { "en", "false" },
+        { "pl_prs", "1" } } },
+    { "sensor", "bluetooth_signal_strength", "_bluetooth_signal_strength", "Bluetooth signal strength",
+      "~" mqtt_topic_lock_rssi, "signal_strength", "measurement", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "unit_of_meas", "dBm" } } },
+};
+
+// Published by publishHASSConfig() while the MQTT log is enabled
+constexpr HassEntity hassMqttLogEntity =
+    { "sensor", "mqtt_log", "_mqtt_log", "MQTT Log",
+      mqtt_topic_log, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" } },
+      nullptr, nullptr, true };
+
+// Published by publishHASSConfig() while hybrid mode is enabled
+constexpr HassEntity hassHybridConnectedEntity =
+    { "binary_sensor", "hybrid_connected", "_hybrid_connected", "Hybrid connected",
+      mqtt_hybrid_state, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "pl_on", "1" },
+        { "pl_off", "0" },
+        { "en", "true" } },
+      nullptr, nullptr, true };
+
+// Published by publishHASSConfig() while update checks are enabled, with one of the update entities
+constexpr HassEntity hassNukiHubLatestEntity =
+    { "sensor", "nuki_hub_latest", "_nuki_hub_latest", "NUKI Hub latest",
+      mqtt_topic_info_nuki_hub_latest, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" },
+        { "ic", "mdi:counter" } },
+      nullptr, nullptr, true };
+
+constexpr HassEntity hassNukiHubUpdateEntity =
+    { "update", "nuki_hub_update", "_nuki_hub_update", "NUKI Hub firmware update",
+      mqtt_topic_info_nuki_hub_version, "firmware", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "en", "true" },
+        { "ent_pic", "https://raw.githubusercontent.com/technyon/nuki_hub/master/icon/favicon-32x32.png" },
+        { "rel_u", GITHUB_LATEST_RELEASE_URL },
+        { "l_ver_t", mqtt_topic_info_nuki_hub_latest, true } },
+      nullptr, nullptr, true };
+
+// Installable from Home Assistant, when updates over MQTT are allowed
+constexpr HassEntity hassNukiHubMqttUpdateEntity =
+    { "update", "nuki_hub_update", "_nuki_hub_update", "NUKI Hub firmware update",
+      mqtt_topic_info_nuki_hub_version, "firmware", "", "diagnostic", mqtt_topic_update,
+      HassAcl::None, 0,
+      { { "en", "true" },
+        { "pl_inst", "1" },
+        { "ent_pic", "https://raw.githubusercontent.com/technyon/nuki_hub/master/icon/favicon-32x32.png" },
+        { "rel_u", GITHUB_LATEST_RELEASE_URL },
+        { "l_ver_t", mqtt_topic_info_nuki_hub_latest, true } },
+      nullptr, nullptr, true };
+
+// Published by publishHASSConfigDoorSensor()
+constexpr HassEntity hassDoorSensorEntity =
+    { "binary_sensor", "door_sensor", "_door_sensor", "Door sensor",
+      "~" mqtt_topic_lock_door_sensor_state, "door", "", "", "",
+      HassAcl::None, 0,
+      { { "pl_on", "doorOpened" },
+        { "pl_off", "doorClosed" },
+        { "pl_not_avail", "unavailable" } } };
+
+// Published by publishHASSWifiRssiConfig() on Wi-Fi
+constexpr HassEntity hassWifiRssiEntity =
+    { "sensor", "wifi_signal_strength", "_wifi_signal_strength", "WIFI signal strength",
+      mqtt_topic_wifi_rssi, "signal_strength", "measurement", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "unit_of_meas", "dBm" } },
+      nullptr, nullptr, true };
+
+// Published by publishHASSConfigAccessLog()
+constexpr HassEntity hassAccessLogEntities[] =
+{
+    { "sensor", "last_action_authorization", "_last_action_authorization", "Last action authorization",
+      "~" mqtt_topic_lock_log, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "ic", "mdi:format-list-bulleted" },
+        { "val_tpl", "{{ (value_json|selectattr('type', 'eq', 'LockAction')|selectattr('action', 'in', ['Lock', 'Unlock', 'Unlatch'])|first|default).authorizationName|default }}" } } },
+    { "sensor", "rolling_log", "_rolling_log", "Rolling authorization log",
+      "~" mqtt_topic_lock_log_rolling, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "ic", "mdi:format-list-bulleted" },
+        { "json_attr_t", "~" mqtt_topic_lock_log_rolling },
+        { "val_tpl", "{{value_json.index}}" } } },
+};
+
+// Published by publishHASSConfigKeypad()
+constexpr HassEntity hassKeypadEntities[] =
+{
+    { "binary_sensor", "keypad_battery_low", "_keypad_battery_low", "Keypad battery low",
+      "~" mqtt_topic_battery_basic_json, "battery", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "pl_on", "1" },
+        { "pl_off", "0" },
+        { "val_tpl", "{{value_json.keypadCritical}}" } } },
+    { "button", "query_keypad", "_query_keypad", "Query keypad",
+      "", "", "", "diagnostic", "~" mqtt_topic_query_keypad,
+      HassAcl::None, 0,
+      { { "en", "false" },
+        { "pl_prs", "1" } } },
+    { "sensor", "keypad_status", "_keypad_stats", "Keypad status",
+      "~" mqtt_topic_lock_log, "", "", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "ic", "mdi:drag-vertical" },
+        { "val_tpl", "{{ (value_json|selectattr('type', 'eq', 'KeypadAction')|first|default).completionStatus|default }}" } } },
+};
+
+// Entities published by publishHASSConfigAdditionalLockEntities(). Gated entities are removed when their ACL flag is not set.
+constexpr HassEntity hassLockEntities[] =
+{
+    { "button", "unlatch", "_unlatch", "Open",
+      "", "", "", "", "~" mqtt_topic_lock_action,
+      HassAcl::Acl, 2,
+      { { "en", "false" },
+        { "pl_prs", "unlatch" } } },
+    { "button", "lockngo", "_lockngo", "Lock 'n' Go",
+      "", "", "", "", "~" mqtt_topic_lock_action,
+      HassAcl::Acl, 3,
+      { { "en", "false" },
+        { "pl_prs", "lockNgo" } } },
+    { "button", "lockngounlatch", "_lockngounlatch", "Lock 'n' Go with unlatch",
+      "", "", "", "", "~" mqtt_topic_lock_action,
+      HassAcl::Acl, 4,
+      { { "en", "false" },
+        { "pl_prs", "lockNgoUnlatch" } } },
+    { "button", "query_battery", "_query_battery", "Query battery",
+      "", "", "", "diagnostic", "~" mqtt_topic_query_battery,
+      HassAcl::None, 0,
+      { { "en", "false" },
+        { "pl_prs", "1" } } },
+    { "switch", "led_enabled", "_led_enabled", "LED enabled",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 6,
+      { { "en", "true" },
+        { "ic", "mdi:led-variant-on" },
+        { "pl_on", "{ \"ledEnabled\": \"1\"}" },
+        { "pl_off", "{ \"ledEnabled\": \"0\"}" },
+        { "val_tpl", "{{value_json.ledEnabled}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "switch", "button_enabled", "_button_enabled", "Button enabled",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 5,
+      { { "en", "true" },
+        { "ic", "mdi:radiobox-marked" },
+        { "pl_on", "{ \"buttonEnabled\": \"1\"}" },
+        { "pl_off", "{ \"buttonEnabled\": \"0\"}" },
+        { "val_tpl", "{{value_json.buttonEnabled}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "switch", "auto_lock", "_auto_lock", "Auto lock",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 19,
+      { { "en", "true" },
+        { "pl_on", "{ \"autoLockEnabled\": \"1\"}" },
+        { "pl_off", "{ \"autoLockEnabled\": \"0\"}" },
+        { "val_tpl", "{{value_json.autoLockEnabled}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "switch", "auto_unlock", "_auto_unlock", "Auto unlock",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 12,
+      { { "en", "true" },
+        { "pl_on", "{ \"autoUnLockDisabled\": \"0\"}" },
+        { "pl_off", "{ \"autoUnLockDisabled\": \"1\"}" },
+        { "val_tpl", "{{value_json.autoUnLockDisabled}}" },
+        { "stat_on", "0" },
+        { "stat_off", "1" } } },
+    { "switch", "double_lock", "_double_lock", "Double lock",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 13,
+      { { "en", "true" },
+        { "pl_on", "{ \"singleLock\": \"0\"}" },
+        { "pl_off", "{ \"singleLock\": \"1\"}" },
+        { "val_tpl", "{{value_json.singleLock}}" },
+        { "stat_on", "0" },
+        { "stat_off", "1" } } },
+    { "sensor", "battery_level", "_battery_level", "Battery level",
+      "~" mqtt_topic_battery_basic_json, "battery", "measurement", "diagnostic", "",
+      HassAcl::None, 0,
+      { { "unit_of_meas", "%" },
+        { "val_tpl", "{{value_json.level}}" } } },
+    { "number", "led_brightness", "_led_brightness", "LED brightness",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 7,
+      { { "en", "true" },
+        { "ic", "mdi:brightness-6" },
+        { "cmd_tpl", "{ \"ledBrightness\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.ledBrightness}}" },
+        { "min", "0" },
+        { "max", "5" } } },
+    { "switch", "auto_unlatch", "_auto_unlatch", "Auto unlatch",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 3,
+      { { "en", "true" },
+        { "pl_on", "{ \"autoUnlatch\": \"1\"}" },
+        { "pl_off", "{ \"autoUnlatch\": \"0\"}" },
+        { "val_tpl", "{{value_json.autoUnlatch}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "switch", "pairing_enabled", "_pairing_enabled", "Pairing enabled",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 4,
+      { { "en", "true" },
+        { "pl_on", "{ \"pairingEnabled\": \"1\"}" },
+        { "pl_off", "{ \"pairingEnabled\": \"0\"}" },
+        { "val_tpl", "{{value_json.pairingEnabled}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "number", "timezone_offset", "_timezone_offset", "Timezone offset",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 8,
+      { { "en", "true" },
+        { "ic", "mdi:timer-cog-outline" },
+        { "cmd_tpl", "{ \"timeZoneOffset\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.timeZoneOffset}}" },
+        { "min", "0" },
+        { "max", "60" } } },
+    { "switch", "dst_mode", "_dst_mode", "DST mode European",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 9,
+      { { "en", "true" },
+        { "pl_on", "{ \"dstMode\": \"1\"}" },
+        { "pl_off", "{ \"dstMode\": \"0\"}" },
+        { "val_tpl", "{{value_json.dstMode}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "select", "fob_action_1", "_fob_action_1", "Fob action 1",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 10,
+      { { "val_tpl", "{{value_json.fobAction1}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"fobAction1\": \"{{ value }}\" }" } },
+      "options", hassFobActionOptions },
+    { "select", "fob_action_2", "_fob_action_2", "Fob action 2",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 11,
+      { { "val_tpl", "{{value_json.fobAction2}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"fobAction2\": \"{{ value }}\" }" } },
+      "options", hassFobActionOptions },
+    { "select", "fob_action_3", "_fob_action_3", "Fob action 3",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 12,
+      { { "val_tpl", "{{value_json.fobAction3}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"fobAction3\": \"{{ value }}\" }" } },
+      "options", hassFobActionOptions },
+    { "select", "advertising_mode", "_advertising_mode", "Advertising mode",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 14,
+      { { "val_tpl", "{{value_json.advertisingMode}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"advertisingMode\": \"{{ value }}\" }" } },
+      "options", hassAdvertisingModeOptions },
+    { "select", "timezone", "_timezone", "Timezone",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 15,
+      { { "val_tpl", "{{value_json.timeZone}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"timeZone\": \"{{ value }}\" }" } },
+      "options", hassTimezoneOptions },
+    { "number", "unlocked_position_offset_degrees", "_unlocked_position_offset_degrees", "Unlocked position offset degrees",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 0,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"unlockedPositionOffsetDegrees\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.unlockedPositionOffsetDegrees}}" },
+        { "min", "-90" },
+        { "max", "180" } } },
+    { "number", "locked_position_offset_degrees", "_locked_position_offset_degrees", "Locked position offset degrees",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 1,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"lockedPositionOffsetDegrees\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.lockedPositionOffsetDegrees}}" },
+        { "min", "-180" },
+        { "max", "90" } } },
+    { "number", "single_locked_position_offset_degrees", "_single_locked_position_offset_degrees", "Single locked position offset degrees",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 2,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"singleLockedPositionOffsetDegrees\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.singleLockedPositionOffsetDegrees}}" },
+        { "min", "-180" },
+        { "max", "180" } } },
+    { "number", "unlocked_locked_transition_offset_degrees", "_unlocked_locked_transition_offset_degrees", "Unlocked to locked transition offset degrees",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 3,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"unlockedToLockedTransitionOffsetDegrees\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.unlockedToLockedTransitionOffsetDegrees}}" },
+        { "min", "-180" },
+        { "max", "180" } } },
+    { "number", "lockngo_timeout", "_lockngo_timeout", "Lock n Go timeout",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 4,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"lockNgoTimeout\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.lockNgoTimeout}}" },
+        { "min", "5" },
+        { "max", "60" } } },
+    { "select", "single_button_press_action", "_single_button_press_action", "Single button press action",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 5,
+      { { "val_tpl", "{{value_json.singleButtonPressAction}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"singleButtonPressAction\": \"{{ value }}\" }" } },
+      "options", hassButtonPressActionOptions },
+    { "select", "double_button_press_action", "_double_button_press_action", "Double button press action",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 6,
+      { { "val_tpl", "{{value_json.doubleButtonPressAction}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"doubleButtonPressAction\": \"{{ value }}\" }" } },
+      "options", hassButtonPressActionOptions },
+    { "switch", "detached_cylinder", "_detached_cylinder", "Detached cylinder",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 7,
+      { { "en", "true" },
+        { "pl_on", "{ \"detachedCylinder\": \"1\"}" },
+        { "pl_off", "{ \"detachedCylinder\": \"0\"}" },
+        { "val_tpl", "{{value_json.detachedCylinder}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "select", "battery_type", "_battery_type", "Battery type",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 8,
+      { { "val_tpl", "{{value_json.batteryType}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"batteryType\": \"{{ value }}\" }" } },
+      "options", hassBatteryTypeOptions },
+    { "switch", "automatic_battery_type_detection", "_automatic_battery_type_detection", "Automatic battery type detection",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 9,
+      { { "en", "true" },
+        { "pl_on", "{ \"automaticBatteryTypeDetection\": \"1\"}" },
+        { "pl_off", "{ \"automaticBatteryTypeDetection\": \"0\"}" },
+        { "val_tpl", "{{value_json.automaticBatteryTypeDetection}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "number", "unlatch_duration", "_unlatch_duration", "Unlatch duration",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 10,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"unlatchDuration\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.unlatchDuration}}" },
+        { "min", "1" },
+        { "max", "30" } } },
+    { "number", "auto_lock_timeout", "_auto_lock_timeout", "Auto lock timeout",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 11,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"autoLockTimeOut\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.autoLockTimeOut}}" },
+        { "min", "30" },
+        { "max", "1800" } } },
+    { "switch", "nightmode_enabled", "_nightmode_enabled", "Nightmode enabled",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 13,
+      { { "en", "true" },
+        { "pl_on", "{ \"nightModeEnabled\": \"1\"}" },
+        { "pl_off", "{ \"nightModeEnabled\": \"0\"}" },
+        { "val_tpl", "{{value_json.nightModeEnabled}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "text", "nightmode_start_time", "_nightmode_start_time", "Nightmode start time",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 14,
+      { { "en", "true" },
+        { "pattern", "([0-1][0-9]|2[0-3]):[0-5][0-9]" },
+        { "cmd_tpl", "{ \"nightModeStartTime\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.nightModeStartTime}}" },
+        { "min", "5" },
+        { "max", "5" } } },
+    { "text", "nightmode_end_time", "_nightmode_end_time", "Nightmode end time",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 15,
+      { { "en", "true" },
+        { "pattern", "([0-1][0-9]|2[0-3]):[0-5][0-9]" },
+        { "cmd_tpl", "{ \"nightModeEndTime\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.nightModeEndTime}}" },
+        { "min", "5" },
+        { "max", "5" } } },
+    { "switch", "nightmode_auto_lock", "_nightmode_auto_lock", "Nightmode auto lock",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 16,
+      { { "en", "true" },
+        { "pl_on", "{ \"nightModeAutoLockEnabled\": \"1\"}" },
+        { "pl_off", "{ \"nightModeAutoLockEnabled\": \"0\"}" },
+        { "val_tpl", "{{value_json.nightModeAutoLockEnabled}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "switch", "nightmode_auto_unlock", "_nightmode_auto_unlock", "Nightmode auto unlock",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 17,
+      { { "en", "true" },
+        { "pl_on", "{ \"nightModeAutoUnlockDisabled\": \"0\"}" },
+        { "pl_off", "{ \"nightModeAutoUnlockDisabled\": \"1\"}" },
+        { "val_tpl", "{{value_json.nightModeAutoUnlockDisabled}}" },
+        { "stat_on", "0" },
+        { "stat_off", "1" } } },
+    { "switch", "nightmode_immediate_lock_start", "_nightmode_immediate_lock_start", "Nightmode immediate lock on start",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 18,
+      { { "en", "true" },
+        { "pl_on", "{ \"nightModeImmediateLockOnStart\": \"1\"}" },
+        { "pl_off", "{ \"nightModeImmediateLockOnStart\": \"0\"}" },
+        { "val_tpl", "{{value_json.nightModeImmediateLockOnStart}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "switch", "immediate_auto_lock_enabled", "_immediate_auto_lock_enabled", "Immediate auto lock enabled",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 20,
+      { { "en", "true" },
+        { "pl_on", "{ \"immediateAutoLockEnabled\": \"1\"}" },
+        { "pl_off", "{ \"immediateAutoLockEnabled\": \"0\"}" },
+        { "val_tpl", "{{value_json.immediateAutoLockEnabled}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "switch", "auto_update_enabled", "_auto_update_enabled", "Auto update enabled",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 21,
+      { { "en", "true" },
+        { "pl_on", "{ \"autoUpdateEnabled\": \"1\"}" },
+        { "pl_off", "{ \"autoUpdateEnabled\": \"0\"}" },
+        { "val_tpl", "{{value_json.autoUpdateEnabled}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+};
+
+// Published by publishHASSConfigAdditionalOpenerEntities() when both continuous mode actions are permitted
+constexpr HassEntity hassOpenerContinuousModeEntity =
+    { "switch", "continuous_mode", "_continuous_mode", "Continuous mode",
+      "~" mqtt_topic_lock_continuous_mode, "", "", "", "~" mqtt_topic_lock_action,
+      HassAcl::None, 0,
+      { { "en", "true" },
+        { "stat_on", "on" },
+        { "stat_off", "off" },
+        { "pl_on", "activateCM" },
+        { "pl_off", "deactivateCM" } } };
+
+// Entities published by publishHASSConfigAdditionalOpenerEntities(). Gated entities are removed when their ACL flag is not set.
+constexpr HassEntity hassOpenerEntities[] =
+{
+    { "button", "unlatch", "_unlatch", "Open",
+      "", "", "", "", "~" mqtt_topic_lock_action,
+      HassAcl::Acl, 11,
+      { { "en", "false" },
+        { "pl_prs", "electricStrikeActuation" } } },
+    { "binary_sensor", "continuous_mode", "_continuous_mode", "Continuous mode",
+      "~" mqtt_topic_lock_continuous_mode, "lock", "", "", "",
+      HassAcl::None, 0,
+      { { "pl_on", "on" },
+        { "pl_off", "off" } } },
+    { "binary_sensor", "ring_detect", "_ring_detect", "Ring detect",
+      "~" mqtt_topic_lock_binary_ring, "sound", "", "", "",
+      HassAcl::None, 0,
+      { { "pl_on", "ring" },
+        { "pl_off", "standby" } } },
+    { "event", "ring", "_ring_event", "Ring",
+      "~" mqtt_topic_lock_ring, "doorbell", "", "", "",
+      HassAcl::None, 0,
+      { { "val_tpl", "{ \"event_type\": \"{{ value }}\" }" } },
+      "event_types", hassRingEventTypes },
+    { "switch", "led_enabled", "_led_enabled", "LED enabled",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 5,
+      { { "en", "true" },
+        { "ic", "mdi:led-variant-on" },
+        { "pl_on", "{ \"ledEnabled\": \"1\"}" },
+        { "pl_off", "{ \"ledEnabled\": \"0\"}" },
+        { "val_tpl", "{{value_json.ledEnabled}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "switch", "button_enabled", "_button_enabled", "Button enabled",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 4,
+      { { "en", "true" },
+        { "ic", "mdi:radiobox-marked" },
+        { "pl_on", "{ \"buttonEnabled\": \"1\"}" },
+        { "pl_off", "{ \"buttonEnabled\": \"0\"}" },
+        { "val_tpl", "{{value_json.buttonEnabled}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "number", "sound_level", "_sound_level", "Sound level",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 15,
+      { { "en", "true" },
+        { "ic", "mdi:volume-source" },
+        { "cmd_tpl", "{ \"soundLevel\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.soundLevel}}" },
+        { "min", "0" },
+        { "max", "255" },
+        { "mode", "slider" },
+        { "step", "25.5" } } },
+    { "switch", "pairing_enabled", "_pairing_enabled", "Pairing enabled",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 3,
+      { { "en", "true" },
+        { "pl_on", "{ \"pairingEnabled\": \"1\"}" },
+        { "pl_off", "{ \"pairingEnabled\": \"0\"}" },
+        { "val_tpl", "{{value_json.pairingEnabled}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "number", "timezone_offset", "_timezone_offset", "Timezone offset",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 6,
+      { { "en", "true" },
+        { "ic", "mdi:timer-cog-outline" },
+        { "cmd_tpl", "{ \"timeZoneOffset\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.timeZoneOffset}}" },
+        { "min", "0" },
+        { "max", "60" } } },
+    { "switch", "dst_mode", "_dst_mode", "DST mode European",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 7,
+      { { "en", "true" },
+        { "pl_on", "{ \"dstMode\": \"1\"}" },
+        { "pl_off", "{ \"dstMode\": \"0\"}" },
+        { "val_tpl", "{{value_json.dstMode}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "select", "fob_action_1", "_fob_action_1", "Fob action 1",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 8,
+      { { "val_tpl", "{{value_json.fobAction1}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"fobAction1\": \"{{ value }}\" }" } },
+      "options", hassOpenerFobActionOptions },
+    { "select", "fob_action_2", "_fob_action_2", "Fob action 2",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 9,
+      { { "val_tpl", "{{value_json.fobAction2}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"fobAction2\": \"{{ value }}\" }" } },
+      "options", hassOpenerFobActionOptions },
+    { "select", "fob_action_3", "_fob_action_3", "Fob action 3",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 10,
+      { { "val_tpl", "{{value_json.fobAction3}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"fobAction3\": \"{{ value }}\" }" } },
+      "options", hassOpenerFobActionOptions },
+    { "select", "advertising_mode", "_advertising_mode", "Advertising mode",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 12,
+      { { "val_tpl", "{{value_json.advertisingMode}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"advertisingMode\": \"{{ value }}\" }" } },
+      "options", hassAdvertisingModeOptions },
+    { "select", "timezone", "_timezone", "Timezone",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 13,
+      { { "val_tpl", "{{value_json.timeZone}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"timeZone\": \"{{ value }}\" }" } },
+      "options", hassTimezoneOptions },
+    { "select", "operating_mode", "_operating_mode", "Operating mode",
+      "~" mqtt_topic_config_basic_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::BasicConfigAcl, 11,
+      { { "val_tpl", "{{value_json.operatingMode}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"operatingMode\": \"{{ value }}\" }" } },
+      "options", hassOperatingModeOptions },
+    { "switch", "bus_mode_switch", "_bus_mode_switch", "BUS mode switch analogue",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 1,
+      { { "en", "true" },
+        { "pl_on", "{ \"busModeSwitch\": \"1\"}" },
+        { "pl_off", "{ \"busModeSwitch\": \"0\"}" },
+        { "val_tpl", "{{value_json.busModeSwitch}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "number", "short_circuit_duration", "_short_circuit_duration", "Short circuit duration",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 2,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"shortCircuitDuration\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.shortCircuitDuration}}" },
+        { "min", "0" } } },
+    { "number", "electric_strike_delay", "_electric_strike_delay", "Electric strike delay",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 3,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"electricStrikeDelay\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.electricStrikeDelay}}" },
+        { "min", "0" },
+        { "max", "30000" },
+        { "step", "3000" } } },
+    { "switch", "random_electric_strike_delay", "_random_electric_strike_delay", "Random electric strike delay",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 4,
+      { { "en", "true" },
+        { "pl_on", "{ \"randomElectricStrikeDelay\": \"1\"}" },
+        { "pl_off", "{ \"randomElectricStrikeDelay\": \"0\"}" },
+        { "val_tpl", "{{value_json.randomElectricStrikeDelay}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "number", "electric_strike_duration", "_electric_strike_duration", "Electric strike duration",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 5,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"electricStrikeDuration\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.electricStrikeDuration}}" },
+        { "min", "1000" },
+        { "max", "30000" },
+        { "step", "3000" } } },
+    { "switch", "disable_rto_after_ring", "_disable_rto_after_ring", "Disable RTO after ring",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 6,
+      { { "en", "true" },
+        { "pl_on", "{ \"disableRtoAfterRing\": \"1\"}" },
+        { "pl_off", "{ \"disableRtoAfterRing\": \"0\"}" },
+        { "val_tpl", "{{value_json.disableRtoAfterRing}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "number", "rto_timeout", "_rto_timeout", "RTO timeout",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 7,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"rtoTimeout\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.rtoTimeout}}" },
+        { "min", "5" },
+        { "max", "60" } } },
+    { "select", "doorbell_suppression", "_doorbell_suppression", "Doorbell suppression",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 8,
+      { { "val_tpl", "{{value_json.doorbellSuppression}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"doorbellSuppression\": \"{{ value }}\" }" } },
+      "options", hassDoorbellSuppressionOptions },
+    { "number", "doorbell_suppression_duration", "_doorbell_suppression_duration", "Doorbell suppression duration",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 9,
+      { { "en", "true" },
+        { "cmd_tpl", "{ \"doorbellSuppressionDuration\": \"{{ value }}\" }" },
+        { "val_tpl", "{{value_json.doorbellSuppressionDuration}}" },
+        { "min", "500" },
+        { "max", "10000" },
+        { "step", "1000" } } },
+    { "select", "sound_ring", "_sound_ring", "Sound ring",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 10,
+      { { "val_tpl", "{{value_json.soundRing}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"soundRing\": \"{{ value }}\" }" } },
+      "options", hassSoundOptions },
+    { "select", "sound_open", "_sound_open", "Sound open",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 11,
+      { { "val_tpl", "{{value_json.soundOpen}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"soundOpen\": \"{{ value }}\" }" } },
+      "options", hassSoundOptions },
+    { "select", "sound_rto", "_sound_rto", "Sound RTO",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 12,
+      { { "val_tpl", "{{value_json.soundRto}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"soundRto\": \"{{ value }}\" }" } },
+      "options", hassSoundOptions },
+    { "select", "sound_cm", "_sound_cm", "Sound CM",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 13,
+      { { "val_tpl", "{{value_json.soundCm}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"soundCm\": \"{{ value }}\" }" } },
+      "options", hassSoundOptions },
+    { "switch", "sound_confirmation", "_sound_confirmation", "Sound confirmation",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 14,
+      { { "en", "true" },
+        { "pl_on", "{ \"soundConfirmation\": \"1\"}" },
+        { "pl_off", "{ \"soundConfirmation\": \"0\"}" },
+        { "val_tpl", "{{value_json.soundConfirmation}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+    { "select", "single_button_press_action", "_single_button_press_action", "Single button press action",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 16,
+      { { "val_tpl", "{{value_json.singleButtonPressAction}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"singleButtonPressAction\": \"{{ value }}\" }" } },
+      "options", hassOpenerButtonPressActionOptions },
+    { "select", "double_button_press_action", "_double_button_press_action", "Double button press action",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 17,
+      { { "val_tpl", "{{value_json.doubleButtonPressAction}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"doubleButtonPressAction\": \"{{ value }}\" }" } },
+      "options", hassOpenerButtonPressActionOptions },
+    { "select", "battery_type", "_battery_type", "Battery type",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 18,
+      { { "val_tpl", "{{value_json.batteryType}}" },
+        { "en", "true" },
+        { "cmd_tpl", "{ \"batteryType\": \"{{ value }}\" }" } },
+      "options", hassBatteryTypeOptions },
+    { "switch", "automatic_battery_type_detection", "_automatic_battery_type_detection", "Automatic battery type detection",
+      "~" mqtt_topic_config_advanced_json, "", "", "config", "~" mqtt_topic_config_action,
+      HassAcl::AdvancedConfigAcl, 19,
+      { { "en", "true" },
+        { "pl_on", "{ \"automaticBatteryTypeDetection\": \"1\"}" },
+        { "pl_off", "{ \"automaticBatteryTypeDetection\": \"0\"}" },
+        { "val_tpl", "{{value_json.automaticBatteryTypeDetection}}" },
+        { "stat_on", "1" },
+        { "stat_off", "0" } } },
+};
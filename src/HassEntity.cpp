@@ -0,0 +1,270 @@
+#include "HassEntity.h"
+#include "MqttTopics.h"
+#include <cstring>
+
+namespace
+{
+    class HassJsonWriter
+    {
+    public:
+        HassJsonWriter(char* buffer, const size_t bufferSize)
+        : _buffer(buffer),
+          _bufferSize(bufferSize)
+        {}
+
+        void raw(const char* str)
+        {
+            while(*str != 0)
+            {
+                put(*str);
+                ++str;
+            }
+        }
+
+        void string(const char* str, const char* suffix = nullptr)
+        {
+            put('"');
+            escaped(str);
+            if(suffix != nullptr) escaped(suffix);
+            put('"');
+        }
+
+        void key(const char* key)
+        {
+            if(_needsComma) put(',');
+            string(key);
+            put(':');
+            _needsComma = false;
+        }
+
+        void member(const char* key, const char* value, const char* valueSuffix = nullptr)
+        {
+            this->key(key);
+            string(value, valueSuffix);
+            _needsComma = true;
+        }
+
+        void optionalMember(const char* key, const char* value)
+        {
+            if(value != nullptr && value[0] != 0) member(key, value);
+        }
+
+        // prefix nullptr: topic is a complete value
+        void optionalTopic(const char* key, const char* topic, const char* prefix)
+        {
+            if(topic == nullptr || topic[0] == 0) return;
+            if(prefix != nullptr) member(key, prefix, topic);
+            else member(key, topic);
+        }
+
+        void nullMember(const char* key)
+        {
+            this->key(key);
+            raw("null");
+            _needsComma = true;
+        }
+
+        void attribute(const char* key, const char* value)
+        {
+            this->key(key);
+            if(strcmp(value, "true") == 0 || strcmp(value, "false") == 0) raw(value);
+            else string(value);
+            _needsComma = true;
+        }
+
+        void beginObject(const char* key = nullptr)
+        {
+            if(key != nullptr) this->key(key);
+            put('{');
+            _needsComma = false;
+        }
+
+        void endObject()
+        {
+            put('}');
+            _needsComma = true;
+        }
+
+        void beginArray(const char* key)
+        {
+            this->key(key);
+            put('[');
+            _needsComma = false;
+        }
+
+        void arrayValue(const char* value, const char* valueSuffix = nullptr)
+        {
+            if(_needsComma) put(',');
+            string(value, valueSuffix);
+            _needsComma = true;
+        }
+
+        void endArray()
+        {
+            put(']');
+            _needsComma = true;
+        }
+
+        size_t finish()
+        {
+            if(_pos >= _bufferSize) return 0;
+            _buffer[_pos] = 0x00;
+            return _pos;
+        }
+
+    private:
+        void escaped(const char* str)
+        {
+            while(*str != 0)
+            {
+                switch(*str)
+                {
+                    case '"':
+                        raw("\\\"");
+                        break;
+                    case '\\':
+                        raw("\\\\");
+                        break;
+                    case '\b':
+                        raw("\\b");
+                        break;
+                    case '\f':
+                        raw("\\f");
+                        break;
+                    case '\n':
+                        raw("\\n");
+                        break;
+                    case '\r':
+                        raw("\\r");
+                        break;
+                    case '\t':
+                        raw("\\t");
+                        break;
+                    default:
+                        put(*str);
+                        break;
+                }
+                ++str;
+            }
+        }
+
+        void put(const char c)
+        {
+            if(_pos < _bufferSize) _buffer[_pos] = c;
+            ++_pos;
+        }
+
+        char* _buffer;
+        const size_t _bufferSize;
+        size_t _pos = 0;
+        bool _needsComma = false;
+    };
+
+    // State payloads of the lock entity, what NukiNetworkLock publishes to mqtt_topic_lock_ha_state
+    const HassAttribute lockStates[] =
+    {
+        { "stat_jammed", "jammed" },
+        { "stat_locked", "locked" },
+        { "stat_locking", "locking" },
+        { "stat_unlocked", "unlocked" },
+        { "stat_unlocking", "unlocking" },
+        { "stat_open", "open" },
+        { "stat_opening", "opening" },
+    };
+}
+
+size_t serializeHassEntity(const HassEntity& entity,
+                           char* buffer,
+                           const size_t bufferSize,
+                           const char* uidString,
+                           const char* name,
+                           const char* baseTopic,
+                           const char* deviceType,
+                           const char* availabilityTopic,
+                           const char* hubPath)
+{
+    HassJsonWriter json(buffer, bufferSize);
+
+    // Same member order as the JsonDocument based createHassJson()
+    json.beginObject();
+    json.beginObject("dev");
+    json.beginArray("ids");
+    json.arrayValue("nuki_", uidString);
+    json.endArray();
+    json.member("mf", "Nuki");
+    json.member("mdl", deviceType);
+    json.member("name", name);
+    json.endObject();
+    json.member("~", baseTopic);
+    json.member("name", entity.displayName);
+    json.member("unique_id", uidString, entity.uidPostfix);
+    json.optionalMember("dev_cla", entity.deviceClass);
+    json.optionalTopic("stat_t", entity.stateTopic, entity.hubTopics ? hubPath : nullptr);
+    json.optionalMember("stat_cla", entity.stateClass);
+    json.optionalMember("ent_cat", entity.entityCat);
+    json.optionalTopic("cmd_t", entity.commandTopic, entity.hubTopics ? hubPath : nullptr);
+    json.beginObject("avty");
+    json.member("t", availabilityTopic);
+    json.endObject();
+
+    for(const HassAttribute& attribute : entity.attributes)
+    {
+        if(attribute.key == nullptr) break;
+        if(attribute.hubTopic) json.member(attribute.key, hubPath, attribute.value);
+        else json.attribute(attribute.key, attribute.value);
+    }
+
+    if(entity.listKey != nullptr)
+    {
+        json.beginArray(entity.listKey);
+        for(const char* const* value = entity.listValues; *value != nullptr; ++value)
+        {
+            json.arrayValue(*value);
+        }
+        json.endArray();
+    }
+
+    json.endObject();
+
+    return json.finish();
+}
+
+size_t serializeHassLock(const HassLock& lock, char* buffer, const size_t bufferSize)
+{
+    HassJsonWriter json(buffer, bufferSize);
+
+    json.beginObject();
+    json.beginObject("dev");
+    json.beginArray("ids");
+    json.arrayValue("nuki_", lock.uidString);
+    json.endArray();
+    json.member("mf", "Nuki");
+    json.member("mdl", lock.deviceType);
+    json.member("name", lock.name);
+    json.member("sw", lock.softwareVersion);
+    json.member("hw", lock.hardwareVersion);
+    json.member("cu", lock.configurationUrl);
+    json.endObject();
+    json.member("~", lock.baseTopic);
+    json.nullMember("name");
+    json.member("unique_id", lock.uidString, "_lock");
+    json.member("cmd_t", "~" mqtt_topic_lock_action);
+    json.beginObject("avty");
+    json.member("t", lock.availabilityTopic);
+    json.endObject();
+    json.member("pl_lock", lock.lockAction);
+    json.member("pl_unlk", lock.unlockAction);
+    if(lock.openAction != nullptr) json.member("pl_open", lock.openAction);
+    json.member("stat_t", "~" mqtt_topic_lock_ha_state);
+
+    for(const HassAttribute& state : lockStates)
+    {
+        json.member(state.key, state.value);
+    }
+
+    // A string, unlike the booleans of the entity attributes
+    json.member("opt", "false");
+    json.endObject();
+
+    return json.finish();
+}
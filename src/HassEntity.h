@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Table entries with more attributes fail to compile (too many initializers), publishHassTopic() logs an error
+#define HASS_MAX_ATTRIBUTES 8
+
+enum class HassAcl : uint8_t
+{
+    None,
+    Acl,
+    BasicConfigAcl,
+    AdvancedConfigAcl
+};
+
+struct HassAttribute
+{
+    const char* key;
+    const char* value; // "true" and "false" are written as JSON booleans
+    bool hubTopic = false; // value is a topic below the Nuki Hub path
+};
+
+// Home Assistant discovery entity. Topics are complete values, "~" is expanded by Home Assistant to the base topic.
+// Entities of Nuki Hub itself set hubTopics, their state and command topics are below the Nuki Hub path instead.
+struct HassEntity
+{
+    const char* component;
+    const char* objectId;
+    const char* uidPostfix;
+    const char* displayName;
+    const char* stateTopic;
+    const char* deviceClass;
+    const char* stateClass;
+    const char* entityCat;
+    const char* commandTopic;
+    HassAcl acl;
+    uint8_t aclIndex;
+    HassAttribute attributes[HASS_MAX_ATTRIBUTES];
+    const char* listKey = nullptr; // "options" or "event_types"
+    const char* const* listValues = nullptr; // nullptr terminated
+    bool hubTopics = false;
+};
+
+// The lock entity of a device, it carries the device details and takes its name from the device
+struct HassLock
+{
+    const char* uidString;
+    const char* name;
+    const char* baseTopic;
+    const char* deviceType;
+    const char* softwareVersion;
+    const char* hardwareVersion;
+    const char* configurationUrl;
+    const char* availabilityTopic;
+    const char* lockAction;
+    const char* unlockAction;
+    const char* openAction; // nullptr when opening isn't permitted
+};
+
+// Writes the discovery document straight into buffer (NUL terminated), returns 0 when it doesn't fit
+size_t serializeHassEntity(const HassEntity& entity,
+                           char* buffer,
+                           const size_t bufferSize,
+                           const char* uidString,
+                           const char* name,
+                           const char* baseTopic,
+                           const char* deviceType,
+                           const char* availabilityTopic,
+                           const char* hubPath);
+
+size_t serializeHassLock(const HassLock& lock, char* buffer, const size_t bufferSize);
@@ -0,0 +1,195 @@
+#include "JsonArena.h"
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <esp_heap_caps.h>
+#ifdef CONFIG_SOC_SPIRAM_SUPPORTED
+#include <esp_psram.h>
+#endif
+
+#define JSON_ARENA_ALIGN 8
+#define JSON_ARENA_HEADER JSON_ARENA_ALIGN
+
+uint32_t JsonArena::_highWater[(size_t)JsonArenaDoc::Count] = {0};
+uint32_t JsonArena::_heapFallbacks[(size_t)JsonArenaDoc::Count] = {0};
+
+JsonArena::JsonArena(const size_t size, const size_t psramSize)
+{
+    #ifdef CONFIG_SOC_SPIRAM_SUPPORTED
+    if(esp_psram_get_size() > 0)
+    {
+        _buffer = (uint8_t*)heap_caps_aligned_alloc(JSON_ARENA_ALIGN, psramSize, MALLOC_CAP_SPIRAM);
+        if(_buffer != nullptr)
+        {
+            _capacity = psramSize;
+            _psram = true;
+        }
+    }
+    #endif
+
+    if(_buffer == nullptr)
+    {
+        _buffer = (uint8_t*)heap_caps_aligned_alloc(JSON_ARENA_ALIGN, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        _capacity = _buffer != nullptr ? size : 0;
+    }
+
+    _lastBlock = _capacity;
+}
+
+JsonArena::~JsonArena()
+{
+    heap_caps_free(_buffer);
+}
+
+void* JsonArena::allocate(size_t size)
+{
+    size_t alignedSize = (size + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1);
+
+    if(_used + JSON_ARENA_HEADER + alignedSize > _capacity)
+    {
+        ++_heapFallbacks[(size_t)_doc];
+        return malloc(size);
+    }
+
+    uint8_t* block = _buffer + _used;
+    *(size_t*)block = alignedSize;
+    _lastBlock = _used;
+    _used += JSON_ARENA_HEADER + alignedSize;
+    _peak = std::max(_peak, _used);
+    ++_liveBlocks;
+
+    return block + JSON_ARENA_HEADER;
+}
+
+void JsonArena::deallocate(void* ptr)
+{
+    if(ptr == nullptr) return;
+
+    if(!owns(ptr))
+    {
+        free(ptr);
+        return;
+    }
+
+    --_liveBlocks;
+
+    if(_liveBlocks == 0)
+    {
+        _used = 0;
+        _lastBlock = _capacity;
+    }
+    else if((uint8_t*)ptr - JSON_ARENA_HEADER == _buffer + _lastBlock)
+    {
+        _used = _lastBlock;
+        _lastBlock = _capacity;
+    }
+}
+
+void* JsonArena::reallocate(void* ptr, size_t newSize)
+{
+    if(ptr == nullptr) return allocate(newSize);
+    if(!owns(ptr)) return realloc(ptr, newSize);
+
+    size_t oldSize = blockSize(ptr);
+    size_t alignedSize = (newSize + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1);
+
+    // ArduinoJson grows strings and shrinks pools in place, which mostly hits the most recent block
+    if((uint8_t*)ptr - JSON_ARENA_HEADER == _buffer + _lastBlock && _lastBlock + JSON_ARENA_HEADER + alignedSize <= _capacity)
+    {
+        *(size_t*)(_buffer + _lastBlock) = alignedSize;
+        _used = _lastBlock + JSON_ARENA_HEADER + alignedSize;
+        _peak = std::max(_peak, _used);
+        return ptr;
+    }
+
+    if(alignedSize <= oldSize) return ptr;
+
+    void* newPtr = allocate(newSize);
+    if(newPtr == nullptr) return nullptr;
+
+    memcpy(newPtr, ptr, oldSize);
+    deallocate(ptr);
+    return newPtr;
+}
+
+const size_t JsonArena::capacity() const
+{
+    return _capacity;
+}
+
+const bool JsonArena::psram() const
+{
+    return _psram;
+}
+
+const char* JsonArena::docName(const JsonArenaDoc& doc)
+{
+    switch(doc)
+    {
+        case JsonArenaDoc::KeyTurnerState:
+            return "Key turner state";
+        case JsonArenaDoc::BatteryReport:
+            return "Battery report";
+        case JsonArenaDoc::Config:
+            return "Config";
+        case JsonArenaDoc::AdvancedConfig:
+            return "Advanced config";
+        case JsonArenaDoc::Keypad:
+            return "Keypad";
+        case JsonArenaDoc::TimeControl:
+            return "Time control";
+        case JsonArenaDoc::Auth:
+            return "Authorizations";
+        case JsonArenaDoc::AuthorizationInfo:
+            return "Authorization log";
+        default:
+            return "Unknown";
+    }
+}
+
+const uint32_t JsonArena::highWater(const JsonArenaDoc& doc)
+{
+    return doc < JsonArenaDoc::Count ? _highWater[(size_t)doc] : 0;
+}
+
+const uint32_t JsonArena::heapFallbacks(const JsonArenaDoc& doc)
+{
+    return doc < JsonArenaDoc::Count ? _heapFallbacks[(size_t)doc] : 0;
+}
+
+bool JsonArena::owns(const void* ptr) const
+{
+    return _buffer != nullptr && ptr >= _buffer && ptr < _buffer + _capacity;
+}
+
+size_t JsonArena::blockSize(const void* ptr) const
+{
+    return *(const size_t*)((const uint8_t*)ptr - JSON_ARENA_HEADER);
+}
+
+void JsonArena::endCycle()
+{
+    _highWater[(size_t)_doc] = std::max<uint32_t>(_highWater[(size_t)_doc], _peak);
+
+    if(_depth == 0 && _liveBlocks == 0)
+    {
+        _used = 0;
+        _lastBlock = _capacity;
+    }
+}
+
+JsonArenaScope::JsonArenaScope(JsonArena& arena, const JsonArenaDoc& doc)
+: _arena(arena),
+  _previousDoc(arena._doc)
+{
+    if(_arena._depth == 0) _arena._peak = _arena._used;
+    ++_arena._depth;
+    _arena._doc = doc;
+}
+
+JsonArenaScope::~JsonArenaScope()
+{
+    --_arena._depth;
+    _arena.endCycle();
+    _arena._doc = _previousDoc;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <ArduinoJson.h>
+
+enum class JsonArenaDoc : uint8_t
+{
+    KeyTurnerState,
+    BatteryReport,
+    Config,
+    AdvancedConfig,
+    Keypad,
+    TimeControl,
+    Auth,
+    AuthorizationInfo,
+    Count
+};
+
+// Bump allocator for the JsonDocuments of one publisher. The buffer is allocated once (in PSRAM when available)
+// and rewinds when the last document of a publish cycle is destroyed, so building documents doesn't fragment the heap.
+// Requests that don't fit fall back to the heap. Not thread safe, each worker task uses its own arena.
+class JsonArena : public ArduinoJson::Allocator
+{
+public:
+    JsonArena(const size_t size, const size_t psramSize);
+    ~JsonArena();
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t newSize) override;
+
+    const size_t capacity() const;
+    const bool psram() const;
+
+    static const char* docName(const JsonArenaDoc& doc);
+    static const uint32_t highWater(const JsonArenaDoc& doc); // bytes, largest cycle of this document type on any arena
+    static const uint32_t heapFallbacks(const JsonArenaDoc& doc);
+
+private:
+    friend class JsonArenaScope;
+
+    bool owns(const void* ptr) const;
+    size_t blockSize(const void* ptr) const;
+    void endCycle();
+
+    uint8_t* _buffer = nullptr;
+    size_t _capacity = 0;
+    size_t _used = 0;
+    size_t _peak = 0;
+    size_t _lastBlock = 0; // offset of the most recent block, it can grow or shrink in place
+    uint32_t _liveBlocks = 0;
+    uint8_t _depth = 0;
+    bool _psram = false;
+    JsonArenaDoc _doc = JsonArenaDoc::KeyTurnerState;
+
+    static uint32_t _highWater[(size_t)JsonArenaDoc::Count];
+    static uint32_t _heapFallbacks[(size_t)JsonArenaDoc::Count];
+};
+
+// Marks one publish cycle, declare it before the JsonDocuments so the arena rewinds after they are destroyed
+class JsonArenaScope
+{
+public:
+    JsonArenaScope(JsonArena& arena, const JsonArenaDoc& doc);
+    ~JsonArenaScope();
+
+private:
+    JsonArena& _arena;
+    JsonArenaDoc _previousDoc;
+};
@@ -0,0 +1,34 @@
+#include "LatencyStats.h"
+#include <algorithm>
+
+void LatencyStats::add(const int64_t& latency)
+{
+    _samples[_next] = latency < 0 ? 0 : (latency > UINT32_MAX ? UINT32_MAX : (uint32_t)latency);
+    _next = (_next + 1) % LATENCY_STATS_SAMPLES;
+    ++_count;
+}
+
+const uint32_t LatencyStats::percentile(const uint8_t& p) const
+{
+    size_t n = std::min<uint32_t>(_count, LATENCY_STATS_SAMPLES);
+    if(n == 0) return 0;
+
+    uint32_t sorted[LATENCY_STATS_SAMPLES];
+    std::copy(_samples, _samples + n, sorted);
+    std::sort(sorted, sorted + n);
+
+    size_t index = (n * std::min<uint8_t>(p, 100) + 99) / 100;
+    return sorted[index > 0 ? index - 1 : 0];
+}
+
+const uint32_t LatencyStats::max() const
+{
+    size_t n = std::min<uint32_t>(_count, LATENCY_STATS_SAMPLES);
+    if(n == 0) return 0;
+    return *std::max_element(_samples, _samples + n);
+}
+
+const uint32_t LatencyStats::count() const
+{
+    return _count;
+}
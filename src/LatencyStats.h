@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#define LATENCY_STATS_SAMPLES 32
+
+// Keeps the most recent latency samples (ms) of one stage of the command path and reports percentiles over them
+class LatencyStats
+{
+public:
+    void add(const int64_t& latency);
+    const uint32_t percentile(const uint8_t& p) const; // 0 if no samples were recorded
+    const uint32_t max() const;
+    const uint32_t count() const; // total number of samples, not limited to the ones kept
+
+private:
+    uint32_t _samples[LATENCY_STATS_SAMPLES] = {0};
+    size_t _next = 0;
+    uint32_t _count = 0;
+};
@@ -0,0 +1,48 @@
+#include "MqttMessageAssembler.h"
+#include <cstring>
+
+MqttMessageAssembler::MqttMessageAssembler(const size_t maxPayloadSize)
+: _maxPayloadSize(maxPayloadSize)
+{
+    _buffer = new char[maxPayloadSize + 1];
+}
+
+MqttMessageAssembler::~MqttMessageAssembler()
+{
+    delete[] _buffer;
+}
+
+const char* MqttMessageAssembler::append(const uint8_t* payload, const size_t& len, const size_t& index, const size_t& total)
+{
+    if(index == 0)
+    {
+        _length = 0;
+        _overflow = total > _maxPayloadSize;
+        _dropped = _overflow;
+    }
+
+    // A lost fragment drops the rest of the message, the next one starts again at index 0
+    if(_dropped || index != _length || len > total - _length)
+    {
+        _dropped = true;
+        return nullptr;
+    }
+
+    memcpy(_buffer + _length, payload, len);
+    _length += len;
+
+    if(_length < total) return nullptr;
+
+    _buffer[_length] = 0x00;
+    return _buffer;
+}
+
+const size_t MqttMessageAssembler::length() const
+{
+    return _length;
+}
+
+const bool MqttMessageAssembler::overflow() const
+{
+    return _overflow;
+}
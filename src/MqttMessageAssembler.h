@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Joins the fragments espMqttClient delivers for one message into a preallocated, NUL terminated buffer.
+// Receivers parse payloads as C strings, so each fragment is copied once and nothing is allocated per message.
+class MqttMessageAssembler
+{
+public:
+    explicit MqttMessageAssembler(const size_t maxPayloadSize);
+    ~MqttMessageAssembler();
+
+    // Returns the complete payload once the last fragment was appended, nullptr while fragments are missing or if the
+    // message is dropped. Larger messages than maxPayloadSize and fragments out of order drop the message.
+    const char* append(const uint8_t* payload, const size_t& len, const size_t& index, const size_t& total);
+    const size_t length() const;
+    const bool overflow() const; // the current message is larger than maxPayloadSize
+
+private:
+    char* _buffer = nullptr;
+    const size_t _maxPayloadSize;
+    size_t _length = 0;
+    bool _overflow = false;
+    bool _dropped = false;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// FNV-1a over a topic suffix, constexpr so it can be used as a switch label when dispatching inbound messages
+constexpr uint32_t mqttTopicHash(const char* topic)
+{
+    uint32_t hash = 2166136261u;
+    while(*topic != 0)
+    {
+        hash = (hash ^ (uint8_t)*topic) * 16777619u;
+        ++topic;
+    }
+    return hash;
+}
+
+// FNV-1a over raw bytes, used to detect entries that changed since they were last published
+inline uint32_t mqttPayloadHash(const void* data, const size_t length, uint32_t hash = 2166136261u)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for(size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
@@ -106,6 +106,13 @@
 #define mqtt_topic_wifi_rssi "/maintenance/wifiRssi"
 #define mqtt_topic_log "/maintenance/log"
 #define mqtt_topic_freeheap "/maintenance/freeHeap"
+#define mqtt_topic_hass_discovery_sent "/maintenance/hassDiscoverySent"
+#define mqtt_topic_hass_discovery_skipped "/maintenance/hassDiscoverySkipped"
+#define mqtt_topic_publish_queue_depth "/maintenance/publishQueueDepth"
+#define mqtt_topic_publish_coalesced "/maintenance/publishCoalesced"
+#define mqtt_topic_publish_dropped "/maintenance/publishDropped"
+#define mqtt_topic_publish_throttled "/maintenance/publishThrottled"
+#define mqtt_topic_packet_pool_heap_allocations "/maintenance/mqttPacketHeapAllocations"
 #define mqtt_topic_restart_reason_fw "/maintenance/restartReasonNukiHub"
 #define mqtt_topic_restart_reason_esp "/maintenance/restartReasonNukiEsp"
 #define mqtt_topic_mqtt_connection_state "/maintenance/mqttConnectionState"
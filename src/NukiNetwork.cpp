@@ -13,6 +13,10 @@
 
 #ifndef NUKI_HUB_UPDATER
 #include <ArduinoJson.h>
+#include "NukiScheduler.h"
+#include "MqttTopicHash.h"
+#include "HassEntities.h"
+#include "Packets/PacketPool.h"
 #endif
 
 NukiNetwork* NukiNetwork::_inst = nullptr;
@@ -60,6 +64,9 @@ NukiNetwork::NukiNetwork(Preferences *preferences)
     {
         _mqttConnectionStateTopic[i] = connectionStateTopic.charAt(i);
     }
+
+    _mqttRxMessage = new MqttMessageAssembler(MQTT_RX_PAYLOAD_BUFFER_SIZE);
+    _publishQueueDrained = xSemaphoreCreateBinary();
     #endif
 
     setupDevice();
@@ -214,6 +221,10 @@ void NukiNetwork::initialize()
     }
 
     strcpy(_hostnameArr, _hostname.c_str());
+    _device->setConnectedCallback([&]()
+        {
+            onDeviceConnected();
+        });
     _device->initialize();
 
     Log->print(F("Host name: "));
@@ -323,6 +334,7 @@ void NukiNetwork::readSettings()
 bool NukiNetwork::update()
 {
     int64_t ts = (esp_timer_get_time() / 1000);
+    if(_networkTaskHandle == nullptr) _networkTaskHandle = xTaskGetCurrentTaskHandle();
     _device->update();
 
     if(!_mqttEnabled)
@@ -330,6 +342,13 @@ bool NukiNetwork::update()
         return true;
     }
 
+    if(_deviceConnectedEvent)
+    {
+        // Link is back, connect to the broker right away instead of waiting for the retry interval
+        _deviceConnectedEvent = false;
+        _nextReconnect = 0;
+    }
+
     if(!_device->isConnected() || (_mqttConnectCounter > 15 && _reconnectNetworkOnMqttDisconnect && !_firstConnect))
     {
         _mqttConnectCounter = 0;
@@ -377,7 +396,7 @@ bool NukiNetwork::update()
         bool success = reconnect();
         if(!success)
         {
-            delay(2000);
+            waitForNetworkEvent(2000);
             _mqttConnectCounter++;
             return false;
         }
@@ -389,7 +408,6 @@ bool NukiNetwork::update()
             restartEsp(RestartReason::ReconfigureWebServer);
         }
         else if(!_webEnabled) forceEnableWebServer = false;
-        delay(2000);
     }
 
     if(!_device->mqttConnected() || !_device->isConnected())
@@ -401,12 +419,15 @@ bool NukiNetwork::update()
             delay(200);
             restartEsp(RestartReason::NetworkTimeoutWatchdog);
         }
-        delay(2000);
+        waitForNetworkEvent(2000);
         return false;
     }
 
     _lastConnectedTs = ts;
 
+    publishPendingPublishes();
+    publishPendingHassDocuments();
+
     if(_device->signalStrength() != 127 && _rssiPublishInterval > 0 && ts - _lastRssiTs > _rssiPublishInterval)
     {
         _lastRssiTs = ts;
@@ -434,6 +455,15 @@ bool NukiNetwork::update()
         if(_publishDebugInfo)
         {
             publishUInt(_maintenancePathPrefix, mqtt_topic_freeheap, esp_get_free_heap_size(), true);
+            publishUInt(_maintenancePathPrefix, mqtt_topic_hass_discovery_sent, _hassDocumentsSent, true);
+            publishUInt(_maintenancePathPrefix, mqtt_topic_hass_discovery_skipped, _hassDocumentsSkipped, true);
+            publishUInt(_maintenancePathPrefix, mqtt_topic_publish_queue_depth, publishQueueDepth(), true);
+            publishUInt(_maintenancePathPrefix, mqtt_topic_publish_coalesced, _publishesCoalesced, true);
+            publishUInt(_maintenancePathPrefix, mqtt_topic_publish_dropped, _publishesDropped, true);
+            publishUInt(_maintenancePathPrefix, mqtt_topic_publish_throttled, _publishesThrottled, true);
+#if EMC_USE_PACKET_POOL
+            publishUInt(_maintenancePathPrefix, mqtt_topic_packet_pool_heap_allocations, espMqttClientInternals::PacketPool::heapAllocations(), true);
+#endif
         }
         _lastMaintenanceTs = ts;
     }
@@ -512,11 +542,22 @@ bool NukiNetwork::update()
 void NukiNetwork::onMqttConnect(const bool &sessionPresent)
 {
     _connectReplyReceived = true;
+    // The broker may have lost its retained messages, resend all discovery documents on the resync after reconnect
+    _hassDocumentsInvalidated = true;
+    _device->markReconnectPhase(ReconnectPhase::Tcp, _device->mqttTcpConnectedTs());
+    _device->markReconnectPhase(ReconnectPhase::Connack);
 }
 
 void NukiNetwork::onMqttDisconnect(const espMqttClientTypes::DisconnectReason &reason)
 {
     _connectReplyReceived = false;
+    _device->markDisconnected();
+
+    // Publishers waiting for the queue give up, it doesn't drain until the next connect
+    {
+        std::lock_guard<std::mutex> lock(_publishQueueMutex);
+        if(_publishQueueWaiters > 0) xSemaphoreGive(_publishQueueDrained);
+    }
 
     Log->print("MQTT disconnected. Reason: ");
     switch(reason)
@@ -551,6 +592,24 @@ void NukiNetwork::onMqttDisconnect(const espMqttClientTypes::DisconnectReason &r
     }
 }
 
+void NukiNetwork::onDeviceConnected()
+{
+    // Called from the network event task
+    _deviceConnectedEvent = true;
+    if(_networkTaskHandle != nullptr) xTaskNotifyGive(_networkTaskHandle);
+}
+
+void NukiNetwork::waitForNetworkEvent(const uint32_t timeout)
+{
+    if(_networkTaskHandle == nullptr)
+    {
+        delay(timeout);
+        return;
+    }
+
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout));
+}
+
 bool NukiNetwork::reconnect()
 {
     _mqttConnectionState = 0;
@@ -611,7 +670,7 @@ bool NukiNetwork::reconnect()
                 publishString(_maintenancePathPrefix, mqtt_topic_network_device, _device->deviceName().c_str(), true);
                 for(const auto& it : _initTopics)
                 {
-                    _device->mqttPublish(it.first.c_str(), MQTT_QOS_LEVEL, true, it.second.c_str());
+                    mqttPublish(it.first.c_str(), true, it.second.c_str());
                 }
             }
 
@@ -623,6 +682,7 @@ bool NukiNetwork::reconnect()
             {
                 callback();
             }
+            NukiScheduler::wakeAll();
         }
         else
         {
@@ -685,16 +745,25 @@ void NukiNetwork::registerMqttReceiver(MqttReceiver* receiver)
 
 void NukiNetwork::onMqttDataReceivedCallback(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t len, size_t index, size_t total)
 {
-    uint8_t value[800] = {0};
+    _inst->onMqttFragmentReceived(properties, topic, payload, len, index, total);
+}
 
-    size_t l = min(len, sizeof(value)-1);
+void NukiNetwork::onMqttFragmentReceived(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t& len, size_t& index, size_t& total)
+{
+    const char* message = _mqttRxMessage->append(payload, len, index, total);
 
-    for(int i=0; i<l; i++)
+    if(index == 0 && _mqttRxMessage->overflow())
     {
-        value[i] = payload[i];
+        Log->print(F("MQTT payload too large, dropping message on "));
+        Log->print(topic);
+        Log->print(F(", size: "));
+        Log->println(total);
     }
 
-    _inst->onMqttDataReceived(properties, topic, value, len, index, total);
+    if(message == nullptr) return;
+
+    size_t length = _mqttRxMessage->length();
+    onMqttDataReceived(properties, topic, (const uint8_t*)message, length, index, total);
 }
 
 void NukiNetwork::onMqttDataReceived(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t& len, size_t& index, size_t& total)
@@ -705,38 +774,41 @@ void NukiNetwork::onMqttDataReceived(const espMqttClientTypes::MessageProperties
 
     for(auto receiver : _mqttReceivers)
     {
-        receiver->onMqttDataReceived(topic, (byte*)payload, index);
+        receiver->onMqttDataReceived(topic, (byte*)payload, len);
     }
+
+    NukiScheduler::wakeAll();
 }
 
 
 void NukiNetwork::parseGpioTopics(const espMqttClientTypes::MessageProperties &properties, const char *topic, const uint8_t *payload, size_t& len, size_t& index, size_t& total)
 {
-    char gpioPath[250];
-    buildMqttPath(gpioPath, {_lockPath.c_str(), mqtt_topic_gpio_prefix, mqtt_topic_gpio_pin});
 //    /nuki_t/gpio/pin_17/state
-    size_t gpioLen = strlen(gpioPath);
-    if(strncmp(gpioPath, topic, gpioLen) == 0)
+    size_t gpioLen = 0;
+    for(const char* part : {_lockPath.c_str(), mqtt_topic_gpio_prefix, mqtt_topic_gpio_pin})
     {
-        char pinStr[3] = {0};
-        pinStr[0] = topic[gpioLen];
-        if(topic[gpioLen+1] != '/')
-        {
-            pinStr[1] = topic[gpioLen+1];
-        }
+        size_t partLen = strlen(part);
+        if(strncmp(topic + gpioLen, part, partLen) != 0) return;
+        gpioLen += partLen;
+    }
 
-        int pin = std::atoi(pinStr);
+    char pinStr[3] = {0};
+    pinStr[0] = topic[gpioLen];
+    if(topic[gpioLen+1] != '/')
+    {
+        pinStr[1] = topic[gpioLen+1];
+    }
 
-        if(_gpio->getPinRole(pin) == PinRole::GeneralOutput)
-        {
-            const uint8_t pinState = strcmp((const char*)payload, "1") == 0 ? HIGH : LOW;
-            Log->print(F("GPIO "));
-            Log->print(pin);
-            Log->print(F(" (Output) --> "));
-            Log->println(pinState);
-            digitalWrite(pin, pinState);
-        }
+    int pin = std::atoi(pinStr);
 
+    if(_gpio->getPinRole(pin) == PinRole::GeneralOutput)
+    {
+        const uint8_t pinState = strcmp((const char*)payload, "1") == 0 ? HIGH : LOW;
+        Log->print(F("GPIO "));
+        Log->print(pin);
+        Log->print(F(" (Output) --> "));
+        Log->println(pinState);
+        digitalWrite(pin, pinState);
     }
 }
 
@@ -768,45 +840,48 @@ bool NukiNetwork::mqttRecentlyConnected()
 
 bool NukiNetwork::pathEquals(const char* prefix, const char* path, const char* referencePath)
 {
-    char prefixedPath[500];
-    buildMqttPath(prefixedPath, { prefix, path });
-    return strcmp(prefixedPath, referencePath) == 0;
+    size_t prefixLen = strlen(prefix);
+    return strncmp(referencePath, prefix, prefixLen) == 0 && strcmp(referencePath + prefixLen, path) == 0;
+}
+
+const char* NukiNetwork::prefixedPath(char* outPath, const char* prefix, const char* topic)
+{
+    if(prefix == nullptr) return topic;
+
+    buildMqttPath(outPath, { prefix, topic });
+    return outPath;
 }
 
 void NukiNetwork::publishFloat(const char* prefix, const char* topic, const float value, bool retain, const uint8_t precision)
 {
     char str[30];
     dtostrf(value, 0, precision, str);
-    char path[200] = {0};
-    buildMqttPath(path, { prefix, topic });
-    _device->mqttPublish(path, MQTT_QOS_LEVEL, retain, str);
+    char path[200];
+    mqttPublish(prefixedPath(path, prefix, topic), retain, str);
 }
 
 void NukiNetwork::publishInt(const char* prefix, const char *topic, const int value, bool retain)
 {
     char str[30];
     itoa(value, str, 10);
-    char path[200] = {0};
-    buildMqttPath(path, { prefix, topic });
-    _device->mqttPublish(path, MQTT_QOS_LEVEL, retain, str);
+    char path[200];
+    mqttPublish(prefixedPath(path, prefix, topic), retain, str);
 }
 
 void NukiNetwork::publishUInt(const char* prefix, const char *topic, const unsigned int value, bool retain)
 {
     char str[30];
     utoa(value, str, 10);
-    char path[200] = {0};
-    buildMqttPath(path, { prefix, topic });
-    _device->mqttPublish(path, MQTT_QOS_LEVEL, retain, str);
+    char path[200];
+    mqttPublish(prefixedPath(path, prefix, topic), retain, str);
 }
 
 void NukiNetwork::publishULong(const char* prefix, const char *topic, const unsigned long value, bool retain)
 {
     char str[30];
     utoa(value, str, 10);
-    char path[200] = {0};
-    buildMqttPath(path, { prefix, topic });
-    _device->mqttPublish(path, MQTT_QOS_LEVEL, retain, str);
+    char path[200];
+    mqttPublish(prefixedPath(path, prefix, topic), retain, str);
 }
 
 void NukiNetwork::publishLongLong(const char* prefix, const char *topic, int64_t value, bool retain)
@@ -825,1597 +900,216 @@ void NukiNetwork::publishLongLong(const char* prefix, const char *topic, int64_t
         sprintf(temp, "%c%s", c, result);
         strcpy(result, temp);
     }
-    char path[200] = {0};
-    buildMqttPath(path, { prefix, topic });
-    _device->mqttPublish(path, MQTT_QOS_LEVEL, retain, result);
+    char path[200];
+    mqttPublish(prefixedPath(path, prefix, topic), retain, result);
 }
 
 void NukiNetwork::publishBool(const char* prefix, const char *topic, const bool value, bool retain)
 {
     char str[2] = {0};
     str[0] = value ? '1' : '0';
-    char path[200] = {0};
-    buildMqttPath(path, { prefix, topic });
-    _device->mqttPublish(path, MQTT_QOS_LEVEL, retain, str);
+    char path[200];
+    mqttPublish(prefixedPath(path, prefix, topic), retain, str);
 }
 
 bool NukiNetwork::publishString(const char* prefix, const char *topic, const char *value, bool retain)
 {
-    char path[200] = {0};
-    buildMqttPath(path, { prefix, topic });
-    return _device->mqttPublish(path, MQTT_QOS_LEVEL, retain, value) > 0;
+    char path[200];
+    return mqttPublish(prefixedPath(path, prefix, topic), retain, value) > 0;
 }
 
-void NukiNetwork::publishHASSConfig(char* deviceType, const char* baseTopic, char* name, char* uidString, const char *softwareVersion, const char *hardwareVersion, const char* availabilityTopic, const bool& hasKeypad, char* lockAction, char* unlockAction, char* openAction)
+uint16_t NukiNetwork::mqttPublish(const char* path, bool retain, const char* payload)
 {
-    JsonDocument json;
-    json.clear();
-    JsonObject dev = json["dev"].to<JsonObject>();
-    JsonArray ids = dev["ids"].to<JsonArray>();
-    ids.add(String("nuki_") + uidString);
-    json["dev"]["mf"] = "Nuki";
-    json["dev"]["mdl"] = deviceType;
-    json["dev"]["name"] = name;
-    json["dev"]["sw"] = softwareVersion;
-    json["dev"]["hw"] = hardwareVersion;
+    // All messages go through one queue in publish order, so an event can't overtake an older retained value of
+    // the same topic. A retained value that is superseded while it waits for the outbox is replaced in place.
+    std::unique_lock<std::mutex> lock(_publishQueueMutex);
+    bool connected = _device->mqttConnected();
 
-    String cuUrl = _preferences->getString(preference_mqtt_hass_cu_url, "");
+    if(!connected && !retain) return 0;
 
-    if (cuUrl != "")
+    if(_pendingPublishes.empty() && connected && _device->mqttQueueSize() < MQTT_PUBLISH_QUEUE_THRESHOLD)
     {
-        json["dev"]["cu"] = cuUrl;
+        uint16_t packetId = _device->mqttPublish(path, MQTT_QOS_LEVEL, retain, payload);
+        if(packetId > 0 || !retain) return packetId;
     }
-    else
-    {
-        json["dev"]["cu"] = "http://" + _device->localIP();
-    }
-
-    json["~"] = baseTopic;
-    json["name"] = nullptr;
-    json["unique_id"] = String(uidString) + "_lock";
-    json["cmd_t"] = String("~") + String(mqtt_topic_lock_action);
-    json["avty"]["t"] = availabilityTopic;
-    json["pl_lock"] = lockAction;
-    json["pl_unlk"] = unlockAction;
 
-    uint32_t aclPrefs[17];
-    _preferences->getBytes(preference_acl, &aclPrefs, sizeof(aclPrefs));
-    if((int)aclPrefs[2]) json["pl_open"] = openAction;
-
-    json["stat_t"] = String("~") + mqtt_topic_lock_ha_state;
-    json["stat_jammed"] = "jammed";
-    json["stat_locked"] = "locked";
-    json["stat_locking"] = "locking";
-    json["stat_unlocked"] = "unlocked";
-    json["stat_unlocking"] = "unlocking";
-    json["stat_open"] = "open";
-    json["stat_opening"] = "opening";
-    json["opt"] = "false";
-
-    serializeJson(json, _buffer, _bufferSize);
-
-    String path = _preferences->getString(preference_mqtt_hass_discovery, "homeassistant");
-    path.concat("/lock/");
-    path.concat(uidString);
-    path.concat("/smartlock/config");
-
-    _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-
-    // Battery critical
-    publishHassTopic("binary_sensor",
-                     "battery_low",
-                     uidString,
-                     "_battery_low",
-                     "Battery low",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_battery_basic_json,
-                     deviceType,
-                     "battery",
-                     "",
-                     "diagnostic",
-                     "",
-                     {{(char*)"pl_on", (char*)"1"},
-                      {(char*)"pl_off", (char*)"0"},
-                      {(char*)"val_tpl", (char*)"{{value_json.critical}}" }});
-
-    // Battery voltage
-    publishHassTopic("sensor",
-                     "battery_voltage",
-                     uidString,
-                     "_battery_voltage",
-                     "Battery voltage",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_battery_advanced_json,
-                     deviceType,
-                     "voltage",
-                     "measurement",
-                     "diagnostic",
-                     "",
-                     { {(char*)"unit_of_meas", (char*)"V"},
-                       {(char*)"val_tpl", (char*)"{{value_json.batteryVoltage}}" }});
-
-    // Trigger
-    publishHassTopic("sensor",
-                     "trigger",
-                     uidString,
-                     "_trigger",
-                     "Trigger",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_lock_trigger,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"en", (char*)"true" } });
-
-    // MQTT Connected
-    publishHassTopic("binary_sensor",
-                     "mqtt_connected",
-                     uidString,
-                     "_mqtt_connected",
-                     "MQTT connected",
-                     name,
-                     baseTopic,
-                     _lockPath + mqtt_topic_mqtt_connection_state,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     {{(char*)"pl_on", (char*)"online"},
-                      {(char*)"pl_off", (char*)"offline"},
-                      {(char*)"ic", (char*)"mdi:lan-connect"}});
-
-    // Reset
-    publishHassTopic("switch",
-                     "reset",
-                     uidString,
-                     "_reset",
-                     "Restart Nuki Hub",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_reset,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     String("~") + mqtt_topic_reset,
-                     { { (char*)"ic", (char*)"mdi:restart" },
-                       { (char*)"pl_on", (char*)"1" },
-                       { (char*)"pl_off", (char*)"0" },
-                       { (char*)"stat_on", (char*)"1" },
-                       { (char*)"stat_off", (char*)"0" }});
-
-     // Network device
-    publishHassTopic("sensor",
-                     "network_device",
-                     uidString,
-                     "_network_device",
-                     "Network device",
-                     name,
-                     baseTopic,
-                     _lockPath + mqtt_topic_network_device,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"en", (char*)"true" }});
-
-    // Nuki Hub Webserver enabled
-    publishHassTopic("switch",
-                     "webserver",
-                     uidString,
-                     "_webserver",
-                     "Nuki Hub webserver enabled",
-                     name,
-                     baseTopic,
-                     _lockPath + mqtt_topic_webserver_state,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     _lockPath + mqtt_topic_webserver_action,
-                     { { (char*)"pl_on", (char*)"1" },
-                       { (char*)"pl_off", (char*)"0" },
-                       { (char*)"stat_on", (char*)"1" },
-                       { (char*)"stat_off", (char*)"0" }});
-
-     // Uptime
-    publishHassTopic("sensor",
-                     "uptime",
-                     uidString,
-                     "_uptime",
-                     "Uptime",
-                     name,
-                     baseTopic,
-                     _lockPath + mqtt_topic_uptime,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"en", (char*)"true" }});
-
-    if(_preferences->getBool(preference_mqtt_log_enabled, false))
-    {
-         // MQTT Log
-        publishHassTopic("sensor",
-                         "mqtt_log",
-                         uidString,
-                         "_mqtt_log",
-                         "MQTT Log",
-                         name,
-                         baseTopic,
-                         _lockPath + mqtt_topic_log,
-                         deviceType,
-                         "",
-                         "",
-                         "diagnostic",
-                         "",
-                         { { (char*)"en", (char*)"true" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"sensor", (char*)"mqtt_log", uidString);
-    }
+    uint32_t pathHash = mqttTopicHash(path);
 
-    if(_offEnabled)
-    {
-        // Hybrid connected
-        publishHassTopic("binary_sensor",
-                         "hybrid_connected",
-                         uidString,
-                         "_hybrid_connected",
-                         "Hybrid connected",
-                         name,
-                         baseTopic,
-                         _lockPath + mqtt_hybrid_state,
-                         deviceType,
-                         "",
-                         "",
-                         "diagnostic",
-                         "",
-                         { {(char*)"pl_on", (char*)"1"},
-                           {(char*)"pl_off", (char*)"0"},
-                           { (char*)"en", (char*)"true" }});
-    }
-    else
+    if(retain)
     {
-        removeHassTopic((char*)"binary_sensor", (char*)"hybrid_connected", uidString);
-    }
-
-    // Firmware version
-    publishHassTopic("sensor",
-                     "firmware_version",
-                     uidString,
-                     "_firmware_version",
-                     "Firmware version",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_info_firmware_version,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"en", (char*)"true" },
-                       {(char*)"ic", (char*)"mdi:counter"}});
-
-    // Hardware version
-    publishHassTopic("sensor",
-                     "hardware_version",
-                     uidString,
-                     "_hardware_version",
-                     "Hardware version",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_info_hardware_version,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"en", (char*)"true" },
-                       {(char*)"ic", (char*)"mdi:counter"}});
-
-    // Nuki Hub version
-    publishHassTopic("sensor",
-                     "nuki_hub_version",
-                     uidString,
-                     "_nuki_hub_version",
-                     "Nuki Hub version",
-                     name,
-                     baseTopic,
-                     _lockPath + mqtt_topic_info_nuki_hub_version,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"en", (char*)"true" },
-                       {(char*)"ic", (char*)"mdi:counter"}});
-
-    // Nuki Hub build
-    publishHassTopic("sensor",
-                     "nuki_hub_build",
-                     uidString,
-                     "_nuki_hub_build",
-                     "Nuki Hub build",
-                     name,
-                     baseTopic,
-                     _lockPath + mqtt_topic_info_nuki_hub_build,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"en", (char*)"true" },
-                       {(char*)"ic", (char*)"mdi:counter"}});
-
-    // Nuki Hub restart reason
-    publishHassTopic("sensor",
-                     "nuki_hub_restart_reason",
-                     uidString,
-                     "_nuki_hub_restart_reason",
-                     "Nuki Hub restart reason",
-                     name,
-                     baseTopic,
-                     _lockPath + mqtt_topic_restart_reason_fw,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"en", (char*)"true" }});
-
-    // Nuki Hub restart reason ESP
-    publishHassTopic("sensor",
-                     "nuki_hub_restart_reason_esp",
-                     uidString,
-                     "_nuki_hub_restart_reason_esp",
-                     "Nuki Hub restart reason ESP",
-                     name,
-                     baseTopic,
-                     _lockPath + mqtt_topic_restart_reason_esp,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"en", (char*)"true" }});
-
-    if(_checkUpdates)
-    {
-        // NUKI Hub latest
-        publishHassTopic("sensor",
-                         "nuki_hub_latest",
-                         uidString,
-                         "_nuki_hub_latest",
-                         "NUKI Hub latest",
-                         name,
-                         baseTopic,
-                         _lockPath + mqtt_topic_info_nuki_hub_latest,
-                         deviceType,
-                         "",
-                         "",
-                         "diagnostic",
-                         "",
-                         { { (char*)"en", (char*)"true" },
-                           {(char*)"ic", (char*)"mdi:counter"}});
-
-        // NUKI Hub update
-        char latest_version_topic[250];
-        _lockPath.toCharArray(latest_version_topic,_lockPath.length() + 1);
-        strcat(latest_version_topic, mqtt_topic_info_nuki_hub_latest);
-
-        if(!_updateFromMQTT)
-        {
-            publishHassTopic("update",
-                             "nuki_hub_update",
-                             uidString,
-                             "_nuki_hub_update",
-                             "NUKI Hub firmware update",
-                             name,
-                             baseTopic,
-                             _lockPath + mqtt_topic_info_nuki_hub_version,
-                             deviceType,
-                             "firmware",
-                             "",
-                             "diagnostic",
-                             "",
-                             { { (char*)"en", (char*)"true" },
-                               { (char*)"ent_pic", (char*)"https://raw.githubusercontent.com/technyon/nuki_hub/master/icon/favicon-32x32.png" },
-                               { (char*)"rel_u", (char*)GITHUB_LATEST_RELEASE_URL },
-                               { (char*)"l_ver_t", (char*)latest_version_topic }});
-        }
-        else
+        for(auto it = _pendingPublishes.rbegin(); it != _pendingPublishes.rend(); ++it)
         {
-            publishHassTopic("update",
-                             "nuki_hub_update",
-                             uidString,
-                             "_nuki_hub_update",
-                             "NUKI Hub firmware update",
-                             name,
-                             baseTopic,
-                             _lockPath + mqtt_topic_info_nuki_hub_version,
-                             deviceType,
-                             "firmware",
-                             "",
-                             "diagnostic",
-                             _lockPath + mqtt_topic_update,
-                             { { (char*)"en", (char*)"true" },
-                               { (char*)"pl_inst", (char*)"1" },
-                               { (char*)"ent_pic", (char*)"https://raw.githubusercontent.com/technyon/nuki_hub/master/icon/favicon-32x32.png" },
-                               { (char*)"rel_u", (char*)GITHUB_LATEST_RELEASE_URL },
-                               { (char*)"l_ver_t", (char*)latest_version_topic }});
-        }
-    }
-    else
-    {
-        removeHassTopic((char*)"sensor", (char*)"nuki_hub_latest", uidString);
-        removeHassTopic((char*)"update", (char*)"nuki_hub_update", uidString);
-    }
-
-    // Nuki Hub IP Address
-    publishHassTopic("sensor",
-                     "nuki_hub_ip",
-                     uidString,
-                     "_nuki_hub_ip",
-                     "Nuki Hub IP",
-                     name,
-                     baseTopic,
-                     _lockPath + mqtt_topic_info_nuki_hub_ip,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"en", (char*)"true" },
-                       {(char*)"ic", (char*)"mdi:ip"}});
-
-    // Query Lock State
-    publishHassTopic("button",
-                     "query_lockstate",
-                     uidString,
-                     "_query_lockstate",
-                     "Query lock state",
-                     name,
-                     baseTopic,
-                     "",
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     String("~") + mqtt_topic_query_lockstate,
-                     { { (char*)"en", (char*)"false" },
-                       { (char*)"pl_prs", (char*)"1" }});
-
-    // Query Config
-    publishHassTopic("button",
-                     "query_config",
-                     uidString,
-                     "_query_config",
-                     "Query config",
-                     name,
-                     baseTopic,
-                     "",
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     String("~") + mqtt_topic_query_config,
-                     { { (char*)"en", (char*)"false" },
-                       { (char*)"pl_prs", (char*)"1" }});
-
-    // Query Lock State Command result
-    publishHassTopic("button",
-                     "query_commandresult",
-                     uidString,
-                     "_query_commandresult",
-                     "Query lock state command result",
-                     name,
-                     baseTopic,
-                     "",
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     String("~") + mqtt_topic_query_lockstate_command_result,
-                     { { (char*)"en", (char*)"false" },
-                       { (char*)"pl_prs", (char*)"1" }});
-
-    publishHassTopic("sensor",
-                     "bluetooth_signal_strength",
-                     uidString,
-                     "_bluetooth_signal_strength",
-                     "Bluetooth signal strength",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_lock_rssi,
-                     deviceType,
-                     "signal_strength",
-                     "measurement",
-                     "diagnostic",
-                     "",
-                     { {(char*)"unit_of_meas", (char*)"dBm"} });
-}
-
-void NukiNetwork::publishHASSConfigAdditionalLockEntities(char *deviceType, const char *baseTopic, char *name, char *uidString)
-{
-    uint32_t aclPrefs[17];
-    _preferences->getBytes(preference_acl, &aclPrefs, sizeof(aclPrefs));
-
-    uint32_t basicLockConfigAclPrefs[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    uint32_t advancedLockConfigAclPrefs[22] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-
-    if(_preferences->getBool(preference_conf_info_enabled, true))
-    {
-        _preferences->getBytes(preference_conf_lock_basic_acl, &basicLockConfigAclPrefs, sizeof(basicLockConfigAclPrefs));
-        _preferences->getBytes(preference_conf_lock_advanced_acl, &advancedLockConfigAclPrefs, sizeof(advancedLockConfigAclPrefs));
-    }
+            if(it->pathHash != pathHash || it->path != path) continue;
+            if(!it->retain) break; // the newer value has to stay behind the queued event
 
-    if((int)aclPrefs[2])
-    {
-        // Unlatch
-        publishHassTopic("button",
-                         "unlatch",
-                         uidString,
-                         "_unlatch",
-                         "Open",
-                         name,
-                         baseTopic,
-                         "",
-                         deviceType,
-                         "",
-                         "",
-                         "",
-                         String("~") + mqtt_topic_lock_action,
-                         { { (char*)"en", (char*)"false" },
-                           { (char*)"pl_prs", (char*)"unlatch" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"button", (char*)"unlatch", uidString);
-    }
-
-    if((int)aclPrefs[3])
-    {
-        // Lock 'n' Go
-        publishHassTopic("button",
-                         "lockngo",
-                         uidString,
-                         "_lockngo",
-                         "Lock 'n' Go",
-                         name,
-                         baseTopic,
-                         "",
-                         deviceType,
-                         "",
-                         "",
-                         "",
-                         String("~") + mqtt_topic_lock_action,
-                         { { (char*)"en", (char*)"false" },
-                           { (char*)"pl_prs", (char*)"lockNgo" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"button", (char*)"lockngo", uidString);
-    }
-
-    if((int)aclPrefs[4])
-    {
-        // Lock 'n' Go with unlatch
-        publishHassTopic("button",
-                         "lockngounlatch",
-                         uidString,
-                         "_lockngounlatch",
-                         "Lock 'n' Go with unlatch",
-                         name,
-                         baseTopic,
-                         "",
-                         deviceType,
-                         "",
-                         "",
-                         "",
-                         String("~") + mqtt_topic_lock_action,
-                         { { (char*)"en", (char*)"false" },
-                           { (char*)"pl_prs", (char*)"lockNgoUnlatch" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"button", (char*)"lockngounlatch", uidString);
+            it->payload = payload;
+            ++_publishesCoalesced;
+            return 1;
+        }
     }
 
-    // Query Battery
-    publishHassTopic("button",
-                     "query_battery",
-                     uidString,
-                     "_query_battery",
-                     "Query battery",
-                     name,
-                     baseTopic,
-                     "",
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     String("~") + mqtt_topic_query_battery,
-                     { { (char*)"en", (char*)"false" },
-                       { (char*)"pl_prs", (char*)"1" }});
-
-    if((int)basicLockConfigAclPrefs[6] == 1)
-    {
-        // LED enabled
-        publishHassTopic("switch",
-                         "led_enabled",
-                         uidString,
-                         "_led_enabled",
-                         "LED enabled",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"ic", (char*)"mdi:led-variant-on" },
-                           { (char*)"pl_on", (char*)"{ \"ledEnabled\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"ledEnabled\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.ledEnabled}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
+    // The limit bounds memory while nothing drains. While connected, nothing is dropped, publishers are slowed
+    // down to the pace of the broker instead.
+    if(!connected && _pendingPublishes.size() >= MQTT_MAX_PENDING_PUBLISHES)
     {
-        removeHassTopic((char*)"switch", (char*)"led_enabled", uidString);
+        ++_publishesDropped;
+        return 0;
     }
 
-    if((int)basicLockConfigAclPrefs[5] == 1)
-    {
-        // Button enabled
-        publishHassTopic("switch",
-                         "button_enabled",
-                         uidString,
-                         "_button_enabled",
-                         "Button enabled",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"ic", (char*)"mdi:radiobox-marked" },
-                           { (char*)"pl_on", (char*)"{ \"buttonEnabled\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"buttonEnabled\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.buttonEnabled}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"button_enabled", uidString);
-    }
+    _pendingPublishes.push_back({pathHash, path, payload, retain});
 
-    if((int)advancedLockConfigAclPrefs[19] == 1)
-    {
-        // Auto Lock
-        publishHassTopic("switch",
-                         "auto_lock",
-                         uidString,
-                         "_auto_lock",
-                         "Auto lock",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"autoLockEnabled\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"autoLockEnabled\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.autoLockEnabled}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
+    if(connected && _pendingPublishes.size() > MQTT_MAX_PENDING_PUBLISHES && xTaskGetCurrentTaskHandle() != _networkTaskHandle)
     {
-        removeHassTopic((char*)"switch", (char*)"auto_lock", uidString);
+        lock.unlock();
+        waitForPublishQueue();
     }
 
-    if((int)advancedLockConfigAclPrefs[12] == 1)
-    {
-        // Auto Unlock
-        publishHassTopic("switch",
-                         "auto_unlock",
-                         uidString,
-                         "_auto_unlock",
-                         "Auto unlock",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"autoUnLockDisabled\": \"0\"}" },
-                           { (char*)"pl_off", (char*)"{ \"autoUnLockDisabled\": \"1\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.autoUnLockDisabled}}" },
-                           { (char*)"stat_on", (char*)"0" },
-                           { (char*)"stat_off", (char*)"1" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"auto_unlock", uidString);
-    }
-
-    if((int)basicLockConfigAclPrefs[13] == 1)
-    {
-        // Double lock
-        publishHassTopic("switch",
-                         "double_lock",
-                         uidString,
-                         "_double_lock",
-                         "Double lock",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"singleLock\": \"0\"}" },
-                           { (char*)"pl_off", (char*)"{ \"singleLock\": \"1\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.singleLock}}" },
-                           { (char*)"stat_on", (char*)"0" },
-                           { (char*)"stat_off", (char*)"1" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"double_lock", uidString);
-    }
-
-    publishHassTopic("sensor",
-                     "battery_level",
-                     uidString,
-                     "_battery_level",
-                     "Battery level",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_battery_basic_json,
-                     deviceType,
-                     "battery",
-                     "measurement",
-                     "diagnostic",
-                     "",
-                     { {(char*)"unit_of_meas", (char*)"%"},
-                       {(char*)"val_tpl", (char*)"{{value_json.level}}" }});
-
-    if((int)basicLockConfigAclPrefs[7] == 1)
-    {
-        publishHassTopic("number",
-                         "led_brightness",
-                         uidString,
-                         "_led_brightness",
-                         "LED brightness",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"ic", (char*)"mdi:brightness-6" },
-                           { (char*)"cmd_tpl", (char*)"{ \"ledBrightness\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.ledBrightness}}" },
-                           { (char*)"min", (char*)"0" },
-                           { (char*)"max", (char*)"5" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"number", (char*)"led_brightness", uidString);
-    }
+    return 1;
+}
 
-    if((int)basicLockConfigAclPrefs[3] == 1)
-    {
-        // Auto Unlatch
-        publishHassTopic("switch",
-                         "auto_unlatch",
-                         uidString,
-                         "_auto_unlatch",
-                         "Auto unlatch",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"autoUnlatch\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"autoUnlatch\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.autoUnlatch}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"auto_unlatch", uidString);
-    }
+void NukiNetwork::waitForPublishQueue()
+{
+    // Blocks the publishing task until the network task drained the queue to MQTT_MAX_PENDING_PUBLISHES, the
+    // connection dropped or the timeout expired
+    int64_t timeout = (esp_timer_get_time() / 1000) + MQTT_PUBLISH_BACKPRESSURE_TIMEOUT;
+    ++_publishesThrottled;
 
-    if((int)basicLockConfigAclPrefs[4] == 1)
-    {
-        // Pairing enabled
-        publishHassTopic("switch",
-                         "pairing_enabled",
-                         uidString,
-                         "_pairing_enabled",
-                         "Pairing enabled",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"pairingEnabled\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"pairingEnabled\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.pairingEnabled}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"pairing_enabled", uidString);
-    }
+    std::unique_lock<std::mutex> lock(_publishQueueMutex);
+    ++_publishQueueWaiters;
 
-    if((int)basicLockConfigAclPrefs[8] == 1)
-    {
-        publishHassTopic("number",
-                         "timezone_offset",
-                         uidString,
-                         "_timezone_offset",
-                         "Timezone offset",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"ic", (char*)"mdi:timer-cog-outline" },
-                           { (char*)"cmd_tpl", (char*)"{ \"timeZoneOffset\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.timeZoneOffset}}" },
-                           { (char*)"min", (char*)"0" },
-                           { (char*)"max", (char*)"60" }});
-    }
-    else
+    while(_pendingPublishes.size() > MQTT_MAX_PENDING_PUBLISHES && _device->mqttConnected())
     {
-        removeHassTopic((char*)"number", (char*)"timezone_offset", uidString);
-    }
+        int64_t remaining = timeout - (esp_timer_get_time() / 1000);
+        if(remaining <= 0) break;
 
-    if((int)basicLockConfigAclPrefs[9] == 1)
-    {
-        // DST Mode
-        publishHassTopic("switch",
-                         "dst_mode",
-                         uidString,
-                         "_dst_mode",
-                         "DST mode European",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"dstMode\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"dstMode\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.dstMode}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"dst_mode", uidString);
+        lock.unlock();
+        if(_networkTaskHandle != nullptr) xTaskNotifyGive(_networkTaskHandle);
+        xSemaphoreTake(_publishQueueDrained, pdMS_TO_TICKS(remaining));
+        lock.lock();
     }
 
-    if((int)basicLockConfigAclPrefs[10] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_fob_action_1", "Fob action 1", name, baseTopic, String("~") + mqtt_topic_config_basic_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.fobAction1}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"fobAction1\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Action";
-        json["options"][1] = "Unlock";
-        json["options"][2] = "Lock";
-        json["options"][3] = "Lock n Go";
-        json["options"][4] = "Intelligent";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "fob_action_1", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"fob_action_1", uidString);
-    }
+    // The semaphore wakes one waiter, pass it on to the next one
+    if(--_publishQueueWaiters > 0 && (_pendingPublishes.size() <= MQTT_MAX_PENDING_PUBLISHES || !_device->mqttConnected())) xSemaphoreGive(_publishQueueDrained);
+}
 
-    if((int)basicLockConfigAclPrefs[11] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_fob_action_2", "Fob action 2", name, baseTopic, String("~") + mqtt_topic_config_basic_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.fobAction2}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"fobAction2\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Action";
-        json["options"][1] = "Unlock";
-        json["options"][2] = "Lock";
-        json["options"][3] = "Lock n Go";
-        json["options"][4] = "Intelligent";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "fob_action_2", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"fob_action_2", uidString);
-    }
+void NukiNetwork::publishPendingPublishes()
+{
+    std::lock_guard<std::mutex> lock(_publishQueueMutex);
 
-    if((int)basicLockConfigAclPrefs[12] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_fob_action_3", "Fob action 3", name, baseTopic, String("~") + mqtt_topic_config_basic_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.fobAction3}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"fobAction3\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Action";
-        json["options"][1] = "Unlock";
-        json["options"][2] = "Lock";
-        json["options"][3] = "Lock n Go";
-        json["options"][4] = "Intelligent";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "fob_action_3", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
+    while(!_pendingPublishes.empty() && _device->mqttConnected() && _device->mqttQueueSize() < MQTT_PUBLISH_QUEUE_THRESHOLD)
     {
-        removeHassTopic((char*)"select", (char*)"fob_action_3", uidString);
+        const PendingPublish& pending = _pendingPublishes.front();
+        if(_device->mqttPublish(pending.path.c_str(), MQTT_QOS_LEVEL, pending.retain, pending.payload.c_str()) == 0) break;
+        _pendingPublishes.pop_front();
     }
 
-    if((int)basicLockConfigAclPrefs[14] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_advertising_mode", "Advertising mode", name, baseTopic, String("~") + mqtt_topic_config_basic_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.advertisingMode}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"advertisingMode\": \"{{ value }}\" }" }});
-        json["options"][0] = "Automatic";
-        json["options"][1] = "Normal";
-        json["options"][2] = "Slow";
-        json["options"][3] = "Slowest";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "advertising_mode", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"advertising_mode", uidString);
-    }
+    if(_publishQueueWaiters > 0 && (_pendingPublishes.size() <= MQTT_MAX_PENDING_PUBLISHES || !_device->mqttConnected())) xSemaphoreGive(_publishQueueDrained);
+}
 
-    if((int)basicLockConfigAclPrefs[15] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_timezone", "Timezone", name, baseTopic, String("~") + mqtt_topic_config_basic_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.timeZone}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"timeZone\": \"{{ value }}\" }" }});
-        json["options"][0] = "Africa/Cairo";
-        json["options"][1] = "Africa/Lagos";
-        json["options"][2] = "Africa/Maputo";
-        json["options"][3] = "Africa/Nairobi";
-        json["options"][4] = "America/Anchorage";
-        json["options"][5] = "America/Argentina/Buenos_Aires";
-        json["options"][6] = "America/Chicago";
-        json["options"][7] = "America/Denver";
-        json["options"][8] = "America/Halifax";
-        json["options"][9] = "America/Los_Angeles";
-        json["options"][10] = "America/Manaus";
-        json["options"][11] = "America/Mexico_City";
-        json["options"][12] = "America/New_York";
-        json["options"][13] = "America/Phoenix";
-        json["options"][14] = "America/Regina";
-        json["options"][15] = "America/Santiago";
-        json["options"][16] = "America/Sao_Paulo";
-        json["options"][17] = "America/St_Johns";
-        json["options"][18] = "Asia/Bangkok";
-        json["options"][19] = "Asia/Dubai";
-        json["options"][20] = "Asia/Hong_Kong";
-        json["options"][21] = "Asia/Jerusalem";
-        json["options"][22] = "Asia/Karachi";
-        json["options"][23] = "Asia/Kathmandu";
-        json["options"][24] = "Asia/Kolkata";
-        json["options"][25] = "Asia/Riyadh";
-        json["options"][26] = "Asia/Seoul";
-        json["options"][27] = "Asia/Shanghai";
-        json["options"][28] = "Asia/Tehran";
-        json["options"][29] = "Asia/Tokyo";
-        json["options"][30] = "Asia/Yangon";
-        json["options"][31] = "Australia/Adelaide";
-        json["options"][32] = "Australia/Brisbane";
-        json["options"][33] = "Australia/Darwin";
-        json["options"][34] = "Australia/Hobart";
-        json["options"][35] = "Australia/Perth";
-        json["options"][36] = "Australia/Sydney";
-        json["options"][37] = "Europe/Berlin";
-        json["options"][38] = "Europe/Helsinki";
-        json["options"][39] = "Europe/Istanbul";
-        json["options"][40] = "Europe/London";
-        json["options"][41] = "Europe/Moscow";
-        json["options"][42] = "Pacific/Auckland";
-        json["options"][43] = "Pacific/Guam";
-        json["options"][44] = "Pacific/Honolulu";
-        json["options"][45] = "Pacific/Pago_Pago";
-        json["options"][46] = "None";
-
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "timezone", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"timezone", uidString);
-    }
+const size_t NukiNetwork::publishQueueDepth()
+{
+    std::lock_guard<std::mutex> lock(_publishQueueMutex);
+    return _pendingPublishes.size();
+}
 
-    if((int)advancedLockConfigAclPrefs[0] == 1)
-    {
-        publishHassTopic("number",
-                         "unlocked_position_offset_degrees",
-                         uidString,
-                         "_unlocked_position_offset_degrees",
-                         "Unlocked position offset degrees",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"unlockedPositionOffsetDegrees\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.unlockedPositionOffsetDegrees}}" },
-                           { (char*)"min", (char*)"-90" },
-                           { (char*)"max", (char*)"180" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"number", (char*)"unlocked_position_offset_degrees", uidString);
-    }
+const uint32_t NukiNetwork::publishesCoalesced()
+{
+    return _publishesCoalesced;
+}
 
-    if((int)advancedLockConfigAclPrefs[1] == 1)
-    {
-        publishHassTopic("number",
-                         "locked_position_offset_degrees",
-                         uidString,
-                         "_locked_position_offset_degrees",
-                         "Locked position offset degrees",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"lockedPositionOffsetDegrees\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.lockedPositionOffsetDegrees}}" },
-                           { (char*)"min", (char*)"-180" },
-                           { (char*)"max", (char*)"90" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"number", (char*)"locked_position_offset_degrees", uidString);
-    }
+const uint32_t NukiNetwork::publishesDropped()
+{
+    return _publishesDropped;
+}
 
-    if((int)advancedLockConfigAclPrefs[2] == 1)
-    {
-        publishHassTopic("number",
-                         "single_locked_position_offset_degrees",
-                         uidString,
-                         "_single_locked_position_offset_degrees",
-                         "Single locked position offset degrees",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"singleLockedPositionOffsetDegrees\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.singleLockedPositionOffsetDegrees}}" },
-                           { (char*)"min", (char*)"-180" },
-                           { (char*)"max", (char*)"180" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"number", (char*)"single_locked_position_offset_degrees", uidString);
-    }
+const uint32_t NukiNetwork::publishesThrottled()
+{
+    return _publishesThrottled;
+}
 
-    if((int)advancedLockConfigAclPrefs[3] == 1)
-    {
-        publishHassTopic("number",
-                         "unlocked_locked_transition_offset_degrees",
-                         uidString,
-                         "_unlocked_locked_transition_offset_degrees",
-                         "Unlocked to locked transition offset degrees",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"unlockedToLockedTransitionOffsetDegrees\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.unlockedToLockedTransitionOffsetDegrees}}" },
-                           { (char*)"min", (char*)"-180" },
-                           { (char*)"max", (char*)"180" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"number", (char*)"unlocked_locked_transition_offset_degrees", uidString);
-    }
+void NukiNetwork::publishHASSConfig(const char* deviceType, const char* baseTopic, const char* name, const char* uidString, const char *softwareVersion, const char *hardwareVersion, const char* availabilityTopic, const bool& hasKeypad, const char* lockAction, const char* unlockAction, const char* openAction)
+{
+    if (_discoveryTopic == "") return;
 
-    if((int)advancedLockConfigAclPrefs[4] == 1)
-    {
-        publishHassTopic("number",
-                         "lockngo_timeout",
-                         uidString,
-                         "_lockngo_timeout",
-                         "Lock n Go timeout",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"lockNgoTimeout\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.lockNgoTimeout}}" },
-                           { (char*)"min", (char*)"5" },
-                           { (char*)"max", (char*)"60" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"number", (char*)"lockngo_timeout", uidString);
-    }
+    String cuUrl = _preferences->getString(preference_mqtt_hass_cu_url, "");
+    if(cuUrl == "") cuUrl = "http://" + _device->localIP();
 
-    if((int)advancedLockConfigAclPrefs[5] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_single_button_press_action", "Single button press action", name, baseTopic, String("~") + mqtt_topic_config_advanced_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.singleButtonPressAction}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"singleButtonPressAction\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Action";
-        json["options"][1] = "Intelligent";
-        json["options"][2] = "Unlock";
-        json["options"][3] = "Lock";
-        json["options"][4] = "Unlatch";
-        json["options"][5] = "Lock n Go";
-        json["options"][6] = "Show Status";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "single_button_press_action", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"single_button_press_action", uidString);
-    }
+    uint32_t aclPrefs[17];
+    _preferences->getBytes(preference_acl, &aclPrefs, sizeof(aclPrefs));
 
-    if((int)advancedLockConfigAclPrefs[6] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_double_button_press_action", "Double button press action", name, baseTopic, String("~") + mqtt_topic_config_advanced_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.doubleButtonPressAction}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"doubleButtonPressAction\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Action";
-        json["options"][1] = "Intelligent";
-        json["options"][2] = "Unlock";
-        json["options"][3] = "Lock";
-        json["options"][4] = "Unlatch";
-        json["options"][5] = "Lock n Go";
-        json["options"][6] = "Show Status";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "double_button_press_action", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"double_button_press_action", uidString);
-    }
+    HassLock hassLock = { uidString, name, baseTopic, deviceType, softwareVersion, hardwareVersion, cuUrl.c_str(), availabilityTopic,
+                          lockAction, unlockAction, (int)aclPrefs[2] ? openAction : nullptr };
 
-    if((int)advancedLockConfigAclPrefs[7] == 1)
-    {
-        // Detached cylinder
-        publishHassTopic("switch",
-                         "detached_cylinder",
-                         uidString,
-                         "_detached_cylinder",
-                         "Detached cylinder",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"detachedCylinder\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"detachedCylinder\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.detachedCylinder}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"detached_cylinder", uidString);
-    }
+    char path[200];
+    snprintf(path, sizeof(path), "%s/lock/%s/smartlock/config", _discoveryTopic.c_str(), uidString);
 
-    if((int)advancedLockConfigAclPrefs[8] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_battery_type", "Battery type", name, baseTopic, String("~") + mqtt_topic_config_advanced_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.batteryType}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"batteryType\": \"{{ value }}\" }" }});
-        json["options"][0] = "Alkali";
-        json["options"][1] = "Accumulators";
-        json["options"][2] = "Lithium";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "battery_type", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
     {
-        removeHassTopic((char*)"select", (char*)"battery_type", uidString);
+        std::lock_guard<std::mutex> lock(_hassBufferMutex);
+        if(serializeHassLock(hassLock, _buffer, _bufferSize) == 0)
+        {
+            Log->println(F("HA discovery document too large: smartlock"));
+        }
+        else
+        {
+            publishHassDocument(path, _buffer);
+        }
     }
 
-    if((int)advancedLockConfigAclPrefs[9] == 1)
-    {
-        // Automatic battery type detection
-        publishHassTopic("switch",
-                         "automatic_battery_type_detection",
-                         uidString,
-                         "_automatic_battery_type_detection",
-                         "Automatic battery type detection",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"automaticBatteryTypeDetection\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"automaticBatteryTypeDetection\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.automaticBatteryTypeDetection}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"automatic_battery_type_detection", uidString);
-    }
+    publishHassEntities(hassDeviceEntities, sizeof(hassDeviceEntities) / sizeof(hassDeviceEntities[0]), deviceType, baseTopic, name, uidString, nullptr, nullptr, nullptr);
 
-    if((int)advancedLockConfigAclPrefs[10] == 1)
-    {
-        publishHassTopic("number",
-                         "unlatch_duration",
-                         uidString,
-                         "_unlatch_duration",
-                         "Unlatch duration",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"unlatchDuration\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.unlatchDuration}}" },
-                           { (char*)"min", (char*)"1" },
-                           { (char*)"max", (char*)"30" }});
-    }
-    else
+    if(_preferences->getBool(preference_mqtt_log_enabled, false))
     {
-        removeHassTopic((char*)"number", (char*)"unlatch_duration", uidString);
-    }
-
-    if((int)advancedLockConfigAclPrefs[11] == 1)
-    {
-        publishHassTopic("number",
-                         "auto_lock_timeout",
-                         uidString,
-                         "_auto_lock_timeout",
-                         "Auto lock timeout",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"autoLockTimeOut\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.autoLockTimeOut}}" },
-                           { (char*)"min", (char*)"30" },
-                           { (char*)"max", (char*)"1800" }});
+        publishHassEntity(hassMqttLogEntity, deviceType, baseTopic, name, uidString);
     }
     else
     {
-        removeHassTopic((char*)"number", (char*)"auto_lock_timeout", uidString);
+        removeHassTopic(hassMqttLogEntity.component, hassMqttLogEntity.objectId, uidString);
     }
 
-    if((int)advancedLockConfigAclPrefs[13] == 1)
-    {
-        // Nightmode enabled
-        publishHassTopic("switch",
-                         "nightmode_enabled",
-                         uidString,
-                         "_nightmode_enabled",
-                         "Nightmode enabled",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"nightModeEnabled\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"nightModeEnabled\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.nightModeEnabled}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
+    if(_offEnabled)
     {
-        removeHassTopic((char*)"switch", (char*)"nightmode_enabled", uidString);
-    }
-
-    if((int)advancedLockConfigAclPrefs[14] == 1)
-    {
-        // Nightmode start time
-        publishHassTopic("text",
-                         "nightmode_start_time",
-                         uidString,
-                         "_nightmode_start_time",
-                         "Nightmode start time",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pattern", (char*)"([0-1][0-9]|2[0-3]):[0-5][0-9]" },
-                           { (char*)"cmd_tpl", (char*)"{ \"nightModeStartTime\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.nightModeStartTime}}" },
-                           { (char*)"min", (char*)"5" },
-                           { (char*)"max", (char*)"5" }});
+        publishHassEntity(hassHybridConnectedEntity, deviceType, baseTopic, name, uidString);
     }
     else
     {
-        removeHassTopic((char*)"text", (char*)"nightmode_start_time", uidString);
+        removeHassTopic(hassHybridConnectedEntity.component, hassHybridConnectedEntity.objectId, uidString);
     }
 
-    if((int)advancedLockConfigAclPrefs[15] == 1)
-    {
-        // Nightmode end time
-        publishHassTopic("text",
-                         "nightmode_end_time",
-                         uidString,
-                         "_nightmode_end_time",
-                         "Nightmode end time",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pattern", (char*)"([0-1][0-9]|2[0-3]):[0-5][0-9]" },
-                           { (char*)"cmd_tpl", (char*)"{ \"nightModeEndTime\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.nightModeEndTime}}" },
-                           { (char*)"min", (char*)"5" },
-                           { (char*)"max", (char*)"5" }});
-    }
-    else
+    if(_checkUpdates)
     {
-        removeHassTopic((char*)"text", (char*)"nightmode_end_time", uidString);
-    }
-
-    if((int)advancedLockConfigAclPrefs[16] == 1)
-    {
-        // Nightmode Auto Lock
-        publishHassTopic("switch",
-                         "nightmode_auto_lock",
-                         uidString,
-                         "_nightmode_auto_lock",
-                         "Nightmode auto lock",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"nightModeAutoLockEnabled\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"nightModeAutoLockEnabled\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.nightModeAutoLockEnabled}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
+        publishHassEntity(hassNukiHubLatestEntity, deviceType, baseTopic, name, uidString);
+        publishHassEntity(_updateFromMQTT ? hassNukiHubMqttUpdateEntity : hassNukiHubUpdateEntity, deviceType, baseTopic, name, uidString);
     }
     else
     {
-        removeHassTopic((char*)"switch", (char*)"nightmode_auto_lock", uidString);
+        removeHassTopic(hassNukiHubLatestEntity.component, hassNukiHubLatestEntity.objectId, uidString);
+        removeHassTopic(hassNukiHubUpdateEntity.component, hassNukiHubUpdateEntity.objectId, uidString);
     }
+}
 
-    if((int)advancedLockConfigAclPrefs[17] == 1)
-    {
-        // Nightmode Auto Unlock
-        publishHassTopic("switch",
-                         "nightmode_auto_unlock",
-                         uidString,
-                         "_nightmode_auto_unlock",
-                         "Nightmode auto unlock",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"nightModeAutoUnlockDisabled\": \"0\"}" },
-                           { (char*)"pl_off", (char*)"{ \"nightModeAutoUnlockDisabled\": \"1\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.nightModeAutoUnlockDisabled}}" },
-                           { (char*)"stat_on", (char*)"0" },
-                           { (char*)"stat_off", (char*)"1" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"nightmode_auto_unlock", uidString);
-    }
+void NukiNetwork::publishHASSConfigAdditionalLockEntities(const char *deviceType, const char *baseTopic, const char *name, const char *uidString)
+{
+    uint32_t aclPrefs[17];
+    _preferences->getBytes(preference_acl, &aclPrefs, sizeof(aclPrefs));
 
-    if((int)advancedLockConfigAclPrefs[18] == 1)
-    {
-        // Nightmode immediate lock on start
-        publishHassTopic("switch",
-                         "nightmode_immediate_lock_start",
-                         uidString,
-                         "_nightmode_immediate_lock_start",
-                         "Nightmode immediate lock on start",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"nightModeImmediateLockOnStart\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"nightModeImmediateLockOnStart\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.nightModeImmediateLockOnStart}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"nightmode_immediate_lock_start", uidString);
-    }
+    uint32_t basicLockConfigAclPrefs[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint32_t advancedLockConfigAclPrefs[22] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
-    if((int)advancedLockConfigAclPrefs[20] == 1)
-    {
-        // Immediate auto lock enabled
-        publishHassTopic("switch",
-                         "immediate_auto_lock_enabled",
-                         uidString,
-                         "_immediate_auto_lock_enabled",
-                         "Immediate auto lock enabled",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"immediateAutoLockEnabled\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"immediateAutoLockEnabled\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.immediateAutoLockEnabled}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
+    if(_preferences->getBool(preference_conf_info_enabled, true))
     {
-        removeHassTopic((char*)"switch", (char*)"immediate_auto_lock_enabled", uidString);
+        _preferences->getBytes(preference_conf_lock_basic_acl, &basicLockConfigAclPrefs, sizeof(basicLockConfigAclPrefs));
+        _preferences->getBytes(preference_conf_lock_advanced_acl, &advancedLockConfigAclPrefs, sizeof(advancedLockConfigAclPrefs));
     }
 
-    if((int)advancedLockConfigAclPrefs[21] == 1)
-    {
-        // Auto update enabled
-        publishHassTopic("switch",
-                         "auto_update_enabled",
-                         uidString,
-                         "_auto_update_enabled",
-                         "Auto update enabled",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"autoUpdateEnabled\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"autoUpdateEnabled\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.autoUpdateEnabled}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"auto_update_enabled", uidString);
-    }
+    publishHassEntities(hassLockEntities, sizeof(hassLockEntities) / sizeof(hassLockEntities[0]), deviceType, baseTopic, name, uidString, aclPrefs, basicLockConfigAclPrefs, advancedLockConfigAclPrefs);
 }
 
-void NukiNetwork::publishHASSConfigDoorSensor(char *deviceType, const char *baseTopic, char *name, char *uidString)
+void NukiNetwork::publishHASSConfigDoorSensor(const char *deviceType, const char *baseTopic, const char *name, const char *uidString)
 {
-    publishHassTopic("binary_sensor",
-                     "door_sensor",
-                     uidString,
-                     "_door_sensor",
-                     "Door sensor",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_lock_door_sensor_state,
-                     deviceType,
-                     "door",
-                     "",
-                     "",
-                     "",
-                     {{(char*)"pl_on", (char*)"doorOpened"},
-                      {(char*)"pl_off", (char*)"doorClosed"},
-                      {(char*)"pl_not_avail", (char*)"unavailable"}});
+    publishHassEntity(hassDoorSensorEntity, deviceType, baseTopic, name, uidString);
 }
 
-void NukiNetwork::publishHASSConfigAdditionalOpenerEntities(char *deviceType, const char *baseTopic, char *name, char *uidString)
+void NukiNetwork::publishHASSConfigAdditionalOpenerEntities(const char *deviceType, const char *baseTopic, const char *name, const char *uidString)
 {
     uint32_t aclPrefs[17];
     _preferences->getBytes(preference_acl, &aclPrefs, sizeof(aclPrefs));
@@ -2428,1021 +1122,246 @@ void NukiNetwork::publishHASSConfigAdditionalOpenerEntities(char *deviceType, co
         _preferences->getBytes(preference_conf_opener_advanced_acl, &advancedOpenerConfigAclPrefs, sizeof(advancedOpenerConfigAclPrefs));
     }
 
-    if((int)aclPrefs[11])
-    {
-        // Unlatch
-        publishHassTopic("button",
-                         "unlatch",
-                         uidString,
-                         "_unlatch",
-                         "Open",
-                         name,
-                         baseTopic,
-                         "",
-                         deviceType,
-                         "",
-                         "",
-                         "",
-                         String("~") + mqtt_topic_lock_action,
-                         { { (char*)"en", (char*)"false" },
-                           { (char*)"pl_prs", (char*)"electricStrikeActuation" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"button", (char*)"unlatch", uidString);
-    }
-
-    publishHassTopic("binary_sensor",
-                     "continuous_mode",
-                     uidString,
-                     "_continuous_mode",
-                     "Continuous mode",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_lock_continuous_mode,
-                     deviceType,
-                     "lock",
-                     "",
-                     "",
-                     "",
-                     {{(char*)"pl_on", (char*)"on"},
-                      {(char*)"pl_off", (char*)"off"}});
-
     if((int)aclPrefs[12] == 1 && (int)aclPrefs[13] == 1)
     {
-        publishHassTopic("switch",
-                         "continuous_mode",
-                         uidString,
-                         "_continuous_mode",
-                         "Continuous mode",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_lock_continuous_mode,
-                         deviceType,
-                         "",
-                         "",
-                         "",
-                         String("~") + mqtt_topic_lock_action,
-                         {{ (char*)"en", (char*)"true" },
-                          {(char*)"stat_on", (char*)"on"},
-                          {(char*)"stat_off", (char*)"off"},
-                          {(char*)"pl_on", (char*)"activateCM"},
-                          {(char*)"pl_off", (char*)"deactivateCM"}});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"continuous_mode", uidString);
-    }
-
-    publishHassTopic("binary_sensor",
-                     "ring_detect",
-                     uidString,
-                     "_ring_detect",
-                     "Ring detect",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_lock_binary_ring,
-                     deviceType,
-                     "sound",
-                     "",
-                     "",
-                     "",
-                     {{(char*)"pl_on", (char*)"ring"},
-                      {(char*)"pl_off", (char*)"standby"}});
-
-    JsonDocument json;
-    json = createHassJson(uidString, "_ring_event", "Ring", name, baseTopic, String("~") + mqtt_topic_lock_ring, deviceType, "doorbell", "", "", "", {{(char*)"val_tpl", (char*)"{ \"event_type\": \"{{ value }}\" }"}});
-    json["event_types"][0] = "ring";
-    json["event_types"][1] = "ringlocked";
-    serializeJson(json, _buffer, _bufferSize);
-    String path = createHassTopicPath("event", "ring", uidString);
-    _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-
-    if((int)basicOpenerConfigAclPrefs[5] == 1)
-    {
-        // LED enabled
-        publishHassTopic("switch",
-                         "led_enabled",
-                         uidString,
-                         "_led_enabled",
-                         "LED enabled",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"ic", (char*)"mdi:led-variant-on" },
-                           { (char*)"pl_on", (char*)"{ \"ledEnabled\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"ledEnabled\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.ledEnabled}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"led_enabled", uidString);
-    }
-
-    if((int)basicOpenerConfigAclPrefs[4] == 1)
-    {
-        // Button enabled
-        publishHassTopic("switch",
-                         "button_enabled",
-                         uidString,
-                         "_button_enabled",
-                         "Button enabled",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"ic", (char*)"mdi:radiobox-marked" },
-                           { (char*)"pl_on", (char*)"{ \"buttonEnabled\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"buttonEnabled\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.buttonEnabled}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"button_enabled", uidString);
-    }
-
-    if((int)advancedOpenerConfigAclPrefs[15] == 1)
-    {
-        publishHassTopic("number",
-                         "sound_level",
-                         uidString,
-                         "_sound_level",
-                         "Sound level",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"ic", (char*)"mdi:volume-source" },
-                           { (char*)"cmd_tpl", (char*)"{ \"soundLevel\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.soundLevel}}" },
-                           { (char*)"min", (char*)"0" },
-                           { (char*)"max", (char*)"255" },
-                           { (char*)"mode", (char*)"slider" },
-                           { (char*)"step", (char*)"25.5" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"number", (char*)"sound_level", uidString);
-    }
-
-    if((int)basicOpenerConfigAclPrefs[3] == 1)
-    {
-        // Pairing enabled
-        publishHassTopic("switch",
-                         "pairing_enabled",
-                         uidString,
-                         "_pairing_enabled",
-                         "Pairing enabled",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"pairingEnabled\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"pairingEnabled\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.pairingEnabled}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"pairing_enabled", uidString);
-    }
-
-    if((int)basicOpenerConfigAclPrefs[6] == 1)
-    {
-        publishHassTopic("number",
-                         "timezone_offset",
-                         uidString,
-                         "_timezone_offset",
-                         "Timezone offset",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"ic", (char*)"mdi:timer-cog-outline" },
-                           { (char*)"cmd_tpl", (char*)"{ \"timeZoneOffset\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.timeZoneOffset}}" },
-                           { (char*)"min", (char*)"0" },
-                           { (char*)"max", (char*)"60" }});
+        publishHassEntity(hassOpenerContinuousModeEntity, deviceType, baseTopic, name, uidString);
     }
     else
     {
-        removeHassTopic((char*)"number", (char*)"timezone_offset", uidString);
+        removeHassTopic(hassOpenerContinuousModeEntity.component, hassOpenerContinuousModeEntity.objectId, uidString);
     }
 
-    if((int)basicOpenerConfigAclPrefs[7] == 1)
-    {
-        // DST Mode
-        publishHassTopic("switch",
-                         "dst_mode",
-                         uidString,
-                         "_dst_mode",
-                         "DST mode European",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_basic_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"dstMode\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"dstMode\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.dstMode}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"dst_mode", uidString);
-    }
+    publishHassEntities(hassOpenerEntities, sizeof(hassOpenerEntities) / sizeof(hassOpenerEntities[0]), deviceType, baseTopic, name, uidString, aclPrefs, basicOpenerConfigAclPrefs, advancedOpenerConfigAclPrefs);
+}
 
-    if((int)basicOpenerConfigAclPrefs[8] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_fob_action_1", "Fob action 1", name, baseTopic, String("~") + mqtt_topic_config_basic_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.fobAction1}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"fobAction1\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Action";
-        json["options"][1] = "Toggle RTO";
-        json["options"][2] = "Activate RTO";
-        json["options"][3] = "Deactivate RTO";
-        json["options"][4] = "Open";
-        json["options"][5] = "Ring";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "fob_action_1", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"fob_action_1", uidString);
-    }
+void NukiNetwork::publishHASSConfigAccessLog(const char *deviceType, const char *baseTopic, const char *name, const char *uidString)
+{
+    publishHassEntities(hassAccessLogEntities, sizeof(hassAccessLogEntities) / sizeof(hassAccessLogEntities[0]), deviceType, baseTopic, name, uidString, nullptr, nullptr, nullptr);
+}
 
-    if((int)basicOpenerConfigAclPrefs[9] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_fob_action_2", "Fob action 2", name, baseTopic, String("~") + mqtt_topic_config_basic_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.fobAction2}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"fobAction2\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Action";
-        json["options"][1] = "Toggle RTO";
-        json["options"][2] = "Activate RTO";
-        json["options"][3] = "Deactivate RTO";
-        json["options"][4] = "Open";
-        json["options"][5] = "Ring";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "fob_action_2", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"fob_action_2", uidString);
-    }
+void NukiNetwork::publishHASSConfigKeypad(const char *deviceType, const char *baseTopic, const char *name, const char *uidString)
+{
+    publishHassEntities(hassKeypadEntities, sizeof(hassKeypadEntities) / sizeof(hassKeypadEntities[0]), deviceType, baseTopic, name, uidString, nullptr, nullptr, nullptr);
+}
 
-    if((int)basicOpenerConfigAclPrefs[10] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_fob_action_3", "Fob action 3", name, baseTopic, String("~") + mqtt_topic_config_basic_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.fobAction3}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"fobAction3\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Action";
-        json["options"][1] = "Toggle RTO";
-        json["options"][2] = "Activate RTO";
-        json["options"][3] = "Deactivate RTO";
-        json["options"][4] = "Open";
-        json["options"][5] = "Ring";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "fob_action_3", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
+void NukiNetwork::publishHASSWifiRssiConfig(const char *deviceType, const char *baseTopic, const char *name, const char *uidString)
+{
+    if(_device->signalStrength() == 127)
     {
-        removeHassTopic((char*)"select", (char*)"fob_action_3", uidString);
+        return;
     }
 
-    if((int)basicOpenerConfigAclPrefs[12] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_advertising_mode", "Advertising mode", name, baseTopic, String("~") + mqtt_topic_config_basic_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.advertisingMode}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"advertisingMode\": \"{{ value }}\" }" }});
-        json["options"][0] = "Automatic";
-        json["options"][1] = "Normal";
-        json["options"][2] = "Slow";
-        json["options"][3] = "Slowest";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "advertising_mode", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"advertising_mode", uidString);
-    }
+    publishHassEntity(hassWifiRssiEntity, deviceType, baseTopic, name, uidString);
+}
 
-    if((int)basicOpenerConfigAclPrefs[13] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_timezone", "Timezone", name, baseTopic, String("~") + mqtt_topic_config_basic_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.timeZone}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"timeZone\": \"{{ value }}\" }" }});
-        json["options"][0] = "Africa/Cairo";
-        json["options"][1] = "Africa/Lagos";
-        json["options"][2] = "Africa/Maputo";
-        json["options"][3] = "Africa/Nairobi";
-        json["options"][4] = "America/Anchorage";
-        json["options"][5] = "America/Argentina/Buenos_Aires";
-        json["options"][6] = "America/Chicago";
-        json["options"][7] = "America/Denver";
-        json["options"][8] = "America/Halifax";
-        json["options"][9] = "America/Los_Angeles";
-        json["options"][10] = "America/Manaus";
-        json["options"][11] = "America/Mexico_City";
-        json["options"][12] = "America/New_York";
-        json["options"][13] = "America/Phoenix";
-        json["options"][14] = "America/Regina";
-        json["options"][15] = "America/Santiago";
-        json["options"][16] = "America/Sao_Paulo";
-        json["options"][17] = "America/St_Johns";
-        json["options"][18] = "Asia/Bangkok";
-        json["options"][19] = "Asia/Dubai";
-        json["options"][20] = "Asia/Hong_Kong";
-        json["options"][21] = "Asia/Jerusalem";
-        json["options"][22] = "Asia/Karachi";
-        json["options"][23] = "Asia/Kathmandu";
-        json["options"][24] = "Asia/Kolkata";
-        json["options"][25] = "Asia/Riyadh";
-        json["options"][26] = "Asia/Seoul";
-        json["options"][27] = "Asia/Shanghai";
-        json["options"][28] = "Asia/Tehran";
-        json["options"][29] = "Asia/Tokyo";
-        json["options"][30] = "Asia/Yangon";
-        json["options"][31] = "Australia/Adelaide";
-        json["options"][32] = "Australia/Brisbane";
-        json["options"][33] = "Australia/Darwin";
-        json["options"][34] = "Australia/Hobart";
-        json["options"][35] = "Australia/Perth";
-        json["options"][36] = "Australia/Sydney";
-        json["options"][37] = "Europe/Berlin";
-        json["options"][38] = "Europe/Helsinki";
-        json["options"][39] = "Europe/Istanbul";
-        json["options"][40] = "Europe/London";
-        json["options"][41] = "Europe/Moscow";
-        json["options"][42] = "Pacific/Auckland";
-        json["options"][43] = "Pacific/Guam";
-        json["options"][44] = "Pacific/Honolulu";
-        json["options"][45] = "Pacific/Pago_Pago";
-        json["options"][46] = "None";
-
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "timezone", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
+void NukiNetwork::publishHassTopic(const String& mqttDeviceType,
+                               const String& mqttDeviceName,
+                               const String& uidString,
+                               const String& uidStringPostfix,
+                               const String& displayName,
+                               const String& name,
+                               const String& baseTopic,
+                               const String& stateTopic,
+                               const String& deviceType,
+                               const String& deviceClass,
+                               const String& stateClass,
+                               const String& entityCat,
+                               const String& commandTopic,
+                               std::initializer_list<std::pair<const char*, const char*>> additionalEntries
+)
+{
+    if (_discoveryTopic != "")
     {
-        removeHassTopic((char*)"select", (char*)"timezone", uidString);
-    }
+        HassEntity entity = { mqttDeviceType.c_str(), mqttDeviceName.c_str(), uidStringPostfix.c_str(), displayName.c_str(),
+                              stateTopic.c_str(), deviceClass.c_str(), stateClass.c_str(), entityCat.c_str(), commandTopic.c_str(),
+                              HassAcl::None, 0, {} };
 
-    if((int)basicOpenerConfigAclPrefs[11] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_operating_mode", "Operating mode", name, baseTopic, String("~") + mqtt_topic_config_basic_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.operatingMode}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"operatingMode\": \"{{ value }}\" }" }});
-        json["options"][0] = "Generic door opener";
-        json["options"][1] = "Analogue intercom";
-        json["options"][2] = "Digital intercom";
-        json["options"][3] = "Siedle";
-        json["options"][4] = "TCS";
-        json["options"][5] = "Bticino";
-        json["options"][6] = "Siedle HTS";
-        json["options"][7] = "STR";
-        json["options"][8] = "Ritto";
-        json["options"][9] = "Fermax";
-        json["options"][10] = "Comelit";
-        json["options"][11] = "Urmet BiBus";
-        json["options"][12] = "Urmet 2Voice";
-        json["options"][13] = "Golmar";
-        json["options"][14] = "SKS";
-        json["options"][15] = "Spare";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "operating_mode", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"operating_mode", uidString);
-    }
+        // A truncated document would silently drop settings like the command template
+        if(additionalEntries.size() > HASS_MAX_ATTRIBUTES)
+        {
+            Log->print(F("Too many attributes for HASS entity, not published: "));
+            Log->println(mqttDeviceName);
+            return;
+        }
 
-    if((int)advancedOpenerConfigAclPrefs[1] == 1)
-    {
-        // BUS mode switch analogue
-        publishHassTopic("switch",
-                         "bus_mode_switch",
-                         uidString,
-                         "_bus_mode_switch",
-                         "BUS mode switch analogue",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"busModeSwitch\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"busModeSwitch\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.busModeSwitch}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"bus_mode_switch", uidString);
-    }
+        size_t index = 0;
+        for(const auto& entry : additionalEntries)
+        {
+            entity.attributes[index++] = { entry.first, entry.second };
+        }
 
-    if((int)advancedOpenerConfigAclPrefs[2] == 1)
-    {
-        publishHassTopic("number",
-                         "short_circuit_duration",
-                         uidString,
-                         "_short_circuit_duration",
-                         "Short circuit duration",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"shortCircuitDuration\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.shortCircuitDuration}}" },
-                           { (char*)"min", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"number", (char*)"short_circuit_duration", uidString);
+        publishHassEntity(entity, deviceType.c_str(), baseTopic.c_str(), name.c_str(), uidString.c_str());
     }
+}
 
-    if((int)advancedOpenerConfigAclPrefs[3] == 1)
-    {
-        publishHassTopic("number",
-                         "electric_strike_delay",
-                         uidString,
-                         "_electric_strike_delay",
-                         "Electric strike delay",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"electricStrikeDelay\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.electricStrikeDelay}}" },
-                           { (char*)"min", (char*)"0" },
-                           { (char*)"min", (char*)"30000" },
-                           { (char*)"step", (char*)"3000" }});
-    }
-    else
+void NukiNetwork::publishHassEntities(const HassEntity* entities,
+                                      const size_t count,
+                                      const char* deviceType,
+                                      const char* baseTopic,
+                                      const char* name,
+                                      const char* uidString,
+                                      const uint32_t* aclPrefs,
+                                      const uint32_t* basicConfigAclPrefs,
+                                      const uint32_t* advancedConfigAclPrefs)
+{
+    for(size_t i = 0; i < count; i++)
     {
-        removeHassTopic((char*)"number", (char*)"electric_strike_delay", uidString);
-    }
+        const HassEntity& entity = entities[i];
+        bool enabled = true;
 
-    if((int)advancedOpenerConfigAclPrefs[4] == 1)
-    {
-        // Random Electric Strike Delay
-        publishHassTopic("switch",
-                         "random_electric_strike_delay",
-                         uidString,
-                         "_random_electric_strike_delay",
-                         "Random electric strike delay",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"randomElectricStrikeDelay\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"randomElectricStrikeDelay\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.randomElectricStrikeDelay}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"random_electric_strike_delay", uidString);
-    }
+        switch(entity.acl)
+        {
+            case HassAcl::None:
+                break;
+            case HassAcl::Acl:
+                enabled = (int)aclPrefs[entity.aclIndex] != 0;
+                break;
+            case HassAcl::BasicConfigAcl:
+                enabled = (int)basicConfigAclPrefs[entity.aclIndex] == 1;
+                break;
+            case HassAcl::AdvancedConfigAcl:
+                enabled = (int)advancedConfigAclPrefs[entity.aclIndex] == 1;
+                break;
+        }
 
-    if((int)advancedOpenerConfigAclPrefs[5] == 1)
-    {
-        publishHassTopic("number",
-                         "electric_strike_duration",
-                         uidString,
-                         "_electric_strike_duration",
-                         "Electric strike duration",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"electricStrikeDuration\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.electricStrikeDuration}}" },
-                           { (char*)"min", (char*)"1000" },
-                           { (char*)"min", (char*)"30000" },
-                           { (char*)"step", (char*)"3000" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"number", (char*)"electric_strike_duration", uidString);
+        if(enabled)
+        {
+            publishHassEntity(entity, deviceType, baseTopic, name, uidString);
+        }
+        else
+        {
+            removeHassTopic(entity.component, entity.objectId, uidString);
+        }
     }
+}
 
-    if((int)advancedOpenerConfigAclPrefs[6] == 1)
-    {
-        // Disable RTO after ring
-        publishHassTopic("switch",
-                         "disable_rto_after_ring",
-                         uidString,
-                         "_disable_rto_after_ring",
-                         "Disable RTO after ring",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"disableRtoAfterRing\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"disableRtoAfterRing\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.disableRtoAfterRing}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"switch", (char*)"disable_rto_after_ring", uidString);
-    }
+void NukiNetwork::publishHassEntity(const HassEntity& entity, const char* deviceType, const char* baseTopic, const char* name, const char* uidString)
+{
+    if (_discoveryTopic == "") return;
 
-    if((int)advancedOpenerConfigAclPrefs[7] == 1)
-    {
-        publishHassTopic("number",
-                         "rto_timeout",
-                         uidString,
-                         "_rto_timeout",
-                         "RTO timeout",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"rtoTimeout\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.rtoTimeout}}" },
-                           { (char*)"min", (char*)"5" },
-                           { (char*)"min", (char*)"60" }});
-    }
-    else
+    std::lock_guard<std::mutex> lock(_hassBufferMutex);
+    if(serializeHassEntity(entity, _buffer, _bufferSize, uidString, name, baseTopic, deviceType, _mqttConnectionStateTopic, _lockPath.c_str()) == 0)
     {
-        removeHassTopic((char*)"number", (char*)"rto_timeout", uidString);
+        Log->print(F("HA discovery document too large: "));
+        Log->println(entity.objectId);
+        return;
     }
 
-    if((int)advancedOpenerConfigAclPrefs[8] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_doorbell_suppression", "Doorbell suppression", name, baseTopic, String("~") + mqtt_topic_config_advanced_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.doorbellSuppression}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"doorbellSuppression\": \"{{ value }}\" }" }});
-        json["options"][0] = "Off";
-        json["options"][1] = "CM";
-        json["options"][2] = "RTO";
-        json["options"][3] = "CM & RTO";
-        json["options"][4] = "Ring";
-        json["options"][5] = "CM & Ring";
-        json["options"][6] = "RTO & Ring";
-        json["options"][7] = "CM & RTO & Ring";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "doorbell_suppression", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"doorbell_suppression", uidString);
-    }
+    char path[200];
+    snprintf(path, sizeof(path), "%s/%s/%s/%s/config", _discoveryTopic.c_str(), entity.component, uidString, entity.objectId);
+    publishHassDocument(path, _buffer);
+}
 
-    if((int)advancedOpenerConfigAclPrefs[9] == 1)
-    {
-        publishHassTopic("number",
-                         "doorbell_suppression_duration",
-                         uidString,
-                         "_doorbell_suppression_duration",
-                         "Doorbell suppression duration",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"cmd_tpl", (char*)"{ \"doorbellSuppressionDuration\": \"{{ value }}\" }" },
-                           { (char*)"val_tpl", (char*)"{{value_json.doorbellSuppressionDuration}}" },
-                           { (char*)"min", (char*)"500" },
-                           { (char*)"min", (char*)"10000" },
-                           { (char*)"step", (char*)"1000" }});
-    }
-    else
-    {
-        removeHassTopic((char*)"number", (char*)"doorbell_suppression_duration", uidString);
-    }
+String NukiNetwork::createHassTopicPath(const String& mqttDeviceType, const String& mqttDeviceName, const String& uidString)
+{
+    String path = _discoveryTopic;
+    path.concat("/");
+    path.concat(mqttDeviceType);
+    path.concat("/");
+    path.concat(uidString);
+    path.concat("/");
+    path.concat(mqttDeviceName);
+    path.concat("/config");
 
-    if((int)advancedOpenerConfigAclPrefs[10] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_sound_ring", "Sound ring", name, baseTopic, String("~") + mqtt_topic_config_advanced_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.soundRing}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"soundRing\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Sound";
-        json["options"][1] = "Sound 1";
-        json["options"][2] = "Sound 2";
-        json["options"][3] = "Sound 3";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "sound_ring", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"sound_ring", uidString);
-    }
+    return path;
+}
 
-    if((int)advancedOpenerConfigAclPrefs[11] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_sound_open", "Sound open", name, baseTopic, String("~") + mqtt_topic_config_advanced_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.soundOpen}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"soundOpen\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Sound";
-        json["options"][1] = "Sound 1";
-        json["options"][2] = "Sound 2";
-        json["options"][3] = "Sound 3";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "sound_open", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
+void NukiNetwork::removeHassTopic(const String& mqttDeviceType, const String& mqttDeviceName, const String& uidString)
+{
+    if (_discoveryTopic != "")
     {
-        removeHassTopic((char*)"select", (char*)"sound_open", uidString);
+        String path = createHassTopicPath(mqttDeviceType, mqttDeviceName, uidString);
+        publishHassDocument(path.c_str(), "");
     }
+}
 
-    if((int)advancedOpenerConfigAclPrefs[12] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_sound_rto", "Sound RTO", name, baseTopic, String("~") + mqtt_topic_config_advanced_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.soundRto}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"soundRto\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Sound";
-        json["options"][1] = "Sound 1";
-        json["options"][2] = "Sound 2";
-        json["options"][3] = "Sound 3";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "sound_rto", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
+void NukiNetwork::publishHassDocument(const char* path, const char* payload)
+{
+    std::lock_guard<std::mutex> lock(_hassDocumentMutex);
+    if(_hassDocumentsInvalidated)
     {
-        removeHassTopic((char*)"select", (char*)"sound_rto", uidString);
+        _hassDocumentsInvalidated = false;
+        _hassDocumentHashes.clear();
     }
 
-    if((int)advancedOpenerConfigAclPrefs[13] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_sound_cm", "Sound CM", name, baseTopic, String("~") + mqtt_topic_config_advanced_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.soundCm}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"soundCm\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Sound";
-        json["options"][1] = "Sound 1";
-        json["options"][2] = "Sound 2";
-        json["options"][3] = "Sound 3";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "sound_cm", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
+    for(auto& pending : _hassPendingDocuments)
     {
-        removeHassTopic((char*)"select", (char*)"sound_cm", uidString);
+        if(pending.path == path)
+        {
+            pending.payload = payload;
+            return;
+        }
     }
 
-    if((int)advancedOpenerConfigAclPrefs[14] == 1)
-    {
-        // Sound confirmation
-        publishHassTopic("switch",
-                         "sound_confirmation",
-                         uidString,
-                         "_sound_confirmation",
-                         "Sound confirmation",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"soundConfirmation\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"soundConfirmation\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.soundConfirmation}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
+    auto it = _hassDocumentHashes.find(path);
+    if(it != _hassDocumentHashes.end() && it->second == mqttTopicHash(payload))
     {
-        removeHassTopic((char*)"switch", (char*)"sound_confirmation", uidString);
+        ++_hassDocumentsSkipped;
+        return;
     }
 
-    if((int)advancedOpenerConfigAclPrefs[16] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_single_button_press_action", "Single button press action", name, baseTopic, String("~") + mqtt_topic_config_advanced_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.singleButtonPressAction}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"singleButtonPressAction\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Action";
-        json["options"][1] = "Toggle RTO";
-        json["options"][2] = "Activate RTO";
-        json["options"][3] = "Deactivate RTO";
-        json["options"][4] = "Toggle CM";
-        json["options"][5] = "Activate CM";
-        json["options"][6] = "Deactivate CM";
-        json["options"][7] = "Open";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "single_button_press_action", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"single_button_press_action", uidString);
-    }
+    if(_hassPendingDocuments.empty() && takeHassDiscoveryToken() && sendHassDocument(path, payload)) return;
 
-    if((int)advancedOpenerConfigAclPrefs[17] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_double_button_press_action", "Double button press action", name, baseTopic, String("~") + mqtt_topic_config_advanced_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.doubleButtonPressAction}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"doubleButtonPressAction\": \"{{ value }}\" }" }});
-        json["options"][0] = "No Action";
-        json["options"][1] = "Toggle RTO";
-        json["options"][2] = "Activate RTO";
-        json["options"][3] = "Deactivate RTO";
-        json["options"][4] = "Toggle CM";
-        json["options"][5] = "Activate CM";
-        json["options"][6] = "Deactivate CM";
-        json["options"][7] = "Open";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "double_button_press_action", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"double_button_press_action", uidString);
-    }
+    _hassPendingDocuments.push_back({path, payload});
+}
 
-    if((int)advancedOpenerConfigAclPrefs[18] == 1)
-    {
-        JsonDocument json;
-        json = createHassJson(uidString, "_battery_type", "Battery type", name, baseTopic, String("~") + mqtt_topic_config_advanced_json, deviceType, "", "", "config", String("~") + mqtt_topic_config_action, {{ (char*)"val_tpl", (char*)"{{value_json.batteryType}}" }, { (char*)"en", (char*)"true" }, { (char*)"cmd_tpl", (char*)"{ \"batteryType\": \"{{ value }}\" }" }});
-        json["options"][0] = "Alkali";
-        json["options"][1] = "Accumulators";
-        json["options"][2] = "Lithium";
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath("select", "battery_type", uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
-    }
-    else
-    {
-        removeHassTopic((char*)"select", (char*)"battery_type", uidString);
-    }
+void NukiNetwork::publishPendingHassDocuments()
+{
+    // Skipped while a worker task publishes discovery, it may be waiting for this task to drain the publish queue
+    std::unique_lock<std::mutex> lock(_hassDocumentMutex, std::try_to_lock);
+    if(!lock.owns_lock()) return;
 
-    if((int)advancedOpenerConfigAclPrefs[19] == 1)
-    {
-        // Automatic battery type detection
-        publishHassTopic("switch",
-                         "automatic_battery_type_detection",
-                         uidString,
-                         "_automatic_battery_type_detection",
-                         "Automatic battery type detection",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_config_advanced_json,
-                         deviceType,
-                         "",
-                         "",
-                         "config",
-                         String("~") + mqtt_topic_config_action,
-                         { { (char*)"en", (char*)"true" },
-                           { (char*)"pl_on", (char*)"{ \"automaticBatteryTypeDetection\": \"1\"}" },
-                           { (char*)"pl_off", (char*)"{ \"automaticBatteryTypeDetection\": \"0\"}" },
-                           { (char*)"val_tpl", (char*)"{{value_json.automaticBatteryTypeDetection}}" },
-                           { (char*)"stat_on", (char*)"1" },
-                           { (char*)"stat_off", (char*)"0" }});
-    }
-    else
+    while(!_hassPendingDocuments.empty() && takeHassDiscoveryToken())
     {
-        removeHassTopic((char*)"switch", (char*)"automatic_battery_type_detection", uidString);
+        const HassDocument& document = _hassPendingDocuments.front();
+        if(!sendHassDocument(document.path.c_str(), document.payload.c_str())) break;
+        _hassPendingDocuments.pop_front();
     }
 }
 
-void NukiNetwork::publishHASSConfigAccessLog(char *deviceType, const char *baseTopic, char *name, char *uidString)
-{
-    publishHassTopic("sensor",
-                     "last_action_authorization",
-                     uidString,
-                     "_last_action_authorization",
-                     "Last action authorization",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_lock_log,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"ic", (char*)"mdi:format-list-bulleted" },
-                       { (char*)"val_tpl", (char*)"{{ (value_json|selectattr('type', 'eq', 'LockAction')|selectattr('action', 'in', ['Lock', 'Unlock', 'Unlatch'])|first|default).authorizationName|default }}" }});
-
-    String rollingSate = "~";
-    rollingSate.concat(mqtt_topic_lock_log_rolling);
-    const char *rollingStateChr = rollingSate.c_str();
-
-    publishHassTopic("sensor",
-                     "rolling_log",
-                     uidString,
-                     "_rolling_log",
-                     "Rolling authorization log",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_lock_log_rolling,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"ic", (char*)"mdi:format-list-bulleted" },
-                       { (char*)"json_attr_t", (char*)rollingStateChr },
-                       { (char*)"val_tpl", (char*)"{{value_json.index}}" }});
-}
-
-void NukiNetwork::publishHASSConfigKeypad(char *deviceType, const char *baseTopic, char *name, char *uidString)
-{
-    // Keypad battery critical
-        publishHassTopic("binary_sensor",
-                         "keypad_battery_low",
-                         uidString,
-                         "_keypad_battery_low",
-                         "Keypad battery low",
-                         name,
-                         baseTopic,
-                         String("~") + mqtt_topic_battery_basic_json,
-                         deviceType,
-                         "battery",
-                         "",
-                         "diagnostic",
-                         "",
-                         {{(char*)"pl_on", (char*)"1"},
-                          {(char*)"pl_off", (char*)"0"},
-                          {(char*)"val_tpl", (char*)"{{value_json.keypadCritical}}" }});
-
-    // Query Keypad
-    publishHassTopic("button",
-                     "query_keypad",
-                     uidString,
-                     "_query_keypad",
-                     "Query keypad",
-                     name,
-                     baseTopic,
-                     "",
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     String("~") + mqtt_topic_query_keypad,
-                     { { (char*)"en", (char*)"false" },
-                       { (char*)"pl_prs", (char*)"1" }});
-
-    publishHassTopic("sensor",
-                     "keypad_status",
-                     uidString,
-                     "_keypad_stats",
-                     "Keypad status",
-                     name,
-                     baseTopic,
-                     String("~") + mqtt_topic_lock_log,
-                     deviceType,
-                     "",
-                     "",
-                     "diagnostic",
-                     "",
-                     { { (char*)"ic", (char*)"mdi:drag-vertical" },
-                       { (char*)"val_tpl", (char*)"{{ (value_json|selectattr('type', 'eq', 'KeypadAction')|first|default).completionStatus|default }}" }});
-}
-
-void NukiNetwork::publishHASSWifiRssiConfig(char *deviceType, const char *baseTopic, char *name, char *uidString)
+bool NukiNetwork::sendHassDocument(const char* path, const char* payload)
 {
-    if(_device->signalStrength() == 127)
-    {
-        return;
-    }
+    // Only remembered once published, a document that couldn't be sent is retried by the next setupHASS()
+    if(mqttPublish(path, true, payload) == 0) return false;
 
-    publishHassTopic("sensor",
-                     "wifi_signal_strength",
-                     uidString,
-                     "_wifi_signal_strength",
-                     "WIFI signal strength",
-                     name,
-                     baseTopic,
-                     _lockPath + mqtt_topic_wifi_rssi,
-                     deviceType,
-                     "signal_strength",
-                     "measurement",
-                     "diagnostic",
-                     "",
-                     { {(char*)"unit_of_meas", (char*)"dBm"} });
+    _hassDocumentHashes[path] = mqttTopicHash(payload);
+    ++_hassDocumentsSent;
+    return true;
 }
 
-void NukiNetwork::publishHassTopic(const String& mqttDeviceType,
-                               const String& mqttDeviceName,
-                               const String& uidString,
-                               const String& uidStringPostfix,
-                               const String& displayName,
-                               const String& name,
-                               const String& baseTopic,
-                               const String& stateTopic,
-                               const String& deviceType,
-                               const String& deviceClass,
-                               const String& stateClass,
-                               const String& entityCat,
-                               const String& commandTopic,
-                               std::vector<std::pair<char*, char*>> additionalEntries
-)
+bool NukiNetwork::takeHassDiscoveryToken()
 {
-    if (_discoveryTopic != "")
+    int64_t ts = (esp_timer_get_time() / 1000);
+    int64_t refill = (ts - _hassTokensRefillTs) / HASS_DISCOVERY_TOKEN_INTERVAL;
+
+    if(refill > 0)
     {
-        JsonDocument json;
-        json = createHassJson(uidString, uidStringPostfix, displayName, name, baseTopic, stateTopic, deviceType, deviceClass, stateClass, entityCat, commandTopic, additionalEntries);
-        serializeJson(json, _buffer, _bufferSize);
-        String path = createHassTopicPath(mqttDeviceType, mqttDeviceName, uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, _buffer);
+        _hassTokens = min((int64_t)HASS_DISCOVERY_BURST, _hassTokens + refill);
+        _hassTokensRefillTs += refill * HASS_DISCOVERY_TOKEN_INTERVAL;
     }
+
+    if(_hassTokens == HASS_DISCOVERY_BURST) _hassTokensRefillTs = ts;
+    if(_hassTokens == 0) return false;
+
+    --_hassTokens;
+    return true;
 }
 
-String NukiNetwork::createHassTopicPath(const String& mqttDeviceType, const String& mqttDeviceName, const String& uidString)
+const uint32_t NukiNetwork::hassDocumentsSent()
 {
-    String path = _discoveryTopic;
-    path.concat("/");
-    path.concat(mqttDeviceType);
-    path.concat("/");
-    path.concat(uidString);
-    path.concat("/");
-    path.concat(mqttDeviceName);
-    path.concat("/config");
-
-    return path;
+    return _hassDocumentsSent;
 }
 
-void NukiNetwork::removeHassTopic(const String& mqttDeviceType, const String& mqttDeviceName, const String& uidString)
+const uint32_t NukiNetwork::hassDocumentsSkipped()
 {
-    if (_discoveryTopic != "")
-    {
-        String path = createHassTopicPath(mqttDeviceType, mqttDeviceName, uidString);
-        _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, "");
-    }
+    return _hassDocumentsSkipped;
 }
 
 void NukiNetwork::removeTopic(const String& mqttPath, const String& mqttTopic)
 {
     String path = mqttPath;
     path.concat(mqttTopic);
-   _device->mqttPublish(path.c_str(), MQTT_QOS_LEVEL, true, "");
+    mqttPublish(path.c_str(), true, "");
 
     #ifdef DEBUG_NUKIHUB
     Log->print(F("Removing MQTT topic: "));
@@ -3451,177 +1370,105 @@ void NukiNetwork::removeTopic(const String& mqttPath, const String& mqttTopic)
 }
 
 
-void NukiNetwork::removeHASSConfig(char* uidString)
-{
-    removeHassTopic((char*)"lock", (char*)"smartlock", uidString);
-    removeHassTopic((char*)"binary_sensor", (char*)"battery_low", uidString);
-    removeHassTopic((char*)"binary_sensor", (char*)"keypad_battery_low", uidString);
-    removeHassTopic((char*)"sensor", (char*)"battery_voltage", uidString);
-    removeHassTopic((char*)"sensor", (char*)"trigger", uidString);
-    removeHassTopic((char*)"binary_sensor", (char*)"mqtt_connected", uidString);
-    removeHassTopic((char*)"switch", (char*)"reset", uidString);
-    removeHassTopic((char*)"sensor", (char*)"firmware_version", uidString);
-    removeHassTopic((char*)"sensor", (char*)"hardware_version", uidString);
-    removeHassTopic((char*)"sensor", (char*)"nuki_hub_version", uidString);
-    removeHassTopic((char*)"sensor", (char*)"nuki_hub_build", uidString);
-    removeHassTopic((char*)"sensor", (char*)"nuki_hub_latest", uidString);
-    removeHassTopic((char*)"update", (char*)"nuki_hub_update", uidString);
-    removeHassTopic((char*)"sensor", (char*)"nuki_hub_ip", uidString);
-    removeHassTopic((char*)"button", (char*)"unlatch", uidString);
-    removeHassTopic((char*)"button", (char*)"lockngo", uidString);
-    removeHassTopic((char*)"button", (char*)"lockngounlatch", uidString);
-    removeHassTopic((char*)"sensor", (char*)"battery_level", uidString);
-    removeHassTopic((char*)"binary_sensor", (char*)"door_sensor", uidString);
-    removeHassTopic((char*)"binary_sensor", (char*)"ring_detect", uidString);
-    removeHassTopic((char*)"sensor", (char*)"sound_level", uidString);
-    removeHassTopic((char*)"sensor", (char*)"last_action_authorization", uidString);
-    removeHassTopic((char*)"sensor", (char*)"keypad_status", uidString);
-    removeHassTopic((char*)"sensor", (char*)"rolling_log", uidString);
-    removeHassTopic((char*)"sensor", (char*)"wifi_signal_strength", uidString);
-    removeHassTopic((char*)"sensor", (char*)"bluetooth_signal_strength", uidString);
-    removeHassTopic((char*)"binary_sensor", (char*)"continuous_mode", uidString);
-    removeHassTopic((char*)"switch", (char*)"continuous_mode", uidString);
-    removeHassTopic((char*)"button", (char*)"query_lockstate", uidString);
-    removeHassTopic((char*)"button", (char*)"query_config", uidString);
-    removeHassTopic((char*)"button", (char*)"query_keypad", uidString);
-    removeHassTopic((char*)"button", (char*)"query_battery", uidString);
-    removeHassTopic((char*)"button", (char*)"query_commandresult", uidString);
-    removeHassTopic((char*)"switch", (char*)"auto_lock", uidString);
-    removeHassTopic((char*)"switch", (char*)"auto_unlock", uidString);
-    removeHassTopic((char*)"switch", (char*)"double_lock", uidString);
-    removeHassTopic((char*)"switch", (char*)"automatic_battery_type_detection", uidString);
-    removeHassTopic((char*)"select", (char*)"battery_type", uidString);
-    removeHassTopic((char*)"select", (char*)"double_button_press_action", uidString);
-    removeHassTopic((char*)"select", (char*)"single_button_press_action", uidString);
-    removeHassTopic((char*)"switch", (char*)"sound_confirmation", uidString);
-    removeHassTopic((char*)"select", (char*)"sound_cm", uidString);
-    removeHassTopic((char*)"select", (char*)"sound_rto", uidString);
-    removeHassTopic((char*)"select", (char*)"sound_open", uidString);
-    removeHassTopic((char*)"select", (char*)"sound_ring", uidString);
-    removeHassTopic((char*)"number", (char*)"doorbell_suppression_duration", uidString);
-    removeHassTopic((char*)"select", (char*)"doorbell_suppression", uidString);
-    removeHassTopic((char*)"number", (char*)"rto_timeout", uidString);
-    removeHassTopic((char*)"switch", (char*)"disable_rto_after_ring", uidString);
-    removeHassTopic((char*)"number", (char*)"electric_strike_duration", uidString);
-    removeHassTopic((char*)"switch", (char*)"random_electric_strike_delay", uidString);
-    removeHassTopic((char*)"number", (char*)"electric_strike_delay", uidString);
-    removeHassTopic((char*)"number", (char*)"short_circuit_duration", uidString);
-    removeHassTopic((char*)"switch", (char*)"bus_mode_switch", uidString);
-    removeHassTopic((char*)"select", (char*)"operating_mode", uidString);
-    removeHassTopic((char*)"select", (char*)"timezone", uidString);
-    removeHassTopic((char*)"select", (char*)"advertising_mode", uidString);
-    removeHassTopic((char*)"select", (char*)"fob_action_3", uidString);
-    removeHassTopic((char*)"select", (char*)"fob_action_2", uidString);
-    removeHassTopic((char*)"select", (char*)"fob_action_1", uidString);
-    removeHassTopic((char*)"switch", (char*)"dst_mode", uidString);
-    removeHassTopic((char*)"number", (char*)"timezone_offset", uidString);
-    removeHassTopic((char*)"switch", (char*)"pairing_enabled", uidString);
-    removeHassTopic((char*)"number", (char*)"sound_level", uidString);
-    removeHassTopic((char*)"switch", (char*)"button_enabled", uidString);
-    removeHassTopic((char*)"switch", (char*)"led_enabled", uidString);
-    removeHassTopic((char*)"number", (char*)"led_brightness", uidString);
-    removeHassTopic((char*)"switch", (char*)"auto_update_enabled", uidString);
-    removeHassTopic((char*)"switch", (char*)"immediate_auto_lock_enabled", uidString);
-    removeHassTopic((char*)"switch", (char*)"nightmode_immediate_lock_start", uidString);
-    removeHassTopic((char*)"switch", (char*)"nightmode_auto_unlock", uidString);
-    removeHassTopic((char*)"switch", (char*)"nightmode_auto_lock", uidString);
-    removeHassTopic((char*)"text", (char*)"nightmode_end_time", uidString);
-    removeHassTopic((char*)"text", (char*)"nightmode_start_time", uidString);
-    removeHassTopic((char*)"switch", (char*)"nightmode_enabled", uidString);
-    removeHassTopic((char*)"number", (char*)"auto_lock_timeout", uidString);
-    removeHassTopic((char*)"number", (char*)"unlatch_duration", uidString);
-    removeHassTopic((char*)"switch", (char*)"detached_cylinder", uidString);
-    removeHassTopic((char*)"number", (char*)"lockngo_timeout", uidString);
-    removeHassTopic((char*)"number", (char*)"unlocked_locked_transition_offset_degrees", uidString);
-    removeHassTopic((char*)"number", (char*)"single_locked_position_offset_degrees", uidString);
-    removeHassTopic((char*)"number", (char*)"locked_position_offset_degrees", uidString);
-    removeHassTopic((char*)"number", (char*)"unlocked_position_offset_degrees", uidString);
-    removeHassTopic((char*)"switch", (char*)"pairing_enabled", uidString);
-    removeHassTopic((char*)"switch", (char*)"auto_unlatch", uidString);
-    removeHassTopic((char*)"sensor", (char*)"network_device", uidString);
-    removeHassTopic((char*)"switch", (char*)"webserver", uidString);
-    removeHassTopic((char*)"sensor", (char*)"uptime", uidString);
-    removeHassTopic((char*)"sensor", (char*)"mqtt_log", uidString);
-    removeHassTopic((char*)"binary_sensor", (char*)"hybrid_connected", uidString);
-    removeHassTopic((char*)"sensor", (char*)"nuki_hub_restart_reason", uidString);
-    removeHassTopic((char*)"sensor", (char*)"nuki_hub_restart_reason_esp", uidString);
-}
-
-void NukiNetwork::removeHASSConfigTopic(char *deviceType, char *name, char *uidString)
+void NukiNetwork::removeHASSConfig(const char* uidString)
 {
-    removeHassTopic(deviceType, name, uidString);
+    removeHassTopic("lock", "smartlock", uidString);
+    removeHassTopic("binary_sensor", "battery_low", uidString);
+    removeHassTopic("binary_sensor", "keypad_battery_low", uidString);
+    removeHassTopic("sensor", "battery_voltage", uidString);
+    removeHassTopic("sensor", "trigger", uidString);
+    removeHassTopic("binary_sensor", "mqtt_connected", uidString);
+    removeHassTopic("switch", "reset", uidString);
+    removeHassTopic("sensor", "firmware_version", uidString);
+    removeHassTopic("sensor", "hardware_version", uidString);
+    removeHassTopic("sensor", "nuki_hub_version", uidString);
+    removeHassTopic("sensor", "nuki_hub_build", uidString);
+    removeHassTopic("sensor", "nuki_hub_latest", uidString);
+    removeHassTopic("update", "nuki_hub_update", uidString);
+    removeHassTopic("sensor", "nuki_hub_ip", uidString);
+    removeHassTopic("button", "unlatch", uidString);
+    removeHassTopic("button", "lockngo", uidString);
+    removeHassTopic("button", "lockngounlatch", uidString);
+    removeHassTopic("sensor", "battery_level", uidString);
+    removeHassTopic("binary_sensor", "door_sensor", uidString);
+    removeHassTopic("binary_sensor", "ring_detect", uidString);
+    removeHassTopic("sensor", "sound_level", uidString);
+    removeHassTopic("sensor", "last_action_authorization", uidString);
+    removeHassTopic("sensor", "keypad_status", uidString);
+    removeHassTopic("sensor", "rolling_log", uidString);
+    removeHassTopic("sensor", "wifi_signal_strength", uidString);
+    removeHassTopic("sensor", "bluetooth_signal_strength", uidString);
+    removeHassTopic("binary_sensor", "continuous_mode", uidString);
+    removeHassTopic("switch", "continuous_mode", uidString);
+    removeHassTopic("button", "query_lockstate", uidString);
+    removeHassTopic("button", "query_config", uidString);
+    removeHassTopic("button", "query_keypad", uidString);
+    removeHassTopic("button", "query_battery", uidString);
+    removeHassTopic("button", "query_commandresult", uidString);
+    removeHassTopic("switch", "auto_lock", uidString);
+    removeHassTopic("switch", "auto_unlock", uidString);
+    removeHassTopic("switch", "double_lock", uidString);
+    removeHassTopic("switch", "automatic_battery_type_detection", uidString);
+    removeHassTopic("select", "battery_type", uidString);
+    removeHassTopic("select", "double_button_press_action", uidString);
+    removeHassTopic("select", "single_button_press_action", uidString);
+    removeHassTopic("switch", "sound_confirmation", uidString);
+    removeHassTopic("select", "sound_cm", uidString);
+    removeHassTopic("select", "sound_rto", uidString);
+    removeHassTopic("select", "sound_open", uidString);
+    removeHassTopic("select", "sound_ring", uidString);
+    removeHassTopic("number", "doorbell_suppression_duration", uidString);
+    removeHassTopic("select", "doorbell_suppression", uidString);
+    removeHassTopic("number", "rto_timeout", uidString);
+    removeHassTopic("switch", "disable_rto_after_ring", uidString);
+    removeHassTopic("number", "electric_strike_duration", uidString);
+    removeHassTopic("switch", "random_electric_strike_delay", uidString);
+    removeHassTopic("number", "electric_strike_delay", uidString);
+    removeHassTopic("number", "short_circuit_duration", uidString);
+    removeHassTopic("switch", "bus_mode_switch", uidString);
+    removeHassTopic("select", "operating_mode", uidString);
+    removeHassTopic("select", "timezone", uidString);
+    removeHassTopic("select", "advertising_mode", uidString);
+    removeHassTopic("select", "fob_action_3", uidString);
+    removeHassTopic("select", "fob_action_2", uidString);
+    removeHassTopic("select", "fob_action_1", uidString);
+    removeHassTopic("switch", "dst_mode", uidString);
+    removeHassTopic("number", "timezone_offset", uidString);
+    removeHassTopic("switch", "pairing_enabled", uidString);
+    removeHassTopic("number", "sound_level", uidString);
+    removeHassTopic("switch", "button_enabled", uidString);
+    removeHassTopic("switch", "led_enabled", uidString);
+    removeHassTopic("number", "led_brightness", uidString);
+    removeHassTopic("switch", "auto_update_enabled", uidString);
+    removeHassTopic("switch", "immediate_auto_lock_enabled", uidString);
+    removeHassTopic("switch", "nightmode_immediate_lock_start", uidString);
+    removeHassTopic("switch", "nightmode_auto_unlock", uidString);
+    removeHassTopic("switch", "nightmode_auto_lock", uidString);
+    removeHassTopic("text", "nightmode_end_time", uidString);
+    removeHassTopic("text", "nightmode_start_time", uidString);
+    removeHassTopic("switch", "nightmode_enabled", uidString);
+    removeHassTopic("number", "auto_lock_timeout", uidString);
+    removeHassTopic("number", "unlatch_duration", uidString);
+    removeHassTopic("switch", "detached_cylinder", uidString);
+    removeHassTopic("number", "lockngo_timeout", uidString);
+    removeHassTopic("number", "unlocked_locked_transition_offset_degrees", uidString);
+    removeHassTopic("number", "single_locked_position_offset_degrees", uidString);
+    removeHassTopic("number", "locked_position_offset_degrees", uidString);
+    removeHassTopic("number", "unlocked_position_offset_degrees", uidString);
+    removeHassTopic("switch", "pairing_enabled", uidString);
+    removeHassTopic("switch", "auto_unlatch", uidString);
+    removeHassTopic("sensor", "network_device", uidString);
+    removeHassTopic("switch", "webserver", uidString);
+    removeHassTopic("sensor", "uptime", uidString);
+    removeHassTopic("sensor", "mqtt_log", uidString);
+    removeHassTopic("binary_sensor", "hybrid_connected", uidString);
+    removeHassTopic("sensor", "nuki_hub_restart_reason", uidString);
+    removeHassTopic("sensor", "nuki_hub_restart_reason_esp", uidString);
 }
 
-JsonDocument NukiNetwork::createHassJson(const String& uidString,
-                             const String& uidStringPostfix,
-                             const String& displayName,
-                             const String& name,
-                             const String& baseTopic,
-                             const String& stateTopic,
-                             const String& deviceType,
-                             const String& deviceClass,
-                             const String& stateClass,
-                             const String& entityCat,
-                             const String& commandTopic,
-                             std::vector<std::pair<char*, char*>> additionalEntries
-)
+void NukiNetwork::removeHASSConfigTopic(const char *deviceType, const char *name, const char *uidString)
 {
-    JsonDocument json;
-    json.clear();
-    JsonObject dev = json["dev"].to<JsonObject>();
-    JsonArray ids = dev["ids"].to<JsonArray>();
-    ids.add(String("nuki_") + uidString);
-    json["dev"]["mf"] = "Nuki";
-    json["dev"]["mdl"] = deviceType;
-    json["dev"]["name"] = name;
-    json["~"] = baseTopic;
-    json["name"] = displayName;
-    json["unique_id"] = String(uidString) + uidStringPostfix;
-
-    if(deviceClass != "")
-    {
-        json["dev_cla"] = deviceClass;
-    }
-
-    if(stateTopic != "")
-    {
-        json["stat_t"] = stateTopic;
-    }
-
-    if(stateClass != "")
-    {
-        json["stat_cla"] = stateClass;
-    }
-
-    if(entityCat != "")
-    {
-        json["ent_cat"] = entityCat;
-    }
-
-    if(commandTopic != "")
-    {
-        json["cmd_t"] = commandTopic;
-    }
-
-    json["avty"]["t"] = _lockPath + mqtt_topic_mqtt_connection_state;
-
-    for(const auto& entry : additionalEntries)
-    {
-        if(strcmp(entry.second, "true") == 0)
-        {
-            json[entry.first] = true;
-        }
-        else if(strcmp(entry.second, "false") == 0)
-        {
-            json[entry.first] = false;
-        }
-        else
-        {
-            json[entry.first] = entry.second;
-        }
-    }
-
-    return json;
+    removeHassTopic(deviceType, name, uidString);
 }
 
 void NukiNetwork::batteryTypeToString(const Nuki::BatteryType battype, char* str) {
@@ -3,6 +3,10 @@
 #include <Preferences.h>
 #include <vector>
 #include <map>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <string>
 #include "networkDevices/NetworkDevice.h"
 #include "networkDevices/IPConfiguration.h"
 #include "enums/NetworkDeviceType.h"
@@ -14,6 +18,9 @@
 #include "Gpio.h"
 #include <ArduinoJson.h>
 #include "NukiConstants.h"
+#include "HassEntity.h"
+#include "MqttMessageAssembler.h"
+#include "freertos/semphr.h"
 #endif
 
 #define JSON_BUFFER_SIZE 1024
@@ -55,15 +62,15 @@ public:
     void publishBool(const char* prefix, const char* topic, const bool value, bool retain);
     bool publishString(const char* prefix, const char* topic, const char* value, bool retain);
 
-    void publishHASSConfig(char* deviceType, const char* baseTopic, char* name, char* uidString, const char *softwareVersion, const char *hardwareVersion, const char* availabilityTopic, const bool& hasKeypad, char* lockAction, char* unlockAction, char* openAction);
-    void publishHASSConfigAdditionalLockEntities(char* deviceType, const char* baseTopic, char* name, char* uidString);
-    void publishHASSConfigDoorSensor(char* deviceType, const char* baseTopic, char* name, char* uidString);
-    void publishHASSConfigAdditionalOpenerEntities(char* deviceType, const char* baseTopic, char* name, char* uidString);
-    void publishHASSConfigAccessLog(char* deviceType, const char* baseTopic, char* name, char* uidString);
-    void publishHASSConfigKeypad(char* deviceType, const char* baseTopic, char* name, char* uidString);
-    void publishHASSWifiRssiConfig(char* deviceType, const char* baseTopic, char* name, char* uidString);
-    void removeHASSConfig(char* uidString);
-    void removeHASSConfigTopic(char* deviceType, char* name, char* uidString);
+    void publishHASSConfig(const char* deviceType, const char* baseTopic, const char* name, const char* uidString, const char *softwareVersion, const char *hardwareVersion, const char* availabilityTopic, const bool& hasKeypad, const char* lockAction, const char* unlockAction, const char* openAction);
+    void publishHASSConfigAdditionalLockEntities(const char* deviceType, const char* baseTopic, const char* name, const char* uidString);
+    void publishHASSConfigDoorSensor(const char* deviceType, const char* baseTopic, const char* name, const char* uidString);
+    void publishHASSConfigAdditionalOpenerEntities(const char* deviceType, const char* baseTopic, const char* name, const char* uidString);
+    void publishHASSConfigAccessLog(const char* deviceType, const char* baseTopic, const char* name, const char* uidString);
+    void publishHASSConfigKeypad(const char* deviceType, const char* baseTopic, const char* name, const char* uidString);
+    void publishHASSWifiRssiConfig(const char* deviceType, const char* baseTopic, const char* name, const char* uidString);
+    void removeHASSConfig(const char* uidString);
+    void removeHASSConfigTopic(const char* deviceType, const char* name, const char* uidString);
     void publishHassTopic(const String& mqttDeviceType,
                           const String& mqttDeviceName,
                           const String& uidString,
@@ -77,7 +84,7 @@ public:
                           const String& stateClass = "",
                           const String& entityCat = "",
                           const String& commandTopic = "",
-                          std::vector<std::pair<char*, char*>> additionalEntries = {}
+                          std::initializer_list<std::pair<const char*, const char*>> additionalEntries = {}
                           );
     void removeHassTopic(const String& mqttDeviceType, const String& mqttDeviceName, const String& uidString);
     void removeTopic(const String& mqttPath, const String& mqttTopic);
@@ -92,6 +99,16 @@ public:
     uint16_t subscribe(const char* topic, uint8_t qos);
 
     void addReconnectedCallback(std::function<void()> reconnectedCallback);
+
+    const uint32_t hassDocumentsSent();
+    const uint32_t hassDocumentsSkipped();
+    const size_t publishQueueDepth();
+    const uint32_t publishesCoalesced();
+    const uint32_t publishesDropped();
+    const uint32_t publishesThrottled();
+
+    // networkTask sleeps here between loops, a network event or a publisher waiting for the queue wakes it early
+    void waitForNetworkEvent(const uint32_t timeout);
     #endif
 private:
     void setupDevice();
@@ -118,29 +135,38 @@ private:
 
     #ifndef NUKI_HUB_UPDATER
     static void onMqttDataReceivedCallback(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t len, size_t index, size_t total);
+    void onMqttFragmentReceived(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t& len, size_t& index, size_t& total);
     void onMqttDataReceived(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t& len, size_t& index, size_t& total);
     void parseGpioTopics(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, size_t& len, size_t& index, size_t& total);
     void gpioActionCallback(const GpioAction& action, const int& pin);
 
     String createHassTopicPath(const String& mqttDeviceType, const String& mqttDeviceName, const String& uidString);
-    JsonDocument createHassJson(const String& uidString,
-                        const String& uidStringPostfix,
-                        const String& displayName,
-                        const String& name,
-                        const String& baseTopic,
-                        const String& stateTopic,
-                        const String& deviceType,
-                        const String& deviceClass,
-                        const String& stateClass = "",
-                        const String& entityCat = "",
-                        const String& commandTopic = "",
-                        std::vector<std::pair<char*, char*>> additionalEntries = {}
-                        );
+    void publishHassEntities(const HassEntity* entities,
+                             const size_t count,
+                             const char* deviceType,
+                             const char* baseTopic,
+                             const char* name,
+                             const char* uidString,
+                             const uint32_t* aclPrefs,
+                             const uint32_t* basicConfigAclPrefs,
+                             const uint32_t* advancedConfigAclPrefs);
+    void publishHassEntity(const HassEntity& entity, const char* deviceType, const char* baseTopic, const char* name, const char* uidString);
 
     void onMqttConnect(const bool& sessionPresent);
     void onMqttDisconnect(const espMqttClientTypes::DisconnectReason& reason);
+    void onDeviceConnected();
 
     void buildMqttPath(char* outPath, std::initializer_list<const char*> paths);
+    const char* prefixedPath(char* outPath, const char* prefix, const char* topic); // prefix nullptr: topic is a complete path
+
+    // Discovery documents are only sent when their content hash changed and are paced by a token bucket
+    void publishHassDocument(const char* path, const char* payload);
+    void publishPendingHassDocuments();
+    bool sendHassDocument(const char* path, const char* payload);
+    bool takeHassDiscoveryToken();
+    uint16_t mqttPublish(const char* path, bool retain, const char* payload);
+    void publishPendingPublishes();
+    void waitForPublishQueue();
 
     const char* _lastWillPayload = "offline";
     char _mqttConnectionStateTopic[211] = {0};
@@ -157,6 +183,8 @@ private:
     bool _firstDisconnected = true;
     
     int64_t _nextReconnect = 0;
+    TaskHandle_t _networkTaskHandle = nullptr;
+    volatile bool _deviceConnectedEvent = false;
     char _mqttBrokerAddr[101] = {0};
     char _mqttUser[31] = {0};
     char _mqttPass[31] = {0};
@@ -182,6 +210,41 @@ private:
 
     char* _buffer;
     const size_t _bufferSize;
+    std::mutex _hassBufferMutex; // _buffer is written by the lock and the opener worker task
+
+    struct HassDocument
+    {
+        String path;
+        String payload;
+    };
+
+    std::mutex _hassDocumentMutex; // discovery is published from the lock and the opener worker task and paced by the network task
+    std::unordered_map<std::string, uint32_t> _hassDocumentHashes; // discovery topic -> payload hash
+    std::deque<HassDocument> _hassPendingDocuments;
+    volatile bool _hassDocumentsInvalidated = false;
+    int64_t _hassTokens = 0;
+    int64_t _hassTokensRefillTs = 0;
+    uint32_t _hassDocumentsSent = 0;
+    uint32_t _hassDocumentsSkipped = 0;
+
+    // Messages waiting for the espMqttClient outbox to drain, in publish order
+    struct PendingPublish
+    {
+        uint32_t pathHash;
+        String path;
+        String payload;
+        bool retain;
+    };
+
+    std::mutex _publishQueueMutex;
+    std::deque<PendingPublish> _pendingPublishes;
+    SemaphoreHandle_t _publishQueueDrained = nullptr; // given by publishPendingPublishes() while publishers wait for the queue
+    uint32_t _publishQueueWaiters = 0; // guarded by _publishQueueMutex
+    uint32_t _publishesCoalesced = 0;
+    uint32_t _publishesDropped = 0;
+    uint32_t _publishesThrottled = 0;
+
+    MqttMessageAssembler* _mqttRxMessage = nullptr;
 
     int8_t _lastRssi = 127;
     #endif
@@ -14,12 +14,17 @@ extern bool forceEnableWebServer;
 extern const uint8_t x509_crt_imported_bundle_bin_start[] asm("_binary_x509_crt_bundle_start");
 extern const uint8_t x509_crt_imported_bundle_bin_end[]   asm("_binary_x509_crt_bundle_end");
 
+// Survives a soft restart, so entries already sent to the rolling log aren't streamed again before the retained index arrives
+RTC_NOINIT_ATTR uint32_t NukiNetworkLock_lastRollingLog;
+RTC_NOINIT_ATTR uint32_t NukiNetworkLock_lastRollingLogDetect;
+
 NukiNetworkLock::NukiNetworkLock(NukiNetwork* network, NukiOfficial* nukiOfficial, Preferences* preferences, char* buffer, size_t bufferSize)
 : _network(network),
   _nukiOfficial(nukiOfficial),
   _preferences(preferences),
   _buffer(buffer),
-  _bufferSize(bufferSize)
+  _bufferSize(bufferSize),
+  _jsonArena(JSON_ARENA_SIZE, JSON_ARENA_SIZE_PSRAM)
 {
     _nukiPublisher = new NukiPublisher(network, _mqttPath);
     _nukiOfficial->setPublisher(_nukiPublisher);
@@ -27,6 +32,11 @@ NukiNetworkLock::NukiNetworkLock(NukiNetwork* network, NukiOfficial* nukiOfficia
     memset(_authName, 0, sizeof(_authName));
     _authName[0] = '\0';
 
+    if(NukiNetworkLock_lastRollingLogDetect == (NukiNetworkLock_lastRollingLog ^ ROLLING_LOG_DETECT))
+    {
+        _lastRollingLog = NukiNetworkLock_lastRollingLog;
+    }
+
     _network->registerMqttReceiver(this);
 }
 
@@ -34,6 +44,16 @@ NukiNetworkLock::~NukiNetworkLock()
 {
 }
 
+void NukiNetworkLock::readSettings()
+{
+    _haEnabled = _preferences->getString(preference_mqtt_hass_discovery, "") != "";
+    _disableNonJSON = _preferences->getBool(preference_disable_non_json, false);
+    _keypadPublishCode = _preferences->getBool(preference_keypad_publish_code, false);
+    _keypadTopicPerEntry = _preferences->getBool(preference_keypad_topic_per_entry, false);
+    _timeControlTopicPerEntry = _preferences->getBool(preference_timecontrol_topic_per_entry, false);
+    _authTopicPerEntry = _preferences->getBool(preference_auth_topic_per_entry, false);
+}
+
 void NukiNetworkLock::initialize()
 {
     String mqttPath = _preferences->getString(preference_mqtt_lock_path, "");
@@ -51,8 +71,29 @@ void NukiNetworkLock::initialize()
         _preferences->putString(preference_mqtt_lock_path, _mqttPath);
     }
 
-    _haEnabled = _preferences->getString(preference_mqtt_hass_discovery, "") != "";
-    _disableNonJSON = _preferences->getBool(preference_disable_non_json, false);
+    readSettings();
+
+    _nukiPublisher->internTopics({
+        mqtt_topic_lock_state,
+        mqtt_topic_lock_ha_state,
+        mqtt_topic_lock_binary_state,
+        mqtt_topic_lock_trigger,
+        mqtt_topic_lock_last_lock_action,
+        mqtt_topic_lock_completionStatus,
+        mqtt_topic_lock_door_sensor_state,
+        mqtt_topic_lock_json,
+        mqtt_topic_lock_status_updated,
+        mqtt_topic_lock_action,
+        mqtt_topic_lock_action_command_result,
+        mqtt_topic_query_lockstate_command_result,
+        mqtt_topic_lock_retry,
+        mqtt_topic_lock_rssi,
+        mqtt_topic_battery_critical,
+        mqtt_topic_battery_charging,
+        mqtt_topic_battery_level,
+        mqtt_topic_battery_keypad_critical,
+        mqtt_topic_battery_basic_json
+    });
 
     _network->initTopic(_mqttPath, mqtt_topic_lock_action, "--");
     _network->subscribe(_mqttPath, mqtt_topic_lock_action);
@@ -167,6 +208,7 @@ void NukiNetworkLock::initialize()
     _network->addReconnectedCallback([&]()
     {
         _reconnected = true;
+        _keypadCacheInvalidated = true;
     });
 }
 
@@ -182,206 +224,100 @@ void NukiNetworkLock::onMqttDataReceived(const char* topic, byte* payload, const
 {
     char* value = (char*)payload;
 
-    if(_network->mqttRecentlyConnected() && _network->pathEquals(_mqttPath, mqtt_topic_lock_action, topic))
-    {
-        Log->println("MQTT recently connected, ignoring lock action.");
-        return;
-    }
-
-    if(comparePrefixedPath(topic, mqtt_topic_reset) && strcmp(value, "1") == 0)
-    {
-        Log->println(F("Restart requested via MQTT."));
-        _network->clearWifiFallback();
-        delay(200);
-        restartEsp(RestartReason::RequestedViaMqtt);
-    }
-    else if(comparePrefixedPath(topic, mqtt_topic_update) && strcmp(value, "1") == 0 && _preferences->getBool(preference_update_from_mqtt, false))
+    if(_nukiOfficial->getOffEnabled())
     {
-        Log->println(F("Update requested via MQTT."));
-
-        bool otaManifestSuccess = false;
-        JsonDocument doc;
-
-        NetworkClientSecure *client = new NetworkClientSecure;
-        if (client) {
-            client->setCACertBundle(x509_crt_imported_bundle_bin_start, x509_crt_imported_bundle_bin_end - x509_crt_imported_bundle_bin_start);
-            {
-                HTTPClient https;
-                https.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-                https.useHTTP10(true);
-
-                if (https.begin(*client, GITHUB_OTA_MANIFEST_URL)) {
-                    int httpResponseCode = https.GET();
-
-                    if (httpResponseCode == HTTP_CODE_OK || httpResponseCode == HTTP_CODE_MOVED_PERMANENTLY)
-                    {
-                        DeserializationError jsonError = deserializeJson(doc, https.getStream());
-
-                        if (!jsonError) { otaManifestSuccess = true; }
-                    }
-                }
-                https.end();
-            }
-            delete client;
-        }
-
-        if (otaManifestSuccess)
+        for(auto offTopic : _nukiOfficial->getOffTopics())
         {
-            String currentVersion = NUKI_HUB_VERSION;
-
-            if(atof(doc["release"]["version"]) >= atof(currentVersion.c_str()))
-            {
-                if(strcmp(NUKI_HUB_VERSION, doc["release"]["fullversion"].as<const char*>()) == 0 && strcmp(NUKI_HUB_BUILD, doc["release"]["build"].as<const char*>()) == 0 && strcmp(NUKI_HUB_DATE, doc["release"]["time"].as<const char*>()) == 0)
-                {
-                    Log->println(F("Nuki Hub is already on the latest release version, OTA update aborted."));
-                }
-                else
-                {
-                    _preferences->putString(preference_ota_updater_url, GITHUB_LATEST_UPDATER_BINARY_URL);
-                    _preferences->putString(preference_ota_main_url, GITHUB_LATEST_RELEASE_BINARY_URL);
-                    Log->println(F("Updating to latest release version."));
-                    delay(200);
-                    restartEsp(RestartReason::OTAReboot);
-                }
-            }
-            else if(currentVersion.indexOf("beta") > 0)
-            {
-                if(strcmp(NUKI_HUB_VERSION, doc["beta"]["fullversion"].as<const char*>()) == 0 && strcmp(NUKI_HUB_BUILD, doc["beta"]["build"].as<const char*>()) == 0 && strcmp(NUKI_HUB_DATE, doc["beta"]["time"].as<const char*>()) == 0)
-                {
-                    Log->println(F("Nuki Hub is already on the latest beta version, OTA update aborted."));
-                }
-                else
-                {
-                    _preferences->putString(preference_ota_updater_url, GITHUB_BETA_RELEASE_BINARY_URL);
-                    _preferences->putString(preference_ota_main_url, GITHUB_BETA_UPDATER_BINARY_URL);
-                    Log->println(F("Updating to latest beta version."));
-                    delay(200);
-                    restartEsp(RestartReason::OTAReboot);
-                }
-            }
-            else if(currentVersion.indexOf("master") > 0)
-            {
-                if(strcmp(NUKI_HUB_VERSION, doc["master"]["fullversion"].as<const char*>()) == 0 && strcmp(NUKI_HUB_BUILD, doc["master"]["build"].as<const char*>()) == 0 && strcmp(NUKI_HUB_DATE, doc["master"]["time"].as<const char*>()) == 0)
-                {
-                    Log->println(F("Nuki Hub is already on the latest development version, OTA update aborted."));
-                }
-                else
-                {
-                    _preferences->putString(preference_ota_updater_url, GITHUB_MASTER_RELEASE_BINARY_URL);
-                    _preferences->putString(preference_ota_main_url, GITHUB_MASTER_UPDATER_BINARY_URL);
-                    Log->println(F("Updating to latest developmemt version."));
-                    delay(200);
-                    restartEsp(RestartReason::OTAReboot);
-                }
-            }
-            else
+            if(_nukiOfficial->comparePrefixedPath(topic, offTopic))
             {
-                if(strcmp(NUKI_HUB_VERSION, doc["release"]["fullversion"].as<const char*>()) == 0 && strcmp(NUKI_HUB_BUILD, doc["release"]["build"].as<const char*>()) == 0 && strcmp(NUKI_HUB_DATE, doc["release"]["time"].as<const char*>()) == 0)
-                {
-                    Log->println(F("Nuki Hub is already on the latest release version, OTA update aborted."));
-                }
-                else
+                if(_officialUpdateReceivedCallback != nullptr)
                 {
-                    _preferences->putString(preference_ota_updater_url, GITHUB_LATEST_UPDATER_BINARY_URL);
-                    _preferences->putString(preference_ota_main_url, GITHUB_LATEST_RELEASE_BINARY_URL);
-                    Log->println(F("Updating to latest release version."));
-                    delay(200);
-                    restartEsp(RestartReason::OTAReboot);
+                    _officialUpdateReceivedCallback(offTopic, value);
                 }
             }
         }
-        else
-        {
-            Log->println(F("Failed to retrieve OTA manifest, OTA update aborted."));
-        }
     }
-    else if(comparePrefixedPath(topic, mqtt_topic_webserver_action))
-    {
-        if(strcmp(value, "") == 0 ||
-           strcmp(value, "--") == 0) return;
 
-        if(strcmp(value, "1") == 0)
-        {
-            if(_preferences->getBool(preference_webserver_enabled, true) || forceEnableWebServer) return;
-            Log->println(F("Webserver enabled, restarting."));
-            _preferences->putBool(preference_webserver_enabled, true);
+    size_t prefixLen = strlen(_mqttPath);
+    if(strncmp(topic, _mqttPath, prefixLen) != 0) return;
 
-        }
-        else if (strcmp(value, "0") == 0)
-        {
-            if(!_preferences->getBool(preference_webserver_enabled, true) && !forceEnableWebServer) return;
-            Log->println(F("Webserver disabled, restarting."));
-            _preferences->putBool(preference_webserver_enabled, false);
-        }
+    const char* subPath = topic + prefixLen;
 
-        publishString(mqtt_topic_webserver_action, "--", true);
-        _network->clearWifiFallback();
-        delay(200);
-        restartEsp(RestartReason::ReconfigureWebServer);
-    }
-    else if(comparePrefixedPath(topic, mqtt_topic_lock_log_rolling_last))
+    // Each case verifies the full suffix, the hash only selects the candidate handler
+    switch(mqttTopicHash(subPath))
     {
-        if(strcmp(value, "") == 0 ||
-           strcmp(value, "--") == 0) return;
+        case mqttTopicHash(mqtt_topic_lock_action):
+            if(strcmp(subPath, mqtt_topic_lock_action) != 0) break;
 
-        if(atoi(value) > 0 && atoi(value) > _lastRollingLog) _lastRollingLog = atoi(value);
-    }
+            if(_network->mqttRecentlyConnected())
+            {
+                Log->println("MQTT recently connected, ignoring lock action.");
+                break;
+            }
 
-    if(_nukiOfficial->getOffEnabled())
-    {
-        for(auto offTopic : _nukiOfficial->getOffTopics())
-        {
-            if(_nukiOfficial->comparePrefixedPath(topic, offTopic))
+            if(strcmp(value, "") == 0 ||
+               strcmp(value, "--") == 0 ||
+               strcmp(value, "ack") == 0 ||
+               strcmp(value, "unknown_action") == 0 ||
+               strcmp(value, "denied") == 0 ||
+               strcmp(value, "error") == 0) break;
+
+            Log->print(F("Lock action received: "));
+            Log->println(value);
+            onLockActionReceived(value);
+            break;
+        case mqttTopicHash(mqtt_topic_reset):
+            if(strcmp(subPath, mqtt_topic_reset) != 0 || strcmp(value, "1") != 0) break;
+
+            Log->println(F("Restart requested via MQTT."));
+            _network->clearWifiFallback();
+            delay(200);
+            restartEsp(RestartReason::RequestedViaMqtt);
+            break;
+        case mqttTopicHash(mqtt_topic_update):
+            if(strcmp(subPath, mqtt_topic_update) != 0 || strcmp(value, "1") != 0 || !_preferences->getBool(preference_update_from_mqtt, false)) break;
+
+            onUpdateRequested();
+            break;
+        case mqttTopicHash(mqtt_topic_webserver_action):
+            if(strcmp(subPath, mqtt_topic_webserver_action) != 0) break;
+
+            if(strcmp(value, "") == 0 ||
+               strcmp(value, "--") == 0) break;
+
+            if(strcmp(value, "1") == 0)
             {
-                if(_officialUpdateReceivedCallback != nullptr)
-                {
-                    _officialUpdateReceivedCallback(offTopic, value);
-                }
+                if(_preferences->getBool(preference_webserver_enabled, true) || forceEnableWebServer) break;
+                Log->println(F("Webserver enabled, restarting."));
+                _preferences->putBool(preference_webserver_enabled, true);
+
+            }
+            else if (strcmp(value, "0") == 0)
+            {
+                if(!_preferences->getBool(preference_webserver_enabled, true) && !forceEnableWebServer) break;
+                Log->println(F("Webserver disabled, restarting."));
+                _preferences->putBool(preference_webserver_enabled, false);
             }
-        }
-    }
 
-    if(comparePrefixedPath(topic, mqtt_topic_lock_action))
-    {
-        if(strcmp(value, "") == 0 ||
-           strcmp(value, "--") == 0 ||
-           strcmp(value, "ack") == 0 ||
-           strcmp(value, "unknown_action") == 0 ||
-           strcmp(value, "denied") == 0 ||
-           strcmp(value, "error") == 0) return;
-
-        Log->print(F("Lock action received: "));
-        Log->println(value);
-        LockActionResult lockActionResult = LockActionResult::Failed;
-        if(_lockActionReceivedCallback != NULL)
-        {
-            lockActionResult = _lockActionReceivedCallback(value);
-        }
+            publishString(mqtt_topic_webserver_action, "--", true);
+            _network->clearWifiFallback();
+            delay(200);
+            restartEsp(RestartReason::ReconfigureWebServer);
+            break;
+        case mqttTopicHash(mqtt_topic_lock_log_rolling_last):
+            if(strcmp(subPath, mqtt_topic_lock_log_rolling_last) != 0) break;
 
-        switch(lockActionResult)
-        {
-            case LockActionResult::Success:
-                publishString(mqtt_topic_lock_action, "ack", false);
-                break;
-            case LockActionResult::UnknownAction:
-                publishString(mqtt_topic_lock_action, "unknown_action", false);
-                break;
-            case LockActionResult::AccessDenied:
-                publishString(mqtt_topic_lock_action, "denied", false);
-                break;
-            case LockActionResult::Failed:
-                publishString(mqtt_topic_lock_action, "error", false);
-                break;
-        }
-    }
+            if(strcmp(value, "") == 0 ||
+               strcmp(value, "--") == 0) break;
+
+            if(atoi(value) > 0 && atoi(value) > _lastRollingLog) setLastRollingLog(atoi(value));
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_command_action):
+            if(strcmp(subPath, mqtt_topic_keypad_command_action) != 0 || _disableNonJSON) break;
 
-    if(!_disableNonJSON)
-    {
-        if(comparePrefixedPath(topic, mqtt_topic_keypad_command_action))
-        {
             if(_keypadCommandReceivedReceivedCallback != nullptr)
             {
-                if(strcmp(value, "--") == 0) return;
+                if(strcmp(value, "--") == 0) break;
 
                 _keypadCommandReceivedReceivedCallback(value, _keypadCommandId, _keypadCommandName, _keypadCommandCode, _keypadCommandEnabled);
 
@@ -390,101 +326,221 @@ void NukiNetworkLock::onMqttDataReceived(const char* topic, byte* payload, const
                 _keypadCommandCode = "000000";
                 _keypadCommandEnabled = 1;
 
-                if(strcmp(value, "--") != 0)
-                {
-                    publishString(mqtt_topic_keypad_command_action, "--", true);
-                }
+                publishString(mqtt_topic_keypad_command_action, "--", true);
                 publishInt(mqtt_topic_keypad_command_id, _keypadCommandId, true);
                 publishString(mqtt_topic_keypad_command_name, _keypadCommandName, true);
                 publishString(mqtt_topic_keypad_command_code, _keypadCommandCode, true);
                 publishInt(mqtt_topic_keypad_command_enabled, _keypadCommandEnabled, true);
             }
-        }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_id))
-        {
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_command_id):
+            if(strcmp(subPath, mqtt_topic_keypad_command_id) != 0 || _disableNonJSON) break;
             _keypadCommandId = atoi(value);
-        }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_name))
-        {
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_command_name):
+            if(strcmp(subPath, mqtt_topic_keypad_command_name) != 0 || _disableNonJSON) break;
             _keypadCommandName = value;
-        }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_code))
-        {
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_command_code):
+            if(strcmp(subPath, mqtt_topic_keypad_command_code) != 0 || _disableNonJSON) break;
             _keypadCommandCode = value;
-        }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_enabled))
-        {
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_command_enabled):
+            if(strcmp(subPath, mqtt_topic_keypad_command_enabled) != 0 || _disableNonJSON) break;
             _keypadCommandEnabled = atoi(value);
-        }
-    }
+            break;
+        case mqttTopicHash(mqtt_topic_query_config):
+            if(strcmp(subPath, mqtt_topic_query_config) != 0 || strcmp(value, "1") != 0) break;
+            _queryCommands = _queryCommands | QUERY_COMMAND_CONFIG;
+            publishString(mqtt_topic_query_config, "0", true);
+            break;
+        case mqttTopicHash(mqtt_topic_query_lockstate):
+            if(strcmp(subPath, mqtt_topic_query_lockstate) != 0 || strcmp(value, "1") != 0) break;
+            _queryCommands = _queryCommands | QUERY_COMMAND_LOCKSTATE;
+            publishString(mqtt_topic_query_lockstate, "0", true);
+            break;
+        case mqttTopicHash(mqtt_topic_query_keypad):
+            if(strcmp(subPath, mqtt_topic_query_keypad) != 0 || strcmp(value, "1") != 0) break;
+            _queryCommands = _queryCommands | QUERY_COMMAND_KEYPAD;
+            publishString(mqtt_topic_query_keypad, "0", true);
+            break;
+        case mqttTopicHash(mqtt_topic_query_battery):
+            if(strcmp(subPath, mqtt_topic_query_battery) != 0 || strcmp(value, "1") != 0) break;
+            _queryCommands = _queryCommands | QUERY_COMMAND_BATTERY;
+            publishString(mqtt_topic_query_battery, "0", true);
+            break;
+        case mqttTopicHash(mqtt_topic_config_action):
+            if(strcmp(subPath, mqtt_topic_config_action) != 0) break;
+            if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) break;
 
-    if(comparePrefixedPath(topic, mqtt_topic_query_config) && strcmp(value, "1") == 0)
-    {
-        _queryCommands = _queryCommands | QUERY_COMMAND_CONFIG;
-        publishString(mqtt_topic_query_config, "0", true);
-    }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_lockstate) && strcmp(value, "1") == 0)
-    {
-        _queryCommands = _queryCommands | QUERY_COMMAND_LOCKSTATE;
-        publishString(mqtt_topic_query_lockstate, "0", true);
+            if(_configUpdateReceivedCallback != NULL)
+            {
+                _configUpdateReceivedCallback(value);
+            }
+
+            publishString(mqtt_topic_config_action, "--", true);
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_json_action):
+            if(strcmp(subPath, mqtt_topic_keypad_json_action) != 0) break;
+            if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) break;
+
+            if(_keypadJsonCommandReceivedReceivedCallback != NULL)
+            {
+                _keypadJsonCommandReceivedReceivedCallback(value);
+            }
+
+            publishString(mqtt_topic_keypad_json_action, "--", true);
+            break;
+        case mqttTopicHash(mqtt_topic_timecontrol_action):
+            if(strcmp(subPath, mqtt_topic_timecontrol_action) != 0) break;
+            if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) break;
+
+            if(_timeControlCommandReceivedReceivedCallback != NULL)
+            {
+                _timeControlCommandReceivedReceivedCallback(value);
+            }
+
+            publishString(mqtt_topic_timecontrol_action, "--", true);
+            break;
+        case mqttTopicHash(mqtt_topic_auth_action):
+            if(strcmp(subPath, mqtt_topic_auth_action) != 0) break;
+            if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) break;
+
+            if(_authCommandReceivedReceivedCallback != NULL)
+            {
+                _authCommandReceivedReceivedCallback(value);
+            }
+
+            publishString(mqtt_topic_auth_action, "--", true);
+            break;
+        default:
+            break;
     }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_keypad) && strcmp(value, "1") == 0)
+}
+
+void NukiNetworkLock::onLockActionReceived(const char* value)
+{
+    LockActionResult lockActionResult = LockActionResult::Failed;
+    if(_lockActionReceivedCallback != NULL)
     {
-        _queryCommands = _queryCommands | QUERY_COMMAND_KEYPAD;
-        publishString(mqtt_topic_query_keypad, "0", true);
+        lockActionResult = _lockActionReceivedCallback(value);
     }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_battery) && strcmp(value, "1") == 0)
+
+    switch(lockActionResult)
     {
-        _queryCommands = _queryCommands | QUERY_COMMAND_BATTERY;
-        publishString(mqtt_topic_query_battery, "0", true);
+        case LockActionResult::Success:
+            publishString(mqtt_topic_lock_action, "ack", false);
+            break;
+        case LockActionResult::UnknownAction:
+            publishString(mqtt_topic_lock_action, "unknown_action", false);
+            break;
+        case LockActionResult::AccessDenied:
+            publishString(mqtt_topic_lock_action, "denied", false);
+            break;
+        case LockActionResult::Failed:
+            publishString(mqtt_topic_lock_action, "error", false);
+            break;
     }
+}
 
-    if(comparePrefixedPath(topic, mqtt_topic_config_action))
-    {
-        if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) return;
+void NukiNetworkLock::onUpdateRequested()
+{
+    Log->println(F("Update requested via MQTT."));
+
+    bool otaManifestSuccess = false;
+    JsonDocument doc;
 
-        if(_configUpdateReceivedCallback != NULL)
+    NetworkClientSecure *client = new NetworkClientSecure;
+    if (client) {
+        client->setCACertBundle(x509_crt_imported_bundle_bin_start, x509_crt_imported_bundle_bin_end - x509_crt_imported_bundle_bin_start);
         {
-            _configUpdateReceivedCallback(value);
-        }
+            HTTPClient https;
+            https.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
+            https.useHTTP10(true);
 
-        publishString(mqtt_topic_config_action, "--", true);
-    }
+            if (https.begin(*client, GITHUB_OTA_MANIFEST_URL)) {
+                int httpResponseCode = https.GET();
 
-    if(comparePrefixedPath(topic, mqtt_topic_keypad_json_action))
-    {
-        if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) return;
+                if (httpResponseCode == HTTP_CODE_OK || httpResponseCode == HTTP_CODE_MOVED_PERMANENTLY)
+                {
+                    DeserializationError jsonError = deserializeJson(doc, https.getStream());
 
-        if(_keypadJsonCommandReceivedReceivedCallback != NULL)
-        {
-            _keypadJsonCommandReceivedReceivedCallback(value);
+                    if (!jsonError) { otaManifestSuccess = true; }
+                }
+            }
+            https.end();
         }
-
-        publishString(mqtt_topic_keypad_json_action, "--", true);
+        delete client;
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_timecontrol_action))
+    if (otaManifestSuccess)
     {
-        if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) return;
+        String currentVersion = NUKI_HUB_VERSION;
 
-        if(_timeControlCommandReceivedReceivedCallback != NULL)
+        if(atof(doc["release"]["version"]) >= atof(currentVersion.c_str()))
         {
-            _timeControlCommandReceivedReceivedCallback(value);
+            if(strcmp(NUKI_HUB_VERSION, doc["release"]["fullversion"].as<const char*>()) == 0 && strcmp(NUKI_HUB_BUILD, doc["release"]["build"].as<const char*>()) == 0 && strcmp(NUKI_HUB_DATE, doc["release"]["time"].as<const char*>()) == 0)
+            {
+                Log->println(F("Nuki Hub is already on the latest release version, OTA update aborted."));
+            }
+            else
+            {
+                _preferences->putString(preference_ota_updater_url, GITHUB_LATEST_UPDATER_BINARY_URL);
+                _preferences->putString(preference_ota_main_url, GITHUB_LATEST_RELEASE_BINARY_URL);
+                Log->println(F("Updating to latest release version."));
+                delay(200);
+                restartEsp(RestartReason::OTAReboot);
+            }
         }
-
-        publishString(mqtt_topic_timecontrol_action, "--", true);
-    }
-
-    if(comparePrefixedPath(topic, mqtt_topic_auth_action))
-    {
-        if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) return;
-
-        if(_authCommandReceivedReceivedCallback != NULL)
+        else if(currentVersion.indexOf("beta") > 0)
+        {
+            if(strcmp(NUKI_HUB_VERSION, doc["beta"]["fullversion"].as<const char*>()) == 0 && strcmp(NUKI_HUB_BUILD, doc["beta"]["build"].as<const char*>()) == 0 && strcmp(NUKI_HUB_DATE, doc["beta"]["time"].as<const char*>()) == 0)
+            {
+                Log->println(F("Nuki Hub is already on the latest beta version, OTA update aborted."));
+            }
+            else
+            {
+                _preferences->putString(preference_ota_updater_url, GITHUB_BETA_RELEASE_BINARY_URL);
+                _preferences->putString(preference_ota_main_url, GITHUB_BETA_UPDATER_BINARY_URL);
+                Log->println(F("Updating to latest beta version."));
+                delay(200);
+                restartEsp(RestartReason::OTAReboot);
+            }
+        }
+        else if(currentVersion.indexOf("master") > 0)
         {
-            _authCommandReceivedReceivedCallback(value);
+            if(strcmp(NUKI_HUB_VERSION, doc["master"]["fullversion"].as<const char*>()) == 0 && strcmp(NUKI_HUB_BUILD, doc["master"]["build"].as<const char*>()) == 0 && strcmp(NUKI_HUB_DATE, doc["master"]["time"].as<const char*>()) == 0)
+            {
+                Log->println(F("Nuki Hub is already on the latest development version, OTA update aborted."));
+            }
+            else
+            {
+                _preferences->putString(preference_ota_updater_url, GITHUB_MASTER_RELEASE_BINARY_URL);
+                _preferences->putString(preference_ota_main_url, GITHUB_MASTER_UPDATER_BINARY_URL);
+                Log->println(F("Updating to latest developmemt version."));
+                delay(200);
+                restartEsp(RestartReason::OTAReboot);
+            }
         }
-
-        publishString(mqtt_topic_auth_action, "--", true);
+        else
+        {
+            if(strcmp(NUKI_HUB_VERSION, doc["release"]["fullversion"].as<const char*>()) == 0 && strcmp(NUKI_HUB_BUILD, doc["release"]["build"].as<const char*>()) == 0 && strcmp(NUKI_HUB_DATE, doc["release"]["time"].as<const char*>()) == 0)
+            {
+                Log->println(F("Nuki Hub is already on the latest release version, OTA update aborted."));
+            }
+            else
+            {
+                _preferences->putString(preference_ota_updater_url, GITHUB_LATEST_UPDATER_BINARY_URL);
+                _preferences->putString(preference_ota_main_url, GITHUB_LATEST_RELEASE_BINARY_URL);
+                Log->println(F("Updating to latest release version."));
+                delay(200);
+                restartEsp(RestartReason::OTAReboot);
+            }
+        }
+    }
+    else
+    {
+        Log->println(F("Failed to retrieve OTA manifest, OTA update aborted."));
     }
 }
 
@@ -493,8 +549,9 @@ void NukiNetworkLock::publishKeyTurnerState(const NukiLock::KeyTurnerState& keyT
     char str[50];
     memset(&str, 0, sizeof(str));
 
-    JsonDocument json;
-    JsonDocument jsonBattery;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::KeyTurnerState);
+    JsonDocument json(&_jsonArena);
+    JsonDocument jsonBattery(&_jsonArena);
 
     if(!_nukiOfficial->getOffConnected())
     {
@@ -677,7 +734,8 @@ void NukiNetworkLock::publishAuthorizationInfo(const std::list<NukiLock::LogEntr
     char authName[33];
     uint32_t authIndex = 0;
 
-    JsonDocument json;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::AuthorizationInfo);
+    JsonDocument json(&_jsonArena);
 
     for(const auto& log : logEntries)
     {
@@ -797,7 +855,7 @@ void NukiNetworkLock::publishAuthorizationInfo(const std::list<NukiLock::LogEntr
 
         if(log.index > _lastRollingLog)
         {
-            _lastRollingLog = log.index;
+            setLastRollingLog(log.index);
             serializeJson(entry, _buffer, _bufferSize);
             publishString(mqtt_topic_lock_log_rolling, _buffer, true);
             publishInt(mqtt_topic_lock_log_rolling_last, log.index, true);
@@ -846,7 +904,8 @@ void NukiNetworkLock::publishBatteryReport(const NukiLock::BatteryReport& batter
     char str[50];
     memset(&str, 0, sizeof(str));
 
-    JsonDocument json;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::BatteryReport);
+    JsonDocument json(&_jsonArena);
 
     json["batteryDrain"] = batteryReport.batteryDrain;
     json["batteryVoltage"] = (float)batteryReport.batteryVoltage / 1000.0;
@@ -865,6 +924,31 @@ void NukiNetworkLock::publishBatteryReport(const NukiLock::BatteryReport& batter
 }
 
 void NukiNetworkLock::publishConfig(const NukiLock::Config &config)
+{
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::Config);
+    JsonDocument json(&_jsonArena);
+
+    memset(_nukiName, 0, sizeof(_nukiName));
+    memcpy(_nukiName, config.name, sizeof(config.name));
+
+    configToJson(config, json.to<JsonObject>());
+
+    serializeJson(json, _buffer, _bufferSize);
+    publishString(mqtt_topic_config_basic_json, _buffer, true);
+
+    if(!_disableNonJSON)
+    {
+        publishBool(mqtt_topic_config_button_enabled, config.buttonEnabled == 1, true);
+        publishBool(mqtt_topic_config_led_enabled, config.ledEnabled == 1, true);
+        publishInt(mqtt_topic_config_led_brightness, config.ledBrightness, true);
+        publishBool(mqtt_topic_config_single_lock, config.singleLock == 1, true);
+    }
+
+    publishString(mqtt_topic_info_firmware_version, std::to_string(config.firmwareVersion[0]) + "." + std::to_string(config.firmwareVersion[1]) + "." + std::to_string(config.firmwareVersion[2]), true);
+    publishString(mqtt_topic_info_hardware_version, std::to_string(config.hardwareRevision[0]) + "." + std::to_string(config.hardwareRevision[1]), true);
+}
+
+void NukiNetworkLock::configToJson(const NukiLock::Config &config, JsonObject json)
 {
     char str[50];
     char curTime[20];
@@ -872,11 +956,6 @@ void NukiNetworkLock::publishConfig(const NukiLock::Config &config)
     char uidString[20];
     itoa(config.nukiId, uidString, 16);
 
-    JsonDocument json;
-
-    memset(_nukiName, 0, sizeof(_nukiName));
-    memcpy(_nukiName, config.name, sizeof(config.name));
-
     json["nukiID"] = uidString;
     json["name"] = config.name;
     //json["latitude"] = config.latitude;
@@ -913,23 +992,26 @@ void NukiNetworkLock::publishConfig(const NukiLock::Config &config)
     memset(str, 0, sizeof(str));
     _network->timeZoneIdToString(config.timeZoneId, str);
     json["timeZone"] = str;
+}
+
+void NukiNetworkLock::publishAdvancedConfig(const NukiLock::AdvancedConfig &config)
+{
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::AdvancedConfig);
+    JsonDocument json(&_jsonArena);
+
+    advancedConfigToJson(config, json.to<JsonObject>());
 
     serializeJson(json, _buffer, _bufferSize);
-    publishString(mqtt_topic_config_basic_json, _buffer, true);
+    publishString(mqtt_topic_config_advanced_json, _buffer, true);
 
     if(!_disableNonJSON)
     {
-        publishBool(mqtt_topic_config_button_enabled, config.buttonEnabled == 1, true);
-        publishBool(mqtt_topic_config_led_enabled, config.ledEnabled == 1, true);
-        publishInt(mqtt_topic_config_led_brightness, config.ledBrightness, true);
-        publishBool(mqtt_topic_config_single_lock, config.singleLock == 1, true);
+        publishBool(mqtt_topic_config_auto_unlock, config.autoUnLockDisabled == 0, true);
+        publishBool(mqtt_topic_config_auto_lock, config.autoLockEnabled == 1, true);
     }
-
-    publishString(mqtt_topic_info_firmware_version, std::to_string(config.firmwareVersion[0]) + "." + std::to_string(config.firmwareVersion[1]) + "." + std::to_string(config.firmwareVersion[2]), true);
-    publishString(mqtt_topic_info_hardware_version, std::to_string(config.hardwareRevision[0]) + "." + std::to_string(config.hardwareRevision[1]), true);
 }
 
-void NukiNetworkLock::publishAdvancedConfig(const NukiLock::AdvancedConfig &config)
+void NukiNetworkLock::advancedConfigToJson(const NukiLock::AdvancedConfig &config, JsonObject json)
 {
     char str[50];
     char nmst[6];
@@ -937,8 +1019,6 @@ void NukiNetworkLock::publishAdvancedConfig(const NukiLock::AdvancedConfig &conf
     char nmet[6];
     sprintf(nmet, "%02d:%02d", config.nightModeEndTime[0], config.nightModeEndTime[1]);
 
-    JsonDocument json;
-
     json["totalDegrees"] = config.totalDegrees;
     json["unlockedPositionOffsetDegrees"] = config.unlockedPositionOffsetDegrees;
     json["lockedPositionOffsetDegrees"] = config.lockedPositionOffsetDegrees;
@@ -968,15 +1048,6 @@ void NukiNetworkLock::publishAdvancedConfig(const NukiLock::AdvancedConfig &conf
     json["autoLockEnabled"] = config.autoLockEnabled;
     json["immediateAutoLockEnabled"] = config.immediateAutoLockEnabled;
     json["autoUpdateEnabled"] = config.autoUpdateEnabled;
-
-    serializeJson(json, _buffer, _bufferSize);
-    publishString(mqtt_topic_config_advanced_json, _buffer, true);
-
-    if(!_disableNonJSON)
-    {
-        publishBool(mqtt_topic_config_auto_unlock, config.autoUnLockDisabled == 0, true);
-        publishBool(mqtt_topic_config_auto_lock, config.autoLockEnabled == 1, true);
-    }
 }
 
 void NukiNetworkLock::publishRssi(const int& rssi)
@@ -996,20 +1067,59 @@ void NukiNetworkLock::publishBleAddress(const std::string &address)
 
 void NukiNetworkLock::publishKeypad(const std::list<NukiLock::KeypadEntry>& entries, uint maxKeypadCodeCount)
 {
-    bool publishCode = _preferences->getBool(preference_keypad_publish_code, false);
-    bool topicPerEntry = _preferences->getBool(preference_keypad_topic_per_entry, false);
+    bool publishCode = _keypadPublishCode;
+    bool topicPerEntry = _keypadTopicPerEntry;
     uint index = 0;
     char uidString[20];
     itoa(_preferences->getUInt(preference_nuki_id_lock, 0), uidString, 16);
-    String baseTopic = _preferences->getString(preference_mqtt_lock_path);
-    JsonDocument json;
+    const uint8_t publishFlags = (publishCode ? 1 : 0) | (topicPerEntry ? 2 : 0) | (_disableNonJSON ? 4 : 0);
+
+    if(_keypadCacheInvalidated)
+    {
+        // The broker may have lost its retained messages while MQTT was disconnected
+        _keypadCacheInvalidated = false;
+        _keypadPublished = false;
+        _keypadEntryHashes.clear();
+    }
+
+    // Codes published before have to be removed as soon as publishing them is turned off
+    const bool removeCodes = !publishCode && (!_keypadPublished || (_keypadPublishedFlags & 1) != 0);
+    const bool removeNonJSON = _disableNonJSON && (!_keypadPublished || (_keypadPublishedFlags & 4) == 0);
+
+    // Only entries that were added or changed since the last refresh are republished, the JSON array only when anything changed
+    std::vector<uint32_t> entryHashes;
+    entryHashes.reserve(entries.size());
+    bool changed = !_keypadPublished || publishFlags != _keypadPublishedFlags || entries.size() != _keypadEntryHashes.size() || maxKeypadCodeCount != _keypadPublishedMaxCount;
 
     for(const auto& entry : entries)
     {
+        uint32_t hash = mqttPayloadHash(&entry, sizeof(entry), mqttPayloadHash(&publishFlags, sizeof(publishFlags)));
+        if(entryHashes.size() >= _keypadEntryHashes.size() || _keypadEntryHashes[entryHashes.size()] != hash) changed = true;
+        entryHashes.push_back(hash);
+    }
+
+    if(!changed)
+    {
+        Log->println(F("Keypad entries unchanged, skipping publish"));
+        return;
+    }
+
+    const size_t previousEntryCount = _keypadPublished ? _keypadEntryHashes.size() : maxKeypadCodeCount;
+    uint entriesPublished = 0;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::Keypad);
+    JsonDocument json(&_jsonArena);
+
+    for(const auto& entry : entries)
+    {
+        const bool entryChanged = index >= _keypadEntryHashes.size() || _keypadEntryHashes[index] != entryHashes[index];
         String basePath = mqtt_topic_keypad;
         basePath.concat("/code_");
         basePath.concat(std::to_string(index).c_str());
-        publishKeypadEntry(basePath, entry);
+        if(entryChanged)
+        {
+            publishKeypadEntry(basePath, entry);
+            ++entriesPublished;
+        }
 
         auto jsonEntry = json.add<JsonVariant>();
 
@@ -1088,7 +1198,7 @@ void NukiNetworkLock::publishKeypad(const std::list<NukiLock::KeypadEntry>& entr
         sprintf(allowedUntilTimeT, "%02d:%02d", entry.allowedUntilTimeHour, entry.allowedUntilTimeMin);
         jsonEntry["allowedUntilTime"] = allowedUntilTimeT;
 
-        if(topicPerEntry)
+        if(topicPerEntry && entryChanged)
         {
             basePath = mqtt_topic_keypad;
             basePath.concat("/codes/");
@@ -1118,7 +1228,7 @@ void NukiNetworkLock::publishKeypad(const std::list<NukiLock::KeypadEntry>& entr
                              uidStringPostfix.c_str(),
                              displayName.c_str(),
                              _nukiName,
-                             baseTopic.c_str(),
+                             _mqttPath,
                              String("~") + basePath.c_str(),
                              (char*)"SmartLock",
                              "",
@@ -1141,7 +1251,8 @@ void NukiNetworkLock::publishKeypad(const std::list<NukiLock::KeypadEntry>& entr
 
     if(!_disableNonJSON)
     {
-        while(index < maxKeypadCodeCount)
+        // slots beyond the entries only need clearing when they held an entry before
+        while(index < maxKeypadCodeCount && index < previousEntryCount)
         {
             NukiLock::KeypadEntry entry;
             memset(&entry, 0, sizeof(entry));
@@ -1153,7 +1264,7 @@ void NukiNetworkLock::publishKeypad(const std::list<NukiLock::KeypadEntry>& entr
             ++index;
         }
 
-        if(!publishCode)
+        if(removeCodes)
         {
             for(int i=0; i<maxKeypadCodeCount; i++)
             {
@@ -1166,7 +1277,7 @@ void NukiNetworkLock::publishKeypad(const std::list<NukiLock::KeypadEntry>& entr
             }
         }
     }
-    else
+    else if(removeNonJSON)
     {
         for(int i=0; i<maxKeypadCodeCount; i++)
         {
@@ -1187,8 +1298,11 @@ void NukiNetworkLock::publishKeypad(const std::list<NukiLock::KeypadEntry>& entr
             _network->removeTopic(codeTopic, "createdSec");
             _network->removeTopic(codeTopic, "lockCount");
         }
+    }
 
-        for(int j=entries.size(); j<maxKeypadCodeCount; j++)
+    if(_disableNonJSON)
+    {
+        for(int j=entries.size(); j<maxKeypadCodeCount && j<previousEntryCount; j++)
         {
             String codesTopic = _mqttPath;
             codesTopic.concat(mqtt_topic_keypad_codes);
@@ -1197,9 +1311,19 @@ void NukiNetworkLock::publishKeypad(const std::list<NukiLock::KeypadEntry>& entr
             codeTopic.concat(std::to_string(j).c_str());
             _network->removeTopic(codesTopic, codeTopic);
             std::string mqttDeviceName = std::string("keypad_") + std::to_string(j);
-            _network->removeHassTopic((char*)"switch", (char*)mqttDeviceName.c_str(), uidString);
+            _network->removeHassTopic("switch", mqttDeviceName.c_str(), uidString);
         }
     }
+
+    _keypadEntryHashes = std::move(entryHashes);
+    _keypadPublishedMaxCount = maxKeypadCodeCount;
+    _keypadPublishedFlags = publishFlags;
+    _keypadPublished = true;
+
+    Log->print(F("Keypad entries republished: "));
+    Log->print(entriesPublished);
+    Log->print(F(" of "));
+    Log->println(entries.size());
 }
 
 void NukiNetworkLock::publishKeypadEntry(const String topic, NukiLock::KeypadEntry entry)
@@ -1214,7 +1338,7 @@ void NukiNetworkLock::publishKeypadEntry(const String topic, NukiLock::KeypadEnt
     publishBool(concat(topic, "/enabled").c_str(), entry.enabled, true);
     publishString(concat(topic, "/name").c_str(), codeName, true);
 
-    if(_preferences->getBool(preference_keypad_publish_code, false))
+    if(_keypadPublishCode)
     {
         publishInt(concat(topic, "/code").c_str(), entry.code, true);
     }
@@ -1230,13 +1354,13 @@ void NukiNetworkLock::publishKeypadEntry(const String topic, NukiLock::KeypadEnt
 
 void NukiNetworkLock::publishTimeControl(const std::list<NukiLock::TimeControlEntry>& timeControlEntries, uint maxTimeControlEntryCount)
 {
-    bool topicPerEntry = _preferences->getBool(preference_timecontrol_topic_per_entry, false);
+    bool topicPerEntry = _timeControlTopicPerEntry;
     uint index = 0;
     char str[50];
     char uidString[20];
     itoa(_preferences->getUInt(preference_nuki_id_lock, 0), uidString, 16);
-    String baseTopic = _preferences->getString(preference_mqtt_lock_path);
-    JsonDocument json;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::TimeControl);
+    JsonDocument json(&_jsonArena);
 
     for(const auto& entry : timeControlEntries)
     {
@@ -1326,7 +1450,7 @@ void NukiNetworkLock::publishTimeControl(const std::list<NukiLock::TimeControlEn
                              uidStringPostfix.c_str(),
                              displayName.c_str(),
                              _nukiName,
-                             baseTopic.c_str(),
+                             _mqttPath,
                              String("~") + basePath.c_str(),
                              (char*)"SmartLock",
                              "",
@@ -1354,7 +1478,7 @@ void NukiNetworkLock::publishTimeControl(const std::list<NukiLock::TimeControlEn
         entriesTopic.concat("/");
         _network->removeTopic(entriesTopic, (char*)std::to_string(j).c_str());
         std::string mqttDeviceName = std::string("timecontrol_") + std::to_string(j);
-        _network->removeHassTopic((char*)"switch", (char*)mqttDeviceName.c_str(), uidString);
+        _network->removeHassTopic("switch", mqttDeviceName.c_str(), uidString);
     }
 }
 
@@ -1364,8 +1488,8 @@ void NukiNetworkLock::publishAuth(const std::list<NukiLock::AuthorizationEntry>&
     char str[50];
     char uidString[20];
     itoa(_preferences->getUInt(preference_nuki_id_lock, 0), uidString, 16);
-    String baseTopic = _preferences->getString(preference_mqtt_lock_path);
-    JsonDocument json;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::Auth);
+    JsonDocument json(&_jsonArena);
 
     for(const auto& entry : authEntries)
     {
@@ -1447,7 +1571,7 @@ void NukiNetworkLock::publishAuth(const std::list<NukiLock::AuthorizationEntry>&
         sprintf(allowedUntilTimeT, "%02d:%02d", entry.allowedUntilTimeHour, entry.allowedUntilTimeMin);
         jsonEntry["allowedUntilTime"] = allowedUntilTimeT;
 
-        if(_preferences->getBool(preference_auth_topic_per_entry, false))
+        if(_authTopicPerEntry)
         {
             String basePath = mqtt_topic_auth;
             basePath.concat("/entries/");
@@ -1473,7 +1597,7 @@ void NukiNetworkLock::publishAuth(const std::list<NukiLock::AuthorizationEntry>&
                              uidStringPostfix.c_str(),
                              displayName.c_str(),
                              _nukiName,
-                             baseTopic.c_str(),
+                             _mqttPath,
                              String("~") + basePath.c_str(),
                              (char*)"SmartLock",
                              "",
@@ -1501,7 +1625,7 @@ void NukiNetworkLock::publishAuth(const std::list<NukiLock::AuthorizationEntry>&
         entriesTopic.concat("/");
         _network->removeTopic(entriesTopic, (char*)std::to_string(j).c_str());
         std::string mqttDeviceName = std::string("auth_") + std::to_string(j);
-        _network->removeHassTopic((char*)"switch", (char*)mqttDeviceName.c_str(), uidString);
+        _network->removeHassTopic("switch", mqttDeviceName.c_str(), uidString);
     }
 }
 
@@ -1572,41 +1696,8 @@ void NukiNetworkLock::setAuthCommandReceivedCallback(void (*authCommandReceivedR
     _authCommandReceivedReceivedCallback = authCommandReceivedReceivedCallback;
 }
 
-void NukiNetworkLock::buildMqttPath(const char* path, char* outPath)
-{
-    int offset = 0;
-    char inPath[181] = {0};
-
-    memcpy(inPath, _mqttPath, sizeof(_mqttPath));
-
-    for(const char& c : inPath)
-    {
-        if(c == 0x00)
-        {
-            break;
-        }
-        outPath[offset] = c;
-        ++offset;
-    }
-    int i=0;
-    while(outPath[i] != 0x00)
-    {
-        outPath[offset] = path[i];
-        ++i;
-        ++offset;
-    }
-    outPath[i+1] = 0x00;
-}
-
-bool NukiNetworkLock::comparePrefixedPath(const char *fullPath, const char *subPath)
-{
-    char prefixedPath[500];
-    buildMqttPath(subPath, prefixedPath);
-    return strcmp(fullPath, prefixedPath) == 0;
-}
-
-void NukiNetworkLock::publishHASSConfig(char *deviceType, const char *baseTopic, char *name,  char *uidString, const char *softwareVersion, const char *hardwareVersion, const bool& hasDoorSensor, const bool& hasKeypad, const bool& publishAuthData, char *lockAction,
-                               char *unlockAction, char *openAction)
+void NukiNetworkLock::publishHASSConfig(const char *deviceType, const char *baseTopic, const char *name, const char *uidString, const char *softwareVersion, const char *hardwareVersion, const bool& hasDoorSensor, const bool& hasKeypad, const bool& publishAuthData, const char *lockAction,
+                               const char *unlockAction, const char *openAction)
 {
     _network->publishHASSConfig(deviceType, baseTopic, name, uidString, softwareVersion, hardwareVersion, "~/maintenance/mqttConnectionState", hasKeypad, lockAction, unlockAction, openAction);
     _network->publishHASSConfigAdditionalLockEntities(deviceType, baseTopic, name, uidString);
@@ -1617,7 +1708,7 @@ void NukiNetworkLock::publishHASSConfig(char *deviceType, const char *baseTopic,
     }
     else
     {
-        _network->removeHASSConfigTopic((char*)"binary_sensor", (char*)"door_sensor", uidString);
+        _network->removeHASSConfigTopic("binary_sensor", "door_sensor", uidString);
     }
 
     #ifndef CONFIG_IDF_TARGET_ESP32H2
@@ -1630,8 +1721,8 @@ void NukiNetworkLock::publishHASSConfig(char *deviceType, const char *baseTopic,
     }
     else
     {
-        _network->removeHASSConfigTopic((char*)"sensor", (char*)"last_action_authorization", uidString);
-        _network->removeHASSConfigTopic((char*)"sensor", (char*)"rolling_log", uidString);
+        _network->removeHASSConfigTopic("sensor", "last_action_authorization", uidString);
+        _network->removeHASSConfigTopic("sensor", "rolling_log", uidString);
     }
 
     if(hasKeypad)
@@ -1640,12 +1731,12 @@ void NukiNetworkLock::publishHASSConfig(char *deviceType, const char *baseTopic,
     }
     else
     {
-        _network->removeHASSConfigTopic((char*)"sensor", (char*)"keypad_status", uidString);
-        _network->removeHASSConfigTopic((char*)"binary_sensor", (char*)"keypad_battery_low", uidString);
+        _network->removeHASSConfigTopic("sensor", "keypad_status", uidString);
+        _network->removeHASSConfigTopic("binary_sensor", "keypad_battery_low", uidString);
     }
 }
 
-void NukiNetworkLock::removeHASSConfig(char *uidString)
+void NukiNetworkLock::removeHASSConfig(const char *uidString)
 {
     return  _network->removeHASSConfig(uidString);
 }
@@ -1714,6 +1805,13 @@ bool NukiNetworkLock::reconnected()
     return r;
 }
 
+void NukiNetworkLock::setLastRollingLog(const uint32_t index)
+{
+    _lastRollingLog = index;
+    NukiNetworkLock_lastRollingLog = index;
+    NukiNetworkLock_lastRollingLogDetect = index ^ ROLLING_LOG_DETECT;
+}
+
 uint8_t NukiNetworkLock::queryCommands()
 {
     uint8_t qc = _queryCommands;
@@ -14,6 +14,8 @@
 #include "LockActionResult.h"
 #include "NukiOfficial.h"
 #include "NukiPublisher.h"
+#include "MqttTopicHash.h"
+#include "JsonArena.h"
 
 #define LOCK_LOG_JSON_BUFFER_SIZE 2048
 
@@ -24,6 +26,7 @@ public:
     virtual ~NukiNetworkLock();
 
     void initialize();
+    void readSettings();
     void update();
 
     void publishKeyTurnerState(const NukiLock::KeyTurnerState& keyTurnerState, const NukiLock::KeyTurnerState& lastKeyTurnerState);
@@ -35,11 +38,13 @@ public:
     void publishBatteryReport(const NukiLock::BatteryReport& batteryReport);
     void publishConfig(const NukiLock::Config& config);
     void publishAdvancedConfig(const NukiLock::AdvancedConfig& config);
+    void configToJson(const NukiLock::Config& config, JsonObject json);
+    void advancedConfigToJson(const NukiLock::AdvancedConfig& config, JsonObject json);
     void publishRssi(const int& rssi);
     void publishRetry(const std::string& message);
     void publishBleAddress(const std::string& address);
-    void publishHASSConfig(char* deviceType, const char* baseTopic, char* name, char* uidString, const char *softwareVersion, const char *hardwareVersion, const bool& hasDoorSensor, const bool& hasKeypad, const bool& publishAuthData, char* lockAction, char* unlockAction, char* openAction);
-    void removeHASSConfig(char* uidString);
+    void publishHASSConfig(const char* deviceType, const char* baseTopic, const char* name, const char* uidString, const char *softwareVersion, const char *hardwareVersion, const bool& hasDoorSensor, const bool& hasKeypad, const bool& publishAuthData, const char* lockAction, const char* unlockAction, const char* openAction);
+    void removeHASSConfig(const char* uidString);
     void publishKeypad(const std::list<NukiLock::KeypadEntry>& entries, uint maxKeypadCodeCount);
     void publishTimeControl(const std::list<NukiLock::TimeControlEntry>& timeControlEntries, uint maxTimeControlEntryCount);
     void publishAuth(const std::list<NukiLock::AuthorizationEntry>& authEntries, uint maxAuthEntryCount);
@@ -76,9 +81,11 @@ public:
     uint8_t queryCommands();
 
 private:
-    bool comparePrefixedPath(const char* fullPath, const char* subPath);
+    void onLockActionReceived(const char* value);
+    void onUpdateRequested();
 
     void publishKeypadEntry(const String topic, NukiLock::KeypadEntry entry);
+    void setLastRollingLog(const uint32_t index);
     void buttonPressActionToString(const NukiLock::ButtonPressAction btnPressAction, char* str);
     void homeKitStatusToString(const int hkstatus, char* str);
     void fobActionToString(const int fobact, char* str);
@@ -87,8 +94,6 @@ private:
 
     String concat(String a, String b);
 
-    void buildMqttPath(const char* path, char* outPath);
-
     NukiNetwork* _network = nullptr;
     NukiPublisher* _nukiPublisher = nullptr;
     NukiOfficial* _nukiOfficial = nullptr;
@@ -102,11 +107,20 @@ private:
     bool _haEnabled = false;
     bool _reconnected = false;
     bool _disableNonJSON = false;
+    bool _keypadPublishCode = false;
+    bool _keypadTopicPerEntry = false;
+    bool _timeControlTopicPerEntry = false;
+    bool _authTopicPerEntry = false;
 
     String _keypadCommandName = "";
     String _keypadCommandCode = "";
     uint _keypadCommandId = 0;
     int _keypadCommandEnabled = 1;
+    std::vector<uint32_t> _keypadEntryHashes;
+    uint _keypadPublishedMaxCount = 0;
+    uint8_t _keypadPublishedFlags = 0;
+    bool _keypadPublished = false;
+    volatile bool _keypadCacheInvalidated = false;
     uint8_t _queryCommands = 0;
     uint32_t _lastRollingLog = 0;
     uint32_t _authId = 0;
@@ -116,6 +130,7 @@ private:
 
     char* _buffer;
     size_t _bufferSize;
+    JsonArena _jsonArena;
 
     LockActionResult (*_lockActionReceivedCallback)(const char* value) = nullptr;
     void (*_configUpdateReceivedCallback)(const char* value) = nullptr;
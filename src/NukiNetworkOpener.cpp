@@ -6,20 +6,40 @@
 #include "Config.h"
 #include <ArduinoJson.h>
 
+// Survives a soft restart, so entries already sent to the rolling log aren't streamed again before the retained index arrives
+RTC_NOINIT_ATTR uint32_t NukiNetworkOpener_lastRollingLog;
+RTC_NOINIT_ATTR uint32_t NukiNetworkOpener_lastRollingLogDetect;
+
 NukiNetworkOpener::NukiNetworkOpener(NukiNetwork* network, Preferences* preferences, char* buffer, size_t bufferSize)
         : _preferences(preferences),
           _network(network),
           _buffer(buffer),
-          _bufferSize(bufferSize)
+          _bufferSize(bufferSize),
+          _jsonArena(JSON_ARENA_SIZE, JSON_ARENA_SIZE_PSRAM)
 {
     _nukiPublisher = new NukiPublisher(network, _mqttPath);
 
     memset(_authName, 0, sizeof(_authName));
     _authName[0] = '\0';
 
+    if(NukiNetworkOpener_lastRollingLogDetect == (NukiNetworkOpener_lastRollingLog ^ ROLLING_LOG_DETECT))
+    {
+        _lastRollingLog = NukiNetworkOpener_lastRollingLog;
+    }
+
     _network->registerMqttReceiver(this);
 }
 
+void NukiNetworkOpener::readSettings()
+{
+    _haEnabled = _preferences->getString(preference_mqtt_hass_discovery, "") != "";
+    _disableNonJSON = _preferences->getBool(preference_disable_non_json, false);
+    _keypadPublishCode = _preferences->getBool(preference_keypad_publish_code, false);
+    _keypadTopicPerEntry = _preferences->getBool(preference_keypad_topic_per_entry, false);
+    _timeControlTopicPerEntry = _preferences->getBool(preference_timecontrol_topic_per_entry, false);
+    _authTopicPerEntry = _preferences->getBool(preference_auth_topic_per_entry, false);
+}
+
 void NukiNetworkOpener::initialize()
 {
     String mqttPath = _preferences->getString(preference_mqtt_opener_path);
@@ -37,8 +57,29 @@ void NukiNetworkOpener::initialize()
         _preferences->putString(preference_mqtt_opener_path, _mqttPath);
     }
 
-    _haEnabled = _preferences->getString(preference_mqtt_hass_discovery, "") != "";
-    _disableNonJSON = _preferences->getBool(preference_disable_non_json, false);
+    readSettings();
+
+    _nukiPublisher->internTopics({
+        mqtt_topic_lock_state,
+        mqtt_topic_lock_ha_state,
+        mqtt_topic_lock_binary_state,
+        mqtt_topic_lock_continuous_mode,
+        mqtt_topic_lock_ring,
+        mqtt_topic_lock_binary_ring,
+        mqtt_topic_lock_trigger,
+        mqtt_topic_lock_last_lock_action,
+        mqtt_topic_lock_completionStatus,
+        mqtt_topic_lock_door_sensor_state,
+        mqtt_topic_lock_json,
+        mqtt_topic_lock_status_updated,
+        mqtt_topic_lock_action,
+        mqtt_topic_lock_action_command_result,
+        mqtt_topic_query_lockstate_command_result,
+        mqtt_topic_lock_retry,
+        mqtt_topic_lock_rssi,
+        mqtt_topic_battery_critical,
+        mqtt_topic_battery_basic_json
+    });
 
     _network->initTopic(_mqttPath, mqtt_topic_lock_action, "--");
     _network->subscribe(_mqttPath, mqtt_topic_lock_action);
@@ -126,6 +167,7 @@ void NukiNetworkOpener::initialize()
     _network->addReconnectedCallback([&]()
      {
          _reconnected = true;
+         _keypadCacheInvalidated = true;
      });
 }
 
@@ -142,61 +184,48 @@ void NukiNetworkOpener::onMqttDataReceived(const char* topic, byte* payload, con
 {
     char* value = (char*)payload;
 
-    if(_network->mqttRecentlyConnected() && _network->pathEquals(_mqttPath, mqtt_topic_lock_action, topic))
-    {
-        Log->println("MQTT recently connected, ignoring opener action.");
-        return;
-    }
-
-    if(comparePrefixedPath(topic, mqtt_topic_lock_log_rolling_last))
-    {
-        if(strcmp(value, "") == 0 ||
-           strcmp(value, "--") == 0) return;
+    size_t prefixLen = strlen(_mqttPath);
+    if(strncmp(topic, _mqttPath, prefixLen) != 0) return;
 
-        if(atoi(value) > 0 && atoi(value) > _lastRollingLog) _lastRollingLog = atoi(value);
-    }
+    const char* subPath = topic + prefixLen;
 
-    if(comparePrefixedPath(topic, mqtt_topic_lock_action))
+    // Each case verifies the full suffix, the hash only selects the candidate handler
+    switch(mqttTopicHash(subPath))
     {
-        if(strcmp(value, "") == 0 ||
-           strcmp(value, "--") == 0 ||
-           strcmp(value, "ack") == 0 ||
-           strcmp(value, "unknown_action") == 0 ||
-           strcmp(value, "denied") == 0 ||
-           strcmp(value, "error") == 0) return;
-
-        Log->print(F("Opener action received: "));
-        Log->println(value);
-        LockActionResult lockActionResult = LockActionResult::Failed;
-        if(_lockActionReceivedCallback != NULL)
-        {
-            lockActionResult = _lockActionReceivedCallback(value);
-        }
+        case mqttTopicHash(mqtt_topic_lock_action):
+            if(strcmp(subPath, mqtt_topic_lock_action) != 0) break;
 
-        switch(lockActionResult)
-        {
-            case LockActionResult::Success:
-                publishString(mqtt_topic_lock_action, "ack", false);
-                break;
-            case LockActionResult::UnknownAction:
-                publishString(mqtt_topic_lock_action, "unknown_action", false);
-                break;
-            case LockActionResult::AccessDenied:
-                publishString(mqtt_topic_lock_action, "denied", false);
-                break;
-            case LockActionResult::Failed:
-                publishString(mqtt_topic_lock_action, "error", false);
+            if(_network->mqttRecentlyConnected())
+            {
+                Log->println("MQTT recently connected, ignoring opener action.");
                 break;
-        }
-    }
+            }
+
+            if(strcmp(value, "") == 0 ||
+               strcmp(value, "--") == 0 ||
+               strcmp(value, "ack") == 0 ||
+               strcmp(value, "unknown_action") == 0 ||
+               strcmp(value, "denied") == 0 ||
+               strcmp(value, "error") == 0) break;
+
+            Log->print(F("Opener action received: "));
+            Log->println(value);
+            onLockActionReceived(value);
+            break;
+        case mqttTopicHash(mqtt_topic_lock_log_rolling_last):
+            if(strcmp(subPath, mqtt_topic_lock_log_rolling_last) != 0) break;
+
+            if(strcmp(value, "") == 0 ||
+               strcmp(value, "--") == 0) break;
+
+            if(atoi(value) > 0 && atoi(value) > _lastRollingLog) setLastRollingLog(atoi(value));
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_command_action):
+            if(strcmp(subPath, mqtt_topic_keypad_command_action) != 0 || _disableNonJSON) break;
 
-    if(!_disableNonJSON)
-    {
-        if(comparePrefixedPath(topic, mqtt_topic_keypad_command_action))
-        {
             if(_keypadCommandReceivedReceivedCallback != nullptr)
             {
-                if(strcmp(value, "--") == 0) return;
+                if(strcmp(value, "--") == 0) break;
 
                 _keypadCommandReceivedReceivedCallback(value, _keypadCommandId, _keypadCommandName, _keypadCommandCode, _keypadCommandEnabled);
 
@@ -205,101 +234,120 @@ void NukiNetworkOpener::onMqttDataReceived(const char* topic, byte* payload, con
                 _keypadCommandCode = "000000";
                 _keypadCommandEnabled = 1;
 
-                if(strcmp(value, "--") != 0)
-                {
-                    publishString(mqtt_topic_keypad_command_action, "--", true);
-                }
+                publishString(mqtt_topic_keypad_command_action, "--", true);
                 publishInt(mqtt_topic_keypad_command_id, _keypadCommandId, true);
                 publishString(mqtt_topic_keypad_command_name, _keypadCommandName, true);
                 publishString(mqtt_topic_keypad_command_code, _keypadCommandCode, true);
                 publishInt(mqtt_topic_keypad_command_enabled, _keypadCommandEnabled, true);
             }
-        }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_id))
-        {
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_command_id):
+            if(strcmp(subPath, mqtt_topic_keypad_command_id) != 0 || _disableNonJSON) break;
             _keypadCommandId = atoi(value);
-        }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_name))
-        {
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_command_name):
+            if(strcmp(subPath, mqtt_topic_keypad_command_name) != 0 || _disableNonJSON) break;
             _keypadCommandName = value;
-        }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_code))
-        {
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_command_code):
+            if(strcmp(subPath, mqtt_topic_keypad_command_code) != 0 || _disableNonJSON) break;
             _keypadCommandCode = value;
-        }
-        else if(comparePrefixedPath(topic, mqtt_topic_keypad_command_enabled))
-        {
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_command_enabled):
+            if(strcmp(subPath, mqtt_topic_keypad_command_enabled) != 0 || _disableNonJSON) break;
             _keypadCommandEnabled = atoi(value);
-        }
-    }
+            break;
+        case mqttTopicHash(mqtt_topic_query_config):
+            if(strcmp(subPath, mqtt_topic_query_config) != 0 || strcmp(value, "1") != 0) break;
+            _queryCommands = _queryCommands | QUERY_COMMAND_CONFIG;
+            publishString(mqtt_topic_query_config, "0", true);
+            break;
+        case mqttTopicHash(mqtt_topic_query_lockstate):
+            if(strcmp(subPath, mqtt_topic_query_lockstate) != 0 || strcmp(value, "1") != 0) break;
+            _queryCommands = _queryCommands | QUERY_COMMAND_LOCKSTATE;
+            publishString(mqtt_topic_query_lockstate, "0", true);
+            break;
+        case mqttTopicHash(mqtt_topic_query_keypad):
+            if(strcmp(subPath, mqtt_topic_query_keypad) != 0 || strcmp(value, "1") != 0) break;
+            _queryCommands = _queryCommands | QUERY_COMMAND_KEYPAD;
+            publishString(mqtt_topic_query_keypad, "0", true);
+            break;
+        case mqttTopicHash(mqtt_topic_query_battery):
+            if(strcmp(subPath, mqtt_topic_query_battery) != 0 || strcmp(value, "1") != 0) break;
+            _queryCommands = _queryCommands | QUERY_COMMAND_BATTERY;
+            publishString(mqtt_topic_query_battery, "0", true);
+            break;
+        case mqttTopicHash(mqtt_topic_config_action):
+            if(strcmp(subPath, mqtt_topic_config_action) != 0) break;
+            if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) break;
 
-    if(comparePrefixedPath(topic, mqtt_topic_query_config) && strcmp(value, "1") == 0)
-    {
-        _queryCommands = _queryCommands | QUERY_COMMAND_CONFIG;
-        publishString(mqtt_topic_query_config, "0", true);
-    }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_lockstate) && strcmp(value, "1") == 0)
-    {
-        _queryCommands = _queryCommands | QUERY_COMMAND_LOCKSTATE;
-        publishString(mqtt_topic_query_lockstate, "0", true);
-    }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_keypad) && strcmp(value, "1") == 0)
-    {
-        _queryCommands = _queryCommands | QUERY_COMMAND_KEYPAD;
-        publishString(mqtt_topic_query_keypad, "0", true);
-    }
-    else if(comparePrefixedPath(topic, mqtt_topic_query_battery) && strcmp(value, "1") == 0)
-    {
-        _queryCommands = _queryCommands | QUERY_COMMAND_BATTERY;
-        publishString(mqtt_topic_query_battery, "0", true);
-    }
+            if(_configUpdateReceivedCallback != NULL)
+            {
+                _configUpdateReceivedCallback(value);
+            }
 
-    if(comparePrefixedPath(topic, mqtt_topic_config_action))
-    {
-        if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) return;
+            publishString(mqtt_topic_config_action, "--", true);
+            break;
+        case mqttTopicHash(mqtt_topic_keypad_json_action):
+            if(strcmp(subPath, mqtt_topic_keypad_json_action) != 0) break;
+            if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) break;
 
-        if(_configUpdateReceivedCallback != NULL)
-        {
-            _configUpdateReceivedCallback(value);
-        }
+            if(_keypadJsonCommandReceivedReceivedCallback != NULL)
+            {
+                _keypadJsonCommandReceivedReceivedCallback(value);
+            }
 
-        publishString(mqtt_topic_config_action, "--", true);
-    }
+            publishString(mqtt_topic_keypad_json_action, "--", true);
+            break;
+        case mqttTopicHash(mqtt_topic_timecontrol_action):
+            if(strcmp(subPath, mqtt_topic_timecontrol_action) != 0) break;
+            if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) break;
 
-    if(comparePrefixedPath(topic, mqtt_topic_keypad_json_action))
-    {
-        if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) return;
+            if(_timeControlCommandReceivedReceivedCallback != NULL)
+            {
+                _timeControlCommandReceivedReceivedCallback(value);
+            }
 
-        if(_keypadJsonCommandReceivedReceivedCallback != NULL)
-        {
-            _keypadJsonCommandReceivedReceivedCallback(value);
-        }
+            publishString(mqtt_topic_timecontrol_action, "--", true);
+            break;
+        case mqttTopicHash(mqtt_topic_auth_action):
+            if(strcmp(subPath, mqtt_topic_auth_action) != 0) break;
+            if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) break;
+
+            if(_authCommandReceivedReceivedCallback != NULL)
+            {
+                _authCommandReceivedReceivedCallback(value);
+            }
 
-        publishString(mqtt_topic_keypad_json_action, "--", true);
+            publishString(mqtt_topic_auth_action, "--", true);
+            break;
+        default:
+            break;
     }
+}
 
-    if(comparePrefixedPath(topic, mqtt_topic_timecontrol_action))
+void NukiNetworkOpener::onLockActionReceived(const char* value)
+{
+    LockActionResult lockActionResult = LockActionResult::Failed;
+    if(_lockActionReceivedCallback != NULL)
     {
-        if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) return;
-
-        if(_timeControlCommandReceivedReceivedCallback != NULL)
-        {
-            _timeControlCommandReceivedReceivedCallback(value);
-        }
-
-        publishString(mqtt_topic_timecontrol_action, "--", true);
+        lockActionResult = _lockActionReceivedCallback(value);
     }
 
-    if(comparePrefixedPath(topic, mqtt_topic_auth_action))
+    switch(lockActionResult)
     {
-        if(strcmp(value, "") == 0 || strcmp(value, "--") == 0) return;
-
-        if(_authCommandReceivedReceivedCallback != NULL)
-        {
-            _authCommandReceivedReceivedCallback(value);
-        }
-
-        publishString(mqtt_topic_auth_action, "--", true);
+        case LockActionResult::Success:
+            publishString(mqtt_topic_lock_action, "ack", false);
+            break;
+        case LockActionResult::UnknownAction:
+            publishString(mqtt_topic_lock_action, "unknown_action", false);
+            break;
+        case LockActionResult::AccessDenied:
+            publishString(mqtt_topic_lock_action, "denied", false);
+            break;
+        case LockActionResult::Failed:
+            publishString(mqtt_topic_lock_action, "error", false);
+            break;
     }
 }
 
@@ -310,8 +358,9 @@ void NukiNetworkOpener::publishKeyTurnerState(const NukiOpener::OpenerState& key
     char str[50];
     memset(&str, 0, sizeof(str));
 
-    JsonDocument json;
-    JsonDocument jsonBattery;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::KeyTurnerState);
+    JsonDocument json(&_jsonArena);
+    JsonDocument jsonBattery(&_jsonArena);
 
     lockstateToString(keyTurnerState.lockState, str);
 
@@ -463,7 +512,8 @@ void NukiNetworkOpener::publishAuthorizationInfo(const std::list<NukiOpener::Log
     char authName[33];
     uint32_t authIndex = 0;
 
-    JsonDocument json;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::AuthorizationInfo);
+    JsonDocument json(&_jsonArena);
 
     for(const auto& log : logEntries)
     {
@@ -618,7 +668,7 @@ void NukiNetworkOpener::publishAuthorizationInfo(const std::list<NukiOpener::Log
 
         if(log.index > _lastRollingLog)
         {
-            _lastRollingLog = log.index;
+            setLastRollingLog(log.index);
             serializeJson(entry, _buffer, _bufferSize);
             publishString(mqtt_topic_lock_log_rolling, _buffer, true);
             publishInt(mqtt_topic_lock_log_rolling_last, log.index, true);
@@ -664,7 +714,8 @@ void NukiNetworkOpener::publishBatteryReport(const NukiOpener::BatteryReport& ba
     char str[50];
     memset(&str, 0, sizeof(str));
 
-    JsonDocument json;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::BatteryReport);
+    JsonDocument json(&_jsonArena);
 
     json["batteryVoltage"] = (float)batteryReport.batteryVoltage / 1000.0;
     json["critical"] = batteryReport.criticalBatteryState;
@@ -678,6 +729,29 @@ void NukiNetworkOpener::publishBatteryReport(const NukiOpener::BatteryReport& ba
 }
 
 void NukiNetworkOpener::publishConfig(const NukiOpener::Config &config)
+{
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::Config);
+    JsonDocument json(&_jsonArena);
+
+    memset(_nukiName, 0, sizeof(_nukiName));
+    memcpy(_nukiName, config.name, sizeof(config.name));
+
+    configToJson(config, json.to<JsonObject>());
+
+    serializeJson(json, _buffer, _bufferSize);
+    publishString(mqtt_topic_config_basic_json, _buffer, true);
+
+    if(!_disableNonJSON)
+    {
+        publishBool(mqtt_topic_config_button_enabled, config.buttonEnabled == 1, true);
+        publishBool(mqtt_topic_config_led_enabled, config.ledFlashEnabled == 1, true);
+    }
+
+    publishString(mqtt_topic_info_firmware_version, std::to_string(config.firmwareVersion[0]) + "." + std::to_string(config.firmwareVersion[1]) + "." + std::to_string(config.firmwareVersion[2]), true);
+    publishString(mqtt_topic_info_hardware_version, std::to_string(config.hardwareRevision[0]) + "." + std::to_string(config.hardwareRevision[1]), true);
+}
+
+void NukiNetworkOpener::configToJson(const NukiOpener::Config &config, JsonObject json)
 {
     char str[50];
     char curTime[20];
@@ -685,11 +759,6 @@ void NukiNetworkOpener::publishConfig(const NukiOpener::Config &config)
     char uidString[20];
     itoa(config.nukiId, uidString, 16);
 
-    JsonDocument json;
-
-    memset(_nukiName, 0, sizeof(_nukiName));
-    memcpy(_nukiName, config.name, sizeof(config.name));
-
     json["nukiID"] = uidString;
     json["name"] = config.name;
     //json["latitude"] = config.latitude;
@@ -726,26 +795,28 @@ void NukiNetworkOpener::publishConfig(const NukiOpener::Config &config)
     memset(str, 0, sizeof(str));
     _network->timeZoneIdToString(config.timeZoneId, str);
     json["timeZone"] = str;
+}
+
+void NukiNetworkOpener::publishAdvancedConfig(const NukiOpener::AdvancedConfig &config)
+{
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::AdvancedConfig);
+    JsonDocument json(&_jsonArena);
+
+    advancedConfigToJson(config, json.to<JsonObject>());
 
     serializeJson(json, _buffer, _bufferSize);
-    publishString(mqtt_topic_config_basic_json, _buffer, true);
+    publishString(mqtt_topic_config_advanced_json, _buffer, true);
 
     if(!_disableNonJSON)
     {
-        publishBool(mqtt_topic_config_button_enabled, config.buttonEnabled == 1, true);
-        publishBool(mqtt_topic_config_led_enabled, config.ledFlashEnabled == 1, true);
+        publishUInt(mqtt_topic_config_sound_level, config.soundLevel, true);
     }
-
-    publishString(mqtt_topic_info_firmware_version, std::to_string(config.firmwareVersion[0]) + "." + std::to_string(config.firmwareVersion[1]) + "." + std::to_string(config.firmwareVersion[2]), true);
-    publishString(mqtt_topic_info_hardware_version, std::to_string(config.hardwareRevision[0]) + "." + std::to_string(config.hardwareRevision[1]), true);
 }
 
-void NukiNetworkOpener::publishAdvancedConfig(const NukiOpener::AdvancedConfig &config)
+void NukiNetworkOpener::advancedConfigToJson(const NukiOpener::AdvancedConfig &config, JsonObject json)
 {
     char str[50];
 
-    JsonDocument json;
-
     json["intercomID"] = config.intercomID;
     json["busModeSwitch"] = config.busModeSwitch;
     json["shortCircuitDuration"] = config.shortCircuitDuration;
@@ -782,14 +853,6 @@ void NukiNetworkOpener::publishAdvancedConfig(const NukiOpener::AdvancedConfig &
     _network->batteryTypeToString(config.batteryType, str);
     json["batteryType"] = str;
     json["automaticBatteryTypeDetection"] = config.automaticBatteryTypeDetection;
-
-    serializeJson(json, _buffer, _bufferSize);
-    publishString(mqtt_topic_config_advanced_json, _buffer, true);
-
-    if(!_disableNonJSON)
-    {
-        publishUInt(mqtt_topic_config_sound_level, config.soundLevel, true);
-    }
 }
 
 void NukiNetworkOpener::publishRssi(const int &rssi)
@@ -807,7 +870,7 @@ void NukiNetworkOpener::publishBleAddress(const std::string &address)
     publishString(mqtt_topic_lock_address, address, true);
 }
 
-void NukiNetworkOpener::publishHASSConfig(char* deviceType, const char* baseTopic, char* name, char* uidString, const char *softwareVersion, const char *hardwareVersion, const bool& publishAuthData, const bool& hasKeypad, char* lockAction, char* unlockAction, char* openAction)
+void NukiNetworkOpener::publishHASSConfig(const char* deviceType, const char* baseTopic, const char* name, const char* uidString, const char *softwareVersion, const char *hardwareVersion, const bool& publishAuthData, const bool& hasKeypad, const char* lockAction, const char* unlockAction, const char* openAction)
 {
     String availabilityTopic = _preferences->getString("mqttpath");
     availabilityTopic.concat("/maintenance/mqttConnectionState");
@@ -820,8 +883,8 @@ void NukiNetworkOpener::publishHASSConfig(char* deviceType, const char* baseTopi
     }
     else
     {
-        _network->removeHASSConfigTopic((char*)"sensor", (char*)"last_action_authorization", uidString);
-        _network->removeHASSConfigTopic((char*)"sensor", (char*)"rolling_log", uidString);
+        _network->removeHASSConfigTopic("sensor", "last_action_authorization", uidString);
+        _network->removeHASSConfigTopic("sensor", "rolling_log", uidString);
     }
     if(hasKeypad)
     {
@@ -829,32 +892,71 @@ void NukiNetworkOpener::publishHASSConfig(char* deviceType, const char* baseTopi
     }
     else
     {
-        _network->removeHASSConfigTopic((char*)"sensor", (char*)"keypad_status", uidString);
-        _network->removeHASSConfigTopic((char*)"binary_sensor", (char*)"keypad_battery_low", uidString);
+        _network->removeHASSConfigTopic("sensor", "keypad_status", uidString);
+        _network->removeHASSConfigTopic("binary_sensor", "keypad_battery_low", uidString);
     }
 }
 
-void NukiNetworkOpener::removeHASSConfig(char* uidString)
+void NukiNetworkOpener::removeHASSConfig(const char* uidString)
 {
     _network->removeHASSConfig(uidString);
 }
 
 void NukiNetworkOpener::publishKeypad(const std::list<NukiLock::KeypadEntry>& entries, uint maxKeypadCodeCount)
 {
-    bool publishCode = _preferences->getBool(preference_keypad_publish_code, false);
-    bool topicPerEntry = _preferences->getBool(preference_keypad_topic_per_entry, false);
+    bool publishCode = _keypadPublishCode;
+    bool topicPerEntry = _keypadTopicPerEntry;
     uint index = 0;
     char uidString[20];
     itoa(_preferences->getUInt(preference_nuki_id_opener, 0), uidString, 16);
-    String baseTopic = _preferences->getString(preference_mqtt_opener_path);
-    JsonDocument json;
+    const uint8_t publishFlags = (publishCode ? 1 : 0) | (topicPerEntry ? 2 : 0) | (_disableNonJSON ? 4 : 0);
+
+    if(_keypadCacheInvalidated)
+    {
+        // The broker may have lost its retained messages while MQTT was disconnected
+        _keypadCacheInvalidated = false;
+        _keypadPublished = false;
+        _keypadEntryHashes.clear();
+    }
+
+    // Codes published before have to be removed as soon as publishing them is turned off
+    const bool removeCodes = !publishCode && (!_keypadPublished || (_keypadPublishedFlags & 1) != 0);
+    const bool removeNonJSON = _disableNonJSON && (!_keypadPublished || (_keypadPublishedFlags & 4) == 0);
+
+    // Only entries that were added or changed since the last refresh are republished, the JSON array only when anything changed
+    std::vector<uint32_t> entryHashes;
+    entryHashes.reserve(entries.size());
+    bool changed = !_keypadPublished || publishFlags != _keypadPublishedFlags || entries.size() != _keypadEntryHashes.size() || maxKeypadCodeCount != _keypadPublishedMaxCount;
+
+    for(const auto& entry : entries)
+    {
+        uint32_t hash = mqttPayloadHash(&entry, sizeof(entry), mqttPayloadHash(&publishFlags, sizeof(publishFlags)));
+        if(entryHashes.size() >= _keypadEntryHashes.size() || _keypadEntryHashes[entryHashes.size()] != hash) changed = true;
+        entryHashes.push_back(hash);
+    }
+
+    if(!changed)
+    {
+        Log->println(F("Keypad entries unchanged, skipping publish"));
+        return;
+    }
+
+    const size_t previousEntryCount = _keypadPublished ? _keypadEntryHashes.size() : maxKeypadCodeCount;
+    uint entriesPublished = 0;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::Keypad);
+    JsonDocument json(&_jsonArena);
 
     for(const auto& entry : entries)
     {
+        const bool entryChanged = index >= _keypadEntryHashes.size() || _keypadEntryHashes[index] != entryHashes[index];
         String basePath = mqtt_topic_keypad;
         basePath.concat("/code_");
         basePath.concat(std::to_string(index).c_str());
-        publishKeypadEntry(basePath, entry);
+        if(entryChanged)
+        {
+            publishKeypadEntry(basePath, entry);
+            ++entriesPublished;
+        }
 
         auto jsonEntry = json.add<JsonVariant>();
 
@@ -933,7 +1035,7 @@ void NukiNetworkOpener::publishKeypad(const std::list<NukiLock::KeypadEntry>& en
         sprintf(allowedUntilTimeT, "%02d:%02d", entry.allowedUntilTimeHour, entry.allowedUntilTimeMin);
         jsonEntry["allowedUntilTime"] = allowedUntilTimeT;
 
-        if(topicPerEntry)
+        if(topicPerEntry && entryChanged)
         {
             basePath = mqtt_topic_keypad;
             basePath.concat("/codes/");
@@ -963,7 +1065,7 @@ void NukiNetworkOpener::publishKeypad(const std::list<NukiLock::KeypadEntry>& en
                              uidStringPostfix.c_str(),
                              displayName.c_str(),
                              _nukiName,
-                             baseTopic.c_str(),
+                             _mqttPath,
                              String("~") + basePath.c_str(),
                              (char*)"SmartLock",
                              "",
@@ -986,7 +1088,8 @@ void NukiNetworkOpener::publishKeypad(const std::list<NukiLock::KeypadEntry>& en
 
     if(!_disableNonJSON)
     {
-        while(index < maxKeypadCodeCount)
+        // slots beyond the entries only need clearing when they held an entry before
+        while(index < maxKeypadCodeCount && index < previousEntryCount)
         {
             NukiLock::KeypadEntry entry;
             memset(&entry, 0, sizeof(entry));
@@ -998,7 +1101,7 @@ void NukiNetworkOpener::publishKeypad(const std::list<NukiLock::KeypadEntry>& en
             ++index;
         }
 
-        if(!publishCode)
+        if(removeCodes)
         {
             for(int i=0; i<maxKeypadCodeCount; i++)
             {
@@ -1011,7 +1114,7 @@ void NukiNetworkOpener::publishKeypad(const std::list<NukiLock::KeypadEntry>& en
             }
         }
     }
-    else
+    else if(removeNonJSON)
     {
         for(int i=0; i<maxKeypadCodeCount; i++)
         {
@@ -1032,28 +1135,41 @@ void NukiNetworkOpener::publishKeypad(const std::list<NukiLock::KeypadEntry>& en
             _network->removeTopic(codeTopic, "createdSec");
             _network->removeTopic(codeTopic, "lockCount");
         }
+    }
 
-        for(int j=entries.size(); j<maxKeypadCodeCount; j++)
+    if(_disableNonJSON)
+    {
+        for(int j=entries.size(); j<maxKeypadCodeCount && j<previousEntryCount; j++)
         {
             String codesTopic = _mqttPath;
             codesTopic.concat(mqtt_topic_keypad_codes);
             codesTopic.concat("/");
             _network->removeTopic(codesTopic, (char*)std::to_string(j).c_str());
             std::string mqttDeviceName = std::string("keypad_") + std::to_string(j);
-            _network->removeHassTopic((char*)"switch", (char*)mqttDeviceName.c_str(), uidString);
+            _network->removeHassTopic("switch", mqttDeviceName.c_str(), uidString);
         }
     }
+
+    _keypadEntryHashes = std::move(entryHashes);
+    _keypadPublishedMaxCount = maxKeypadCodeCount;
+    _keypadPublishedFlags = publishFlags;
+    _keypadPublished = true;
+
+    Log->print(F("Keypad entries republished: "));
+    Log->print(entriesPublished);
+    Log->print(F(" of "));
+    Log->println(entries.size());
 }
 
 void NukiNetworkOpener::publishTimeControl(const std::list<NukiOpener::TimeControlEntry>& timeControlEntries, uint maxTimeControlEntryCount)
 {
-    bool topicPerEntry = _preferences->getBool(preference_timecontrol_topic_per_entry, false);
+    bool topicPerEntry = _timeControlTopicPerEntry;
     uint index = 0;
     char str[50];
     char uidString[20];
     itoa(_preferences->getUInt(preference_nuki_id_opener, 0), uidString, 16);
-    String baseTopic = _preferences->getString(preference_mqtt_opener_path);
-    JsonDocument json;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::TimeControl);
+    JsonDocument json(&_jsonArena);
 
     for(const auto& entry : timeControlEntries)
     {
@@ -1141,7 +1257,7 @@ void NukiNetworkOpener::publishTimeControl(const std::list<NukiOpener::TimeContr
                              uidStringPostfix.c_str(),
                              displayName.c_str(),
                              _nukiName,
-                             baseTopic.c_str(),
+                             _mqttPath,
                              String("~") + basePath.c_str(),
                              (char*)"Opener",
                              "",
@@ -1169,7 +1285,7 @@ void NukiNetworkOpener::publishTimeControl(const std::list<NukiOpener::TimeContr
         entriesTopic.concat("/");
         _network->removeTopic(entriesTopic, (char*)std::to_string(j).c_str());
         std::string mqttDeviceName = std::string("timecontrol_") + std::to_string(j);
-        _network->removeHassTopic((char*)"switch", (char*)mqttDeviceName.c_str(), uidString);
+        _network->removeHassTopic("switch", mqttDeviceName.c_str(), uidString);
     }
 }
 
@@ -1179,8 +1295,8 @@ void NukiNetworkOpener::publishAuth(const std::list<NukiOpener::AuthorizationEnt
     char str[50];
     char uidString[20];
     itoa(_preferences->getUInt(preference_nuki_id_opener, 0), uidString, 16);
-    String baseTopic = _preferences->getString(preference_mqtt_opener_path);
-    JsonDocument json;
+    JsonArenaScope arenaScope(_jsonArena, JsonArenaDoc::Auth);
+    JsonDocument json(&_jsonArena);
 
     for(const auto& entry : authEntries)
     {
@@ -1262,7 +1378,7 @@ void NukiNetworkOpener::publishAuth(const std::list<NukiOpener::AuthorizationEnt
         sprintf(allowedUntilTimeT, "%02d:%02d", entry.allowedUntilTimeHour, entry.allowedUntilTimeMin);
         jsonEntry["allowedUntilTime"] = allowedUntilTimeT;
 
-        if(_preferences->getBool(preference_auth_topic_per_entry, false))
+        if(_authTopicPerEntry)
         {
             String basePath = mqtt_topic_auth;
             basePath.concat("/entries/");
@@ -1288,7 +1404,7 @@ void NukiNetworkOpener::publishAuth(const std::list<NukiOpener::AuthorizationEnt
                              uidStringPostfix.c_str(),
                              displayName.c_str(),
                              _nukiName,
-                             baseTopic.c_str(),
+                             _mqttPath,
                              String("~") + basePath.c_str(),
                              (char*)"Opener",
                              "",
@@ -1316,7 +1432,7 @@ void NukiNetworkOpener::publishAuth(const std::list<NukiOpener::AuthorizationEnt
         entriesTopic.concat("/");
         _network->removeTopic(entriesTopic, (char*)std::to_string(j).c_str());
         std::string mqttDeviceName = std::string("auth_") + std::to_string(j);
-        _network->removeHassTopic((char*)"switch", (char*)mqttDeviceName.c_str(), uidString);
+        _network->removeHassTopic("switch", mqttDeviceName.c_str(), uidString);
     }
 }
 
@@ -1435,7 +1551,7 @@ void NukiNetworkOpener::publishKeypadEntry(const String topic, NukiLock::KeypadE
     publishBool(concat(topic, "/enabled").c_str(), entry.enabled, true);
     publishString(concat(topic, "/name").c_str(), codeName, true);
 
-    if(_preferences->getBool(preference_keypad_publish_code, false))
+    if(_keypadPublishCode)
     {
         publishInt(concat(topic, "/code").c_str(), entry.code, true);
     }
@@ -1478,14 +1594,6 @@ void NukiNetworkOpener::subscribe(const char *path)
     _network->subscribe(prefixedPath, MQTT_QOS_LEVEL);
 }
 
-bool NukiNetworkOpener::comparePrefixedPath(const char *fullPath, const char *subPath)
-{
-    char prefixedPath[500];
-    buildMqttPath(subPath, prefixedPath);
-
-    return strcmp(fullPath, prefixedPath) == 0;
-}
-
 String NukiNetworkOpener::concat(String a, String b)
 {
     String c = a;
@@ -1500,6 +1608,13 @@ bool NukiNetworkOpener::reconnected()
     return r;
 }
 
+void NukiNetworkOpener::setLastRollingLog(const uint32_t index)
+{
+    _lastRollingLog = index;
+    NukiNetworkOpener_lastRollingLog = index;
+    NukiNetworkOpener_lastRollingLogDetect = index ^ ROLLING_LOG_DETECT;
+}
+
 uint8_t NukiNetworkOpener::queryCommands()
 {
     uint8_t qc = _queryCommands;
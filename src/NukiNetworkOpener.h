@@ -6,6 +6,8 @@
 #include "NukiConstants.h"
 #include "NukiOpenerConstants.h"
 #include "NukiNetworkLock.h"
+#include "MqttTopicHash.h"
+#include "JsonArena.h"
 
 class NukiNetworkOpener : public MqttReceiver
 {
@@ -14,6 +16,7 @@ public:
     virtual ~NukiNetworkOpener() = default;
 
     void initialize();
+    void readSettings();
     void update();
 
     void publishKeyTurnerState(const NukiOpener::OpenerState& keyTurnerState, const NukiOpener::OpenerState& lastKeyTurnerState);
@@ -26,11 +29,13 @@ public:
     void publishBatteryReport(const NukiOpener::BatteryReport& batteryReport);
     void publishConfig(const NukiOpener::Config& config);
     void publishAdvancedConfig(const NukiOpener::AdvancedConfig& config);
+    void configToJson(const NukiOpener::Config& config, JsonObject json);
+    void advancedConfigToJson(const NukiOpener::AdvancedConfig& config, JsonObject json);
     void publishRssi(const int& rssi);
     void publishRetry(const std::string& message);
     void publishBleAddress(const std::string& address);
-    void publishHASSConfig(char* deviceType, const char* baseTopic, char* name, char* uidString, const char *softwareVersion, const char *hardwareVersion, const bool& publishAuthData, const bool& hasKeypad, char* lockAction, char* unlockAction, char* openAction);
-    void removeHASSConfig(char* uidString);
+    void publishHASSConfig(const char* deviceType, const char* baseTopic, const char* name, const char* uidString, const char *softwareVersion, const char *hardwareVersion, const bool& publishAuthData, const bool& hasKeypad, const char* lockAction, const char* unlockAction, const char* openAction);
+    void removeHASSConfig(const char* uidString);
     void publishKeypad(const std::list<NukiLock::KeypadEntry>& entries, uint maxKeypadCodeCount);
     void publishTimeControl(const std::list<NukiOpener::TimeControlEntry>& timeControlEntries, uint maxTimeControlEntryCount);
     void publishAuth(const std::list<NukiLock::AuthorizationEntry>& authEntries, uint maxAuthEntryCount);
@@ -54,7 +59,7 @@ public:
     char _nukiName[33];
 
 private:
-    bool comparePrefixedPath(const char* fullPath, const char* subPath);
+    void onLockActionReceived(const char* value);
 
     void publishFloat(const char* topic, const float value, bool retain, const uint8_t precision = 2);
     void publishInt(const char* topic, const int value, bool retain);
@@ -64,6 +69,7 @@ private:
     void publishString(const char* topic, const std::string& value, bool retain);
     void publishString(const char* topic, const char* value, bool retain);
     void publishKeypadEntry(const String topic, NukiLock::KeypadEntry entry);
+    void setLastRollingLog(const uint32_t index);
 
     void buildMqttPath(const char* path, char* outPath);
     void subscribe(const char* path);
@@ -88,11 +94,20 @@ private:
     bool _haEnabled = false;
     bool _reconnected = false;
     bool _disableNonJSON = false;
+    bool _keypadPublishCode = false;
+    bool _keypadTopicPerEntry = false;
+    bool _timeControlTopicPerEntry = false;
+    bool _authTopicPerEntry = false;
 
     String _keypadCommandName = "";
     String _keypadCommandCode = "";
     uint _keypadCommandId = 0;
     int _keypadCommandEnabled = 1;
+    std::vector<uint32_t> _keypadEntryHashes;
+    uint _keypadPublishedMaxCount = 0;
+    uint8_t _keypadPublishedFlags = 0;
+    bool _keypadPublished = false;
+    volatile bool _keypadCacheInvalidated = false;
     int64_t _resetRingStateTs = 0;
     uint8_t _queryCommands = 0;
     uint32_t _authId = 0;
@@ -104,6 +119,7 @@ private:
 
     char* _buffer;
     const size_t _bufferSize;
+    JsonArena _jsonArena;
 
     LockActionResult (*_lockActionReceivedCallback)(const char* value) = nullptr;
     void (*_configUpdateReceivedCallback)(const char* value) = nullptr;
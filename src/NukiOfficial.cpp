@@ -2,7 +2,7 @@
 #include "NukiOfficial.h"
 #include "Logger.h"
 #include "PreferencesKeys.h"
-#include "../lib/nuki_ble/src/NukiLockUtils.h"
+#include "NukiLockUtils.h"
 #include <stdlib.h>
 #include <ctype.h>
 
@@ -49,37 +49,10 @@ const char *NukiOfficial::getMqttPath() const
     return mqttPath;
 }
 
-void NukiOfficial::buildMqttPath(const char *path, char *outPath)
-{
-    int offset = 0;
-    char inPath[181] = {0};
-
-    memcpy(inPath, mqttPath, sizeof(mqttPath));
-
-    for(const char& c : inPath)
-    {
-        if(c == 0x00)
-        {
-            break;
-        }
-        outPath[offset] = c;
-        ++offset;
-    }
-    int i=0;
-    while(outPath[i] != 0x00)
-    {
-        outPath[offset] = path[i];
-        ++i;
-        ++offset;
-    }
-    outPath[i+1] = 0x00;
-}
-
 bool NukiOfficial::comparePrefixedPath(const char *fullPath, const char *subPath)
 {
-    char prefixedPath[500];
-    buildMqttPath(subPath, prefixedPath);
-    return strcmp(fullPath, prefixedPath) == 0;
+    size_t prefixLen = strlen(mqttPath);
+    return strncmp(fullPath, mqttPath, prefixLen) == 0 && strcmp(fullPath + prefixLen, subPath) == 0;
 }
 
 void NukiOfficial::onOfficialUpdateReceived(const char *topic, const char *value)
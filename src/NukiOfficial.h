@@ -2,7 +2,7 @@
 
 #include <cstdint>
 #include <vector>
-#include "../lib/nuki_ble/src/NukiLockConstants.h"
+#include "NukiLockConstants.h"
 #include "NukiPublisher.h"
 
 class NukiOfficial
@@ -23,7 +23,6 @@ public:
     const bool hasAuthId() const;
     void clearAuthId();
 
-    void buildMqttPath(const char* path, char* outPath);
     bool comparePrefixedPath(const char *fullPath, const char *subPath);
 
     void onOfficialUpdateReceived(const char* topic, const char* value);
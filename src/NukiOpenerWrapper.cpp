@@ -5,18 +5,21 @@
 #include "RestartReason.h"
 #include <NukiOpenerUtils.h>
 #include "Config.h"
+#include "NukiScheduler.h"
+#include "BleArbiter.h"
 
 NukiOpenerWrapper* nukiOpenerInst;
 Preferences* nukiOpenerPreferences = nullptr;
 
-NukiOpenerWrapper::NukiOpenerWrapper(const std::string& deviceName, NukiDeviceId* deviceId, BleScanner::Scanner* scanner, NukiNetworkOpener* network, Gpio* gpio, Preferences* preferences)
+NukiOpenerWrapper::NukiOpenerWrapper(const std::string& deviceName, NukiDeviceId* deviceId, BleScanner::Scanner* scanner, NukiNetworkOpener* network, Gpio* gpio, Preferences* preferences, NukiScheduler* scheduler)
 : _deviceName(deviceName),
   _deviceId(deviceId),
   _nukiOpener(deviceName, _deviceId->get()),
   _bleScanner(scanner),
   _network(network),
   _gpio(gpio),
-  _preferences(preferences)
+  _preferences(preferences),
+  _scheduler(scheduler)
 {
     Log->print("Device id opener: ");
     Log->println(_deviceId->get());
@@ -80,6 +83,14 @@ void NukiOpenerWrapper::readSettings()
     _intervalBattery = _preferences->getInt(preference_query_interval_battery);
     _intervalKeypad = _preferences->getInt(preference_query_interval_keypad);
     _keypadEnabled = _preferences->getBool(preference_keypad_info_enabled);
+    _confInfoEnabled = _preferences->getBool(preference_conf_info_enabled, true);
+    _timeControlInfoEnabled = _preferences->getBool(preference_timecontrol_info_enabled, false);
+    _authInfoEnabled = _preferences->getBool(preference_auth_info_enabled, false);
+    _keypadMaxEntries = _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD);
+    _timeControlMaxEntries = _preferences->getInt(preference_timecontrol_max_entries, MAX_TIMECONTROL);
+    _authMaxEntries = _preferences->getInt(preference_auth_max_entries, MAX_AUTH);
+    _authLogMaxEntries = _preferences->getInt(preference_authlog_max_entries, MAX_AUTHLOG);
+    _pinStatus = _preferences->getInt(preference_opener_pin_status, 4);
     _publishAuthData = _preferences->getBool(preference_publish_authdata);
     _maxKeypadCodeCount = _preferences->getUInt(preference_opener_max_keypad_code_count);
     _maxTimeControlEntryCount = _preferences->getUInt(preference_opener_max_timecontrol_entry_count);
@@ -89,6 +100,8 @@ void NukiOpenerWrapper::readSettings()
     _retryDelay = _preferences->getInt(preference_command_retry_delay);
     _rssiPublishInterval = _preferences->getInt(preference_rssi_publish_interval) * 1000;
     _disableNonJSON = _preferences->getBool(preference_disable_non_json, false);
+
+    _network->readSettings();
     _preferences->getBytes(preference_conf_opener_basic_acl, &_basicOpenerConfigAclPrefs, sizeof(_basicOpenerConfigAclPrefs));
     _preferences->getBytes(preference_conf_opener_advanced_acl, &_advancedOpenerConfigAclPrefs, sizeof(_advancedOpenerConfigAclPrefs));
 
@@ -159,7 +172,13 @@ void NukiOpenerWrapper::update()
                                            Nuki::AuthorizationIdType::App :
                                            Nuki::AuthorizationIdType::Bridge;
 
-        if(_nukiOpener.pairNuki(idType) == NukiOpener::PairingResult::Success)
+        NukiOpener::PairingResult pairingResult;
+        {
+            BleArbiterGuard bleGuard(_bleWaitLatency);
+            pairingResult = _nukiOpener.pairNuki(idType);
+        }
+
+        if(pairingResult == NukiOpener::PairingResult::Success)
         {
             Log->println(F("Nuki opener paired"));
             _paired = true;
@@ -174,7 +193,8 @@ void NukiOpenerWrapper::update()
 
     int64_t lastReceivedBeaconTs = _nukiOpener.getLastReceivedBeaconTs();
     int64_t ts = (esp_timer_get_time() / 1000);
-    uint8_t queryCommands = _network->queryCommands();
+    uint8_t queryCommands = _network->queryCommands() | _postponedQueryCommands;
+    _postponedQueryCommands = 0;
 
     if(_restartBeaconTimeout > 0 &&
        ts > 60000 &&
@@ -191,6 +211,11 @@ void NukiOpenerWrapper::update()
 
     _nukiOpener.updateConnectionState();
 
+    if(_nextLockAction != (NukiOpener::LockAction)0xff && ts >= _nextRetryTs)
+    {
+        processLockAction();
+    }
+
     if(_statusUpdated || _nextLockStateUpdateTs == 0 || ts >= _nextLockStateUpdateTs || (queryCommands & QUERY_COMMAND_LOCKSTATE) > 0)
     {
         _statusUpdated = false;
@@ -198,12 +223,12 @@ void NukiOpenerWrapper::update()
         updateKeyTurnerState();
         _network->publishStatusUpdated(_statusUpdated);
     }
-    if(_nextBatteryReportTs == 0 || ts > _nextBatteryReportTs || (queryCommands & QUERY_COMMAND_BATTERY) > 0)
+    if((_nextBatteryReportTs == 0 || ts > _nextBatteryReportTs || (queryCommands & QUERY_COMMAND_BATTERY) > 0) && !postponeForLockAction(queryCommands, QUERY_COMMAND_BATTERY))
     {
         _nextBatteryReportTs = ts + _intervalBattery * 1000;
         updateBatteryState();
     }
-    if(_nextConfigUpdateTs == 0 || ts > _nextConfigUpdateTs || (queryCommands & QUERY_COMMAND_CONFIG) > 0)
+    if((_nextConfigUpdateTs == 0 || ts > _nextConfigUpdateTs || (queryCommands & QUERY_COMMAND_CONFIG) > 0) && !postponeForLockAction(queryCommands, QUERY_COMMAND_CONFIG))
     {
         _nextConfigUpdateTs = ts + _intervalConfig * 1000;
         updateConfig();
@@ -245,104 +270,198 @@ void NukiOpenerWrapper::update()
         {
             _network->publishRssi(rssi);
             _lastRssi = rssi;
+            ++_stateRevision;
         }
     }
 
-    if(_hasKeypad && _keypadEnabled && (_nextKeypadUpdateTs == 0 || ts > _nextKeypadUpdateTs || (queryCommands & QUERY_COMMAND_KEYPAD) > 0))
+    if(_hasKeypad && _keypadEnabled && (_nextKeypadUpdateTs == 0 || ts > _nextKeypadUpdateTs || (queryCommands & QUERY_COMMAND_KEYPAD) > 0) && !postponeForLockAction(queryCommands, QUERY_COMMAND_KEYPAD))
     {
         _nextKeypadUpdateTs = ts + _intervalKeypad * 1000;
+        _bulkReadActive = true;
         updateKeypad(false);
+        _bulkReadActive = false;
     }
 
-    if(_nextLockAction != (NukiOpener::LockAction)0xff)
+    if(_clearAuthData)
     {
-        int retryCount = 0;
-        Nuki::CmdResult cmdResult = (Nuki::CmdResult)-1;
+        _network->clearAuthorizationInfo();
+        _clearAuthData = false;
+    }
+
+    memcpy(&_lastKeyTurnerState, &_keyTurnerState, sizeof(NukiOpener::OpenerState));
+
+    scheduleNextUpdate();
+}
 
-        while(retryCount < _nrOfRetries + 1 && cmdResult != Nuki::CmdResult::Success)
+void NukiOpenerWrapper::processLockAction()
+{
+    const NukiOpener::LockAction action = _nextLockAction;
+    int64_t attemptTs = esp_timer_get_time() / 1000;
+
+    if(_lockActionRetryCount == 0)
+    {
+        _lockActionStartTs = attemptTs;
+        if(_lockActionReceivedTs > 0)
         {
-            cmdResult = _nukiOpener.lockAction(_nextLockAction, 0, 0);
-            char resultStr[15] = {0};
-            NukiOpener::cmdResultToString(cmdResult, resultStr);
+            _lockActionDispatchLatency.add(attemptTs - _lockActionReceivedTs);
+            if(_lockActionQueuedDuringBulkRead) _lockActionBulkReadDispatchLatency.add(attemptTs - _lockActionReceivedTs);
+        }
+        _lockActionReceivedTs = 0;
+    }
 
-            _network->publishCommandResult(resultStr);
+    Nuki::CmdResult cmdResult;
+    {
+        BleArbiterGuard bleGuard(_bleWaitLatency);
+        cmdResult = _nukiOpener.lockAction(action, 0, 0);
+    }
+    ++_lockActionAttempts;
+    postponeBleWatchdog();
 
-            Log->print(F("Opener action result: "));
-            Log->println(resultStr);
+    char resultStr[15] = {0};
+    NukiOpener::cmdResultToString(cmdResult, resultStr);
+    _network->publishCommandResult(resultStr);
 
-            if(cmdResult != Nuki::CmdResult::Success)
-            {
-                Log->print(F("Opener: Last command failed, retrying after "));
-                Log->print(_retryDelay);
-                Log->print(F(" milliseconds. Retry "));
-                Log->print(retryCount + 1);
-                Log->print(" of ");
-                Log->println(_nrOfRetries);
+    Log->print(F("Opener action result: "));
+    Log->println(resultStr);
 
-                _network->publishRetry(std::to_string(retryCount + 1));
+    if(_nextLockAction != action)
+    {
+        // A newer action was queued while this one was executed, queueLockAction() already reset the retry state
+        Log->println(F("Opener: Action superseded by a newer action"));
+        return;
+    }
 
-                delay(_retryDelay);
+    if(cmdResult == Nuki::CmdResult::Success)
+    {
+        _nextLockAction = (NukiOpener::LockAction) 0xff;
+        _lockActionRetryCount = 0;
+        _nextRetryTs = 0;
+        _network->publishRetry("--");
+        _lockActionCompletedTs = esp_timer_get_time() / 1000;
+        _lockActionCommandLatency.add(_lockActionCompletedTs - _lockActionStartTs);
+        if(_intervalLockstate > 10) _nextLockStateUpdateTs = attemptTs + 10 * 1000;
+    }
+    else if(_lockActionRetryCount < _nrOfRetries)
+    {
+        ++_lockActionRetryCount;
+        ++_lockActionRetries;
 
-                ++retryCount;
-            }
-            postponeBleWatchdog();
-        }
+        Log->print(F("Opener: Last command failed, retrying after "));
+        Log->print(_retryDelay);
+        Log->print(F(" milliseconds. Retry "));
+        Log->print(_lockActionRetryCount);
+        Log->print(" of ");
+        Log->println(_nrOfRetries);
 
-        if(cmdResult == Nuki::CmdResult::Success)
-        {
-            _nextLockAction = (NukiOpener::LockAction) 0xff;
-            _network->publishRetry("--");
-            retryCount = 0;
-            if(_intervalLockstate > 10) _nextLockStateUpdateTs = ts + 10 * 1000;
-        }
-        else
-        {
-            Log->println(F("Opener: Maximum number of retries exceeded, aborting."));
-            _network->publishRetry("failed");
-            retryCount = 0;
-            _nextLockAction = (NukiOpener::LockAction) 0xff;
-        }
+        _network->publishRetry(std::to_string(_lockActionRetryCount));
+        _nextRetryTs = (esp_timer_get_time() / 1000) + _retryDelay;
     }
+    else
+    {
+        ++_lockActionsFailed;
+        Log->println(F("Opener: Maximum number of retries exceeded, aborting."));
+        _network->publishRetry("failed");
+        _nextLockAction = (NukiOpener::LockAction) 0xff;
+        _lockActionRetryCount = 0;
+        _nextRetryTs = 0;
+    }
+}
 
-    if(_clearAuthData)
+void NukiOpenerWrapper::scheduleNextUpdate()
+{
+    if(_statusUpdated || _clearAuthData)
     {
-        _network->clearAuthorizationInfo();
-        _clearAuthData = false;
+        _scheduler->scheduleAt(esp_timer_get_time() / 1000);
+        return;
     }
 
-    memcpy(&_lastKeyTurnerState, &_keyTurnerState, sizeof(NukiOpener::OpenerState));
+    // A pending action is retried once _nextRetryTs expires, 0 runs it right away. The bulk reads that are due stay
+    // postponed until then and their expired deadlines would wake the task in a loop, update() runs them after the action.
+    if(_nextLockAction != (NukiOpener::LockAction)0xff)
+    {
+        _scheduler->scheduleAt(_nextRetryTs);
+        return;
+    }
+
+    // update() compares most timestamps with '>', so wake one ms after they expire
+    _scheduler->scheduleAt(_nextLockStateUpdateTs);
+    _scheduler->scheduleAt(_nextBatteryReportTs + 1);
+    _scheduler->scheduleAt(_nextConfigUpdateTs + 1);
+    if(_waitAuthLogUpdateTs != 0) _scheduler->scheduleAt(_waitAuthLogUpdateTs + 1);
+    if(_waitKeypadUpdateTs != 0) _scheduler->scheduleAt(_waitKeypadUpdateTs + 1);
+    if(_waitTimeControlUpdateTs != 0) _scheduler->scheduleAt(_waitTimeControlUpdateTs + 1);
+    if(_waitAuthUpdateTs != 0) _scheduler->scheduleAt(_waitAuthUpdateTs + 1);
+    if(_rssiPublishInterval > 0) _scheduler->scheduleAt(_nextRssiTs + 1);
+    if(_hasKeypad && _keypadEnabled) _scheduler->scheduleAt(_nextKeypadUpdateTs + 1);
+}
+
+
+bool NukiOpenerWrapper::postponeForLockAction(const uint8_t& queryCommands, const uint8_t& queryCommand)
+{
+    // Bulk BLE reads yield to pending actions, the read stays due and runs in a later pass
+    if(_nextLockAction == (NukiOpener::LockAction)0xff)
+    {
+        _postponedReads &= ~queryCommand;
+        return false;
+    }
+
+    _postponedQueryCommands |= (queryCommands & queryCommand);
+
+    // update() checks the read again on every pass until the action completed, it is counted once
+    if(queryCommand == 0 || (_postponedReads & queryCommand) == 0)
+    {
+        _postponedReads |= queryCommand;
+        ++_bulkReadsPostponed;
+    }
+    return true;
 }
 
+bool NukiOpenerWrapper::bulkReadInProgress() const
+{
+    return _bulkReadActive || _waitAuthLogUpdateTs != 0 || _waitKeypadUpdateTs != 0 || _waitTimeControlUpdateTs != 0 || _waitAuthUpdateTs != 0;
+}
+
+void NukiOpenerWrapper::queueLockAction(const NukiOpener::LockAction& action)
+{
+    // A newer action replaces a pending one, including one waiting for its next retry
+    if(_nextLockAction != (NukiOpener::LockAction)0xff) ++_lockActionsSuperseded;
+    _lockActionRetryCount = 0;
+    _nextRetryTs = 0;
+    _lockActionReceivedTs = esp_timer_get_time() / 1000;
+    _lockActionQueuedDuringBulkRead = bulkReadInProgress();
+    _nextLockAction = action;
+    _scheduler->wake();
+}
 
 void NukiOpenerWrapper::electricStrikeActuation()
 {
-    _nextLockAction = NukiOpener::LockAction::ElectricStrikeActuation;
+    queueLockAction(NukiOpener::LockAction::ElectricStrikeActuation);
 }
 
 void NukiOpenerWrapper::activateRTO()
 {
-    _nextLockAction = NukiOpener::LockAction::ActivateRTO;
+    queueLockAction(NukiOpener::LockAction::ActivateRTO);
 }
 
 void NukiOpenerWrapper::activateCM()
 {
-    _nextLockAction = NukiOpener::LockAction::ActivateCM;
+    queueLockAction(NukiOpener::LockAction::ActivateCM);
 }
 
 void NukiOpenerWrapper::deactivateRtoCm()
 {
-    if(_keyTurnerState.nukiState == NukiOpener::State::ContinuousMode) _nextLockAction = NukiOpener::LockAction::DeactivateCM;
-    else if(_keyTurnerState.lockState == NukiOpener::LockState::RTOactive) _nextLockAction = NukiOpener::LockAction::DeactivateRTO;
+    if(_keyTurnerState.nukiState == NukiOpener::State::ContinuousMode) queueLockAction(NukiOpener::LockAction::DeactivateCM);
+    else if(_keyTurnerState.lockState == NukiOpener::LockState::RTOactive) queueLockAction(NukiOpener::LockAction::DeactivateRTO);
 }
 
 void NukiOpenerWrapper::deactivateRTO()
 {
-    _nextLockAction = NukiOpener::LockAction::DeactivateRTO;
+    queueLockAction(NukiOpener::LockAction::DeactivateRTO);
 }
 
 void NukiOpenerWrapper::deactivateCM()
 {
-    _nextLockAction = NukiOpener::LockAction::DeactivateCM;
+    queueLockAction(NukiOpener::LockAction::DeactivateCM);
 }
 
 bool NukiOpenerWrapper::isPinSet()
@@ -352,7 +471,7 @@ bool NukiOpenerWrapper::isPinSet()
 
 bool NukiOpenerWrapper::isPinValid()
 {
-    return _preferences->getInt(preference_opener_pin_status, 4) == 1;
+    return _pinStatus == 1;
 }
 
 void NukiOpenerWrapper::setPin(const uint16_t pin)
@@ -382,13 +501,16 @@ void NukiOpenerWrapper::updateKeyTurnerState()
     Nuki::CmdResult result = (Nuki::CmdResult)-1;
     int retryCount = 0;
 
-    while(result != Nuki::CmdResult::Success && retryCount < _nrOfRetries + 1)
     {
-        Log->print(F("Result (attempt "));
-        Log->print(retryCount + 1);
-        Log->print("): ");
-        result =_nukiOpener.requestOpenerState(&_keyTurnerState);
-        ++retryCount;
+        BleArbiterGuard bleGuard(_bleWaitLatency);
+        while(result != Nuki::CmdResult::Success && retryCount < _nrOfRetries + 1)
+        {
+            Log->print(F("Result (attempt "));
+            Log->print(retryCount + 1);
+            Log->print("): ");
+            result =_nukiOpener.requestOpenerState(&_keyTurnerState);
+            ++retryCount;
+        }
     }
 
     char resultStr[15];
@@ -408,6 +530,8 @@ void NukiOpenerWrapper::updateKeyTurnerState()
     }
     _retryLockstateCount = 0;
 
+    ++_stateRevision;
+
     if(_statusUpdated &&
         _keyTurnerState.lockState == NukiOpener::LockState::Locked &&
         _lastKeyTurnerState.lockState == NukiOpener::LockState::Locked &&
@@ -429,6 +553,12 @@ void NukiOpenerWrapper::updateKeyTurnerState()
         _network->publishKeyTurnerState(_keyTurnerState, _lastKeyTurnerState);
         updateGpioOutputs();
 
+        if(_lockActionCompletedTs > 0)
+        {
+            _lockActionStateLatency.add((esp_timer_get_time() / 1000) - _lockActionCompletedTs);
+            _lockActionCompletedTs = 0;
+        }
+
         if(_keyTurnerState.nukiState == NukiOpener::State::ContinuousMode)
         {
             Log->println(F("Continuous Mode"));
@@ -439,10 +569,12 @@ void NukiOpenerWrapper::updateKeyTurnerState()
         Log->println(lockStateStr);
     }
 
-    if(_publishAuthData)
+    if(_publishAuthData && !postponeForLockAction(0, 0))
     {
         Log->println(F("Publishing auth data"));
+        _bulkReadActive = true;
         updateAuthData(false);
+        _bulkReadActive = false;
         Log->println(F("Done publishing auth data"));
     }
 
@@ -455,15 +587,18 @@ void NukiOpenerWrapper::updateBatteryState()
     Nuki::CmdResult result = (Nuki::CmdResult)-1;
     int retryCount = 0;
 
-    while(retryCount < _nrOfRetries + 1)
     {
-        Log->print(F("Querying opener battery state: "));
-        result = _nukiOpener.requestBatteryReport(&_batteryReport);
-        delay(250);
-        if(result != Nuki::CmdResult::Success) {
-            ++retryCount;
+        BleArbiterGuard bleGuard(_bleWaitLatency);
+        while(retryCount < _nrOfRetries + 1)
+        {
+            Log->print(F("Querying opener battery state: "));
+            result = _nukiOpener.requestBatteryReport(&_batteryReport);
+            delay(250);
+            if(result != Nuki::CmdResult::Success) {
+                ++retryCount;
+            }
+            else break;
         }
-        else break;
     }
 
     printCommandResult(result);
@@ -500,40 +635,45 @@ void NukiOpenerWrapper::updateConfig()
             _hasKeypad = _nukiConfig.hasKeypad > 0 || _nukiConfig.hasKeypadV2 > 0;
             _firmwareVersion = std::to_string(_nukiConfig.firmwareVersion[0]) + "." + std::to_string(_nukiConfig.firmwareVersion[1]) + "." + std::to_string(_nukiConfig.firmwareVersion[2]);
             _hardwareVersion = std::to_string(_nukiConfig.hardwareRevision[0]) + "." + std::to_string(_nukiConfig.hardwareRevision[1]);
-            if(_preferences->getBool(preference_conf_info_enabled, true)) _network->publishConfig(_nukiConfig);
+            if(_confInfoEnabled) _network->publishConfig(_nukiConfig);
             _retryConfigCount = 0;
-            if(_preferences->getBool(preference_timecontrol_info_enabled, false)) updateTimeControl(false);
-            if(_preferences->getBool(preference_auth_info_enabled)) updateAuth(false);
+            if(_timeControlInfoEnabled) updateTimeControl(false);
+            if(_authInfoEnabled) updateAuth(false);
 
-            const int pinStatus = _preferences->getInt(preference_opener_pin_status, 4);
+            const int pinStatus = _pinStatus;
 
             if(isPinSet()) {
                 Nuki::CmdResult result = (Nuki::CmdResult)-1;
                 int retryCount = 0;
                 Log->println(F("Nuki opener PIN is set"));
 
-                while(retryCount < _nrOfRetries + 1)
                 {
-                    result = _nukiOpener.verifySecurityPin();
+                    BleArbiterGuard bleGuard(_bleWaitLatency);
+                    while(retryCount < _nrOfRetries + 1)
+                    {
+                        result = _nukiOpener.verifySecurityPin();
 
-                    if(result != Nuki::CmdResult::Success) {
-                        ++retryCount;
+                        if(result != Nuki::CmdResult::Success) {
+                            ++retryCount;
+                        }
+                        else break;
                     }
-                    else break;
                 }
 
                 if(result != Nuki::CmdResult::Success)
                 {
                     Log->println(F("Nuki opener PIN is invalid"));
                     if(pinStatus != 2) {
-                        _preferences->putInt(preference_opener_pin_status, 2);
+                        _pinStatus = 2;
+                        _preferences->putInt(preference_opener_pin_status, _pinStatus);
                     }
                 }
                 else
                 {
                     Log->println(F("Nuki opener PIN is valid"));
                     if(pinStatus != 1) {
-                        _preferences->putInt(preference_opener_pin_status, 1);
+                        _pinStatus = 1;
+                        _preferences->putInt(preference_opener_pin_status, _pinStatus);
                     }
                 }
             }
@@ -541,7 +681,8 @@ void NukiOpenerWrapper::updateConfig()
             {
                 Log->println(F("Nuki opener PIN is not set"));
                 if(pinStatus != 0) {
-                    _preferences->putInt(preference_opener_pin_status, 0);
+                    _pinStatus = 0;
+                    _preferences->putInt(preference_opener_pin_status, _pinStatus);
                 }
             }
         }
@@ -563,7 +704,7 @@ void NukiOpenerWrapper::updateConfig()
 
         if(_nukiAdvancedConfigValid)
         {
-            if(_preferences->getBool(preference_conf_info_enabled, true)) _network->publishAdvancedConfig(_nukiAdvancedConfig);
+            if(_confInfoEnabled) _network->publishAdvancedConfig(_nukiAdvancedConfig);
         }
         else
         {
@@ -594,35 +735,25 @@ void NukiOpenerWrapper::updateAuthData(bool retrieved)
         return;
     }
 
+    const int maxEntries = _authLogMaxEntries;
+
     if(!retrieved)
     {
-        Nuki::CmdResult result = (Nuki::CmdResult)-1;
-        int retryCount = 0;
+        // The newest entries are requested in descending order. Once the snapshot is filled a short page is enough
+        // on most polls, further pages are requested after it was retrieved until they reach the snapshot.
+        _authLogFetched.clear();
+        _authLogPageSize = _authLog.empty() ? maxEntries : min(maxEntries, AUTHLOG_PAGE_SIZE);
 
-        while(retryCount < _nrOfRetries + 1)
-        {
-            Log->print(F("Retrieve log entries: "));
-            result = _nukiOpener.retrieveLogEntries(0, _preferences->getInt(preference_authlog_max_entries, MAX_AUTHLOG), 1, false);
-
-            if(result != Nuki::CmdResult::Success) {
-                ++retryCount;
-            }
-            else break;
-        }
-
-        Log->println(result);
-        printCommandResult(result);
-        if(result == Nuki::CmdResult::Success)
+        if(retrieveLogEntries(0, _authLogPageSize))
         {
-            _waitAuthLogUpdateTs = (esp_timer_get_time() / 1000) + 5000;
             delay(100);
 
             std::list<NukiOpener::LogEntry> log;
             _nukiOpener.getLogEntries(&log);
 
-            if(log.size() > _preferences->getInt(preference_authlog_max_entries, 3))
+            if(log.size() > maxEntries)
             {
-                log.resize(_preferences->getInt(preference_authlog_max_entries, 3));
+                log.resize(maxEntries);
             }
 
             log.sort([](const NukiOpener::LogEntry& a, const NukiOpener::LogEntry& b) { return a.index < b.index; });
@@ -635,31 +766,85 @@ void NukiOpenerWrapper::updateAuthData(bool retrieved)
     }
     else
     {
-        std::list<NukiOpener::LogEntry> log;
-        _nukiOpener.getLogEntries(&log);
+        std::list<NukiOpener::LogEntry> page;
+        _nukiOpener.getLogEntries(&page);
+
+        const uint32_t lastIndex = _authLog.empty() ? 0 : _authLog.back().index;
+        uint32_t oldestIndex = UINT32_MAX;
+        uint32_t newestIndex = 0;
 
-        if(log.size() > _preferences->getInt(preference_authlog_max_entries, MAX_AUTHLOG))
+        for(const auto& entry : page)
         {
-            log.resize(_preferences->getInt(preference_authlog_max_entries, MAX_AUTHLOG));
+            if(entry.index < oldestIndex) oldestIndex = entry.index;
+            if(entry.index > newestIndex) newestIndex = entry.index;
+            if(entry.index > lastIndex && _authLogFetched.size() < maxEntries) _authLogFetched.push_back(entry);
         }
 
-        log.sort([](const NukiOpener::LogEntry& a, const NukiOpener::LogEntry& b) { return a.index < b.index; });
+        if(_authLogFetched.empty() && !page.empty() && newestIndex < lastIndex)
+        {
+            // The log on the device was reset, the snapshot is rebuilt from a full fetch
+            Log->println(F("Log index below last known index, reloading log"));
+            _authLog.clear();
+            updateAuthData(false);
+            return;
+        }
+
+        if(page.size() >= _authLogPageSize && oldestIndex > lastIndex + 1 && oldestIndex > 1 && _authLogFetched.size() < maxEntries)
+        {
+            // Every entry of the page is new, the entries before it may be new as well
+            Log->println(F("All entries of the log page are new, retrieving older entries"));
+            retrieveLogEntries(oldestIndex - 1, _authLogPageSize);
+            return;
+        }
 
-        Log->print(F("Log size: "));
-        Log->println(log.size());
+        Log->print(F("New log entries: "));
+        Log->println(_authLogFetched.size());
 
-        if(log.size() > 0)
+        if(!_authLogFetched.empty())
         {
-             _network->publishAuthorizationInfo(log, false);
+            _authLog.splice(_authLog.end(), _authLogFetched);
+            _authLog.sort([](const NukiOpener::LogEntry& a, const NukiOpener::LogEntry& b) { return a.index < b.index; });
+
+            while(_authLog.size() > maxEntries)
+            {
+                _authLog.pop_front();
+            }
+
+            _network->publishAuthorizationInfo(_authLog, false);
         }
     }
 
     postponeBleWatchdog();
 }
 
+bool NukiOpenerWrapper::retrieveLogEntries(const uint32_t startIndex, const uint16_t count)
+{
+    Nuki::CmdResult result = (Nuki::CmdResult)-1;
+    int retryCount = 0;
+
+    {
+        BleArbiterGuard bleGuard(_bleWaitLatency);
+        while(retryCount < _nrOfRetries + 1)
+        {
+            Log->print(F("Retrieve log entries: "));
+            result = _nukiOpener.retrieveLogEntries(startIndex, count, 1, false);
+            if(result != Nuki::CmdResult::Success) {
+                ++retryCount;
+            }
+            else break;
+        }
+    }
+
+    printCommandResult(result);
+    if(result != Nuki::CmdResult::Success) return false;
+
+    _waitAuthLogUpdateTs = (esp_timer_get_time() / 1000) + 5000;
+    return true;
+}
+
 void NukiOpenerWrapper::updateKeypad(bool retrieved)
 {
-    if(!_preferences->getBool(preference_keypad_info_enabled)) return;
+    if(!_keypadEnabled) return;
 
     if(!isPinValid())
     {
@@ -672,15 +857,18 @@ void NukiOpenerWrapper::updateKeypad(bool retrieved)
         Nuki::CmdResult result = (Nuki::CmdResult)-1;
         int retryCount = 0;
 
-        while(retryCount < _nrOfRetries + 1)
         {
-            Log->print(F("Querying opener keypad: "));
-            result = _nukiOpener.retrieveKeypadEntries(0, _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD));
+            BleArbiterGuard bleGuard(_bleWaitLatency);
+            while(retryCount < _nrOfRetries + 1)
+            {
+                Log->print(F("Querying opener keypad: "));
+                result = _nukiOpener.retrieveKeypadEntries(0, _keypadMaxEntries);
 
-            if(result != Nuki::CmdResult::Success) {
-                ++retryCount;
+                if(result != Nuki::CmdResult::Success) {
+                    ++retryCount;
+                }
+                else break;
             }
-            else break;
         }
 
         printCommandResult(result);
@@ -699,9 +887,9 @@ void NukiOpenerWrapper::updateKeypad(bool retrieved)
 
         entries.sort([](const NukiOpener::KeypadEntry& a, const NukiOpener::KeypadEntry& b) { return a.codeId < b.codeId; });
 
-        if(entries.size() > _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD))
+        if(entries.size() > _keypadMaxEntries)
         {
-            entries.resize(_preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD));
+            entries.resize(_keypadMaxEntries);
         }
 
         uint keypadCount = entries.size();
@@ -726,7 +914,7 @@ void NukiOpenerWrapper::updateKeypad(bool retrieved)
 
 void NukiOpenerWrapper::updateTimeControl(bool retrieved)
 {
-    if(!_preferences->getBool(preference_timecontrol_info_enabled)) return;
+    if(!_timeControlInfoEnabled) return;
 
     if(!isPinValid())
     {
@@ -739,15 +927,18 @@ void NukiOpenerWrapper::updateTimeControl(bool retrieved)
         Nuki::CmdResult result = (Nuki::CmdResult)-1;
         int retryCount = 0;
 
-        while(retryCount < _nrOfRetries + 1)
         {
-            Log->print(F("Querying opener timecontrol: "));
-            result = _nukiOpener.retrieveTimeControlEntries();
+            BleArbiterGuard bleGuard(_bleWaitLatency);
+            while(retryCount < _nrOfRetries + 1)
+            {
+                Log->print(F("Querying opener timecontrol: "));
+                result = _nukiOpener.retrieveTimeControlEntries();
 
-            if(result != Nuki::CmdResult::Success) {
-                ++retryCount;
+                if(result != Nuki::CmdResult::Success) {
+                    ++retryCount;
+                }
+                else break;
             }
-            else break;
         }
 
         printCommandResult(result);
@@ -766,9 +957,9 @@ void NukiOpenerWrapper::updateTimeControl(bool retrieved)
 
         timeControlEntries.sort([](const NukiOpener::TimeControlEntry& a, const NukiOpener::TimeControlEntry& b) { return a.entryId < b.entryId; });
 
-        if(timeControlEntries.size() > _preferences->getInt(preference_timecontrol_max_entries, MAX_TIMECONTROL))
+        if(timeControlEntries.size() > _timeControlMaxEntries)
         {
-            timeControlEntries.resize(_preferences->getInt(preference_timecontrol_max_entries, MAX_TIMECONTROL));
+            timeControlEntries.resize(_timeControlMaxEntries);
         }
 
         uint timeControlCount = timeControlEntries.size();
@@ -793,22 +984,25 @@ void NukiOpenerWrapper::updateTimeControl(bool retrieved)
 
 void NukiOpenerWrapper::updateAuth(bool retrieved)
 {
-    if(!_preferences->getBool(preference_auth_info_enabled)) return;
+    if(!_authInfoEnabled) return;
 
     if(!retrieved)
     {
         Nuki::CmdResult result = (Nuki::CmdResult)-1;
         int retryCount = 0;
 
-        while(retryCount < _nrOfRetries)
         {
-            Log->print(F("Querying opener authorization: "));
-            result = _nukiOpener.retrieveAuthorizationEntries(0, _preferences->getInt(preference_auth_max_entries, MAX_AUTH));
-            delay(250);
-            if(result != Nuki::CmdResult::Success) {
-                ++retryCount;
+            BleArbiterGuard bleGuard(_bleWaitLatency);
+            while(retryCount < _nrOfRetries)
+            {
+                Log->print(F("Querying opener authorization: "));
+                result = _nukiOpener.retrieveAuthorizationEntries(0, _authMaxEntries);
+                delay(250);
+                if(result != Nuki::CmdResult::Success) {
+                    ++retryCount;
+                }
+                else break;
             }
-            else break;
         }
 
         printCommandResult(result);
@@ -827,9 +1021,9 @@ void NukiOpenerWrapper::updateAuth(bool retrieved)
 
         authEntries.sort([](const NukiOpener::AuthorizationEntry& a, const NukiOpener::AuthorizationEntry& b) { return a.authId < b.authId; });
 
-        if(authEntries.size() > _preferences->getInt(preference_auth_max_entries, MAX_AUTH))
+        if(authEntries.size() > _authMaxEntries)
         {
-            authEntries.resize(_preferences->getInt(preference_auth_max_entries, MAX_AUTH));
+            authEntries.resize(_authMaxEntries);
         }
 
         uint authCount = authEntries.size();
@@ -893,7 +1087,7 @@ LockActionResult NukiOpenerWrapper::onLockActionReceivedCallback(const char *val
     if((action == NukiOpener::LockAction::ActivateRTO && (int)aclPrefs[9] == 1) || (action == NukiOpener::LockAction::DeactivateRTO && (int)aclPrefs[10] == 1) || (action == NukiOpener::LockAction::ElectricStrikeActuation && (int)aclPrefs[11] == 1) || (action == NukiOpener::LockAction::ActivateCM && (int)aclPrefs[12] == 1) || (action == NukiOpener::LockAction::DeactivateCM && (int)aclPrefs[13] == 1) || (action == NukiOpener::LockAction::FobAction1 && (int)aclPrefs[14] == 1) || (action == NukiOpener::LockAction::FobAction2 && (int)aclPrefs[15] == 1) || (action == NukiOpener::LockAction::FobAction3 && (int)aclPrefs[16] == 1))
     {
         nukiOpenerPreferences->end();
-        nukiOpenerInst->_nextLockAction = action;
+        nukiOpenerInst->queueLockAction(action);
         return LockActionResult::Success;
     }
 
@@ -2009,7 +2203,7 @@ void NukiOpenerWrapper::onKeypadJsonCommandReceived(const char *value)
                         return;
                     }
 
-                    Nuki::CmdResult resultKp = _nukiOpener.retrieveKeypadEntries(0, _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD));
+                    Nuki::CmdResult resultKp = _nukiOpener.retrieveKeypadEntries(0, _keypadMaxEntries);
                     bool foundExisting = false;
 
                     if(resultKp == Nuki::CmdResult::Success)
@@ -2694,7 +2888,7 @@ void NukiOpenerWrapper::onAuthCommandReceived(const char *value)
                         return;
                     }
 
-                    Nuki::CmdResult resultAuth = _nukiOpener.retrieveAuthorizationEntries(0, _preferences->getInt(preference_auth_max_entries, MAX_AUTH));
+                    Nuki::CmdResult resultAuth = _nukiOpener.retrieveAuthorizationEntries(0, _authMaxEntries);
                     bool foundExisting = false;
 
                     if(resultAuth == Nuki::CmdResult::Success)
@@ -2889,6 +3083,7 @@ void NukiOpenerWrapper::notify(Nuki::EventType eventType)
         Log->println("KeyTurnerStatusUpdated");
         _statusUpdated = true;
         _network->publishStatusUpdated(_statusUpdated);
+        _scheduler->wake();
     }
 }
 
@@ -2897,15 +3092,18 @@ void NukiOpenerWrapper::readConfig()
     Nuki::CmdResult result = (Nuki::CmdResult)-1;
     int retryCount = 0;
 
-    while(retryCount < _nrOfRetries + 1)
     {
-        result = _nukiOpener.requestConfig(&_nukiConfig);
-        _nukiConfigValid = result == Nuki::CmdResult::Success;
+        BleArbiterGuard bleGuard(_bleWaitLatency);
+        while(retryCount < _nrOfRetries + 1)
+        {
+            result = _nukiOpener.requestConfig(&_nukiConfig);
+            _nukiConfigValid = result == Nuki::CmdResult::Success;
 
-        if(!_nukiConfigValid) {
-            ++retryCount;
+            if(!_nukiConfigValid) {
+                ++retryCount;
+            }
+            else break;
         }
-        else break;
     }
 
     char resultStr[20];
@@ -2923,15 +3121,18 @@ void NukiOpenerWrapper::readAdvancedConfig()
     Nuki::CmdResult result = (Nuki::CmdResult)-1;
     int retryCount = 0;
 
-    while(retryCount < _nrOfRetries + 1)
     {
-         result = _nukiOpener.requestAdvancedConfig(&_nukiAdvancedConfig);
-        _nukiAdvancedConfigValid = result == Nuki::CmdResult::Success;
+        BleArbiterGuard bleGuard(_bleWaitLatency);
+        while(retryCount < _nrOfRetries + 1)
+        {
+             result = _nukiOpener.requestAdvancedConfig(&_nukiAdvancedConfig);
+            _nukiAdvancedConfigValid = result == Nuki::CmdResult::Success;
 
-        if(!_nukiAdvancedConfigValid) {
-            ++retryCount;
+            if(!_nukiAdvancedConfigValid) {
+                ++retryCount;
+            }
+            else break;
         }
-        else break;
     }
 
     char resultStr[20];
@@ -2950,8 +3151,8 @@ void NukiOpenerWrapper::setupHASS()
     char uidString[20];
     itoa(_nukiConfig.nukiId, uidString, 16);
 
-    if(_preferences->getBool(preference_opener_continuous_mode, false)) _network->publishHASSConfig((char*)"Opener", baseTopic.c_str(), (char*)_nukiConfig.name, uidString, _firmwareVersion.c_str(), _hardwareVersion.c_str(), _publishAuthData, _hasKeypad, (char*)"deactivateCM", (char*)"activateCM", (char*)"electricStrikeActuation");
-    else _network->publishHASSConfig((char*)"Opener", baseTopic.c_str(), (char*)_nukiConfig.name, uidString, _firmwareVersion.c_str(), _hardwareVersion.c_str(), _publishAuthData, _hasKeypad, (char*)"deactivateRTO", (char*)"activateRTO", (char*)"electricStrikeActuation");
+    if(_preferences->getBool(preference_opener_continuous_mode, false)) _network->publishHASSConfig("Opener", baseTopic.c_str(), _nukiConfig.name, uidString, _firmwareVersion.c_str(), _hardwareVersion.c_str(), _publishAuthData, _hasKeypad, "deactivateCM", "activateCM", "electricStrikeActuation");
+    else _network->publishHASSConfig("Opener", baseTopic.c_str(), _nukiConfig.name, uidString, _firmwareVersion.c_str(), _hardwareVersion.c_str(), _publishAuthData, _hasKeypad, "deactivateRTO", "activateRTO", "electricStrikeActuation");
 
     _hassSetupCompleted = true;
 
@@ -2982,6 +3183,77 @@ std::string NukiOpenerWrapper::hardwareVersion() const
     return _hardwareVersion;
 }
 
+const uint32_t NukiOpenerWrapper::stateRevision() const
+{
+    return _stateRevision;
+}
+
+const int NukiOpenerWrapper::rssi() const
+{
+    return _lastRssi;
+}
+
+const uint32_t NukiOpenerWrapper::lockActionAttempts() const
+{
+    return _lockActionAttempts;
+}
+
+const uint32_t NukiOpenerWrapper::lockActionRetries() const
+{
+    return _lockActionRetries;
+}
+
+const uint32_t NukiOpenerWrapper::lockActionsFailed() const
+{
+    return _lockActionsFailed;
+}
+
+const uint32_t NukiOpenerWrapper::lockActionsSuperseded() const
+{
+    return _lockActionsSuperseded;
+}
+
+const LatencyStats& NukiOpenerWrapper::bleWaitLatency() const
+{
+    return _bleWaitLatency;
+}
+
+const LatencyStats& NukiOpenerWrapper::lockActionBulkReadDispatchLatency() const
+{
+    return _lockActionBulkReadDispatchLatency;
+}
+
+const uint32_t NukiOpenerWrapper::bulkReadsPostponed() const
+{
+    return _bulkReadsPostponed;
+}
+
+const LatencyStats& NukiOpenerWrapper::lockActionDispatchLatency() const
+{
+    return _lockActionDispatchLatency;
+}
+
+const LatencyStats& NukiOpenerWrapper::lockActionCommandLatency() const
+{
+    return _lockActionCommandLatency;
+}
+
+const LatencyStats& NukiOpenerWrapper::lockActionStateLatency() const
+{
+    return _lockActionStateLatency;
+}
+
+void NukiOpenerWrapper::configToJson(JsonObject json)
+{
+    if(_nukiConfigValid) _network->configToJson(_nukiConfig, json["basic"].to<JsonObject>());
+    if(_nukiAdvancedConfigValid) _network->advancedConfigToJson(_nukiAdvancedConfig, json["advanced"].to<JsonObject>());
+}
+
+LockActionResult NukiOpenerWrapper::onLockActionReceived(const char* value)
+{
+    return onLockActionReceivedCallback(value);
+}
+
 void NukiOpenerWrapper::disableWatchdog()
 {
     _restartBeaconTimeout = -1;
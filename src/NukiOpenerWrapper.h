@@ -7,11 +7,13 @@
 #include "BleScanner.h"
 #include "Gpio.h"
 #include "NukiDeviceId.h"
+#include "LatencyStats.h"
+#include "NukiScheduler.h"
 
 class NukiOpenerWrapper : public NukiOpener::SmartlockEventHandler
 {
 public:
-    NukiOpenerWrapper(const std::string& deviceName, NukiDeviceId* deviceId, BleScanner::Scanner* scanner, NukiNetworkOpener* network, Gpio* gpio, Preferences* preferences);
+    NukiOpenerWrapper(const std::string& deviceName, NukiDeviceId* deviceId, BleScanner::Scanner* scanner, NukiNetworkOpener* network, Gpio* gpio, Preferences* preferences, NukiScheduler* scheduler);
     virtual ~NukiOpenerWrapper();
 
     void initialize();
@@ -46,6 +48,21 @@ public:
 
     BleScanner::Scanner* bleScanner();
 
+    const uint32_t stateRevision() const; // incremented when the state shown in the web UI changed
+    const int rssi() const;
+    const uint32_t lockActionAttempts() const;
+    const uint32_t lockActionRetries() const;
+    const uint32_t lockActionsFailed() const; // aborted after the configured number of retries
+    const uint32_t lockActionsSuperseded() const; // replaced by a newer action before they succeeded
+    const LatencyStats& bleWaitLatency() const; // time this worker waited for the other device's BLE transactions
+    const LatencyStats& lockActionDispatchLatency() const; // lock action received until the first BLE attempt
+    const LatencyStats& lockActionBulkReadDispatchLatency() const; // same, for actions received during a keypad, auth or log read
+    const uint32_t bulkReadsPostponed() const;
+    const LatencyStats& lockActionCommandLatency() const; // first BLE attempt until success, including retries
+    const LatencyStats& lockActionStateLatency() const; // success until the next opener state is published
+    void configToJson(JsonObject json);
+    LockActionResult onLockActionReceived(const char* value);
+
     void notify(NukiOpener::EventType eventType) override;
 
 private:
@@ -67,10 +84,16 @@ private:
     void updateBatteryState();
     void updateConfig();
     void updateAuthData(bool retrieved);
+    bool retrieveLogEntries(const uint32_t startIndex, const uint16_t count);
     void updateKeypad(bool retrieved);
     void updateTimeControl(bool retrieved);
     void updateAuth(bool retrieved);
     void postponeBleWatchdog();
+    void scheduleNextUpdate();
+    void queueLockAction(const NukiOpener::LockAction& action);
+    bool postponeForLockAction(const uint8_t& queryCommands, const uint8_t& queryCommand);
+    bool bulkReadInProgress() const;
+    void processLockAction(); // one attempt, failed attempts are retried from a later update() after _retryDelay
 
     void updateGpioOutputs();
 
@@ -98,6 +121,7 @@ private:
     NukiNetworkOpener* _network = nullptr;
     Gpio* _gpio = nullptr;
     Preferences* _preferences = nullptr;
+    NukiScheduler* _scheduler = nullptr;
     int _intervalLockstate = 0; // seconds
     int _intervalBattery = 0; // seconds
     int _intervalConfig = 60 * 60; // seconds
@@ -132,6 +156,14 @@ private:
     bool _statusUpdated = false;
     bool _hasKeypad = false;
     bool _keypadEnabled = false;
+    bool _confInfoEnabled = true;
+    bool _timeControlInfoEnabled = false;
+    bool _authInfoEnabled = false;
+    int _keypadMaxEntries = 0;
+    int _timeControlMaxEntries = 0;
+    int _authMaxEntries = 0;
+    int _authLogMaxEntries = 0;
+    int _pinStatus = 4;
     uint _maxKeypadCodeCount = 0;
     uint _maxTimeControlEntryCount = 0;
     uint _maxAuthEntryCount = 0;
@@ -140,6 +172,9 @@ private:
     int64_t _nextBatteryReportTs = 0;
     int64_t _nextConfigUpdateTs = 0;
     int64_t _waitAuthLogUpdateTs = 0;
+    std::list<NukiOpener::LogEntry> _authLog;
+    std::list<NukiOpener::LogEntry> _authLogFetched; // new entries of the pages retrieved so far
+    uint16_t _authLogPageSize = 0;
     int64_t _waitKeypadUpdateTs = 0;
     int64_t _waitTimeControlUpdateTs = 0;
     int64_t _waitAuthUpdateTs = 0;
@@ -147,10 +182,29 @@ private:
     int64_t _nextPairTs = 0;
     int64_t _nextRssiTs = 0;
     int64_t _lastRssi = 0;
+    uint32_t _stateRevision = 0;
+    int64_t _lockActionReceivedTs = 0;
+    int64_t _lockActionStartTs = 0;
+    int _lockActionRetryCount = 0;
+    uint32_t _lockActionAttempts = 0;
+    uint32_t _lockActionRetries = 0;
+    uint32_t _lockActionsFailed = 0;
+    uint32_t _lockActionsSuperseded = 0;
+    int64_t _lockActionCompletedTs = 0;
+    LatencyStats _lockActionDispatchLatency;
+    LatencyStats _lockActionCommandLatency;
+    LatencyStats _lockActionStateLatency;
+    LatencyStats _bleWaitLatency;
+    LatencyStats _lockActionBulkReadDispatchLatency;
+    bool _lockActionQueuedDuringBulkRead = false;
+    volatile bool _bulkReadActive = false;
+    uint8_t _postponedQueryCommands = 0;
+    uint8_t _postponedReads = 0; // QUERY_COMMAND_* reads already counted in _bulkReadsPostponed
+    uint32_t _bulkReadsPostponed = 0;
     int64_t _disableBleWatchdogTs = 0;
     uint32_t _basicOpenerConfigAclPrefs[16];
     uint32_t _advancedOpenerConfigAclPrefs[20];
     std::string _firmwareVersion = "";
     std::string _hardwareVersion = "";
-    NukiOpener::LockAction _nextLockAction = (NukiOpener::LockAction)0xff;
+    volatile NukiOpener::LockAction _nextLockAction = (NukiOpener::LockAction)0xff;
 };
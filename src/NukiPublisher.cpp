@@ -1,5 +1,6 @@
 #include "NukiPublisher.h"
-
+#include <algorithm>
+#include "MqttTopicHash.h"
 
 NukiPublisher::NukiPublisher(NukiNetwork *network, const char* mqttPath)
 : _network(network),
@@ -7,53 +8,109 @@ NukiPublisher::NukiPublisher(NukiNetwork *network, const char* mqttPath)
 {
 }
 
+NukiPublisher::~NukiPublisher()
+{
+    delete[] _internedPaths;
+}
+
+void NukiPublisher::internTopics(std::initializer_list<const char*> topics)
+{
+    size_t prefixLen = strlen(_mqttPath);
+    size_t size = 0;
+
+    for(const char* topic : topics)
+    {
+        size += prefixLen + strlen(topic) + 1;
+    }
+
+    delete[] _internedPaths;
+    _internedPaths = new char[size];
+    _internedTopics.clear();
+    _internedTopics.reserve(topics.size());
+
+    char* path = _internedPaths;
+
+    for(const char* topic : topics)
+    {
+        size_t topicLen = strlen(topic);
+        memcpy(path, _mqttPath, prefixLen);
+        memcpy(path + prefixLen, topic, topicLen + 1);
+        _internedTopics.push_back({ mqttTopicHash(topic), path });
+        path += prefixLen + topicLen + 1;
+    }
+
+    _internedPrefixLen = prefixLen;
+    std::sort(_internedTopics.begin(), _internedTopics.end(), [](const InternedTopic& a, const InternedTopic& b) { return a.hash < b.hash; });
+}
+
+const char* NukiPublisher::internedPath(const char *topic) const
+{
+    // Matched by content, the same topic constant can have a different address in every translation unit
+    const uint32_t hash = mqttTopicHash(topic);
+    auto entry = std::lower_bound(_internedTopics.begin(), _internedTopics.end(), hash, [](const InternedTopic& a, const uint32_t& h) { return a.hash < h; });
+
+    for(; entry != _internedTopics.end() && entry->hash == hash; ++entry)
+    {
+        if(strcmp(entry->path + _internedPrefixLen, topic) == 0) return entry->path;
+    }
+    return nullptr;
+}
+
 void NukiPublisher::publishFloat(const char *topic, const float value, bool retain, const uint8_t precision)
 {
-    _network->publishFloat(_mqttPath, topic, value, retain, precision);
+    const char* path = internedPath(topic);
+    if(path != nullptr) _network->publishFloat(nullptr, path, value, retain, precision);
+    else _network->publishFloat(_mqttPath, topic, value, retain, precision);
 }
 
 void NukiPublisher::publishInt(const char *topic, const int value, bool retain)
 {
-    _network->publishInt(_mqttPath, topic, value, retain);
+    const char* path = internedPath(topic);
+    if(path != nullptr) _network->publishInt(nullptr, path, value, retain);
+    else _network->publishInt(_mqttPath, topic, value, retain);
 }
 
 void NukiPublisher::publishUInt(const char *topic, const unsigned int value, bool retain)
 {
-    _network->publishUInt(_mqttPath, topic, value, retain);
+    const char* path = internedPath(topic);
+    if(path != nullptr) _network->publishUInt(nullptr, path, value, retain);
+    else _network->publishUInt(_mqttPath, topic, value, retain);
 }
 
 void NukiPublisher::publishBool(const char *topic, const bool value, bool retain)
 {
-    _network->publishBool(_mqttPath, topic, value, retain);
+    const char* path = internedPath(topic);
+    if(path != nullptr) _network->publishBool(nullptr, path, value, retain);
+    else _network->publishBool(_mqttPath, topic, value, retain);
 }
 
 bool NukiPublisher::publishString(const char *topic, const String &value, bool retain)
 {
-    char str[value.length() + 1];
-    memset(str, 0, sizeof(str));
-    memcpy(str, value.begin(), value.length());
-    return publishString(topic, str, retain);
+    return publishString(topic, value.c_str(), retain);
 }
 
 bool NukiPublisher::publishString(const char *topic, const std::string &value, bool retain)
 {
-    char str[value.size() + 1];
-    memset(str, 0, sizeof(str));
-    memcpy(str, value.data(), value.length());
-    return publishString(topic, str, retain);
+    return publishString(topic, value.c_str(), retain);
 }
 
 bool NukiPublisher::publishString(const char *topic, const char *value, bool retain)
 {
+    const char* path = internedPath(topic);
+    if(path != nullptr) return _network->publishString(nullptr, path, value, retain);
     return _network->publishString(_mqttPath, topic, value, retain);
 }
 
 void NukiPublisher::publishULong(const char *topic, const unsigned long value, bool retain)
 {
-    return _network->publishULong(_mqttPath, topic, value, retain);
+    const char* path = internedPath(topic);
+    if(path != nullptr) _network->publishULong(nullptr, path, value, retain);
+    else _network->publishULong(_mqttPath, topic, value, retain);
 }
 
 void NukiPublisher::publishLongLong(const char *topic, int64_t value, bool retain)
 {
-    return _network->publishLongLong(_mqttPath, topic, value, retain);
+    const char* path = internedPath(topic);
+    if(path != nullptr) _network->publishLongLong(nullptr, path, value, retain);
+    else _network->publishLongLong(_mqttPath, topic, value, retain);
 }
@@ -1,12 +1,17 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 #include "NukiNetwork.h"
 
 class NukiPublisher
 {
 public:
     NukiPublisher(NukiNetwork* _network, const char* mqttPath);
+    virtual ~NukiPublisher();
+
+    void internTopics(std::initializer_list<const char*> topics);
+    const char* internedPath(const char* topic) const; // prefixed path of an interned topic, nullptr if it isn't one
 
     void publishFloat(const char* topic, const float value, bool retain, const uint8_t precision = 2);
     void publishInt(const char* topic, const int value, bool retain);
@@ -19,7 +24,16 @@ public:
     bool publishString(const char* topic, const char* value, bool retain);
 
 private:
+    struct InternedTopic
+    {
+        uint32_t hash; // mqttTopicHash() of the topic
+        const char* path; // prefix followed by the topic
+    };
+
     NukiNetwork* _network;
     const char* _mqttPath;
 
+    std::vector<InternedTopic> _internedTopics; // sorted by hash
+    char* _internedPaths = nullptr;
+    size_t _internedPrefixLen = 0;
 };
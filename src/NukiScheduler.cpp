@@ -0,0 +1,81 @@
+#include "NukiScheduler.h"
+#include "Config.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+
+NukiScheduler* NukiScheduler::_instances[NUKI_SCHEDULER_MAX_INSTANCES] = {nullptr};
+uint8_t NukiScheduler::_instanceCount = 0;
+
+void NukiScheduler::initialize(TaskHandle_t taskHandle)
+{
+    _taskHandle = taskHandle;
+    if(_instanceCount < NUKI_SCHEDULER_MAX_INSTANCES) _instances[_instanceCount++] = this;
+}
+
+void IRAM_ATTR NukiScheduler::wake()
+{
+    if(_taskHandle == nullptr) return;
+
+    if(_wakeRequestedTs == 0) _wakeRequestedTs = esp_timer_get_time();
+
+    if(xPortInIsrContext())
+    {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(_taskHandle, &higherPriorityTaskWoken);
+        if(higherPriorityTaskWoken == pdTRUE) portYIELD_FROM_ISR();
+    }
+    else
+    {
+        xTaskNotifyGive(_taskHandle);
+    }
+}
+
+void NukiScheduler::wakeAll()
+{
+    for(uint8_t i = 0; i < _instanceCount; i++)
+    {
+        _instances[i]->wake();
+    }
+}
+
+void NukiScheduler::scheduleAt(const int64_t& ts)
+{
+    if(ts < _nextDeadlineTs) _nextDeadlineTs = ts;
+}
+
+void NukiScheduler::waitForWork()
+{
+    int64_t ts = (esp_timer_get_time() / 1000);
+    int64_t timeout = NUKI_TASK_MAX_IDLE_TIME;
+
+    if(_nextDeadlineTs - ts < timeout) timeout = _nextDeadlineTs - ts;
+    _nextDeadlineTs = INT64_MAX;
+
+    if(timeout > 0)
+    {
+        if(ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout)) == 0) ++_timedWakeups;
+    }
+
+    if(_wakeRequestedTs != 0)
+    {
+        _lastWakeLatency = esp_timer_get_time() - _wakeRequestedTs;
+        _wakeRequestedTs = 0;
+    }
+
+    ++_wakeups;
+}
+
+const uint32_t NukiScheduler::wakeups() const
+{
+    return _wakeups;
+}
+
+const uint32_t NukiScheduler::timedWakeups() const
+{
+    return _timedWakeups;
+}
+
+const int64_t NukiScheduler::lastWakeLatency() const
+{
+    return _lastWakeLatency;
+}
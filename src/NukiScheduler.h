@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define NUKI_SCHEDULER_MAX_INSTANCES 2
+
+// Wakes a BLE worker task (nukiTask, nukiOpenerTask) when work has been posted (BLE beacon, MQTT command,
+// GPIO action) or when the earliest deadline scheduled by its device wrapper has expired.
+class NukiScheduler
+{
+public:
+    void initialize(TaskHandle_t taskHandle);
+
+    void wake(); // safe to call from task and ISR context
+    void scheduleAt(const int64_t& ts); // ms, esp_timer based
+    void waitForWork();
+
+    const uint32_t wakeups() const;
+    const uint32_t timedWakeups() const;
+    const int64_t lastWakeLatency() const; // us from wake() until the worker task resumed
+
+    static void wakeAll(); // work that isn't bound to one device (MQTT message, reconnect)
+
+private:
+    TaskHandle_t _taskHandle = nullptr;
+    int64_t _nextDeadlineTs = INT64_MAX;
+    volatile int64_t _wakeRequestedTs = 0;
+    uint32_t _wakeups = 0;
+    uint32_t _timedWakeups = 0;
+    int64_t _lastWakeLatency = 0;
+
+    static NukiScheduler* _instances[NUKI_SCHEDULER_MAX_INSTANCES];
+    static uint8_t _instanceCount;
+};
@@ -5,10 +5,12 @@
 #include "RestartReason.h"
 #include <NukiLockUtils.h>
 #include "Config.h"
+#include "NukiScheduler.h"
+#include "BleArbiter.h"
 
 NukiWrapper* nukiInst = nullptr;
 
-NukiWrapper::NukiWrapper(const std::string& deviceName, NukiDeviceId* deviceId, BleScanner::Scanner* scanner, NukiNetworkLock* network, NukiOfficial* nukiOfficial, Gpio* gpio, Preferences* preferences)
+NukiWrapper::NukiWrapper(const std::string& deviceName, NukiDeviceId* deviceId, BleScanner::Scanner* scanner, NukiNetworkLock* network, NukiOfficial* nukiOfficial, Gpio* gpio, Preferences* preferences, NukiScheduler* scheduler)
 : _deviceName(deviceName),
   _deviceId(deviceId),
   _bleScanner(scanner),
@@ -16,7 +18,8 @@ NukiWrapper::NukiWrapper(const std::string& deviceName, NukiDeviceId* deviceId,
   _network(network),
   _nukiOfficial(nukiOfficial),
   _gpio(gpio),
-  _preferences(preferences)
+  _preferences(preferences),
+  _scheduler(scheduler)
 {
     Log->print("Device id lock: ");
     Log->println(_deviceId->get());
@@ -128,6 +131,14 @@ void NukiWrapper::readSettings()
     _intervalBattery = _preferences->getInt(preference_query_interval_battery);
     _intervalKeypad = _preferences->getInt(preference_query_interval_keypad);
     _keypadEnabled = _preferences->getBool(preference_keypad_info_enabled);
+    _confInfoEnabled = _preferences->getBool(preference_conf_info_enabled, true);
+    _timeControlInfoEnabled = _preferences->getBool(preference_timecontrol_info_enabled, false);
+    _authInfoEnabled = _preferences->getBool(preference_auth_info_enabled, false);
+    _keypadMaxEntries = _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD);
+    _timeControlMaxEntries = _preferences->getInt(preference_timecontrol_max_entries, MAX_TIMECONTROL);
+    _authMaxEntries = _preferences->getInt(preference_auth_max_entries, MAX_AUTH);
+    _authLogMaxEntries = _preferences->getInt(preference_authlog_max_entries, MAX_AUTHLOG);
+    _pinStatus = _preferences->getInt(preference_lock_pin_status, 4);
     _publishAuthData = _preferences->getBool(preference_publish_authdata);
     _maxKeypadCodeCount = _preferences->getUInt(preference_lock_max_keypad_code_count);
     _maxTimeControlEntryCount = _preferences->getUInt(preference_lock_max_timecontrol_entry_count);
@@ -138,6 +149,8 @@ void NukiWrapper::readSettings()
     _rssiPublishInterval = _preferences->getInt(preference_rssi_publish_interval) * 1000;
     _disableNonJSON = _preferences->getBool(preference_disable_non_json, false);
 
+    _network->readSettings();
+
     _preferences->getBytes(preference_conf_lock_basic_acl, &_basicLockConfigaclPrefs, sizeof(_basicLockConfigaclPrefs));
     _preferences->getBytes(preference_conf_lock_advanced_acl, &_advancedLockConfigaclPrefs, sizeof(_advancedLockConfigaclPrefs));
 
@@ -215,7 +228,13 @@ void NukiWrapper::update()
                                            Nuki::AuthorizationIdType::App :
                                            Nuki::AuthorizationIdType::Bridge;
 
-        if(_nukiLock.pairNuki(idType) == Nuki::PairingResult::Success)
+        Nuki::PairingResult pairingResult;
+        {
+            BleArbiterGuard bleGuard(_bleWaitLatency);
+            pairingResult = _nukiLock.pairNuki(idType);
+        }
+
+        if(pairingResult == Nuki::PairingResult::Success)
         {
             Log->println(F("Nuki paired"));
             _paired = true;
@@ -230,7 +249,8 @@ void NukiWrapper::update()
 
     int64_t lastReceivedBeaconTs = _nukiLock.getLastReceivedBeaconTs();
     int64_t ts = (esp_timer_get_time() / 1000);
-    uint8_t queryCommands = _network->queryCommands();
+    uint8_t queryCommands = _network->queryCommands() | _postponedQueryCommands;
+    _postponedQueryCommands = 0;
 
     if(_restartBeaconTimeout > 0 &&
        ts > 60000 &&
@@ -249,58 +269,12 @@ void NukiWrapper::update()
 
     if(_nukiOfficial->getOffCommandExecutedTs() > 0 && ts >= _nukiOfficial->getOffCommandExecutedTs())
     {
-        nukiInst->_nextLockAction = _offCommand;
+        queueLockAction(_offCommand);
         _nukiOfficial->clearOffCommandExecutedTs();
     }
-    if(_nextLockAction != (NukiLock::LockAction)0xff)
+    if(_nextLockAction != (NukiLock::LockAction)0xff && ts >= _nextRetryTs)
     {
-        int retryCount = 0;
-        Nuki::CmdResult cmdResult;
-
-        while(retryCount < _nrOfRetries + 1 && cmdResult != Nuki::CmdResult::Success)
-        {
-            cmdResult = _nukiLock.lockAction(_nextLockAction, 0, 0);
-            char resultStr[15] = {0};
-            NukiLock::cmdResultToString(cmdResult, resultStr);
-            _network->publishCommandResult(resultStr);
-
-            Log->print(F("Lock action result: "));
-            Log->println(resultStr);
-
-            if(cmdResult != Nuki::CmdResult::Success)
-            {
-                Log->print(F("Lock: Last command failed, retrying after "));
-                Log->print(_retryDelay);
-                Log->print(F(" milliseconds. Retry "));
-                Log->print(retryCount + 1);
-                Log->print(" of ");
-                Log->println(_nrOfRetries);
-
-                _network->publishRetry(std::to_string(retryCount + 1));
-
-                delay(_retryDelay);
-
-                ++retryCount;
-            }
-            postponeBleWatchdog();
-        }
-
-        if(cmdResult == Nuki::CmdResult::Success)
-        {
-            _nextLockAction = (NukiLock::LockAction) 0xff;
-            _network->publishRetry("--");
-            retryCount = 0;
-            if(!_nukiOfficial->getOffConnected()) _statusUpdated = true; Log->println(F("Lock: updating status after action"));
-            _statusUpdatedTs = ts;
-            if(_intervalLockstate > 10) _nextLockStateUpdateTs = ts + 10 * 1000;
-        }
-        else
-        {
-            Log->println(F("Lock: Maximum number of retries exceeded, aborting."));
-            _network->publishRetry("failed");
-            retryCount = 0;
-            _nextLockAction = (NukiLock::LockAction) 0xff;
-        }
+        processLockAction();
     }
     if(_nukiOfficial->getStatusUpdated() || _statusUpdated || _nextLockStateUpdateTs == 0 || ts >= _nextLockStateUpdateTs || (queryCommands & QUERY_COMMAND_LOCKSTATE) > 0)
     {
@@ -312,13 +286,13 @@ void NukiWrapper::update()
     }
     if(!_statusUpdated)
     {
-        if(_nextBatteryReportTs == 0 || ts > _nextBatteryReportTs || (queryCommands & QUERY_COMMAND_BATTERY) > 0)
+        if((_nextBatteryReportTs == 0 || ts > _nextBatteryReportTs || (queryCommands & QUERY_COMMAND_BATTERY) > 0) && !postponeForLockAction(queryCommands, QUERY_COMMAND_BATTERY))
         {
             Log->println("Updating Lock battery state based on timer or query");
             _nextBatteryReportTs = ts + _intervalBattery * 1000;
             updateBatteryState();
         }
-        if(_nextConfigUpdateTs == 0 || ts > _nextConfigUpdateTs || (queryCommands & QUERY_COMMAND_CONFIG) > 0)
+        if((_nextConfigUpdateTs == 0 || ts > _nextConfigUpdateTs || (queryCommands & QUERY_COMMAND_CONFIG) > 0) && !postponeForLockAction(queryCommands, QUERY_COMMAND_CONFIG))
         {
             Log->println("Updating Lock config based on timer or query");
             _nextConfigUpdateTs = ts + _intervalConfig * 1000;
@@ -361,13 +335,16 @@ void NukiWrapper::update()
             {
                 _network->publishRssi(rssi);
                 _lastRssi = rssi;
+                ++_stateRevision;
             }
         }
-        if(_hasKeypad && _keypadEnabled && (_nextKeypadUpdateTs == 0 || ts > _nextKeypadUpdateTs || (queryCommands & QUERY_COMMAND_KEYPAD) > 0))
+        if(_hasKeypad && _keypadEnabled && (_nextKeypadUpdateTs == 0 || ts > _nextKeypadUpdateTs || (queryCommands & QUERY_COMMAND_KEYPAD) > 0) && !postponeForLockAction(queryCommands, QUERY_COMMAND_KEYPAD))
         {
             Log->println("Updating Lock keypad based on timer or query");
             _nextKeypadUpdateTs = ts + _intervalKeypad * 1000;
+            _bulkReadActive = true;
             updateKeypad(false);
+            _bulkReadActive = false;
         }
     }
     if(_clearAuthData)
@@ -378,31 +355,175 @@ void NukiWrapper::update()
     }
 
     memcpy(&_lastKeyTurnerState, &_keyTurnerState, sizeof(NukiLock::KeyTurnerState));
+
+    scheduleNextUpdate();
+}
+
+void NukiWrapper::processLockAction()
+{
+    const NukiLock::LockAction action = _nextLockAction;
+    int64_t attemptTs = esp_timer_get_time() / 1000;
+
+    if(_lockActionRetryCount == 0)
+    {
+        _lockActionStartTs = attemptTs;
+        if(_lockActionReceivedTs > 0)
+        {
+            _lockActionDispatchLatency.add(attemptTs - _lockActionReceivedTs);
+            if(_lockActionQueuedDuringBulkRead) _lockActionBulkReadDispatchLatency.add(attemptTs - _lockActionReceivedTs);
+        }
+        _lockActionReceivedTs = 0;
+    }
+
+    Nuki::CmdResult cmdResult;
+    {
+        BleArbiterGuard bleGuard(_bleWaitLatency);
+        cmdResult = _nukiLock.lockAction(action, 0, 0);
+    }
+    ++_lockActionAttempts;
+    postponeBleWatchdog();
+
+    char resultStr[15] = {0};
+    NukiLock::cmdResultToString(cmdResult, resultStr);
+    _network->publishCommandResult(resultStr);
+
+    Log->print(F("Lock action result: "));
+    Log->println(resultStr);
+
+    if(_nextLockAction != action)
+    {
+        // A newer action was queued while this one was executed, queueLockAction() already reset the retry state
+        Log->println(F("Lock: Action superseded by a newer action"));
+        return;
+    }
+
+    if(cmdResult == Nuki::CmdResult::Success)
+    {
+        _nextLockAction = (NukiLock::LockAction) 0xff;
+        _lockActionRetryCount = 0;
+        _nextRetryTs = 0;
+        _network->publishRetry("--");
+        _lockActionCompletedTs = esp_timer_get_time() / 1000;
+        _lockActionCommandLatency.add(_lockActionCompletedTs - _lockActionStartTs);
+        if(!_nukiOfficial->getOffConnected()) _statusUpdated = true; Log->println(F("Lock: updating status after action"));
+        _statusUpdatedTs = attemptTs;
+        if(_intervalLockstate > 10) _nextLockStateUpdateTs = attemptTs + 10 * 1000;
+    }
+    else if(_lockActionRetryCount < _nrOfRetries)
+    {
+        ++_lockActionRetryCount;
+        ++_lockActionRetries;
+
+        Log->print(F("Lock: Last command failed, retrying after "));
+        Log->print(_retryDelay);
+        Log->print(F(" milliseconds. Retry "));
+        Log->print(_lockActionRetryCount);
+        Log->print(" of ");
+        Log->println(_nrOfRetries);
+
+        _network->publishRetry(std::to_string(_lockActionRetryCount));
+        _nextRetryTs = (esp_timer_get_time() / 1000) + _retryDelay;
+    }
+    else
+    {
+        ++_lockActionsFailed;
+        Log->println(F("Lock: Maximum number of retries exceeded, aborting."));
+        _network->publishRetry("failed");
+        _nextLockAction = (NukiLock::LockAction) 0xff;
+        _lockActionRetryCount = 0;
+        _nextRetryTs = 0;
+    }
+}
+
+void NukiWrapper::scheduleNextUpdate()
+{
+    if(_statusUpdated || _clearAuthData)
+    {
+        _scheduler->scheduleAt(esp_timer_get_time() / 1000);
+        return;
+    }
+
+    // A pending action is retried once _nextRetryTs expires, 0 runs it right away. The bulk reads that are due stay
+    // postponed until then and their expired deadlines would wake the task in a loop, update() runs them after the action.
+    if(_nextLockAction != (NukiLock::LockAction)0xff)
+    {
+        _scheduler->scheduleAt(_nextRetryTs);
+        return;
+    }
+
+    // update() compares most timestamps with '>', so wake one ms after they expire
+    _scheduler->scheduleAt(_nextLockStateUpdateTs);
+    _scheduler->scheduleAt(_nextBatteryReportTs + 1);
+    _scheduler->scheduleAt(_nextConfigUpdateTs + 1);
+    if(_waitAuthLogUpdateTs != 0) _scheduler->scheduleAt(_waitAuthLogUpdateTs + 1);
+    if(_waitKeypadUpdateTs != 0) _scheduler->scheduleAt(_waitKeypadUpdateTs + 1);
+    if(_waitTimeControlUpdateTs != 0) _scheduler->scheduleAt(_waitTimeControlUpdateTs + 1);
+    if(_waitAuthUpdateTs != 0) _scheduler->scheduleAt(_waitAuthUpdateTs + 1);
+    if(_rssiPublishInterval > 0) _scheduler->scheduleAt(_nextRssiTs + 1);
+    if(_hasKeypad && _keypadEnabled) _scheduler->scheduleAt(_nextKeypadUpdateTs + 1);
+    if(_nukiOfficial->getOffCommandExecutedTs() > 0) _scheduler->scheduleAt(_nukiOfficial->getOffCommandExecutedTs());
+}
+
+bool NukiWrapper::postponeForLockAction(const uint8_t& queryCommands, const uint8_t& queryCommand)
+{
+    // Bulk BLE reads yield to pending actions, the read stays due and runs in a later pass
+    if(_nextLockAction == (NukiLock::LockAction)0xff)
+    {
+        _postponedReads &= ~queryCommand;
+        return false;
+    }
+
+    _postponedQueryCommands |= (queryCommands & queryCommand);
+
+    // update() checks the read again on every pass until the action completed, it is counted once
+    if(queryCommand == 0 || (_postponedReads & queryCommand) == 0)
+    {
+        _postponedReads |= queryCommand;
+        ++_bulkReadsPostponed;
+    }
+    return true;
+}
+
+bool NukiWrapper::bulkReadInProgress() const
+{
+    return _bulkReadActive || _waitAuthLogUpdateTs != 0 || _waitKeypadUpdateTs != 0 || _waitTimeControlUpdateTs != 0 || _waitAuthUpdateTs != 0;
+}
+
+void NukiWrapper::queueLockAction(const NukiLock::LockAction& action)
+{
+    // A newer action replaces a pending one, including one waiting for its next retry
+    if(_nextLockAction != (NukiLock::LockAction)0xff) ++_lockActionsSuperseded;
+    _lockActionRetryCount = 0;
+    _nextRetryTs = 0;
+    _lockActionReceivedTs = esp_timer_get_time() / 1000;
+    _lockActionQueuedDuringBulkRead = bulkReadInProgress();
+    _nextLockAction = action;
+    _scheduler->wake();
 }
 
 void NukiWrapper::lock()
 {
-    _nextLockAction = NukiLock::LockAction::Lock;
+    queueLockAction(NukiLock::LockAction::Lock);
 }
 
 void NukiWrapper::unlock()
 {
-    _nextLockAction = NukiLock::LockAction::Unlock;
+    queueLockAction(NukiLock::LockAction::Unlock);
 }
 
 void NukiWrapper::unlatch()
 {
-    _nextLockAction = NukiLock::LockAction::Unlatch;
+    queueLockAction(NukiLock::LockAction::Unlatch);
 }
 
 void NukiWrapper::lockngo()
 {
-    _nextLockAction = NukiLock::LockAction::LockNgo;
+    queueLockAction(NukiLock::LockAction::LockNgo);
 }
 
 void NukiWrapper::lockngounlatch()
 {
-    _nextLockAction = NukiLock::LockAction::LockNgoUnlatch;
+    queueLockAction(NukiLock::LockAction::LockNgoUnlatch);
 }
 
 bool NukiWrapper::isPinSet()
@@ -412,7 +533,7 @@ bool NukiWrapper::isPinSet()
 
 bool NukiWrapper::isPinValid()
 {
-    return _preferences->getInt(preference_lock_pin_status, 4) == 1;
+    return _pinStatus == 1;
 }
 
 void NukiWrapper::setPin(const uint16_t pin)
@@ -444,13 +565,16 @@ void NukiWrapper::updateKeyTurnerState()
 
     Log->println(F("Querying lock state"));
 
-    while(result != Nuki::CmdResult::Success && retryCount < _nrOfRetries + 1)
     {
-        Log->print(F("Result (attempt "));
-        Log->print(retryCount + 1);
-        Log->print(F("): "));
-        result =_nukiLock.requestKeyTurnerState(&_keyTurnerState);
-        ++retryCount;
+        BleArbiterGuard bleGuard(_bleWaitLatency);
+        while(result != Nuki::CmdResult::Success && retryCount < _nrOfRetries + 1)
+        {
+            Log->print(F("Result (attempt "));
+            Log->print(retryCount + 1);
+            Log->print(F("): "));
+            result =_nukiLock.requestKeyTurnerState(&_keyTurnerState);
+            ++retryCount;
+        }
     }
 
     char resultStr[15];
@@ -485,10 +609,12 @@ void NukiWrapper::updateKeyTurnerState()
        lockState == NukiLock::LockState::BootRun ||
        lockState == NukiLock::LockState::MotorBlocked)
     {
-        if(_publishAuthData && (lockState == NukiLock::LockState::Locked || lockState == NukiLock::LockState::Unlocked))
+        if(_publishAuthData && (lockState == NukiLock::LockState::Locked || lockState == NukiLock::LockState::Unlocked) && !postponeForLockAction(0, 0))
         {
             Log->println(F("Publishing auth data"));
+            _bulkReadActive = true;
             updateAuthData(false);
+            _bulkReadActive = false;
             Log->println(F("Done publishing auth data"));
         }
 
@@ -501,6 +627,13 @@ void NukiWrapper::updateKeyTurnerState()
     }
 
     _network->publishKeyTurnerState(_keyTurnerState, _lastKeyTurnerState);
+    ++_stateRevision;
+
+    if(_lockActionCompletedTs > 0)
+    {
+        _lockActionStateLatency.add((esp_timer_get_time() / 1000) - _lockActionCompletedTs);
+        _lockActionCompletedTs = 0;
+    }
 
     char lockStateStr[20];
     lockstateToString(lockState, lockStateStr);
@@ -517,17 +650,20 @@ void NukiWrapper::updateBatteryState()
 
     Log->println("Querying lock battery state");
 
-    while(retryCount < _nrOfRetries + 1)
     {
-        Log->print(F("Result (attempt "));
-        Log->print(retryCount + 1);
-        Log->print("): ");
-        result = _nukiLock.requestBatteryReport(&_batteryReport);
+        BleArbiterGuard bleGuard(_bleWaitLatency);
+        while(retryCount < _nrOfRetries + 1)
+        {
+            Log->print(F("Result (attempt "));
+            Log->print(retryCount + 1);
+            Log->print("): ");
+            result = _nukiLock.requestBatteryReport(&_batteryReport);
 
-        if(result != Nuki::CmdResult::Success) {
-            ++retryCount;
+            if(result != Nuki::CmdResult::Success) {
+                ++retryCount;
+            }
+            else break;
         }
-        else break;
     }
 
     printCommandResult(result);
@@ -564,38 +700,43 @@ void NukiWrapper::updateConfig()
             _hasKeypad = _nukiConfig.hasKeypad > 0 || _nukiConfig.hasKeypadV2 > 0;
             _firmwareVersion = std::to_string(_nukiConfig.firmwareVersion[0]) + "." + std::to_string(_nukiConfig.firmwareVersion[1]) + "." + std::to_string(_nukiConfig.firmwareVersion[2]);
             _hardwareVersion = std::to_string(_nukiConfig.hardwareRevision[0]) + "." + std::to_string(_nukiConfig.hardwareRevision[1]);
-            if(_preferences->getBool(preference_conf_info_enabled, true)) _network->publishConfig(_nukiConfig);
-            if(_preferences->getBool(preference_timecontrol_info_enabled)) updateTimeControl(false);
-            if(_preferences->getBool(preference_auth_info_enabled)) updateAuth(false);
+            if(_confInfoEnabled) _network->publishConfig(_nukiConfig);
+            if(_timeControlInfoEnabled) updateTimeControl(false);
+            if(_authInfoEnabled) updateAuth(false);
 
-            const int pinStatus = _preferences->getInt(preference_lock_pin_status, 4);
+            const int pinStatus = _pinStatus;
 
             if(isPinSet()) {
                 Nuki::CmdResult result = (Nuki::CmdResult)-1;
                 int retryCount = 0;
                 Log->println(F("Nuki Lock PIN is set"));
 
-                while(retryCount < _nrOfRetries + 1)
                 {
-                    result = _nukiLock.verifySecurityPin();
-                    if(result != Nuki::CmdResult::Success) {
-                        ++retryCount;
+                    BleArbiterGuard bleGuard(_bleWaitLatency);
+                    while(retryCount < _nrOfRetries + 1)
+                    {
+                        result = _nukiLock.verifySecurityPin();
+                        if(result != Nuki::CmdResult::Success) {
+                            ++retryCount;
+                        }
+                        else break;
                     }
-                    else break;
                 }
 
                 if(result != Nuki::CmdResult::Success)
                 {
                     Log->println(F("Nuki Lock PIN is invalid"));
                     if(pinStatus != 2) {
-                        _preferences->putInt(preference_lock_pin_status, 2);
+                        _pinStatus = 2;
+                        _preferences->putInt(preference_lock_pin_status, _pinStatus);
                     }
                 }
                 else
                 {
                     Log->println(F("Nuki Lock PIN is valid"));
                     if(pinStatus != 1) {
-                        _preferences->putInt(preference_lock_pin_status, 1);
+                        _pinStatus = 1;
+                        _preferences->putInt(preference_lock_pin_status, _pinStatus);
                     }
                 }
             }
@@ -603,7 +744,8 @@ void NukiWrapper::updateConfig()
             {
                 Log->println(F("Nuki Lock PIN is not set"));
                 if(pinStatus != 0) {
-                    _preferences->putInt(preference_lock_pin_status, 0);
+                    _pinStatus = 0;
+                    _preferences->putInt(preference_lock_pin_status, _pinStatus);
                 }
             }
         }
@@ -625,7 +767,7 @@ void NukiWrapper::updateConfig()
 
         if(_nukiAdvancedConfigValid)
         {
-            if(_preferences->getBool(preference_conf_info_enabled, true)) _network->publishAdvancedConfig(_nukiAdvancedConfig);
+            if(_confInfoEnabled) _network->publishAdvancedConfig(_nukiAdvancedConfig);
         }
         else
         {
@@ -656,33 +798,25 @@ void NukiWrapper::updateAuthData(bool retrieved)
         return;
     }
 
+    const int maxEntries = _authLogMaxEntries;
+
     if(!retrieved)
     {
-        Nuki::CmdResult result = (Nuki::CmdResult)-1;
-        int retryCount = 0;
+        // The newest entries are requested in descending order. Once the snapshot is filled a short page is enough
+        // on most polls, further pages are requested after it was retrieved until they reach the snapshot.
+        _authLogFetched.clear();
+        _authLogPageSize = _authLog.empty() ? maxEntries : min(maxEntries, AUTHLOG_PAGE_SIZE);
 
-        while(retryCount < _nrOfRetries + 1)
-        {
-            Log->print(F("Retrieve log entries: "));
-            result = _nukiLock.retrieveLogEntries(0, _preferences->getInt(preference_authlog_max_entries, MAX_AUTHLOG), 1, false);
-            if(result != Nuki::CmdResult::Success) {
-                ++retryCount;
-            }
-            else break;
-        }
-
-        printCommandResult(result);
-        if(result == Nuki::CmdResult::Success)
+        if(retrieveLogEntries(0, _authLogPageSize))
         {
-            _waitAuthLogUpdateTs = (esp_timer_get_time() / 1000) + 5000;
             delay(100);
 
             std::list<NukiLock::LogEntry> log;
             _nukiLock.getLogEntries(&log);
 
-            if(log.size() > _preferences->getInt(preference_authlog_max_entries, 3))
+            if(log.size() > maxEntries)
             {
-                log.resize(_preferences->getInt(preference_authlog_max_entries, 3));
+                log.resize(maxEntries);
             }
 
             log.sort([](const NukiLock::LogEntry& a, const NukiLock::LogEntry& b) { return a.index < b.index; });
@@ -695,31 +829,85 @@ void NukiWrapper::updateAuthData(bool retrieved)
     }
     else
     {
-        std::list<NukiLock::LogEntry> log;
-        _nukiLock.getLogEntries(&log);
+        std::list<NukiLock::LogEntry> page;
+        _nukiLock.getLogEntries(&page);
 
-        if(log.size() > _preferences->getInt(preference_authlog_max_entries, MAX_AUTHLOG))
+        const uint32_t lastIndex = _authLog.empty() ? 0 : _authLog.back().index;
+        uint32_t oldestIndex = UINT32_MAX;
+        uint32_t newestIndex = 0;
+
+        for(const auto& entry : page)
         {
-            log.resize(_preferences->getInt(preference_authlog_max_entries, MAX_AUTHLOG));
+            if(entry.index < oldestIndex) oldestIndex = entry.index;
+            if(entry.index > newestIndex) newestIndex = entry.index;
+            if(entry.index > lastIndex && _authLogFetched.size() < maxEntries) _authLogFetched.push_back(entry);
         }
 
-        log.sort([](const NukiLock::LogEntry& a, const NukiLock::LogEntry& b) { return a.index < b.index; });
+        if(_authLogFetched.empty() && !page.empty() && newestIndex < lastIndex)
+        {
+            // The log on the device was reset, the snapshot is rebuilt from a full fetch
+            Log->println(F("Log index below last known index, reloading log"));
+            _authLog.clear();
+            updateAuthData(false);
+            return;
+        }
 
-        Log->print(F("Log size: "));
-        Log->println(log.size());
+        if(page.size() >= _authLogPageSize && oldestIndex > lastIndex + 1 && oldestIndex > 1 && _authLogFetched.size() < maxEntries)
+        {
+            // Every entry of the page is new, the entries before it may be new as well
+            Log->println(F("All entries of the log page are new, retrieving older entries"));
+            retrieveLogEntries(oldestIndex - 1, _authLogPageSize);
+            return;
+        }
+
+        Log->print(F("New log entries: "));
+        Log->println(_authLogFetched.size());
 
-        if(log.size() > 0)
+        if(!_authLogFetched.empty())
         {
-             _network->publishAuthorizationInfo(log, false);
+            _authLog.splice(_authLog.end(), _authLogFetched);
+            _authLog.sort([](const NukiLock::LogEntry& a, const NukiLock::LogEntry& b) { return a.index < b.index; });
+
+            while(_authLog.size() > maxEntries)
+            {
+                _authLog.pop_front();
+            }
+
+            _network->publishAuthorizationInfo(_authLog, false);
         }
     }
 
     postponeBleWatchdog();
 }
 
+bool NukiWrapper::retrieveLogEntries(const uint32_t startIndex, const uint16_t count)
+{
+    Nuki::CmdResult result = (Nuki::CmdResult)-1;
+    int retryCount = 0;
+
+    {
+        BleArbiterGuard bleGuard(_bleWaitLatency);
+        while(retryCount < _nrOfRetries + 1)
+        {
+            Log->print(F("Retrieve log entries: "));
+            result = _nukiLock.retrieveLogEntries(startIndex, count, 1, false);
+            if(result != Nuki::CmdResult::Success) {
+                ++retryCount;
+            }
+            else break;
+        }
+    }
+
+    printCommandResult(result);
+    if(result != Nuki::CmdResult::Success) return false;
+
+    _waitAuthLogUpdateTs = (esp_timer_get_time() / 1000) + 5000;
+    return true;
+}
+
 void NukiWrapper::updateKeypad(bool retrieved)
 {
-    if(!_preferences->getBool(preference_keypad_info_enabled)) return;
+    if(!_keypadEnabled) return;
 
     if(!isPinValid())
     {
@@ -732,14 +920,17 @@ void NukiWrapper::updateKeypad(bool retrieved)
         Nuki::CmdResult result = (Nuki::CmdResult)-1;
         int retryCount = 0;
 
-        while(retryCount < _nrOfRetries + 1)
         {
-            Log->print(F("Querying lock keypad: "));
-            result = _nukiLock.retrieveKeypadEntries(0, _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD));
-            if(result != Nuki::CmdResult::Success) {
-                ++retryCount;
+            BleArbiterGuard bleGuard(_bleWaitLatency);
+            while(retryCount < _nrOfRetries + 1)
+            {
+                Log->print(F("Querying lock keypad: "));
+                result = _nukiLock.retrieveKeypadEntries(0, _keypadMaxEntries);
+                if(result != Nuki::CmdResult::Success) {
+                    ++retryCount;
+                }
+                else break;
             }
-            else break;
         }
 
         printCommandResult(result);
@@ -758,9 +949,9 @@ void NukiWrapper::updateKeypad(bool retrieved)
 
         entries.sort([](const NukiLock::KeypadEntry& a, const NukiLock::KeypadEntry& b) { return a.codeId < b.codeId; });
 
-        if(entries.size() > _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD))
+        if(entries.size() > _keypadMaxEntries)
         {
-            entries.resize(_preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD));
+            entries.resize(_keypadMaxEntries);
         }
 
         uint keypadCount = entries.size();
@@ -785,7 +976,7 @@ void NukiWrapper::updateKeypad(bool retrieved)
 
 void NukiWrapper::updateTimeControl(bool retrieved)
 {
-    if(!_preferences->getBool(preference_timecontrol_info_enabled)) return;
+    if(!_timeControlInfoEnabled) return;
 
     if(!isPinValid())
     {
@@ -798,14 +989,17 @@ void NukiWrapper::updateTimeControl(bool retrieved)
         Nuki::CmdResult result = (Nuki::CmdResult)-1;
         int retryCount = 0;
 
-        while(retryCount < _nrOfRetries + 1)
         {
-            Log->print(F("Querying lock timecontrol: "));
-            result = _nukiLock.retrieveTimeControlEntries();
-            if(result != Nuki::CmdResult::Success) {
-                ++retryCount;
+            BleArbiterGuard bleGuard(_bleWaitLatency);
+            while(retryCount < _nrOfRetries + 1)
+            {
+                Log->print(F("Querying lock timecontrol: "));
+                result = _nukiLock.retrieveTimeControlEntries();
+                if(result != Nuki::CmdResult::Success) {
+                    ++retryCount;
+                }
+                else break;
             }
-            else break;
         }
 
         printCommandResult(result);
@@ -824,9 +1018,9 @@ void NukiWrapper::updateTimeControl(bool retrieved)
 
         timeControlEntries.sort([](const NukiLock::TimeControlEntry& a, const NukiLock::TimeControlEntry& b) { return a.entryId < b.entryId; });
 
-        if(timeControlEntries.size() > _preferences->getInt(preference_timecontrol_max_entries, MAX_TIMECONTROL))
+        if(timeControlEntries.size() > _timeControlMaxEntries)
         {
-            timeControlEntries.resize(_preferences->getInt(preference_timecontrol_max_entries, MAX_TIMECONTROL));
+            timeControlEntries.resize(_timeControlMaxEntries);
         }
 
         uint timeControlCount = timeControlEntries.size();
@@ -851,22 +1045,25 @@ void NukiWrapper::updateTimeControl(bool retrieved)
 
 void NukiWrapper::updateAuth(bool retrieved)
 {
-    if(!_preferences->getBool(preference_auth_info_enabled)) return;
+    if(!_authInfoEnabled) return;
 
     if(!retrieved)
     {
         Nuki::CmdResult result = (Nuki::CmdResult)-1;
         int retryCount = 0;
 
-        while(retryCount < _nrOfRetries)
         {
-            Log->print(F("Querying lock authorization: "));
-            result = _nukiLock.retrieveAuthorizationEntries(0, _preferences->getInt(preference_auth_max_entries, MAX_AUTH));
-            delay(250);
-            if(result != Nuki::CmdResult::Success) {
-                ++retryCount;
+            BleArbiterGuard bleGuard(_bleWaitLatency);
+            while(retryCount < _nrOfRetries)
+            {
+                Log->print(F("Querying lock authorization: "));
+                result = _nukiLock.retrieveAuthorizationEntries(0, _authMaxEntries);
+                delay(250);
+                if(result != Nuki::CmdResult::Success) {
+                    ++retryCount;
+                }
+                else break;
             }
-            else break;
         }
 
         printCommandResult(result);
@@ -885,9 +1082,9 @@ void NukiWrapper::updateAuth(bool retrieved)
 
         authEntries.sort([](const NukiLock::AuthorizationEntry& a, const NukiLock::AuthorizationEntry& b) { return a.authId < b.authId; });
 
-        if(authEntries.size() > _preferences->getInt(preference_auth_max_entries, MAX_AUTH))
+        if(authEntries.size() > _authMaxEntries)
         {
-            authEntries.resize(_preferences->getInt(preference_auth_max_entries, MAX_AUTH));
+            authEntries.resize(_authMaxEntries);
         }
 
         uint authCount = authEntries.size();
@@ -954,7 +1151,7 @@ LockActionResult NukiWrapper::onLockActionReceived(const char *value)
 
     if((action == NukiLock::LockAction::Lock && (int)aclPrefs[0] == 1) || (action == NukiLock::LockAction::Unlock && (int)aclPrefs[1] == 1) || (action == NukiLock::LockAction::Unlatch && (int)aclPrefs[2] == 1) || (action == NukiLock::LockAction::LockNgo && (int)aclPrefs[3] == 1) || (action == NukiLock::LockAction::LockNgoUnlatch && (int)aclPrefs[4] == 1) || (action == NukiLock::LockAction::FullLock && (int)aclPrefs[5] == 1) || (action == NukiLock::LockAction::FobAction1 && (int)aclPrefs[6] == 1) || (action == NukiLock::LockAction::FobAction2 && (int)aclPrefs[7] == 1) || (action == NukiLock::LockAction::FobAction3 && (int)aclPrefs[8] == 1))
     {
-        if(!_nukiOfficial->getOffConnected()) nukiInst->_nextLockAction = action;
+        if(!_nukiOfficial->getOffConnected()) queueLockAction(action);
         else
         {
             if(_preferences->getBool(preference_official_hybrid_actions, false))
@@ -962,10 +1159,11 @@ LockActionResult NukiWrapper::onLockActionReceived(const char *value)
                 _nukiOfficial->setOffCommandExecutedTs((esp_timer_get_time() / 1000) + 2000);
                 _offCommand = action;
                 _network->publishOffAction((int)action);
+                _scheduler->wake();
             }
             else
             {
-                nukiInst->_nextLockAction = action;
+                queueLockAction(action);
             }
         }
         return LockActionResult::Success;
@@ -1706,6 +1904,8 @@ void NukiWrapper::onGpioActionReceived(const GpioAction &action, const int &pin)
             }
             break;
     }
+
+    _scheduler->wake();
 }
 
 void NukiWrapper::onKeypadCommandReceived(const char *command, const uint &id, const String &name, const String &code, const int& enabled)
@@ -2131,7 +2331,7 @@ void NukiWrapper::onKeypadJsonCommandReceived(const char *value)
                         return;
                     }
 
-                    Nuki::CmdResult resultKp = _nukiLock.retrieveKeypadEntries(0, _preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD));
+                    Nuki::CmdResult resultKp = _nukiLock.retrieveKeypadEntries(0, _keypadMaxEntries);
                     bool foundExisting = false;
 
                     if(resultKp == Nuki::CmdResult::Success)
@@ -2819,7 +3019,7 @@ void NukiWrapper::onAuthCommandReceived(const char *value)
                         return;
                     }
 
-                    Nuki::CmdResult resultAuth = _nukiLock.retrieveAuthorizationEntries(0, _preferences->getInt(preference_auth_max_entries, MAX_AUTH));
+                    Nuki::CmdResult resultAuth = _nukiLock.retrieveAuthorizationEntries(0, _authMaxEntries);
                     delay(250);
                     bool foundExisting = false;
 
@@ -3017,6 +3217,7 @@ void NukiWrapper::notify(Nuki::EventType eventType)
                 _network->publishStatusUpdated(_statusUpdated);
             }
         }
+        _scheduler->wake();
     }
 }
 
@@ -3027,7 +3228,10 @@ void NukiWrapper::readConfig()
 
     while(retryCount < _nrOfRetries + 1)
     {
-        result = _nukiLock.requestConfig(&_nukiConfig);
+        {
+            BleArbiterGuard bleGuard(_bleWaitLatency);
+            result = _nukiLock.requestConfig(&_nukiConfig);
+        }
         _nukiConfigValid = result == Nuki::CmdResult::Success;
 
         char resultStr[20];
@@ -3051,7 +3255,10 @@ void NukiWrapper::readAdvancedConfig()
 
     while(retryCount < _nrOfRetries + 1)
     {
-         result = _nukiLock.requestAdvancedConfig(&_nukiAdvancedConfig);
+        {
+            BleArbiterGuard bleGuard(_bleWaitLatency);
+            result = _nukiLock.requestAdvancedConfig(&_nukiAdvancedConfig);
+        }
         _nukiAdvancedConfigValid = result == Nuki::CmdResult::Success;
 
         char resultStr[20];
@@ -3077,7 +3284,7 @@ void NukiWrapper::setupHASS()
     char uidString[20];
     itoa(_nukiConfig.nukiId, uidString, 16);
 
-    _network->publishHASSConfig((char*)"SmartLock", baseTopic.c_str(),(char*)_nukiConfig.name, uidString, _firmwareVersion.c_str(), _hardwareVersion.c_str(), hasDoorSensor(), _hasKeypad, _publishAuthData, (char*)"lock", (char*)"unlock", (char*)"unlatch");
+    _network->publishHASSConfig("SmartLock", baseTopic.c_str(), _nukiConfig.name, uidString, _firmwareVersion.c_str(), _hardwareVersion.c_str(), hasDoorSensor(), _hasKeypad, _publishAuthData, "lock", "unlock", "unlatch");
     _hassSetupCompleted = true;
 
     Log->println("HASS setup for lock completed.");
@@ -3119,6 +3326,72 @@ std::string NukiWrapper::hardwareVersion() const
     return _hardwareVersion;
 }
 
+const uint32_t NukiWrapper::stateRevision() const
+{
+    return _stateRevision;
+}
+
+const int NukiWrapper::rssi() const
+{
+    return _lastRssi;
+}
+
+const uint32_t NukiWrapper::lockActionAttempts() const
+{
+    return _lockActionAttempts;
+}
+
+const uint32_t NukiWrapper::lockActionRetries() const
+{
+    return _lockActionRetries;
+}
+
+const uint32_t NukiWrapper::lockActionsFailed() const
+{
+    return _lockActionsFailed;
+}
+
+const uint32_t NukiWrapper::lockActionsSuperseded() const
+{
+    return _lockActionsSuperseded;
+}
+
+const LatencyStats& NukiWrapper::bleWaitLatency() const
+{
+    return _bleWaitLatency;
+}
+
+const LatencyStats& NukiWrapper::lockActionBulkReadDispatchLatency() const
+{
+    return _lockActionBulkReadDispatchLatency;
+}
+
+const uint32_t NukiWrapper::bulkReadsPostponed() const
+{
+    return _bulkReadsPostponed;
+}
+
+const LatencyStats& NukiWrapper::lockActionDispatchLatency() const
+{
+    return _lockActionDispatchLatency;
+}
+
+const LatencyStats& NukiWrapper::lockActionCommandLatency() const
+{
+    return _lockActionCommandLatency;
+}
+
+const LatencyStats& NukiWrapper::lockActionStateLatency() const
+{
+    return _lockActionStateLatency;
+}
+
+void NukiWrapper::configToJson(JsonObject json)
+{
+    if(_nukiConfigValid) _network->configToJson(_nukiConfig, json["basic"].to<JsonObject>());
+    if(_nukiAdvancedConfigValid) _network->advancedConfigToJson(_nukiAdvancedConfig, json["advanced"].to<JsonObject>());
+}
+
 void NukiWrapper::disableWatchdog()
 {
     _restartBeaconTimeout = -1;
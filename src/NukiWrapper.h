@@ -9,11 +9,13 @@
 #include "LockActionResult.h"
 #include "NukiDeviceId.h"
 #include "NukiOfficial.h"
+#include "LatencyStats.h"
+#include "NukiScheduler.h"
 
 class NukiWrapper : public Nuki::SmartlockEventHandler
 {
 public:
-    NukiWrapper(const std::string& deviceName, NukiDeviceId* deviceId, BleScanner::Scanner* scanner, NukiNetworkLock* network, NukiOfficial* nukiOfficial, Gpio* gpio, Preferences* preferences);
+    NukiWrapper(const std::string& deviceName, NukiDeviceId* deviceId, BleScanner::Scanner* scanner, NukiNetworkLock* network, NukiOfficial* nukiOfficial, Gpio* gpio, Preferences* preferences, NukiScheduler* scheduler);
     virtual ~NukiWrapper();
 
     void initialize(const bool& firstStart);
@@ -46,6 +48,21 @@ public:
     std::string firmwareVersion() const;
     std::string hardwareVersion() const;
 
+    const uint32_t stateRevision() const; // incremented when the state shown in the web UI changed
+    const int rssi() const;
+    const uint32_t lockActionAttempts() const;
+    const uint32_t lockActionRetries() const;
+    const uint32_t lockActionsFailed() const; // aborted after the configured number of retries
+    const uint32_t lockActionsSuperseded() const; // replaced by a newer action before they succeeded
+    const LatencyStats& bleWaitLatency() const; // time this worker waited for the other device's BLE transactions
+    const LatencyStats& lockActionDispatchLatency() const; // lock action received until the first BLE attempt
+    const LatencyStats& lockActionBulkReadDispatchLatency() const; // same, for actions received during a keypad, auth or log read
+    const uint32_t bulkReadsPostponed() const;
+    const LatencyStats& lockActionCommandLatency() const; // first BLE attempt until success, including retries
+    const LatencyStats& lockActionStateLatency() const; // success until the next lock state is published
+    void configToJson(JsonObject json);
+    LockActionResult onLockActionReceived(const char* value);
+
     void notify(Nuki::EventType eventType) override;
 
 private:
@@ -57,7 +74,6 @@ private:
     static void onTimeControlCommandReceivedCallback(const char* value);
     static void onAuthCommandReceivedCallback(const char* value);
     static void gpioActionCallback(const GpioAction& action, const int& pin);
-    LockActionResult onLockActionReceived(const char* value);
     void onKeypadCommandReceived(const char* command, const uint& id, const String& name, const String& code, const int& enabled);
     void onOfficialUpdateReceived(const char* topic, const char* value);
     void onConfigUpdateReceived(const char* value);
@@ -70,10 +86,16 @@ private:
     void updateBatteryState();
     void updateConfig();
     void updateAuthData(bool retrieved);
+    bool retrieveLogEntries(const uint32_t startIndex, const uint16_t count);
     void updateKeypad(bool retrieved);
     void updateTimeControl(bool retrieved);
     void updateAuth(bool retrieved);
     void postponeBleWatchdog();
+    void scheduleNextUpdate();
+    void queueLockAction(const NukiLock::LockAction& action);
+    bool postponeForLockAction(const uint8_t& queryCommands, const uint8_t& queryCommand);
+    bool bulkReadInProgress() const;
+    void processLockAction(); // one attempt, failed attempts are retried from a later update() after _retryDelay
 
     void updateGpioOutputs();
 
@@ -99,6 +121,7 @@ private:
     NukiOfficial* _nukiOfficial = nullptr;
     Gpio* _gpio = nullptr;
     Preferences* _preferences;
+    NukiScheduler* _scheduler = nullptr;
     int _intervalLockstate = 0; // seconds
     int _intervalHybridLockstate = 0; // seconds
     int _intervalBattery = 0; // seconds
@@ -130,6 +153,14 @@ private:
     bool _statusUpdated = false;
     bool _hasKeypad = false;
     bool _keypadEnabled = false;
+    bool _confInfoEnabled = true;
+    bool _timeControlInfoEnabled = false;
+    bool _authInfoEnabled = false;
+    int _keypadMaxEntries = 0;
+    int _timeControlMaxEntries = 0;
+    int _authMaxEntries = 0;
+    int _authLogMaxEntries = 0;
+    int _pinStatus = 4;
     uint _maxKeypadCodeCount = 0;
     uint _maxTimeControlEntryCount = 0;
     uint _maxAuthEntryCount = 0;
@@ -144,12 +175,34 @@ private:
     int64_t _nextBatteryReportTs = 0;
     int64_t _nextConfigUpdateTs = 0;
     int64_t _waitAuthLogUpdateTs = 0;
+    std::list<NukiLock::LogEntry> _authLog;
+    std::list<NukiLock::LogEntry> _authLogFetched; // new entries of the pages retrieved so far
+    uint16_t _authLogPageSize = 0;
     int64_t _waitKeypadUpdateTs = 0;
     int64_t _waitTimeControlUpdateTs = 0;
     int64_t _waitAuthUpdateTs = 0;
     int64_t _nextKeypadUpdateTs = 0;
     int64_t _nextRssiTs = 0;
     int64_t _lastRssi = 0;
+    uint32_t _stateRevision = 0;
+    int64_t _lockActionReceivedTs = 0;
+    int64_t _lockActionStartTs = 0;
+    int _lockActionRetryCount = 0;
+    uint32_t _lockActionAttempts = 0;
+    uint32_t _lockActionRetries = 0;
+    uint32_t _lockActionsFailed = 0;
+    uint32_t _lockActionsSuperseded = 0;
+    int64_t _lockActionCompletedTs = 0;
+    LatencyStats _lockActionDispatchLatency;
+    LatencyStats _lockActionCommandLatency;
+    LatencyStats _lockActionStateLatency;
+    LatencyStats _bleWaitLatency;
+    LatencyStats _lockActionBulkReadDispatchLatency;
+    bool _lockActionQueuedDuringBulkRead = false;
+    volatile bool _bulkReadActive = false;
+    uint8_t _postponedQueryCommands = 0;
+    uint8_t _postponedReads = 0; // QUERY_COMMAND_* reads already counted in _bulkReadsPostponed
+    uint32_t _bulkReadsPostponed = 0;
     int64_t _disableBleWatchdogTs = 0;
     uint32_t _basicLockConfigaclPrefs[16];
     uint32_t _advancedLockConfigaclPrefs[22];
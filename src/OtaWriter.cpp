@@ -0,0 +1,328 @@
+#include "OtaWriter.h"
+#include <cstdlib>
+#include <esp_timer.h>
+#include "rom/miniz.h"
+#include "Logger.h"
+
+#define OTA_IMAGE_MAGIC 0xe9
+
+#define GZIP_FLAG_HCRC 0x02
+#define GZIP_FLAG_EXTRA 0x04
+#define GZIP_FLAG_NAME 0x08
+#define GZIP_FLAG_COMMENT 0x10
+
+enum GzipStage : uint8_t
+{
+    GzipFixedHeader,
+    GzipExtraLength,
+    GzipExtra,
+    GzipName,
+    GzipComment,
+    GzipHeaderCrc,
+    GzipDeflate
+};
+
+struct OtaInflateState
+{
+    tinfl_decompressor decompressor;
+    uint8_t dictionary[TINFL_LZ_DICT_SIZE]; // inflated output doubles as the sliding window
+    size_t dictionaryOffset;
+};
+
+OtaWriter::~OtaWriter()
+{
+    abort();
+}
+
+bool OtaWriter::begin()
+{
+    abort();
+
+    _format = OtaImageFormat::Unknown;
+    _magicLength = 0;
+    _gzipStage = GzipFixedHeader;
+    _gzipFlags = 0;
+    _gzipCount = 0;
+    _inflateDone = false;
+    _bytesReceived = 0;
+    _bytesWritten = 0;
+    _flashTime = 0;
+    _error = "";
+    _startTs = esp_timer_get_time();
+
+    _partition = esp_ota_get_next_update_partition(NULL);
+    if(_partition == nullptr) return fail("No OTA partition available");
+
+    // Sequential writes erase the partition as the image grows, the size of a compressed image is unknown
+    if(esp_ota_begin(_partition, OTA_WITH_SEQUENTIAL_WRITES, &_handle) != ESP_OK)
+    {
+        _handle = 0;
+        return fail("Failed to start OTA");
+    }
+
+    return true;
+}
+
+bool OtaWriter::resume(const int httpStatus)
+{
+    if(!active()) return false;
+    if(httpStatus == 206 && _bytesReceived > 0) return true;
+    if(httpStatus != 200) return false;
+    if(_bytesReceived == 0) return true;
+
+    Log->println(F("Server doesn't support resuming, restarting download"));
+    return begin();
+}
+
+bool OtaWriter::write(const uint8_t* data, size_t len)
+{
+    if(!active()) return false;
+
+    _bytesReceived += len;
+
+    if(_format == OtaImageFormat::Unknown)
+    {
+        while(len > 0 && _magicLength < sizeof(_magic))
+        {
+            _magic[_magicLength++] = *data++;
+            --len;
+        }
+        if(_magicLength < sizeof(_magic)) return true;
+
+        if(_magic[0] == OTA_IMAGE_MAGIC) _format = OtaImageFormat::Raw;
+        else if(_magic[0] == 0x1f && _magic[1] == 0x8b) _format = OtaImageFormat::Gzip;
+        else if((_magic[0] & 0x0f) == 8 && ((_magic[0] << 8) | _magic[1]) % 31 == 0) _format = OtaImageFormat::Zlib;
+        else return fail("Unknown image format");
+
+        if(_format != OtaImageFormat::Raw)
+        {
+            _inflate = (OtaInflateState*)malloc(sizeof(OtaInflateState));
+            if(_inflate == nullptr) return fail("Not enough memory to inflate image");
+            tinfl_init(&_inflate->decompressor);
+            _inflate->dictionaryOffset = 0;
+        }
+
+        if(!consume(_magic, _magicLength)) return false;
+    }
+
+    return consume(data, len);
+}
+
+bool OtaWriter::end()
+{
+    if(!active()) return false;
+
+    if(_format == OtaImageFormat::Unknown) return fail("Image incomplete");
+    if(_format != OtaImageFormat::Raw && !_inflateDone) return fail("Compressed image incomplete");
+
+    esp_err_t err = esp_ota_end(_handle);
+    _handle = 0;
+    release();
+
+    if(err != ESP_OK) return fail(err == ESP_ERR_OTA_VALIDATE_FAILED ? "Image validation failed" : "Failed to finish OTA");
+    if(esp_ota_set_boot_partition(_partition) != ESP_OK) return fail("Failed to set boot partition");
+
+    logStatistics();
+    return true;
+}
+
+void OtaWriter::abort()
+{
+    if(_handle != 0)
+    {
+        esp_ota_abort(_handle);
+        _handle = 0;
+    }
+    release();
+}
+
+const bool OtaWriter::active() const
+{
+    return _handle != 0;
+}
+
+const OtaImageFormat OtaWriter::format() const
+{
+    return _format;
+}
+
+const size_t OtaWriter::bytesReceived() const
+{
+    return _bytesReceived;
+}
+
+const size_t OtaWriter::bytesWritten() const
+{
+    return _bytesWritten;
+}
+
+const char* OtaWriter::error() const
+{
+    return _error;
+}
+
+void OtaWriter::logStatistics() const
+{
+    int64_t duration = (esp_timer_get_time() - _startTs) / 1000;
+
+    Log->print(F("OTA "));
+    Log->print(formatName(_format));
+    Log->print(F(" image: "));
+    Log->print(_bytesReceived);
+    Log->print(F(" bytes received, "));
+    Log->print(_bytesWritten);
+    Log->print(F(" bytes written in "));
+    Log->print((uint32_t)duration);
+    Log->print(F(" ms ("));
+    Log->print((uint32_t)(_flashTime / 1000));
+    Log->print(F(" ms writing flash), "));
+    Log->print(duration > 0 ? (uint32_t)(_bytesReceived / duration) : 0);
+    Log->println(F(" kB/s"));
+}
+
+const char* OtaWriter::formatName(const OtaImageFormat& format)
+{
+    switch(format)
+    {
+        case OtaImageFormat::Raw:
+            return "raw";
+        case OtaImageFormat::Gzip:
+            return "gzip";
+        case OtaImageFormat::Zlib:
+            return "zlib";
+        default:
+            return "unknown";
+    }
+}
+
+bool OtaWriter::consume(const uint8_t* data, size_t len)
+{
+    switch(_format)
+    {
+        case OtaImageFormat::Raw:
+            return flash(data, len);
+        case OtaImageFormat::Gzip:
+            skipGzipHeader(data, len);
+            if(_gzipStage != GzipDeflate) return active();
+            return inflate(data, len);
+        case OtaImageFormat::Zlib:
+            return inflate(data, len);
+        default:
+            return fail("Unknown image format");
+    }
+}
+
+void OtaWriter::skipGzipHeader(const uint8_t*& data, size_t& len)
+{
+    while(len > 0 && _gzipStage != GzipDeflate)
+    {
+        uint8_t c = *data++;
+        --len;
+
+        switch(_gzipStage)
+        {
+            case GzipFixedHeader:
+                // magic (2), method (1), flags (1), mtime (4), extra flags (1), os (1)
+                if(_gzipCount == 2 && c != 8)
+                {
+                    fail("Unsupported gzip compression method");
+                    return;
+                }
+                if(_gzipCount == 3) _gzipFlags = c;
+                if(++_gzipCount == 10) nextGzipStage();
+                break;
+            case GzipExtraLength:
+                if(_gzipCount == 0xffff)
+                {
+                    _gzipCount = c;
+                }
+                else
+                {
+                    _gzipCount |= c << 8;
+                    _gzipStage = GzipExtra;
+                    if(_gzipCount == 0) nextGzipStage();
+                }
+                break;
+            case GzipExtra:
+            case GzipHeaderCrc:
+                if(--_gzipCount == 0) nextGzipStage();
+                break;
+            case GzipName:
+            case GzipComment:
+                if(c == 0) nextGzipStage();
+                break;
+        }
+    }
+}
+
+void OtaWriter::nextGzipStage()
+{
+    if(_gzipStage < GzipExtraLength && (_gzipFlags & GZIP_FLAG_EXTRA))
+    {
+        _gzipStage = GzipExtraLength;
+        _gzipCount = 0xffff;
+    }
+    else if(_gzipStage < GzipName && (_gzipFlags & GZIP_FLAG_NAME)) _gzipStage = GzipName;
+    else if(_gzipStage < GzipComment && (_gzipFlags & GZIP_FLAG_COMMENT)) _gzipStage = GzipComment;
+    else if(_gzipStage < GzipHeaderCrc && (_gzipFlags & GZIP_FLAG_HCRC))
+    {
+        _gzipStage = GzipHeaderCrc;
+        _gzipCount = 2;
+    }
+    else _gzipStage = GzipDeflate;
+}
+
+bool OtaWriter::inflate(const uint8_t* data, size_t len)
+{
+    // The gzip trailer (and anything else after the deflate stream) is ignored, the image carries its own checksum
+    while(!_inflateDone)
+    {
+        size_t inSize = len;
+        size_t outSize = TINFL_LZ_DICT_SIZE - _inflate->dictionaryOffset;
+        mz_uint32 flags = TINFL_FLAG_HAS_MORE_INPUT;
+        if(_format == OtaImageFormat::Zlib) flags |= TINFL_FLAG_PARSE_ZLIB_HEADER;
+
+        tinfl_status status = tinfl_decompress(&_inflate->decompressor, data, &inSize, _inflate->dictionary,
+                                               _inflate->dictionary + _inflate->dictionaryOffset, &outSize, flags);
+        data += inSize;
+        len -= inSize;
+
+        if(outSize > 0 && !flash(_inflate->dictionary + _inflate->dictionaryOffset, outSize)) return false;
+        _inflate->dictionaryOffset = (_inflate->dictionaryOffset + outSize) & (TINFL_LZ_DICT_SIZE - 1);
+
+        if(status < TINFL_STATUS_DONE) return fail("Invalid compressed data");
+        if(status == TINFL_STATUS_DONE) _inflateDone = true;
+        else if(status == TINFL_STATUS_NEEDS_MORE_INPUT) break;
+    }
+
+    return true;
+}
+
+bool OtaWriter::flash(const uint8_t* data, size_t len)
+{
+    if(len == 0) return true;
+
+    int64_t start = esp_timer_get_time();
+    esp_err_t err = esp_ota_write(_handle, data, len);
+    _flashTime += esp_timer_get_time() - start;
+
+    if(err != ESP_OK) return fail(err == ESP_ERR_OTA_VALIDATE_FAILED ? "Invalid image" : "Failed to write image");
+
+    _bytesWritten += len;
+    return true;
+}
+
+bool OtaWriter::fail(const char* message)
+{
+    _error = message;
+    Log->print(F("OTA failed: "));
+    Log->println(message);
+    abort();
+    return false;
+}
+
+void OtaWriter::release()
+{
+    free(_inflate);
+    _inflate = nullptr;
+}
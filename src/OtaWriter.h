@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "esp_ota_ops.h"
+
+enum class OtaImageFormat : uint8_t
+{
+    Unknown,
+    Raw,
+    Gzip,
+    Zlib
+};
+
+struct OtaInflateState;
+
+// Writes a firmware image to the next OTA partition as it arrives. The format is detected from the first bytes,
+// gzip and zlib compressed images are inflated on the fly, so neither image has to fit into memory.
+// The input has to be fed strictly in order, after a failed download it can be continued from bytesReceived(),
+// everything before that offset has already been written to flash.
+class OtaWriter
+{
+public:
+    OtaWriter() = default;
+    ~OtaWriter();
+
+    bool begin();
+    bool resume(const int httpStatus); // continues at bytesReceived() after 206, restarts the image after 200
+    bool write(const uint8_t* data, size_t len);
+    bool end(); // validates the image and selects it as boot partition
+    void abort();
+
+    const bool active() const;
+    const OtaImageFormat format() const;
+    const size_t bytesReceived() const;
+    const size_t bytesWritten() const;
+    const char* error() const;
+    void logStatistics() const;
+
+    static const char* formatName(const OtaImageFormat& format);
+
+private:
+    bool consume(const uint8_t* data, size_t len);
+    void skipGzipHeader(const uint8_t*& data, size_t& len);
+    void nextGzipStage();
+    bool inflate(const uint8_t* data, size_t len);
+    bool flash(const uint8_t* data, size_t len);
+    bool fail(const char* message);
+    void release();
+
+    const esp_partition_t* _partition = nullptr;
+    esp_ota_handle_t _handle = 0;
+    OtaImageFormat _format = OtaImageFormat::Unknown;
+    OtaInflateState* _inflate = nullptr;
+    uint8_t _magic[2] = {0};
+    uint8_t _magicLength = 0;
+    uint8_t _gzipStage = 0;
+    uint8_t _gzipFlags = 0;
+    uint16_t _gzipCount = 0;
+    bool _inflateDone = false;
+    size_t _bytesReceived = 0;
+    size_t _bytesWritten = 0;
+    int64_t _startTs = 0;
+    int64_t _flashTime = 0;
+    const char* _error = "";
+};
@@ -260,10 +260,11 @@ inline bool initPreferences(Preferences* preferences)
     return firstStart;
 }
 
+// Key lists are static, so constructing a DebugPreferences is free
 class DebugPreferences
 {
 private:
-    std::vector<char*> _keys =
+    static inline const std::vector<char*> _keys =
     {
             preference_started_before, preference_config_version, preference_device_id_lock, preference_device_id_opener, preference_nuki_id_lock, preference_nuki_id_opener,
             preference_mqtt_broker, preference_mqtt_broker_port, preference_mqtt_user, preference_mqtt_password, preference_mqtt_log_enabled, preference_check_updates,
@@ -286,12 +287,12 @@ private:
             preference_network_custom_pwr, preference_network_custom_mdio, preference_ntw_reconfigure, preference_lock_max_auth_entry_count, preference_opener_max_auth_entry_count,
             preference_auth_control_enabled, preference_auth_topic_per_entry, preference_auth_info_enabled, preference_auth_max_entries,
     };
-    std::vector<char*> _redact =
+    static inline const std::vector<char*> _redact =
     {
         preference_mqtt_user, preference_mqtt_password, preference_mqtt_ca, preference_mqtt_crt, preference_mqtt_key, preference_cred_user, preference_cred_password,
         preference_nuki_id_lock, preference_nuki_id_opener,
     };
-    std::vector<char*> _boolPrefs =
+    static inline const std::vector<char*> _boolPrefs =
     {
             preference_started_before, preference_mqtt_log_enabled, preference_check_updates, preference_lock_enabled, preference_opener_enabled, preference_opener_continuous_mode,
             preference_timecontrol_topic_per_entry, preference_keypad_topic_per_entry, preference_enable_bootloop_reset, preference_webserver_enabled, preference_find_best_rssi,
@@ -302,12 +303,12 @@ private:
             preference_auth_control_enabled, preference_auth_topic_per_entry, preference_auth_info_enabled, preference_recon_netw_on_mqtt_discon, preference_webserial_enabled,
             preference_ntw_reconfigure
     };
-    std::vector<char*> _bytePrefs =
+    static inline const std::vector<char*> _bytePrefs =
     {
             preference_acl, preference_conf_info_enabled, preference_conf_lock_basic_acl, preference_conf_lock_advanced_acl, preference_conf_opener_basic_acl,
             preference_conf_opener_advanced_acl, preference_gpio_configuration
     };
-    std::vector<char*> _intPrefs =
+    static inline const std::vector<char*> _intPrefs =
     {
             preference_config_version, preference_device_id_lock, preference_device_id_opener, preference_nuki_id_lock, preference_nuki_id_opener, preference_mqtt_broker_port,
             preference_lock_pin_status, preference_opener_pin_status, preference_lock_max_keypad_code_count, preference_opener_max_keypad_code_count,
@@ -321,23 +322,23 @@ private:
             preference_network_custom_mosi, preference_network_custom_pwr, preference_network_custom_mdio
     };
 public:
-    const std::vector<char*> getPreferencesKeys()
+    const std::vector<char*>& getPreferencesKeys()
     {
         return _keys;
     }
-    const std::vector<char*> getPreferencesRedactedKeys()
+    const std::vector<char*>& getPreferencesRedactedKeys()
     {
         return _redact;
     }
-    const std::vector<char*> getPreferencesBoolKeys()
+    const std::vector<char*>& getPreferencesBoolKeys()
     {
         return _boolPrefs;
     }
-    const std::vector<char*> getPreferencesByteKeys()
+    const std::vector<char*>& getPreferencesByteKeys()
     {
         return _bytePrefs;
     }
-    const std::vector<char*> getPreferencesIntKeys()
+    const std::vector<char*>& getPreferencesIntKeys()
     {
         return _intPrefs;
     }
@@ -10,7 +10,6 @@
 #ifndef CONFIG_IDF_TARGET_ESP32H2
 #include <esp_wifi.h>
 #endif
-#include <Update.h>
 
 extern const uint8_t x509_crt_imported_bundle_bin_start[] asm("_binary_x509_crt_bundle_start");
 extern const uint8_t x509_crt_imported_bundle_bin_end[]   asm("_binary_x509_crt_bundle_end");
@@ -19,6 +18,9 @@ extern const uint8_t x509_crt_imported_bundle_bin_end[]   asm("_binary_x509_crt_
 #include <HTTPClient.h>
 #include <NetworkClientSecure.h>
 #include "ArduinoJson.h"
+#include "Packets/PacketPool.h"
+#include "JsonArena.h"
+#include "WebCfgSettings.h"
 
 WebCfgServer::WebCfgServer(NukiWrapper* nuki, NukiOpenerWrapper* nukiOpener, NukiNetwork* network, Gpio* gpio, Preferences* preferences, bool allowRestartToPortal, uint8_t partitionType, AsyncWebServer* asyncServer)
 : _nuki(nuki),
@@ -94,11 +96,27 @@ void WebCfgServer::initialize()
         sendFavicon(request);
     });
     #ifndef NUKI_HUB_UPDATER
+    _events = new AsyncEventSource("/events");
+    if(strlen(_credUser) > 0 && strlen(_credPassword) > 0) _events->setAuthentication(_credUser, _credPassword);
+    _events->onConnect([&](AsyncEventSourceClient *client)
+    {
+        JsonDocument json;
+        char buffer[WEBCFG_LIVE_STATE_BUFFER_SIZE];
+        liveStateToJson(json);
+        serializeJson(json, buffer, sizeof(buffer));
+        client->send(buffer, "state", (uint32_t)(esp_timer_get_time() / 1000), 3000);
+    });
+    _asyncServer->addHandler(_events);
     _asyncServer->on("/import", HTTP_POST, [&](AsyncWebServerRequest *request){
         if(strlen(_credUser) > 0 && strlen(_credPassword) > 0) if(!request->authenticate(_credUser, _credPassword)) return request->requestAuthentication();
         String message = "";
         bool restart = processImport(request, message);
         buildConfirmHtml(request, message, 3, true);
+    },
+    [&](AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final)
+    {
+        if(strlen(_credUser) > 0 && strlen(_credPassword) > 0) if(!request->authenticate(_credUser, _credPassword)) return;
+        handleImportUpload(request, filename, index, data, len, final);
     });
     _asyncServer->on("/export", HTTP_GET, [&](AsyncWebServerRequest *request){
         if(strlen(_credUser) > 0 && strlen(_credPassword) > 0) if(!request->authenticate(_credUser, _credPassword)) return request->requestAuthentication();
@@ -171,6 +189,26 @@ void WebCfgServer::initialize()
         if(strlen(_credUser) > 0 && strlen(_credPassword) > 0) if(!request->authenticate(_credUser, _credPassword)) return request->requestAuthentication();
         buildInfoHtml(request);
     });
+    _asyncServer->on("/api/v1/status", HTTP_GET, [&](AsyncWebServerRequest *request){
+        if(strlen(_credUser) > 0 && strlen(_credPassword) > 0) if(!request->authenticate(_credUser, _credPassword)) return request->requestAuthentication();
+        sendApiStatus(request);
+    });
+    _asyncServer->on("/api/v1/config", HTTP_GET, [&](AsyncWebServerRequest *request){
+        if(strlen(_credUser) > 0 && strlen(_credPassword) > 0) if(!request->authenticate(_credUser, _credPassword)) return request->requestAuthentication();
+        sendApiConfig(request);
+    });
+    _asyncServer->on("/api/v1/lock/action", HTTP_POST, [&](AsyncWebServerRequest *request){
+        if(strlen(_credUser) > 0 && strlen(_credPassword) > 0) if(!request->authenticate(_credUser, _credPassword)) return request->requestAuthentication();
+        processApiAction(request, false);
+    }, nullptr, [&](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total){
+        handleApiBody(request, data, len, index, total);
+    });
+    _asyncServer->on("/api/v1/opener/action", HTTP_POST, [&](AsyncWebServerRequest *request){
+        if(strlen(_credUser) > 0 && strlen(_credPassword) > 0) if(!request->authenticate(_credUser, _credPassword)) return request->requestAuthentication();
+        processApiAction(request, true);
+    }, nullptr, [&](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total){
+        handleApiBody(request, data, len, index, total);
+    });
     _asyncServer->on("/debugon", HTTP_GET, [&](AsyncWebServerRequest *request){
         if(strlen(_credUser) > 0 && strlen(_credPassword) > 0) if(!request->authenticate(_credUser, _credPassword)) return request->requestAuthentication();
         _preferences->putBool(preference_publish_debug_info, true);
@@ -238,16 +276,78 @@ void WebCfgServer::initialize()
 
 void WebCfgServer::sendResponse(AsyncWebServerRequest *request)
 {
-    AsyncWebServerResponse *response = request->beginChunkedResponse("text/html",
-    [&](uint8_t *buffer, size_t maxlen, size_t index) -> size_t {
-      size_t len = min(maxlen, _response.length() - index);
-      memcpy(buffer, _response.c_str() + index, len);
-      return len;
+    sendResponse(request, {});
+}
+
+void WebCfgServer::sendResponse(AsyncWebServerRequest *request, std::vector<std::function<void()>> sections, const char* contentType)
+{
+    WebCfgRenderContext* slot = nullptr;
+    for(WebCfgRenderContext& renderContext : _renderContexts)
+    {
+        if(!renderContext.inUse)
+        {
+            slot = &renderContext;
+            break;
+        }
+    }
+
+    if(slot == nullptr)
+    {
+        _response = "";
+        Log->println(F("Web configurator busy, rejecting request"));
+        AsyncWebServerResponse *response = request->beginResponse(503, "text/plain", "Too many concurrent requests, please retry");
+        response->addHeader("Retry-After", "1");
+        request->send(response);
+        return;
+    }
+
+    slot->inUse = true;
+    slot->nextSection = 0;
+    slot->chunkOffset = 0;
+    slot->chunk = std::move(_response);
+    slot->sections = std::move(sections);
+    _response = "";
+
+    // The slot is returned to the pool when AsyncWebServer destroys the response (sent or client gone)
+    std::shared_ptr<WebCfgRenderContext> context(slot, [](WebCfgRenderContext* renderContext)
+    {
+        renderContext->sections.clear();
+        renderContext->chunk = String();
+        renderContext->inUse = false;
+    });
+
+    AsyncWebServerResponse *response = request->beginChunkedResponse(contentType,
+    [this, context](uint8_t *buffer, size_t maxlen, size_t index) -> size_t {
+      return renderChunk(*context, buffer, maxlen);
     });
 
     request->send(response);
 }
 
+size_t WebCfgServer::renderChunk(WebCfgRenderContext& context, uint8_t *buffer, size_t maxlen)
+{
+    // Render the next section only when the previous one has been sent completely,
+    // _response is used as scratch buffer and handed over to the context
+    while(context.chunkOffset >= context.chunk.length())
+    {
+        if(context.nextSection >= context.sections.size()) return 0;
+
+        _response = "";
+        context.sections[context.nextSection]();
+        context.sections[context.nextSection] = nullptr;
+        ++context.nextSection;
+
+        context.chunk = std::move(_response);
+        context.chunkOffset = 0;
+        _response = "";
+    }
+
+    size_t len = min(maxlen, context.chunk.length() - context.chunkOffset);
+    memcpy(buffer, context.chunk.c_str() + context.chunkOffset, len);
+    context.chunkOffset += len;
+    return len;
+}
+
 void WebCfgServer::buildOtaHtml(AsyncWebServerRequest *request, bool debug)
 {
     _response = "";
@@ -383,7 +483,7 @@ void WebCfgServer::buildOtaHtml(AsyncWebServerRequest *request, bool debug)
         _response.concat("<form action=\"/reboottoota\" method=\"get\"><br><input type=\"submit\" value=\"Reboot to Nuki Hub Updater\" /></form><br><br></div>");
         _response.concat("<div id=\"upform\"><h4>Update Nuki Hub Updater</h4>");
         _response.concat("Select the latest Nuki Hub updater binary to update the Nuki Hub updater");
-        _response.concat("<form enctype=\"multipart/form-data\" action=\"/uploadota\" method=\"post\">Choose the nuki_hub_updater.bin file to upload: <input name=\"uploadedfile\" type=\"file\" accept=\".bin\" /><br/>");
+        _response.concat("<form enctype=\"multipart/form-data\" action=\"/uploadota\" method=\"post\">Choose the nuki_hub_updater.bin file (or nuki_hub_updater.bin.gz) to upload: <input name=\"uploadedfile\" type=\"file\" accept=\".bin,.gz\" /><br/>");
     }
     else
     {
@@ -393,7 +493,7 @@ void WebCfgServer::buildOtaHtml(AsyncWebServerRequest *request, bool debug)
         _response.concat("<form action=\"/reboottoota\" method=\"get\"><br><input type=\"submit\" value=\"Reboot to Nuki Hub\" /></form><br><br></div>");
         _response.concat("<div id=\"upform\"><h4>Update Nuki Hub</h4>");
         _response.concat("Select the latest Nuki Hub binary to update Nuki Hub");
-        _response.concat("<form enctype=\"multipart/form-data\" action=\"/uploadota\" method=\"post\">Choose the nuki_hub.bin file to upload: <input name=\"uploadedfile\" type=\"file\" accept=\".bin\" /><br/>");
+        _response.concat("<form enctype=\"multipart/form-data\" action=\"/uploadota\" method=\"post\">Choose the nuki_hub.bin file (or nuki_hub.bin.gz) to upload: <input name=\"uploadedfile\" type=\"file\" accept=\".bin,.gz\" /><br/>");
     }
     _response.concat("<br><input id=\"submitbtn\" type=\"submit\" value=\"Upload File\" /></form><br><br></div>");
     _response.concat("<div id=\"gitdiv\">");
@@ -491,20 +591,16 @@ void WebCfgServer::handleOtaUpload(AsyncWebServerRequest *request, String filena
         Log->println("Starting manual OTA update");
         _otaContentLen = request->contentLength();
 
+        // A compressed image is always smaller than the binary, so only the upper bound applies before the format is known
         if(_partitionType == 1 && _otaContentLen > 1600000)
         {
             Log->println("Uploaded OTA file too large, are you trying to upload a Nuki Hub binary instead of a Nuki Hub updater binary?");
-            return;
-        }
-        else if(_partitionType == 2 && _otaContentLen < 1600000)
-        {
-            Log->println("Uploaded OTA file is too small, are you trying to upload a Nuki Hub updater binary instead of a Nuki Hub binary?");
-            return;
+            restartEsp(RestartReason::OTAAborted);
         }
 
-        int cmd = U_FLASH;
-        if (!Update.begin(UPDATE_SIZE_UNKNOWN, cmd)) {
-            Update.printError(Serial);
+        if(!_otaWriter.begin())
+        {
+            restartEsp(RestartReason::OTAAborted);
         }
 
         _otaStartTs = esp_timer_get_time() / 1000;
@@ -533,8 +629,14 @@ void WebCfgServer::handleOtaUpload(AsyncWebServerRequest *request, String filena
 
     if (_otaContentLen == 0) return;
 
-    if (Update.write(data, len) != len) {
-        Update.printError(Serial);
+    if (!_otaWriter.write(data, len)) {
+        restartEsp(RestartReason::OTAAborted);
+    }
+
+    if(!index && _partitionType == 2 && _otaWriter.format() == OtaImageFormat::Raw && _otaContentLen < 1600000)
+    {
+        Log->println("Uploaded OTA file is too small, are you trying to upload a Nuki Hub updater binary instead of a Nuki Hub binary?");
+        _otaWriter.abort();
         restartEsp(RestartReason::OTAAborted);
     }
 
@@ -543,8 +645,7 @@ void WebCfgServer::handleOtaUpload(AsyncWebServerRequest *request, String filena
         response->addHeader("Refresh", "20");
         response->addHeader("Location", "/");
         request->send(response);
-        if (!Update.end(true)){
-            Update.printError(Serial);
+        if (!_otaWriter.end()){
             restartEsp(RestartReason::OTAAborted);
         } else {
             Log->print(F("Progress: 100%"));
@@ -601,6 +702,76 @@ String WebCfgServer::generateConfirmCode()
 }
 
 #ifndef NUKI_HUB_UPDATER
+static void appendJsonEscaped(String& target, const char* value)
+{
+    for(const char* c = value; *c != '\0'; c++)
+    {
+        switch(*c)
+        {
+            case '"':
+                target.concat("\\\"");
+                break;
+            case '\\':
+                target.concat("\\\\");
+                break;
+            case '\b':
+                target.concat("\\b");
+                break;
+            case '\f':
+                target.concat("\\f");
+                break;
+            case '\n':
+                target.concat("\\n");
+                break;
+            case '\r':
+                target.concat("\\r");
+                break;
+            case '\t':
+                target.concat("\\t");
+                break;
+            default:
+                if((uint8_t)*c < 0x20)
+                {
+                    char escaped[7];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+                    target.concat(escaped);
+                }
+                else
+                {
+                    target.concat(*c);
+                }
+                break;
+        }
+    }
+}
+
+static String bytesToHex(const uint8_t* data, const size_t length)
+{
+    String text;
+    text.reserve(length * 2);
+    char hex[3];
+    for(size_t i = 0; i < length; i++)
+    {
+        sprintf(hex, "%02x", data[i]);
+        text.concat(hex);
+    }
+    return text;
+}
+
+static bool hexToBytes(const String& text, uint8_t* data, const size_t length)
+{
+    if(text.length() != length * 2) return false;
+
+    for(size_t i = 0; i < length; i++)
+    {
+        char hex[3] = { text[i * 2], text[i * 2 + 1], '\0' };
+        char* end = nullptr;
+        data[i] = (uint8_t)strtoul(hex, &end, 16);
+        if(end != hex + 2) return false;
+    }
+    return true;
+}
+
 void WebCfgServer::sendSettings(AsyncWebServerRequest *request)
 {
     bool redacted = false;
@@ -617,15 +788,17 @@ void WebCfgServer::sendSettings(AsyncWebServerRequest *request)
         if(p->value() == "1") pairing = true;
     }
 
-    JsonDocument json;
-    String jsonPretty;
-
     DebugPreferences debugPreferences;
 
-    const std::vector<char*> keysPrefs = debugPreferences.getPreferencesKeys();
-    const std::vector<char*> boolPrefs = debugPreferences.getPreferencesBoolKeys();
-    const std::vector<char*> redactedPrefs = debugPreferences.getPreferencesRedactedKeys();
-    const std::vector<char*> bytePrefs = debugPreferences.getPreferencesByteKeys();
+    const std::vector<char*>& keysPrefs = debugPreferences.getPreferencesKeys();
+    const std::vector<char*>& boolPrefs = debugPreferences.getPreferencesBoolKeys();
+    const std::vector<char*>& redactedPrefs = debugPreferences.getPreferencesRedactedKeys();
+    const std::vector<char*>& bytePrefs = debugPreferences.getPreferencesByteKeys();
+
+    // Every member is rendered by its own section straight into the chunked response,
+    // so only the largest value (usually a certificate) is held in memory at once
+    std::vector<std::function<void()>> sections;
+    bool first = true;
 
     for(const auto& key : keysPrefs)
     {
@@ -633,153 +806,356 @@ void WebCfgServer::sendSettings(AsyncWebServerRequest *request)
         if(strcmp(key, preference_latest_version) == 0) continue;
         if(strcmp(key, preference_device_id_lock) == 0) continue;
         if(strcmp(key, preference_device_id_opener) == 0) continue;
-        if(!redacted) if(std::find(redactedPrefs.begin(), redactedPrefs.end(), key) != redactedPrefs.end()) continue;
-        if(!_preferences->isKey(key)) json[key] = "";
-        else if(std::find(boolPrefs.begin(), boolPrefs.end(), key) != boolPrefs.end()) json[key] = _preferences->getBool(key) ? "1" : "0";
-        else
+
+        // Settings of the configuration pages carry their type and redaction in the settings table
+        const WebCfgSetting* setting = findWebCfgSettingByPreference(key);
+        bool isRedacted = setting != nullptr ? (setting->flags & WEBCFG_SETTING_REDACTED) != 0 : std::find(redactedPrefs.begin(), redactedPrefs.end(), key) != redactedPrefs.end();
+        bool isBool = setting != nullptr ? setting->type == WebCfgSettingType::Bool : std::find(boolPrefs.begin(), boolPrefs.end(), key) != boolPrefs.end();
+        if(!redacted && isRedacted) continue;
+
+        sections.push_back([this, key, isBool, first]()
         {
-            switch(_preferences->getType(key))
-            {
-                case PT_I8:
-                    json[key] = String(_preferences->getChar(key));
-                    break;
-                case PT_I16:
-                    json[key] = String(_preferences->getShort(key));
-                    break;
-                case PT_I32:
-                    json[key] = String(_preferences->getInt(key));
-                    break;
-                case PT_I64:
-                    json[key] = String(_preferences->getLong64(key));
-                    break;
-                case PT_U8:
-                    json[key] = String(_preferences->getUChar(key));
-                    break;
-                case PT_U16:
-                    json[key] = String(_preferences->getUShort(key));
-                    break;
-                case PT_U32:
-                    json[key] = String(_preferences->getUInt(key));
-                    break;
-                case PT_U64:
-                    json[key] = String(_preferences->getULong64(key));
-                    break;
-                case PT_STR:
-                    json[key] = _preferences->getString(key);
-                    break;
-                default:
-                    json[key] = _preferences->getString(key);
-                    break;
-            }
-        }
+            appendSettingsMember(first, key, exportPreference(key, isBool));
+        });
+        first = false;
     }
 
     if(pairing)
     {
-        if(_nuki != nullptr)
+        if(_nuki != nullptr) sections.push_back([this]() { appendPairingMembers("NukiHub", "Lock"); });
+        if(_nukiOpener != nullptr) sections.push_back([this]() { appendPairingMembers("NukiHubopener", "Opener"); });
+    }
+
+    for(const auto& key : bytePrefs)
+    {
+        if(std::find(keysPrefs.begin(), keysPrefs.end(), key) != keysPrefs.end()) continue;
+
+        sections.push_back([this, key]()
         {
-            unsigned char currentBleAddress[6];
-            unsigned char authorizationId[4] = {0x00};
-            unsigned char secretKeyK[32] = {0x00};
-            uint16_t storedPincode = 0000;
-            Preferences nukiBlePref;
-            nukiBlePref.begin("NukiHub", false);
-            nukiBlePref.getBytes("bleAddress", currentBleAddress, 6);
-            nukiBlePref.getBytes("secretKeyK", secretKeyK, 32);
-            nukiBlePref.getBytes("authorizationId", authorizationId, 4);
-            nukiBlePref.getBytes("securityPinCode", &storedPincode, 2);
-            nukiBlePref.end();
-            char text[255];
-            text[0] = '\0';
-            for(int i = 0 ; i < 6 ; i++) {
-                size_t offset = strlen(text);
-                sprintf(&(text[offset]), "%02x", currentBleAddress[i]);
-            }
-            json["bleAddressLock"] = text;
-            memset(text, 0, sizeof(text));
-            text[0] = '\0';
-            for(int i = 0 ; i < 32 ; i++) {
-                size_t offset = strlen(text);
-                sprintf(&(text[offset]), "%02x", secretKeyK[i]);
-            }
-            json["secretKeyKLock"] = text;
-            memset(text, 0, sizeof(text));
-            text[0] = '\0';
-            for(int i = 0 ; i < 4 ; i++) {
-                size_t offset = strlen(text);
-                sprintf(&(text[offset]), "%02x", authorizationId[i]);
-            }
-            json["authorizationIdLock"] = text;
-            memset(text, 0, sizeof(text));
-            json["securityPinCodeLock"] = storedPincode;
+            size_t storedLength = _preferences->getBytesLength(key);
+            if(storedLength == 0) return;
+            uint8_t serialized[storedLength];
+            memset(serialized, 0, sizeof(serialized));
+            size_t size = _preferences->getBytes(key, serialized, sizeof(serialized));
+            if(size == 0) return;
+            appendSettingsMember(false, key, bytesToHex(serialized, size));
+        });
+    }
+
+    sections.push_back([this]() { _response.concat("\n}"); });
+
+    _response = "{";
+    sendResponse(request, std::move(sections), "application/json");
+}
+
+String WebCfgServer::exportPreference(const char* key, const bool isBool)
+{
+    if(!_preferences->isKey(key)) return "";
+    if(isBool) return _preferences->getBool(key) ? "1" : "0";
+
+    switch(_preferences->getType(key))
+    {
+        case PT_I8:
+            return String(_preferences->getChar(key));
+        case PT_I16:
+            return String(_preferences->getShort(key));
+        case PT_I32:
+            return String(_preferences->getInt(key));
+        case PT_I64:
+            return String(_preferences->getLong64(key));
+        case PT_U8:
+            return String(_preferences->getUChar(key));
+        case PT_U16:
+            return String(_preferences->getUShort(key));
+        case PT_U32:
+            return String(_preferences->getUInt(key));
+        case PT_U64:
+            return String(_preferences->getULong64(key));
+        case PT_STR:
+        default:
+            return _preferences->getString(key);
+    }
+}
+
+void WebCfgServer::appendSettingsMember(const bool first, const char* key, const String& value, const bool quoted)
+{
+    _response.concat(first ? "\n  \"" : ",\n  \"");
+    appendJsonEscaped(_response, key);
+    _response.concat(quoted ? "\": \"" : "\": ");
+    if(quoted)
+    {
+        appendJsonEscaped(_response, value.c_str());
+        _response.concat("\"");
+    }
+    else
+    {
+        _response.concat(value);
+    }
+}
+
+void WebCfgServer::appendPairingMembers(const char* preferencesNamespace, const char* suffix)
+{
+    unsigned char currentBleAddress[6] = {0x00};
+    unsigned char authorizationId[4] = {0x00};
+    unsigned char secretKeyK[32] = {0x00};
+    uint16_t storedPincode = 0000;
+    Preferences nukiBlePref;
+    nukiBlePref.begin(preferencesNamespace, false);
+    nukiBlePref.getBytes("bleAddress", currentBleAddress, 6);
+    nukiBlePref.getBytes("secretKeyK", secretKeyK, 32);
+    nukiBlePref.getBytes("authorizationId", authorizationId, 4);
+    nukiBlePref.getBytes("securityPinCode", &storedPincode, 2);
+    nukiBlePref.end();
+
+    appendSettingsMember(false, (String("bleAddress") + suffix).c_str(), bytesToHex(currentBleAddress, 6));
+    appendSettingsMember(false, (String("secretKeyK") + suffix).c_str(), bytesToHex(secretKeyK, 32));
+    appendSettingsMember(false, (String("authorizationId") + suffix).c_str(), bytesToHex(authorizationId, 4));
+    appendSettingsMember(false, (String("securityPinCode") + suffix).c_str(), String(storedPincode), false);
+    memset(secretKeyK, 0, sizeof(secretKeyK));
+}
+
+void WebCfgServer::sendApiStatus(AsyncWebServerRequest *request)
+{
+    JsonDocument json;
+    char str[50];
+
+    json["version"] = NUKI_HUB_VERSION;
+    json["build"] = NUKI_HUB_BUILD;
+    json["uptime"] = (uint32_t)(esp_timer_get_time() / 1000 / 1000);
+    json["free_heap"] = ESP.getFreeHeap();
+    json["network_connected"] = _network->isConnected();
+    json["mqtt_connected"] = _network->mqttConnectionState() > 0;
+
+    if(_nuki != nullptr)
+    {
+        const NukiLock::KeyTurnerState& keyTurnerState = _nuki->keyTurnerState();
+        JsonObject lock = json["lock"].to<JsonObject>();
+
+        lock["paired"] = _nuki->isPaired();
+        lock["pin_status"] = pinStateToString(_preferences->getInt(preference_lock_pin_status, 4));
+        memset(str, 0, sizeof(str));
+        NukiLock::lockstateToString(keyTurnerState.lockState, str);
+        lock["lock_state"] = str;
+        memset(str, 0, sizeof(str));
+        NukiLock::triggerToString(keyTurnerState.trigger, str);
+        lock["trigger"] = str;
+        memset(str, 0, sizeof(str));
+        NukiLock::lockactionToString(keyTurnerState.lastLockAction, str);
+        lock["last_lock_action"] = str;
+        memset(str, 0, sizeof(str));
+        NukiLock::triggerToString(keyTurnerState.lastLockActionTrigger, str);
+        lock["last_lock_action_trigger"] = str;
+        memset(str, 0, sizeof(str));
+        NukiLock::completionStatusToString(keyTurnerState.lastLockActionCompletionStatus, str);
+        lock["lock_completion_status"] = str;
+        memset(str, 0, sizeof(str));
+        NukiLock::doorSensorStateToString(keyTurnerState.doorSensorState, str);
+        lock["door_sensor_state"] = str;
+        lock["night_mode_active"] = keyTurnerState.nightModeActive;
+
+        JsonObject battery = lock["battery"].to<JsonObject>();
+        battery["critical"] = (keyTurnerState.criticalBatteryState & 0b00000001) > 0;
+        battery["charging"] = (keyTurnerState.criticalBatteryState & 0b00000010) > 0;
+        battery["level"] = (keyTurnerState.criticalBatteryState & 0b11111100) >> 1;
+        battery["keypad_critical"] = (keyTurnerState.accessoryBatteryState & (1 << 7)) != 0 ? (keyTurnerState.accessoryBatteryState & (1 << 6)) != 0 : false;
+    }
+
+    if(_nukiOpener != nullptr)
+    {
+        const NukiOpener::OpenerState& keyTurnerState = _nukiOpener->keyTurnerState();
+        JsonObject opener = json["opener"].to<JsonObject>();
+
+        opener["paired"] = _nukiOpener->isPaired();
+        opener["pin_status"] = pinStateToString(_preferences->getInt(preference_opener_pin_status, 4));
+        memset(str, 0, sizeof(str));
+        NukiOpener::lockstateToString(keyTurnerState.lockState, str);
+        opener["lock_state"] = str;
+        opener["continuous_mode"] = keyTurnerState.nukiState == NukiOpener::State::ContinuousMode;
+        memset(str, 0, sizeof(str));
+        NukiOpener::triggerToString(keyTurnerState.trigger, str);
+        opener["trigger"] = str;
+        memset(str, 0, sizeof(str));
+        NukiOpener::lockactionToString(keyTurnerState.lastLockAction, str);
+        opener["last_lock_action"] = str;
+        memset(str, 0, sizeof(str));
+        NukiOpener::triggerToString(keyTurnerState.lastLockActionTrigger, str);
+        opener["last_lock_action_trigger"] = str;
+        memset(str, 0, sizeof(str));
+        NukiOpener::completionStatusToString(keyTurnerState.lastLockActionCompletionStatus, str);
+        opener["lock_completion_status"] = str;
+        memset(str, 0, sizeof(str));
+        NukiOpener::doorSensorStateToString(keyTurnerState.doorSensorState, str);
+        opener["door_sensor_state"] = str;
+
+        JsonObject battery = opener["battery"].to<JsonObject>();
+        battery["critical"] = (keyTurnerState.criticalBatteryState & 0b00000001) > 0;
+    }
+
+    _response = "";
+    serializeJson(json, _response);
+    sendResponse(request, {}, "application/json");
+}
+
+void WebCfgServer::update()
+{
+    if(_events == nullptr) return;
+
+    if(_events->count() == 0)
+    {
+        _liveState.clear();
+        _liveLockRevision = 0;
+        _liveOpenerRevision = 0;
+        _liveMqttState = -1;
+        return;
+    }
+
+    uint32_t lockRevision = _nuki != nullptr ? _nuki->stateRevision() : 0;
+    uint32_t openerRevision = _nukiOpener != nullptr ? _nukiOpener->stateRevision() : 0;
+    int mqttState = _network->mqttConnectionState();
+
+    if(lockRevision == _liveLockRevision && openerRevision == _liveOpenerRevision && mqttState == _liveMqttState) return;
+
+    _liveLockRevision = lockRevision;
+    _liveOpenerRevision = openerRevision;
+    _liveMqttState = mqttState;
+
+    JsonDocument json;
+    JsonDocument changed;
+    liveStateToJson(json);
+
+    for(JsonPair kv : json.as<JsonObject>())
+    {
+        if(_liveState[kv.key()] != kv.value())
+        {
+            _liveState[kv.key()] = kv.value();
+            changed[kv.key()] = kv.value();
         }
-        if(_nukiOpener != nullptr)
+    }
+
+    if(changed.size() == 0) return;
+
+    char buffer[WEBCFG_LIVE_STATE_BUFFER_SIZE];
+    serializeJson(changed, buffer, sizeof(buffer));
+    _events->send(buffer, "state", (uint32_t)(esp_timer_get_time() / 1000));
+}
+
+void WebCfgServer::liveStateToJson(JsonDocument& json)
+{
+    char str[50];
+
+    // Keys are the element ids on the main page
+    json["mqttState"] = _network->mqttConnectionState() > 0 ? "Yes" : "No";
+
+    if(_nuki != nullptr)
+    {
+        const NukiLock::KeyTurnerState& keyTurnerState = _nuki->keyTurnerState();
+        memset(str, 0, sizeof(str));
+        NukiLock::lockstateToString(keyTurnerState.lockState, str);
+        json["lockState"] = str;
+
+        if(_nuki->hasDoorSensor())
         {
-            unsigned char currentBleAddressOpn[6];
-            unsigned char authorizationIdOpn[4] = {0x00};
-            unsigned char secretKeyKOpn[32] = {0x00};
-            uint16_t storedPincodeOpn = 0000;
-            Preferences nukiBlePref;
-            nukiBlePref.begin("NukiHubopener", false);
-            nukiBlePref.getBytes("bleAddress", currentBleAddressOpn, 6);
-            nukiBlePref.getBytes("secretKeyK", secretKeyKOpn, 32);
-            nukiBlePref.getBytes("authorizationId", authorizationIdOpn, 4);
-            nukiBlePref.getBytes("securityPinCode", &storedPincodeOpn, 2);
-            nukiBlePref.end();
-            char text[255];
-            text[0] = '\0';
-            for(int i = 0 ; i < 6 ; i++) {
-                size_t offset = strlen(text);
-                sprintf(&(text[offset]), "%02x", currentBleAddressOpn[i]);
-            }
-            json["bleAddressOpener"] = text;
-            memset(text, 0, sizeof(text));
-            text[0] = '\0';
-            for(int i = 0 ; i < 32 ; i++) {
-                size_t offset = strlen(text);
-                sprintf(&(text[offset]), "%02x", secretKeyKOpn[i]);
-            }
-            json["secretKeyKOpener"] = text;
-            memset(text, 0, sizeof(text));
-            text[0] = '\0';
-            for(int i = 0 ; i < 4 ; i++) {
-                size_t offset = strlen(text);
-                sprintf(&(text[offset]), "%02x", authorizationIdOpn[i]);
-            }
-            json["authorizationIdOpener"] = text;
-            memset(text, 0, sizeof(text));
-            json["securityPinCodeOpener"] = storedPincodeOpn;
+            memset(str, 0, sizeof(str));
+            NukiLock::doorSensorStateToString(keyTurnerState.doorSensorState, str);
+            json["lockDoorSensor"] = str;
         }
+
+        String battery = String((keyTurnerState.criticalBatteryState & 0b11111100) >> 1) + "%";
+        if((keyTurnerState.criticalBatteryState & 0b00000001) > 0) battery.concat(", critical");
+        if((keyTurnerState.criticalBatteryState & 0b00000010) > 0) battery.concat(", charging");
+        json["lockBattery"] = battery;
+        json["lockRssi"] = String(_nuki->rssi());
     }
 
-    for(const auto& key : bytePrefs)
+    if(_nukiOpener != nullptr)
     {
-        size_t storedLength = _preferences->getBytesLength(key);
-        if(storedLength == 0) continue;
-        uint8_t serialized[storedLength];
-        memset(serialized, 0, sizeof(serialized));
-        size_t size = _preferences->getBytes(key, serialized, sizeof(serialized));
-        if(size == 0) continue;
-        char text[255];
-        text[0] = '\0';
-        for(int i = 0 ; i < size ; i++) {
-            size_t offset = strlen(text);
-            sprintf(&(text[offset]), "%02x", serialized[i]);
+        const NukiOpener::OpenerState& keyTurnerState = _nukiOpener->keyTurnerState();
+
+        if(keyTurnerState.nukiState == NukiOpener::State::ContinuousMode) json["openerState"] = "Open (Continuous Mode)";
+        else
+        {
+            memset(str, 0, sizeof(str));
+            NukiOpener::lockstateToString(keyTurnerState.lockState, str);
+            json["openerState"] = str;
         }
-        json[key] = text;
-        memset(text, 0, sizeof(text));
+
+        json["openerBattery"] = (keyTurnerState.criticalBatteryState & 0b00000001) > 0 ? "Critical" : "OK";
+        json["openerRssi"] = String(_nukiOpener->rssi());
     }
+}
 
-    serializeJsonPretty(json, jsonPretty);
+void WebCfgServer::sendApiConfig(AsyncWebServerRequest *request)
+{
+    JsonDocument json;
 
-    AsyncWebServerResponse *response = request->beginChunkedResponse("application/json",
-    [&](uint8_t *buffer, size_t maxlen, size_t index) -> size_t {
-      size_t len = min(maxlen, jsonPretty.length() - index);
-      memcpy(buffer, jsonPretty.c_str() + index, len);
-      return len;
-    });
+    if(_nuki != nullptr) _nuki->configToJson(json["lock"].to<JsonObject>());
+    if(_nukiOpener != nullptr) _nukiOpener->configToJson(json["opener"].to<JsonObject>());
 
-    request->send(response);
+    _response = "";
+    serializeJson(json, _response);
+    sendResponse(request, {}, "application/json");
+}
+
+void WebCfgServer::handleApiBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+{
+    // Collected NUL terminated in _tempObject, which the request frees
+    if(total > WEBCFG_API_MAX_BODY_SIZE) return;
+    if(index == 0 && request->_tempObject == nullptr) request->_tempObject = calloc(total + 1, 1);
+    if(request->_tempObject == nullptr || index + len > total) return;
+
+    memcpy((char*)request->_tempObject + index, data, len);
+}
+
+void WebCfgServer::processApiAction(AsyncWebServerRequest *request, bool opener)
+{
+    // Actions unlock the door, they are refused as long as the web configurator isn't password protected
+    if(strlen(_credUser) == 0 || strlen(_credPassword) == 0)
+    {
+        request->send(403, "application/json", "{\"result\":\"credentials_required\"}");
+        return;
+    }
+
+    // A cross-site form can't send a JSON body without a CORS preflight, which is never answered. This keeps a
+    // browser with cached credentials from being used to trigger actions.
+    if(!request->contentType().startsWith("application/json"))
+    {
+        request->send(415, "application/json", "{\"result\":\"json_body_required\"}");
+        return;
+    }
+
+    if((!opener && _nuki == nullptr) || (opener && _nukiOpener == nullptr))
+    {
+        request->send(404, "application/json", "{\"result\":\"not_enabled\"}");
+        return;
+    }
+
+    JsonDocument json;
+    if(request->_tempObject == nullptr || deserializeJson(json, (const char*)request->_tempObject) != DeserializationError::Ok || !json["action"].is<const char*>())
+    {
+        request->send(400, "application/json", "{\"result\":\"invalid_request\"}");
+        return;
+    }
+
+    // Same ACL checks as the MQTT lock action topic
+    LockActionResult result;
+    if(!opener) result = _nuki->onLockActionReceived(json["action"].as<const char*>());
+    else result = _nukiOpener->onLockActionReceived(json["action"].as<const char*>());
+
+    switch(result)
+    {
+        case LockActionResult::Success:
+            request->send(200, "application/json", "{\"result\":\"ack\"}");
+            break;
+        case LockActionResult::UnknownAction:
+            request->send(400, "application/json", "{\"result\":\"unknown_action\"}");
+            break;
+        case LockActionResult::AccessDenied:
+            request->send(403, "application/json", "{\"result\":\"denied\"}");
+            break;
+        case LockActionResult::Failed:
+            request->send(500, "application/json", "{\"result\":\"error\"}");
+            break;
+    }
 }
 
 bool WebCfgServer::processArgs(AsyncWebServerRequest *request, String& message)
@@ -804,6 +1180,7 @@ bool WebCfgServer::processArgs(AsyncWebServerRequest *request, String& message)
     uint32_t basicOpenerConfigAclPrefs[14] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
     uint32_t advancedLockConfigAclPrefs[22] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
     uint32_t advancedOpenerConfigAclPrefs[20] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint32_t* aclBitmaps[] = {aclPrefs, basicLockConfigAclPrefs, advancedLockConfigAclPrefs, basicOpenerConfigAclPrefs, advancedOpenerConfigAclPrefs};
 
     int params = request->params();
 
@@ -822,24 +1199,20 @@ bool WebCfgServer::processArgs(AsyncWebServerRequest *request, String& message)
             if(key == next->name()) continue;
         }
 
-        if(key == "MQTTSERVER")
+        const WebCfgSetting* setting = findWebCfgSetting(key.c_str());
+
+        if(setting != nullptr)
         {
-            if(_preferences->getString(preference_mqtt_broker, "") != value)
+            if(setting->type == WebCfgSettingType::Acl)
             {
-                _preferences->putString(preference_mqtt_broker, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
+                aclBitmaps[(uint8_t)setting->acl][setting->value] = ((value == "1") ? 1 : 0);
             }
-        }
-        else if(key == "MQTTPORT")
-        {
-            if(_preferences->getInt(preference_mqtt_broker_port, 0) !=  value.toInt())
+            else if(applyWebCfgSetting(_preferences, *setting, value))
             {
-                _preferences->putInt(preference_mqtt_broker_port,  value.toInt());
                 Log->print(F("Setting changed: "));
                 Log->println(key);
-                configChanged = true;
+                if((setting->flags & WEBCFG_SETTING_RESTART) != 0) configChanged = true;
+                if((setting->flags & WEBCFG_SETTING_NETWORK_RECONFIGURE) != 0) networkReconfigure = true;
             }
         }
         else if(key == "MQTTUSER")
@@ -868,1185 +1241,63 @@ bool WebCfgServer::processArgs(AsyncWebServerRequest *request, String& message)
                     _preferences->putString(preference_mqtt_password, value);
                     Log->print(F("Setting changed: "));
                     Log->println(key);
-                    configChanged = true;
-                }
-            }
-        }
-        else if(key == "MQTTPATH")
-        {
-            if(_preferences->getString(preference_mqtt_lock_path, "") != value)
-            {
-                _preferences->putString(preference_mqtt_lock_path, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "MQTTOPPATH")
-        {
-            if(_preferences->getString(preference_mqtt_opener_path, "") != value)
-            {
-                _preferences->putString(preference_mqtt_opener_path, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "MQTTCA")
-        {
-            if(_preferences->getString(preference_mqtt_ca, "") != value)
-            {
-                _preferences->putString(preference_mqtt_ca, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "MQTTCRT")
-        {
-            if(_preferences->getString(preference_mqtt_crt, "") != value)
-            {
-                _preferences->putString(preference_mqtt_crt, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "MQTTKEY")
-        {
-            if(_preferences->getString(preference_mqtt_key, "") != value)
-            {
-                _preferences->putString(preference_mqtt_key, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWHW")
-        {
-            if(_preferences->getInt(preference_network_hardware, 0) != value.toInt())
-            {
-                if(value.toInt() > 1)
-                {
-                    networkReconfigure = true;
-                    if(value.toInt() != 11) _preferences->putInt(preference_network_custom_phy, 0);
-                }
-                _preferences->putInt(preference_network_hardware, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTPHY")
-        {
-            if(_preferences->getInt(preference_network_custom_phy, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_phy, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTADDR")
-        {
-            if(_preferences->getInt(preference_network_custom_addr, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_addr, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTIRQ")
-        {
-            if(_preferences->getInt(preference_network_custom_irq, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_irq, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTRST")
-        {
-            if(_preferences->getInt(preference_network_custom_rst, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_rst, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTCS")
-        {
-            if(_preferences->getInt(preference_network_custom_cs, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_cs, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTSCK")
-        {
-            if(_preferences->getInt(preference_network_custom_sck, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_sck, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTMISO")
-        {
-            if(_preferences->getInt(preference_network_custom_miso, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_miso, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTMOSI")
-        {
-            if(_preferences->getInt(preference_network_custom_mosi, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_mosi, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTPWR")
-        {
-            if(_preferences->getInt(preference_network_custom_pwr, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_pwr, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTMDIO")
-        {
-            if(_preferences->getInt(preference_network_custom_mdio, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_mdio, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTMDC")
-        {
-            if(_preferences->getInt(preference_network_custom_mdc, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_mdc, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWCUSTCLK")
-        {
-            if(_preferences->getInt(preference_network_custom_clk, 0) != value.toInt())
-            {
-                networkReconfigure = true;
-                _preferences->putInt(preference_network_custom_clk, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NWHWWIFIFB")
-        {
-            if(_preferences->getBool(preference_network_wifi_fallback_disabled, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_network_wifi_fallback_disabled, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "RSSI")
-        {
-            if(_preferences->getInt(preference_rssi_publish_interval, 60) != value.toInt())
-            {
-                _preferences->putInt(preference_rssi_publish_interval, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "HASSDISCOVERY")
-        {
-            if(_preferences->getString(preference_mqtt_hass_discovery, "") != value)
-            {
-                if (_nuki != nullptr) _nuki->disableHASS();
-                if (_nukiOpener != nullptr) _nukiOpener->disableHASS();
-                _preferences->putString(preference_mqtt_hass_discovery, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "OPENERCONT")
-        {
-            if(_preferences->getBool(preference_opener_continuous_mode, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_opener_continuous_mode, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "HASSCUURL")
-        {
-            if(_preferences->getString(preference_mqtt_hass_cu_url, "") != value)
-            {
-                _preferences->putString(preference_mqtt_hass_cu_url, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "BESTRSSI")
-        {
-            if(_preferences->getBool(preference_find_best_rssi, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_find_best_rssi, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "HOSTNAME")
-        {
-            if(_preferences->getString(preference_hostname, "") != value)
-            {
-                _preferences->putString(preference_hostname, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "NETTIMEOUT")
-        {
-            if(_preferences->getInt(preference_network_timeout, 60) != value.toInt())
-            {
-                _preferences->putInt(preference_network_timeout, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "RSTDISC")
-        {
-            if(_preferences->getBool(preference_restart_on_disconnect, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_restart_on_disconnect, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "RECNWTMQTTDIS")
-        {
-            if(_preferences->getBool(preference_recon_netw_on_mqtt_discon, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_recon_netw_on_mqtt_discon, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "MQTTLOG")
-        {
-            if(_preferences->getBool(preference_mqtt_log_enabled, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_mqtt_log_enabled, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "WEBLOG")
-        {
-            if(_preferences->getBool(preference_webserial_enabled, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_webserial_enabled, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "CHECKUPDATE")
-        {
-            if(_preferences->getBool(preference_check_updates, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_check_updates, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "UPDATEMQTT")
-        {
-            if(_preferences->getBool(preference_update_from_mqtt, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_update_from_mqtt, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "OFFHYBRID")
-        {
-            if(_preferences->getBool(preference_official_hybrid_enabled, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_official_hybrid_enabled, (value == "1"));
-                if((value == "1")) _preferences->putBool(preference_register_as_app, true);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "HYBRIDACT")
-        {
-            if(_preferences->getBool(preference_official_hybrid_actions, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_official_hybrid_actions, (value == "1"));
-                if(value == "1") _preferences->putBool(preference_register_as_app, true);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "HYBRIDTIMER")
-        {
-            if(_preferences->getInt(preference_query_interval_hybrid_lockstate, 600) != value.toInt())
-            {
-                _preferences->putInt(preference_query_interval_hybrid_lockstate, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "HYBRIDRETRY")
-        {
-            if(_preferences->getBool(preference_official_hybrid_retry, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_official_hybrid_retry, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "DISNONJSON")
-        {
-            if(_preferences->getBool(preference_disable_non_json, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_disable_non_json, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "DHCPENA")
-        {
-            if(_preferences->getBool(preference_ip_dhcp_enabled, true) != (value == "1"))
-            {
-                _preferences->putBool(preference_ip_dhcp_enabled, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "IPADDR")
-        {
-            if(_preferences->getString(preference_ip_address, "") != value)
-            {
-                _preferences->putString(preference_ip_address, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "IPSUB")
-        {
-            if(_preferences->getString(preference_ip_subnet, "") != value)
-            {
-                _preferences->putString(preference_ip_subnet, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "IPGTW")
-        {
-            if(_preferences->getString(preference_ip_gateway, "") != value)
-            {
-                _preferences->putString(preference_ip_gateway, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "DNSSRV")
-        {
-            if(_preferences->getString(preference_ip_dns_server, "") != value)
-            {
-                _preferences->putString(preference_ip_dns_server, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "LSTINT")
-        {
-            if(_preferences->getInt(preference_query_interval_lockstate, 1800) != value.toInt())
-            {
-                _preferences->putInt(preference_query_interval_lockstate, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "CFGINT")
-        {
-            if(_preferences->getInt(preference_query_interval_configuration, 3600) != value.toInt())
-            {
-                _preferences->putInt(preference_query_interval_configuration, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "BATINT")
-        {
-            if(_preferences->getInt(preference_query_interval_battery, 1800) != value.toInt())
-            {
-                _preferences->putInt(preference_query_interval_battery, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "KPINT")
-        {
-            if(_preferences->getInt(preference_query_interval_keypad, 1800) != value.toInt())
-            {
-                _preferences->putInt(preference_query_interval_keypad, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "NRTRY")
-        {
-            if(_preferences->getInt(preference_command_nr_of_retries, 3) != value.toInt())
-            {
-                _preferences->putInt(preference_command_nr_of_retries, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "TRYDLY")
-        {
-            if(_preferences->getInt(preference_command_retry_delay, 100) != value.toInt())
-            {
-                _preferences->putInt(preference_command_retry_delay, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "TXPWR")
-        {
-            if(value.toInt() >= -12 && value.toInt() <= 9)
-            {
-                if(_preferences->getInt(preference_ble_tx_power, 9) != value.toInt())
-                {
-                    _preferences->putInt(preference_ble_tx_power, value.toInt());
-                    Log->print(F("Setting changed: "));
-                    Log->println(key);
-                    //configChanged = true;
-                }
-            }
-        }
-        else if(key == "RSBC")
-        {
-            if(_preferences->getInt(preference_restart_ble_beacon_lost, 60) != value.toInt())
-            {
-                _preferences->putInt(preference_restart_ble_beacon_lost, value.toInt());
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "TSKNTWK")
-        {
-            if(value.toInt() > 12287 && value.toInt() < 32769)
-            {
-                if(_preferences->getInt(preference_task_size_network, NETWORK_TASK_SIZE) != value.toInt())
-                {
-                    _preferences->putInt(preference_task_size_network, value.toInt());
-                    Log->print(F("Setting changed: "));
-                    Log->println(key);
-                    configChanged = true;
-                }
-            }
-        }
-        else if(key == "TSKNUKI")
-        {
-            if(value.toInt() > 8191 && value.toInt() < 32769)
-            {
-                if(_preferences->getInt(preference_task_size_nuki, NUKI_TASK_SIZE) != value.toInt())
-                {
-                    _preferences->putInt(preference_task_size_nuki, value.toInt());
-                    Log->print(F("Setting changed: "));
-                    Log->println(key);
-                    configChanged = true;
-                }
-            }
-        }
-        else if(key == "ALMAX")
-        {
-            if(value.toInt() > 0 && value.toInt() < 51)
-            {
-                if(_preferences->getInt(preference_authlog_max_entries, MAX_AUTHLOG) != value.toInt())
-                {
-                    _preferences->putInt(preference_authlog_max_entries, value.toInt());
-                    Log->print(F("Setting changed: "));
-                    Log->println(key);
-                    //configChanged = true;
-                }
-            }
-        }
-        else if(key == "KPMAX")
-        {
-            if(value.toInt() > 0 && value.toInt() < 101)
-            {
-                if(_preferences->getInt(preference_keypad_max_entries, MAX_KEYPAD) != value.toInt())
-                {
-                    _preferences->putInt(preference_keypad_max_entries, value.toInt());
-                    Log->print(F("Setting changed: "));
-                    Log->println(key);
-                    //configChanged = true;
-                }
-            }
-        }
-        else if(key == "TCMAX")
-        {
-            if(value.toInt() > 0 && value.toInt() < 51)
-            {
-                if(_preferences->getInt(preference_timecontrol_max_entries, MAX_TIMECONTROL) != value.toInt())
-                {
-                    _preferences->putInt(preference_timecontrol_max_entries, value.toInt());
-                    Log->print(F("Setting changed: "));
-                    Log->println(key);
-                    //configChanged = true;
-                }
-            }
-        }
-        else if(key == "AUTHMAX")
-        {
-            if(value.toInt() > 0 && value.toInt() < 51)
-            {
-                if(_preferences->getInt(preference_auth_max_entries, MAX_AUTH) != value.toInt())
-                {
-                    _preferences->putInt(preference_auth_max_entries, value.toInt());
-                    Log->print(F("Setting changed: "));
-                    Log->println(key);
-                    //configChanged = true;
-                }
-            }
-        }
-        else if(key == "BUFFSIZE")
-        {
-            if(value.toInt() > 4095 && value.toInt() < 32769)
-            {
-                if(_preferences->getInt(preference_buffer_size, CHAR_BUFFER_SIZE) != value.toInt())
-                {
-                    _preferences->putInt(preference_buffer_size, value.toInt());
-                    Log->print(F("Setting changed: "));
-                    Log->println(key);
-                    configChanged = true;
-                }
-            }
-        }
-        else if(key == "BTLPRST")
-        {
-            if(_preferences->getBool(preference_enable_bootloop_reset, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_enable_bootloop_reset, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "OTAUPD")
-        {
-            if(_preferences->getString(preference_ota_updater_url, "") != value)
-            {
-                _preferences->putString(preference_ota_updater_url, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "OTAMAIN")
-        {
-            if(_preferences->getString(preference_ota_main_url, "") != value)
-            {
-                _preferences->putString(preference_ota_main_url, value);
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "SHOWSECRETS")
-        {
-            if(_preferences->getBool(preference_show_secrets, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_show_secrets, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "ACLLVLCHANGED")
-        {
-            aclLvlChanged = true;
-        }
-        else if(key == "CONFPUB")
-        {
-            if(_preferences->getBool(preference_conf_info_enabled, true) != (value == "1"))
-            {
-                _preferences->putBool(preference_conf_info_enabled, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "KPPUB")
-        {
-            if(_preferences->getBool(preference_keypad_info_enabled, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_keypad_info_enabled, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "KPCODE")
-        {
-            if(_preferences->getBool(preference_keypad_publish_code, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_keypad_publish_code, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "KPENA")
-        {
-            if(_preferences->getBool(preference_keypad_control_enabled, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_keypad_control_enabled, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "TCPUB")
-        {
-            if(_preferences->getBool(preference_timecontrol_info_enabled, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_timecontrol_info_enabled, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "AUTHPUB")
-        {
-            if(_preferences->getBool(preference_auth_info_enabled, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_auth_info_enabled, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "KPPER")
-        {
-            if(_preferences->getBool(preference_keypad_topic_per_entry, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_keypad_topic_per_entry, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "TCPER")
-        {
-            if(_preferences->getBool(preference_timecontrol_topic_per_entry, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_timecontrol_topic_per_entry, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "TCENA")
-        {
-            if(_preferences->getBool(preference_timecontrol_control_enabled, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_timecontrol_control_enabled, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "AUTHPER")
-        {
-            if(_preferences->getBool(preference_auth_topic_per_entry, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_auth_topic_per_entry, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "AUTHENA")
-        {
-            if(_preferences->getBool(preference_auth_control_enabled, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_auth_control_enabled, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                configChanged = true;
-            }
-        }
-        else if(key == "PUBAUTH")
-        {
-            if(_preferences->getBool(preference_publish_authdata, false) != (value == "1"))
-            {
-                _preferences->putBool(preference_publish_authdata, (value == "1"));
-                Log->print(F("Setting changed: "));
-                Log->println(key);
-                //configChanged = true;
-            }
-        }
-        else if(key == "ACLLCKLCK")
-        {
-            aclPrefs[0] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLLCKUNLCK")
-        {
-            aclPrefs[1] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLLCKUNLTCH")
-        {
-            aclPrefs[2] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLLCKLNG")
-        {
-            aclPrefs[3] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLLCKLNGU")
-        {
-            aclPrefs[4] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLLCKFLLCK")
-        {
-            aclPrefs[5] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLLCKFOB1")
-        {
-            aclPrefs[6] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLLCKFOB2")
-        {
-            aclPrefs[7] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLLCKFOB3")
-        {
-            aclPrefs[8] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLOPNUNLCK")
-        {
-            aclPrefs[9] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLOPNLCK")
-        {
-            aclPrefs[10] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLOPNUNLTCH")
-        {
-            aclPrefs[11] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLOPNUNLCKCM")
-        {
-            aclPrefs[12] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLOPNLCKCM")
-        {
-            aclPrefs[13] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLOPNFOB1")
-        {
-            aclPrefs[14] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLOPNFOB2")
-        {
-            aclPrefs[15] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "ACLOPNFOB3")
-        {
-            aclPrefs[16] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKNAME")
-        {
-            basicLockConfigAclPrefs[0] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKLAT")
-        {
-            basicLockConfigAclPrefs[1] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKLONG")
-        {
-            basicLockConfigAclPrefs[2] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKAUNL")
-        {
-            basicLockConfigAclPrefs[3] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKPRENA")
-        {
-            basicLockConfigAclPrefs[4] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKBTENA")
-        {
-            basicLockConfigAclPrefs[5] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKLEDENA")
-        {
-            basicLockConfigAclPrefs[6] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKLEDBR")
-        {
-            basicLockConfigAclPrefs[7] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKTZOFF")
-        {
-            basicLockConfigAclPrefs[8] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKDSTM")
-        {
-            basicLockConfigAclPrefs[9] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKFOB1")
-        {
-            basicLockConfigAclPrefs[10] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKFOB2")
-        {
-            basicLockConfigAclPrefs[11] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKFOB3")
-        {
-            basicLockConfigAclPrefs[12] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKSGLLCK")
-        {
-            basicLockConfigAclPrefs[13] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKADVM")
-        {
-            basicLockConfigAclPrefs[14] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKTZID")
-        {
-            basicLockConfigAclPrefs[15] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKUPOD")
-        {
-            advancedLockConfigAclPrefs[0] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKLPOD")
-        {
-            advancedLockConfigAclPrefs[1] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKSLPOD")
-        {
-            advancedLockConfigAclPrefs[2] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKUTLTOD")
-        {
-            advancedLockConfigAclPrefs[3] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKLNGT")
-        {
-            advancedLockConfigAclPrefs[4] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKSBPA")
-        {
-            advancedLockConfigAclPrefs[5] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKDBPA")
-        {
-            advancedLockConfigAclPrefs[6] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKDC")
-        {
-            advancedLockConfigAclPrefs[7] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKBATT")
-        {
-            advancedLockConfigAclPrefs[8] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKABTD")
-        {
-            advancedLockConfigAclPrefs[9] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKUNLD")
-        {
-            advancedLockConfigAclPrefs[10] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKALT")
-        {
-            advancedLockConfigAclPrefs[11] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKAUNLD")
-        {
-            advancedLockConfigAclPrefs[12] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKNMENA")
-        {
-            advancedLockConfigAclPrefs[13] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKNMST")
-        {
-            advancedLockConfigAclPrefs[14] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKNMET")
-        {
-            advancedLockConfigAclPrefs[15] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKNMALENA")
-        {
-            advancedLockConfigAclPrefs[16] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKNMAULD")
-        {
-            advancedLockConfigAclPrefs[17] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKNMLOS")
-        {
-            advancedLockConfigAclPrefs[18] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKALENA")
-        {
-            advancedLockConfigAclPrefs[19] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKIALENA")
-        {
-            advancedLockConfigAclPrefs[20] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFLCKAUENA")
-        {
-            advancedLockConfigAclPrefs[21] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNNAME")
-        {
-            basicOpenerConfigAclPrefs[0] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNLAT")
-        {
-            basicOpenerConfigAclPrefs[1] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNLONG")
-        {
-            basicOpenerConfigAclPrefs[2] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNPRENA")
-        {
-            basicOpenerConfigAclPrefs[3] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNBTENA")
-        {
-            basicOpenerConfigAclPrefs[4] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNLEDENA")
-        {
-            basicOpenerConfigAclPrefs[5] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNTZOFF")
-        {
-            basicOpenerConfigAclPrefs[6] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNDSTM")
-        {
-            basicOpenerConfigAclPrefs[7] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNFOB1")
-        {
-            basicOpenerConfigAclPrefs[8] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNFOB2")
-        {
-            basicOpenerConfigAclPrefs[9] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNFOB3")
-        {
-            basicOpenerConfigAclPrefs[10] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNOPM")
-        {
-            basicOpenerConfigAclPrefs[11] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNADVM")
-        {
-            basicOpenerConfigAclPrefs[12] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNTZID")
-        {
-            basicOpenerConfigAclPrefs[13] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNICID")
-        {
-            advancedOpenerConfigAclPrefs[0] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNBUSMS")
-        {
-            advancedOpenerConfigAclPrefs[1] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNSCDUR")
-        {
-            advancedOpenerConfigAclPrefs[2] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNESD")
-        {
-            advancedOpenerConfigAclPrefs[3] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNRESD")
-        {
-            advancedOpenerConfigAclPrefs[4] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNESDUR")
-        {
-            advancedOpenerConfigAclPrefs[5] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNDRTOAR")
-        {
-            advancedOpenerConfigAclPrefs[6] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNRTOT")
-        {
-            advancedOpenerConfigAclPrefs[7] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNDRBSUP")
-        {
-            advancedOpenerConfigAclPrefs[8] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNDRBSUPDUR")
-        {
-            advancedOpenerConfigAclPrefs[9] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNSRING")
-        {
-            advancedOpenerConfigAclPrefs[10] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNSOPN")
-        {
-            advancedOpenerConfigAclPrefs[11] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNSRTO")
-        {
-            advancedOpenerConfigAclPrefs[12] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNSCM")
-        {
-            advancedOpenerConfigAclPrefs[13] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNSCFRM")
-        {
-            advancedOpenerConfigAclPrefs[14] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNSLVL")
-        {
-            advancedOpenerConfigAclPrefs[15] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNSBPA")
-        {
-            advancedOpenerConfigAclPrefs[16] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNDBPA")
-        {
-            advancedOpenerConfigAclPrefs[17] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNBATT")
-        {
-            advancedOpenerConfigAclPrefs[18] = ((value == "1") ? 1 : 0);
-        }
-        else if(key == "CONFOPNABTD")
-        {
-            advancedOpenerConfigAclPrefs[19] = ((value == "1") ? 1 : 0);
+                    configChanged = true;
+                }
+            }
         }
-        else if(key == "REGAPP")
+        else if(key == "NWHW")
         {
-            if(_preferences->getBool(preference_register_as_app, false) != (value == "1"))
+            if(_preferences->getInt(preference_network_hardware, 0) != value.toInt())
             {
-                _preferences->putBool(preference_register_as_app, (value == "1"));
+                if(value.toInt() > 1)
+                {
+                    networkReconfigure = true;
+                    if(value.toInt() != 11) _preferences->putInt(preference_network_custom_phy, 0);
+                }
+                _preferences->putInt(preference_network_hardware, value.toInt());
                 Log->print(F("Setting changed: "));
                 Log->println(key);
-                //configChanged = true;
+                configChanged = true;
             }
         }
-        else if(key == "REGAPPOPN")
+        else if(key == "HASSDISCOVERY")
         {
-            if(_preferences->getBool(preference_register_opener_as_app, false) != (value == "1"))
+            if(_preferences->getString(preference_mqtt_hass_discovery, "") != value)
             {
-                _preferences->putBool(preference_register_opener_as_app, (value == "1"));
+                if (_nuki != nullptr) _nuki->disableHASS();
+                if (_nukiOpener != nullptr) _nukiOpener->disableHASS();
+                _preferences->putString(preference_mqtt_hass_discovery, value);
                 Log->print(F("Setting changed: "));
                 Log->println(key);
-                //configChanged = true;
+                configChanged = true;
             }
         }
-        else if(key == "LOCKENA")
+        else if(key == "OFFHYBRID")
         {
-            if(_preferences->getBool(preference_lock_enabled, true) != (value == "1"))
+            if(_preferences->getBool(preference_official_hybrid_enabled, false) != (value == "1"))
             {
-                _preferences->putBool(preference_lock_enabled, (value == "1"));
+                _preferences->putBool(preference_official_hybrid_enabled, (value == "1"));
+                if((value == "1")) _preferences->putBool(preference_register_as_app, true);
                 Log->print(F("Setting changed: "));
                 Log->println(key);
                 configChanged = true;
             }
         }
-        else if(key == "OPENA")
+        else if(key == "HYBRIDACT")
         {
-            if(_preferences->getBool(preference_opener_enabled, false) != (value == "1"))
+            if(_preferences->getBool(preference_official_hybrid_actions, false) != (value == "1"))
             {
-                _preferences->putBool(preference_opener_enabled, (value == "1"));
+                _preferences->putBool(preference_official_hybrid_actions, (value == "1"));
+                if(value == "1") _preferences->putBool(preference_register_as_app, true);
                 Log->print(F("Setting changed: "));
                 Log->println(key);
-                configChanged = true;
+                //configChanged = true;
             }
         }
+        else if(key == "ACLLVLCHANGED")
+        {
+            aclLvlChanged = true;
+        }
         else if(key == "CREDUSER")
         {
             if(value == "#")
@@ -2326,162 +1577,266 @@ bool WebCfgServer::processArgs(AsyncWebServerRequest *request, String& message)
     return configChanged;
 }
 
+static const char* importPairingKeys[WEBCFG_IMPORT_PAIRING_KEYS] =
+{
+    "bleAddressLock", "secretKeyKLock", "authorizationIdLock", "securityPinCodeLock",
+    "bleAddressOpener", "secretKeyKOpener", "authorizationIdOpener", "securityPinCodeOpener",
+};
+
 bool WebCfgServer::processImport(AsyncWebServerRequest *request, String& message)
 {
-    bool configChanged = false;
-    unsigned char currentBleAddress[6];
-    unsigned char authorizationId[4] = {0x00};
-    unsigned char secretKeyK[32] = {0x00};
-    unsigned char currentBleAddressOpn[6];
-    unsigned char authorizationIdOpn[4] = {0x00};
-    unsigned char secretKeyKOpn[32] = {0x00};
+    WebCfgImport* import = nullptr;
 
-    int params = request->params();
+    if(_import != nullptr && _import->request == request)
+    {
+        // An empty file input is still posted as a zero length upload
+        if(_import->bytes > 0) import = _import;
+        else delete _import;
+        _import = nullptr;
+    }
 
-    for(int index = 0; index < params; index++)
+    if(import == nullptr)
     {
-        const AsyncWebParameter* p = request->getParam(index);
-        if(p->name() == "importjson")
-        {
-            JsonDocument doc;
+        int params = request->params();
 
-            DeserializationError error = deserializeJson(doc, p->value());
-            if (error)
+        for(int index = 0; index < params; index++)
+        {
+            const AsyncWebParameter* p = request->getParam(index);
+            if(p->name() == "importjson" && p->value().length() > 0)
             {
-                Log->println("Invalid JSON for import");
-                message = "Invalid JSON, config not changed";
-                return configChanged;
+                import = new WebCfgImport(request);
+                feedImport(*import, p->value().c_str(), p->value().length());
+                break;
             }
+        }
+    }
 
-            DebugPreferences debugPreferences;
+    if(import == nullptr)
+    {
+        if(_import != nullptr)
+        {
+            message = "Another configuration import is in progress, config not changed";
+            return false;
+        }
 
-            const std::vector<char*> keysPrefs = debugPreferences.getPreferencesKeys();
-            const std::vector<char*> boolPrefs = debugPreferences.getPreferencesBoolKeys();
-            const std::vector<char*> bytePrefs = debugPreferences.getPreferencesByteKeys();
-            const std::vector<char*> intPrefs = debugPreferences.getPreferencesIntKeys();
+        message = "Configuration saved and applied.";
+        return false;
+    }
 
-            for(const auto& key : keysPrefs)
-            {
-                if(doc[key].isNull()) continue;
-                if(strcmp(key, preference_show_secrets) == 0) continue;
-                if(strcmp(key, preference_latest_version) == 0) continue;
-                if(strcmp(key, preference_device_id_lock) == 0) continue;
-                if(strcmp(key, preference_device_id_opener) == 0) continue;
-                if(std::find(boolPrefs.begin(), boolPrefs.end(), key) != boolPrefs.end())
-                {
-                    if (doc[key].as<String>().length() > 0) _preferences->putBool(key, (doc[key].as<String>() == "1" ? true : false));
-                    else _preferences->remove(key);
-                    continue;
-                }
-                if(std::find(intPrefs.begin(), intPrefs.end(), key) != intPrefs.end())
-                {
-                    if (doc[key].as<String>().length() > 0) _preferences->putInt(key, doc[key].as<int>());
-                    else _preferences->remove(key);
-                    continue;
-                }
+    bool configChanged = finishImport(*import, message);
+    delete import;
+    return configChanged;
+}
 
-                if (doc[key].as<String>().length() > 0) _preferences->putString(key, doc[key].as<String>());
-                else _preferences->remove(key);
-            }
+void WebCfgServer::handleImportUpload(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final)
+{
+    if(!index)
+    {
+        if(_import != nullptr && _import->request != request)
+        {
+            Log->println("Configuration import already in progress, ignoring upload");
+            return;
+        }
 
-            for(const auto& key : bytePrefs)
+        if(_import == nullptr)
+        {
+            _import = new WebCfgImport(request);
+            // Discard the import if the client goes away before the request handler runs
+            request->onDisconnect([this, request]()
             {
-                if(!doc[key].isNull() && doc[key].is<String>())
+                if(_import != nullptr && _import->request == request)
                 {
-                    String value = doc[key].as<String>();
-                    unsigned char tmpchar[32];
-                    for(int i=0; i<value.length();i+=2) tmpchar[(i/2)] = std::stoi(value.substring(i, i+2).c_str(), nullptr, 16);
-                    _preferences->putBytes(key, (byte*)(&tmpchar), (value.length() / 2));
-                    memset(tmpchar, 0, sizeof(tmpchar));
+                    delete _import;
+                    _import = nullptr;
                 }
-            }
+            });
+        }
+    }
 
-            Preferences nukiBlePref;
-            nukiBlePref.begin("NukiHub", false);
+    if(_import == nullptr || _import->request != request) return;
 
-            if(!doc["bleAddressLock"].isNull())
-            {
-                if (doc["bleAddressLock"].as<String>().length() == 12)
-                {
-                    String value = doc["bleAddressLock"].as<String>();
-                    for(int i=0; i<value.length();i+=2) currentBleAddress[(i/2)] = std::stoi(value.substring(i, i+2).c_str(), nullptr, 16);
-                    nukiBlePref.putBytes("bleAddress", currentBleAddress, 6);
-                }
-            }
-            if(!doc["secretKeyKLock"].isNull())
-            {
-                if (doc["secretKeyKLock"].as<String>().length() == 64)
-                {
-                    String value = doc["secretKeyKLock"].as<String>();
-                    for(int i=0; i<value.length();i+=2) secretKeyK[(i/2)] = std::stoi(value.substring(i, i+2).c_str(), nullptr, 16);
-                    nukiBlePref.putBytes("secretKeyK", secretKeyK, 32);
-                }
-            }
-            if(!doc["authorizationIdLock"].isNull())
-            {
-                if (doc["authorizationIdLock"].as<String>().length() == 8)
-                {
-                    String value = doc["authorizationIdLock"].as<String>();
-                    for(int i=0; i<value.length();i+=2) authorizationId[(i/2)] = std::stoi(value.substring(i, i+2).c_str(), nullptr, 16);
-                    nukiBlePref.putBytes("authorizationId", authorizationId, 4);
-                }
-            }
-            nukiBlePref.end();
-            if(!doc["securityPinCodeLock"].isNull() && _nuki != nullptr)
-            {
-                if(doc["securityPinCodeLock"].as<String>().length() > 0) _nuki->setPin(doc["securityPinCodeLock"].as<int>());
-                else _nuki->setPin(0xffff);
-            }
-            nukiBlePref.begin("NukiHubopener", false);
-            if(!doc["bleAddressOpener"].isNull())
-            {
-                if (doc["bleAddressOpener"].as<String>().length() == 12)
-                {
-                    String value = doc["bleAddressOpener"].as<String>();
-                    for(int i=0; i<value.length();i+=2) currentBleAddressOpn[(i/2)] = std::stoi(value.substring(i, i+2).c_str(), nullptr, 16);
-                    nukiBlePref.putBytes("bleAddress", currentBleAddressOpn, 6);
-                }
-            }
-            if(!doc["secretKeyKOpener"].isNull())
-            {
-                if (doc["secretKeyKOpener"].as<String>().length() == 64)
-                {
-                    String value = doc["secretKeyKOpener"].as<String>();
-                    for(int i=0; i<value.length();i+=2) secretKeyKOpn[(i/2)] = std::stoi(value.substring(i, i+2).c_str(), nullptr, 16);
-                    nukiBlePref.putBytes("secretKeyK", secretKeyKOpn, 32);
-                }
-            }
-            if(!doc["authorizationIdOpener"].isNull())
+    _import->bytes += len;
+    feedImport(*_import, (const char*)data, len);
+}
+
+void WebCfgServer::feedImport(WebCfgImport& import, const char* data, const size_t len)
+{
+    if(import.error.length() > 0) return;
+
+    import.reader.feed(data, len, [this, &import](const String& key, const String& value, const bool isNull)
+    {
+        if(!isNull && import.error.length() == 0) processImportMember(import, key, value);
+    });
+}
+
+void WebCfgServer::processImportMember(WebCfgImport& import, const String& key, const String& value)
+{
+    for(int i = 0; i < WEBCFG_IMPORT_PAIRING_KEYS; i++)
+    {
+        if(key == importPairingKeys[i])
+        {
+            import.pairing[i] = value;
+            import.pairingSet[i] = true;
+            return;
+        }
+    }
+
+    DebugPreferences debugPreferences;
+
+    const std::vector<char*>& keysPrefs = debugPreferences.getPreferencesKeys();
+    const std::vector<char*>& boolPrefs = debugPreferences.getPreferencesBoolKeys();
+    const std::vector<char*>& bytePrefs = debugPreferences.getPreferencesByteKeys();
+    const std::vector<char*>& intPrefs = debugPreferences.getPreferencesIntKeys();
+
+    auto keyMatches = [&key](const char* prefKey) { return key == prefKey; };
+
+    WebCfgImportValue staged = { nullptr, WebCfgImportType::Remove, value };
+
+    auto it = std::find_if(keysPrefs.begin(), keysPrefs.end(), keyMatches);
+    if(it != keysPrefs.end())
+    {
+        const char* prefKey = *it;
+        if(strcmp(prefKey, preference_show_secrets) == 0) return;
+        if(strcmp(prefKey, preference_latest_version) == 0) return;
+        if(strcmp(prefKey, preference_device_id_lock) == 0) return;
+        if(strcmp(prefKey, preference_device_id_opener) == 0) return;
+
+        staged.preference = prefKey;
+        const WebCfgSetting* setting = findWebCfgSettingByPreference(prefKey);
+
+        if(value.length() == 0) staged.type = WebCfgImportType::Remove;
+        else if(setting != nullptr)
+        {
+            // Settings of the configuration pages are checked against the same bounds as the form
+            if(!validWebCfgSetting(*setting, value))
             {
-                if (doc["authorizationIdOpener"].as<String>().length() == 8)
-                {
-                    String value = doc["authorizationIdOpener"].as<String>();
-                    for(int i=0; i<value.length();i+=2) authorizationIdOpn[(i/2)] = std::stoi(value.substring(i, i+2).c_str(), nullptr, 16);
-                    nukiBlePref.putBytes("authorizationId", authorizationIdOpn, 4);
-                }
+                import.error = "Invalid value for " + key;
+                return;
             }
-            nukiBlePref.end();
-            if(!doc["securityPinCodeOpener"].isNull() && _nukiOpener != nullptr)
+
+            if(setting->type == WebCfgSettingType::Bool) staged.type = WebCfgImportType::Bool;
+            else if(setting->type == WebCfgSettingType::Int) staged.type = WebCfgImportType::Int;
+            else staged.type = WebCfgImportType::String;
+        }
+        else if(std::find(boolPrefs.begin(), boolPrefs.end(), prefKey) != boolPrefs.end()) staged.type = WebCfgImportType::Bool;
+        else if(std::find(intPrefs.begin(), intPrefs.end(), prefKey) != intPrefs.end()) staged.type = WebCfgImportType::Int;
+        else staged.type = WebCfgImportType::String;
+    }
+    else
+    {
+        it = std::find_if(bytePrefs.begin(), bytePrefs.end(), keyMatches);
+        if(it == bytePrefs.end() || value.length() == 0) return;
+
+        std::vector<uint8_t> serialized(value.length() / 2);
+        if(value.length() % 2 != 0 || !hexToBytes(value, serialized.data(), serialized.size()))
+        {
+            import.error = "Invalid value for " + key;
+            return;
+        }
+
+        staged.preference = *it;
+        staged.type = WebCfgImportType::Bytes;
+    }
+
+    import.stagedBytes += value.length();
+    if(import.stagedBytes > CONFIG_IMPORT_MAX_STAGED_SIZE)
+    {
+        import.error = "Configuration too large";
+        return;
+    }
+
+    import.values.push_back(std::move(staged));
+}
+
+void WebCfgServer::commitImportValue(const WebCfgImportValue& value)
+{
+    switch(value.type)
+    {
+        case WebCfgImportType::Remove:
+            _preferences->remove(value.preference);
+            break;
+        case WebCfgImportType::Bool:
+            _preferences->putBool(value.preference, value.value == "1");
+            break;
+        case WebCfgImportType::Int:
+            _preferences->putInt(value.preference, value.value.toInt());
+            break;
+        case WebCfgImportType::String:
+            _preferences->putString(value.preference, value.value);
+            break;
+        case WebCfgImportType::Bytes:
+        {
+            std::vector<uint8_t> serialized(value.value.length() / 2);
+            if(hexToBytes(value.value, serialized.data(), serialized.size())) _preferences->putBytes(value.preference, serialized.data(), serialized.size());
+            break;
+        }
+    }
+}
+
+bool WebCfgServer::finishImport(WebCfgImport& import, String& message)
+{
+    if(import.error.length() == 0 && !import.reader.complete())
+    {
+        import.error = import.reader.error() ? import.reader.errorMessage() : "Document incomplete";
+    }
+
+    const char* namespaces[2] = { "NukiHub", "NukiHubopener" };
+    const size_t pairingLengths[3] = { 6, 32, 4 };
+    uint8_t pairingData[2][3][32];
+
+    // Pairing data is validated together with the other members, so an invalid key leaves everything untouched
+    for(int device = 0; device < 2 && import.error.length() == 0; device++)
+    {
+        for(int i = 0; i < 3; i++)
+        {
+            const int key = device * 4 + i;
+            if(import.pairingSet[key] && import.pairing[key].length() > 0 &&
+               !hexToBytes(import.pairing[key], pairingData[device][i], pairingLengths[i]))
             {
-                if(doc["securityPinCodeOpener"].as<String>().length() > 0) _nukiOpener->setPin(doc["securityPinCodeOpener"].as<int>());
-                else _nukiOpener->setPin(0xffff);
+                import.error = String("Invalid value for ") + importPairingKeys[key];
+                break;
             }
-
-            configChanged = true;
         }
     }
 
-    if(configChanged)
+    if(import.error.length() > 0)
     {
-        message = "Configuration saved, reboot is required to apply.";
-        _rebootRequired = true;
+        Log->print("Configuration import failed: ");
+        Log->println(import.error);
+        memset(pairingData, 0, sizeof(pairingData));
+        message = "Invalid configuration (" + import.error + "), config not changed";
+        return false;
     }
-    else
+
+    for(const WebCfgImportValue& value : import.values)
     {
-        message = "Configuration saved and applied.";
+        commitImportValue(value);
     }
 
-    return configChanged;
+    for(int device = 0; device < 2; device++)
+    {
+        const String* pairing = &import.pairing[device * 4];
+        const bool* pairingSet = &import.pairingSet[device * 4];
+
+        Preferences nukiBlePref;
+        nukiBlePref.begin(namespaces[device], false);
+        if(pairingSet[0] && pairing[0].length() > 0) nukiBlePref.putBytes("bleAddress", pairingData[device][0], 6);
+        if(pairingSet[1] && pairing[1].length() > 0) nukiBlePref.putBytes("secretKeyK", pairingData[device][1], 32);
+        if(pairingSet[2] && pairing[2].length() > 0) nukiBlePref.putBytes("authorizationId", pairingData[device][2], 4);
+        nukiBlePref.end();
+
+        if(pairingSet[3])
+        {
+            uint16_t pin = pairing[3].length() > 0 ? pairing[3].toInt() : 0xffff;
+            if(device == 0 && _nuki != nullptr) _nuki->setPin(pin);
+            else if(device == 1 && _nukiOpener != nullptr) _nukiOpener->setPin(pin);
+        }
+    }
+    memset(pairingData, 0, sizeof(pairingData));
+
+    message = "Configuration saved, reboot is required to apply.";
+    _rebootRequired = true;
+    return true;
 }
 
 void WebCfgServer::processGpioArgs(AsyncWebServerRequest *request)
@@ -2511,7 +1866,8 @@ void WebCfgServer::buildImportExportHtml(AsyncWebServerRequest *request)
     buildHtmlHeader();
 
     _response.concat("<div id=\"upform\"><h4>Import configuration</h4>");
-    _response.concat("<form method=\"post\" action=\"import\"><textarea id=\"importjson\" name=\"importjson\" rows=\"10\" cols=\"50\"></textarea><br/>");
+    _response.concat("<form method=\"post\" action=\"import\" enctype=\"multipart/form-data\"><textarea id=\"importjson\" name=\"importjson\" rows=\"10\" cols=\"50\"></textarea><br/>");
+    _response.concat("<br>Or select an exported file: <input type=\"file\" name=\"importfile\" accept=\".json,application/json\"><br/>");
     _response.concat("<br><input type=\"submit\" name=\"submit\" value=\"Import\"></form><br><br></div>");
     _response.concat("<div id=\"gitdiv\">");
     _response.concat("<h4>Export configuration</h4><br>");
@@ -2555,7 +1911,7 @@ void WebCfgServer::buildCustomNetworkConfigHtml(AsyncWebServerRequest *request)
 
 void WebCfgServer::buildHtml(AsyncWebServerRequest *request)
 {
-    String header = "<script>let intervalId; window.onload = function() { updateInfo(); intervalId = setInterval(updateInfo, 3000); }; function updateInfo() { var request = new XMLHttpRequest(); request.open('GET', '/status', true); request.onload = () => { const obj = JSON.parse(request.responseText); if (obj.stop == 1) { clearInterval(intervalId); } for (var key of Object.keys(obj)) { if(key=='ota' && document.getElementById(key) !== null) { document.getElementById(key).innerText = \"<a href='/ota'>\" + obj[key] + \"</a>\"; } else if(document.getElementById(key) !== null) { document.getElementById(key).innerText = obj[key]; } } }; request.send(); }</script>";
+    String header = "<script>let intervalId; window.onload = function() { updateInfo(); intervalId = setInterval(updateInfo, 3000); }; function updateInfo() { var request = new XMLHttpRequest(); request.open('GET', '/status', true); request.onload = () => { const obj = JSON.parse(request.responseText); if (obj.stop == 1) { clearInterval(intervalId); } for (var key of Object.keys(obj)) { if(key=='ota' && document.getElementById(key) !== null) { document.getElementById(key).innerText = \"<a href='/ota'>\" + obj[key] + \"</a>\"; } else if(document.getElementById(key) !== null) { document.getElementById(key).innerText = obj[key]; } } }; request.send(); } if (!!window.EventSource) { var source = new EventSource('/events'); source.addEventListener('state', function(e) { const obj = JSON.parse(e.data); for (var key of Object.keys(obj)) { if(document.getElementById(key) !== null) { document.getElementById(key).innerText = obj[key]; } } }, false); }</script>";
     _response = "";
     buildHtmlHeader(header);
 
@@ -2568,6 +1924,9 @@ void WebCfgServer::buildHtml(AsyncWebServerRequest *request)
     _response.concat("<h3>Info</h3><br>");
     _response.concat("<table>");
 
+    JsonDocument liveState;
+    liveStateToJson(liveState);
+
     printParameter("Hostname", _hostname.c_str(), "", "hostname");
     printParameter("MQTT Connected", _network->mqttConnectionState() > 0 ? "Yes" : "No", "", "mqttState");
     if(_nuki != nullptr)
@@ -2587,6 +1946,10 @@ void WebCfgServer::buildHtml(AsyncWebServerRequest *request)
                 String offConnected = _nuki->offConnected() ? "Yes": "No";
                 printParameter("Nuki Lock hybrid mode connected", offConnected.c_str(), "", "lockHybrid");
             }
+
+            if(_nuki->hasDoorSensor()) printParameter("Nuki Lock door sensor", liveState["lockDoorSensor"].as<const char*>(), "", "lockDoorSensor");
+            printParameter("Nuki Lock battery", liveState["lockBattery"].as<const char*>(), "", "lockBattery");
+            printParameter("Nuki Lock RSSI", liveState["lockRssi"].as<const char*>(), "", "lockRssi");
         }
     }
     if(_nukiOpener != nullptr)
@@ -2602,6 +1965,8 @@ void WebCfgServer::buildHtml(AsyncWebServerRequest *request)
         {
             String openerState = pinStateToString(_preferences->getInt(preference_opener_pin_status, 4));
             printParameter("Nuki Opener PIN status", openerState.c_str(), "", "openerPin");
+            printParameter("Nuki Opener battery", liveState["openerBattery"].as<const char*>(), "", "openerBattery");
+            printParameter("Nuki Opener RSSI", liveState["openerRssi"].as<const char*>(), "", "openerRssi");
         }
     }
     printParameter("Firmware", NUKI_HUB_VERSION, "/info", "firmware");
@@ -2903,11 +2268,16 @@ String WebCfgServer::pinStateToString(uint8_t value) {
 void WebCfgServer::buildAccLvlHtml(AsyncWebServerRequest *request)
 {
     _response = "";
-    buildHtmlHeader();
-
-    uint32_t aclPrefs[17];
-    _preferences->getBytes(preference_acl, &aclPrefs, sizeof(aclPrefs));
+    sendResponse(request, {
+        [this]() { buildAccLvlGeneralHtml(); },
+        [this]() { buildAccLvlLockHtml(); },
+        [this]() { buildAccLvlOpenerHtml(); }
+    });
+}
 
+void WebCfgServer::buildAccLvlGeneralHtml()
+{
+    buildHtmlHeader();
     _response.concat("<form method=\"post\" action=\"savecfg\">");
     _response.concat("<input type=\"hidden\" name=\"ACLLVLCHANGED\" value=\"1\">");
     _response.concat("<h3>Nuki General Access Control</h3>");
@@ -2930,6 +2300,12 @@ void WebCfgServer::buildAccLvlHtml(AsyncWebServerRequest *request)
     printCheckBox("PUBAUTH", "Publish authorization log", _preferences->getBool(preference_publish_authdata), "");
     _response.concat("</table><br>");
     _response.concat("<br><input type=\"submit\" name=\"submit\" value=\"Save\">");
+}
+
+void WebCfgServer::buildAccLvlLockHtml()
+{
+    uint32_t aclPrefs[17];
+    _preferences->getBytes(preference_acl, &aclPrefs, sizeof(aclPrefs));
 
     if(_nuki != nullptr)
     {
@@ -3005,6 +2381,13 @@ void WebCfgServer::buildAccLvlHtml(AsyncWebServerRequest *request)
         _response.concat("</table><br>");
         _response.concat("<br><input type=\"submit\" name=\"submit\" value=\"Save\">");
     }
+}
+
+void WebCfgServer::buildAccLvlOpenerHtml()
+{
+    uint32_t aclPrefs[17];
+    _preferences->getBytes(preference_acl, &aclPrefs, sizeof(aclPrefs));
+
     if(_nukiOpener != nullptr)
     {
         uint32_t basicOpenerConfigAclPrefs[14];
@@ -3076,7 +2459,6 @@ void WebCfgServer::buildAccLvlHtml(AsyncWebServerRequest *request)
     }
     _response.concat("</form>");
     _response.concat("</body></html>");
-    sendResponse(request);
 }
 
 void WebCfgServer::buildNukiConfigHtml(AsyncWebServerRequest *request)
@@ -3118,11 +2500,34 @@ void WebCfgServer::buildNukiConfigHtml(AsyncWebServerRequest *request)
 void WebCfgServer::buildGpioConfigHtml(AsyncWebServerRequest *request)
 {
     _response = "";
+    sendResponse(request, {
+        [this]() { buildGpioPinsHtml(); },
+        [this]() { buildGpioScriptHtml(); }
+    });
+}
+
+void WebCfgServer::buildGpioPinsHtml()
+{
     buildHtmlHeader();
     _response.concat("<form method=\"post\" action=\"savegpiocfg\">");
     _response.concat("<h3>GPIO Configuration</h3>");
     _response.concat("<table>");
     std::vector<std::pair<String, String>> options;
+
+    for(const auto& pin : _gpio->availablePins())
+    {
+        String pinStr = String(pin);
+        String pinDesc = "Gpio " + pinStr;
+        printDropDown(pinStr.c_str(), pinDesc.c_str(), "", options, "gpioselect");
+    }
+
+    _response.concat("</table>");
+    _response.concat("<br><input type=\"submit\" name=\"submit\" value=\"Save\">");
+    _response.concat("</form>");
+}
+
+void WebCfgServer::buildGpioScriptHtml()
+{
     String gpiopreselects = "var gpio = []; ";
 
     const auto& availablePins = _gpio->availablePins();
@@ -3131,17 +2536,11 @@ void WebCfgServer::buildGpioConfigHtml(AsyncWebServerRequest *request)
     for(const auto& pin : availablePins)
     {
         String pinStr = String(pin);
-        String pinDesc = "Gpio " + pinStr;
-        printDropDown(pinStr.c_str(), pinDesc.c_str(), "", options, "gpioselect");
         if(std::find(disabledPins.begin(), disabledPins.end(), pin) != disabledPins.end()) gpiopreselects.concat("gpio[" + pinStr + "] = '21';");
         else gpiopreselects.concat("gpio[" + pinStr + "] = '" + getPreselectionForGpio(pin) + "';");
     }
 
-    _response.concat("</table>");
-    _response.concat("<br><input type=\"submit\" name=\"submit\" value=\"Save\">");
-    _response.concat("</form>");
-
-    options = getGpioOptions();
+    std::vector<std::pair<String, String>> options = getGpioOptions();
 
     _response.concat("<script type=\"text/javascript\">" + gpiopreselects + "var gpiooptions = '");
 
@@ -3156,7 +2555,6 @@ void WebCfgServer::buildGpioConfigHtml(AsyncWebServerRequest *request)
 
     _response.concat("'; var gpioselects = document.getElementsByClassName('gpioselect'); for (let i = 0; i < gpioselects.length; i++) { gpioselects[i].options.length = 0; gpioselects[i].innerHTML = gpiooptions; gpioselects[i].value = gpio[gpioselects[i].name]; if(gpioselects[i].value == 21) { gpioselects[i].disabled = true; } }</script>");
     _response.concat("</body></html>");
-    sendResponse(request);
 }
 
 #ifndef CONFIG_IDF_TARGET_ESP32H2
@@ -3174,9 +2572,18 @@ void WebCfgServer::buildConfigureWifiHtml(AsyncWebServerRequest *request)
 
 void WebCfgServer::buildInfoHtml(AsyncWebServerRequest *request)
 {
-     _response = "";
-    uint32_t aclPrefs[17];
-    _preferences->getBytes(preference_acl, &aclPrefs, sizeof(aclPrefs));
+    _response = "";
+    sendResponse(request, {
+        [this]() { buildInfoSystemHtml(); },
+        [this]() { buildInfoNetworkHtml(); },
+        [this]() { buildInfoLockHtml(); },
+        [this]() { buildInfoOpenerHtml(); },
+        [this]() { buildInfoGpioHtml(); }
+    });
+}
+
+void WebCfgServer::buildInfoSystemHtml()
+{
     buildHtmlHeader();
     _response.concat("<h3>System Information</h3><pre>");
     _response.concat("------------ NUKI HUB ------------");
@@ -3256,6 +2663,10 @@ void WebCfgServer::buildInfoHtml(AsyncWebServerRequest *request)
     _response.concat(_preferences->getBool(preference_webserial_enabled, false) ? "Yes" : "No");
     _response.concat("\nBootloop protection enabled: ");
     _response.concat(_preferences->getBool(preference_enable_bootloop_reset, false) ? "Yes" : "No");
+}
+
+void WebCfgServer::buildInfoNetworkHtml()
+{
     _response.concat("\n\n------------ NETWORK ------------");
     _response.concat("\nNetwork device: ");
     _response.concat(_network->networkDeviceName());
@@ -3282,6 +2693,15 @@ void WebCfgServer::buildInfoHtml(AsyncWebServerRequest *request)
             //Ethernet info
         }
     }
+    _response.concat("\nLast reconnect (ms after drop):");
+    for(uint8_t i = 0; i < (uint8_t)ReconnectPhase::Count; i++)
+    {
+        int64_t duration = _network->device()->reconnectPhaseDuration((ReconnectPhase)i);
+        _response.concat(" ");
+        _response.concat(NetworkDevice::reconnectPhaseName((ReconnectPhase)i));
+        _response.concat(" ");
+        _response.concat(duration == -1 ? String("-") : String((uint32_t)duration));
+    }
     _response.concat("\n\n------------ NETWORK SETTINGS ------------");
     _response.concat("\nNuki Hub hostname: ");
     _response.concat(_preferences->getString(preference_hostname, ""));
@@ -3322,6 +2742,51 @@ void WebCfgServer::buildInfoHtml(AsyncWebServerRequest *request)
     _response.concat("\n\n------------ MQTT ------------");
     _response.concat("\nMQTT connected: ");
     _response.concat(_network->mqttConnectionState() > 0 ? "Yes" : "No");
+    _response.concat("\nHA discovery documents sent: ");
+    _response.concat(_network->hassDocumentsSent());
+    _response.concat("\nHA discovery documents unchanged (skipped): ");
+    _response.concat(_network->hassDocumentsSkipped());
+    _response.concat("\nMQTT publishes queued: ");
+    _response.concat(_network->publishQueueDepth());
+    _response.concat("\nMQTT retained publishes coalesced: ");
+    _response.concat(_network->publishesCoalesced());
+    _response.concat("\nMQTT publishes dropped while disconnected: ");
+    _response.concat(_network->publishesDropped());
+    _response.concat("\nMQTT publishers throttled: ");
+    _response.concat(_network->publishesThrottled());
+#if EMC_USE_PACKET_POOL
+    for(size_t i = 0; i < espMqttClientInternals::PacketPool::numClasses(); i++)
+    {
+        espMqttClientInternals::PacketPoolStats poolStats = espMqttClientInternals::PacketPool::classStats(i);
+        _response.concat("\nMQTT packet pool ");
+        _response.concat(poolStats.blockSize);
+        _response.concat(" bytes (in use / peak / blocks / exhausted / heap fallbacks): ");
+        _response.concat(poolStats.inUse);
+        _response.concat(" / ");
+        _response.concat(poolStats.peakInUse);
+        _response.concat(" / ");
+        _response.concat(poolStats.blocks);
+        _response.concat(" / ");
+        _response.concat(poolStats.exhausted);
+        _response.concat(" / ");
+        _response.concat(poolStats.heapFallbacks);
+    }
+    _response.concat("\nMQTT packet heap allocations (in use / total): ");
+    _response.concat(espMqttClientInternals::PacketPool::heapInUse());
+    _response.concat(" / ");
+    _response.concat(espMqttClientInternals::PacketPool::heapAllocations());
+#endif
+#ifndef NUKI_HUB_UPDATER
+    for(uint8_t i = 0; i < (uint8_t)JsonArenaDoc::Count; i++)
+    {
+        _response.concat("\nJSON arena ");
+        _response.concat(JsonArena::docName((JsonArenaDoc)i));
+        _response.concat(" (high-water bytes / heap fallbacks): ");
+        _response.concat(JsonArena::highWater((JsonArenaDoc)i));
+        _response.concat(" / ");
+        _response.concat(JsonArena::heapFallbacks((JsonArenaDoc)i));
+    }
+#endif
     _response.concat("\nMQTT broker address: ");
     _response.concat(_preferences->getString(preference_mqtt_broker, ""));
     _response.concat("\nMQTT broker port: ");
@@ -3403,6 +2868,26 @@ void WebCfgServer::buildInfoHtml(AsyncWebServerRequest *request)
         _response.concat(_preferences->getString(preference_mqtt_hass_cu_url, "").length() > 0 ? _preferences->getString(preference_mqtt_hass_cu_url, "") : "http://" + _network->localIP());
     }
     else _response.concat("No");
+}
+
+void WebCfgServer::appendLatencyInfo(const char* stage, const LatencyStats& stats)
+{
+    _response.concat("\n");
+    _response.concat(stage);
+    _response.concat(" latency (p50 / p99 / max, samples): ");
+    _response.concat(stats.percentile(50));
+    _response.concat(" / ");
+    _response.concat(stats.percentile(99));
+    _response.concat(" / ");
+    _response.concat(stats.max());
+    _response.concat(" ms, ");
+    _response.concat(stats.count());
+}
+
+void WebCfgServer::buildInfoLockHtml()
+{
+    uint32_t aclPrefs[17];
+    _preferences->getBytes(preference_acl, &aclPrefs, sizeof(aclPrefs));
     _response.concat("\n\n------------ NUKI LOCK ------------");
     if(_nuki == nullptr || !_preferences->getBool(preference_lock_enabled, true)) _response.concat("\nLock enabled: No");
     else
@@ -3418,6 +2903,21 @@ void WebCfgServer::buildInfoHtml(AsyncWebServerRequest *request)
         _response.concat(_nuki->firmwareVersion().c_str());
         _response.concat("\nHardware version: ");
         _response.concat(_nuki->hardwareVersion().c_str());
+        _response.concat("\nActions (attempts / retries / failed / superseded): ");
+        _response.concat(_nuki->lockActionAttempts());
+        _response.concat(" / ");
+        _response.concat(_nuki->lockActionRetries());
+        _response.concat(" / ");
+        _response.concat(_nuki->lockActionsFailed());
+        _response.concat(" / ");
+        _response.concat(_nuki->lockActionsSuperseded());
+        appendLatencyInfo("Action dispatch", _nuki->lockActionDispatchLatency());
+        appendLatencyInfo("Action dispatch during bulk read", _nuki->lockActionBulkReadDispatchLatency());
+        _response.concat("\nBulk reads postponed for actions: ");
+        _response.concat(_nuki->bulkReadsPostponed());
+        appendLatencyInfo("Action command", _nuki->lockActionCommandLatency());
+        appendLatencyInfo("Action state publish", _nuki->lockActionStateLatency());
+        appendLatencyInfo("BLE queue wait", _nuki->bleWaitLatency());
         _response.concat("\nValid PIN set: ");
         _response.concat(_nuki->isPaired() ? _nuki->isPinValid() ? "Yes" : "No" : "-");
         _response.concat("\nHas door sensor: ");
@@ -3589,7 +3089,12 @@ void WebCfgServer::buildInfoHtml(AsyncWebServerRequest *request)
             _response.concat(authorizationIdInt);
         }
     }
+}
 
+void WebCfgServer::buildInfoOpenerHtml()
+{
+    uint32_t aclPrefs[17];
+    _preferences->getBytes(preference_acl, &aclPrefs, sizeof(aclPrefs));
     _response.concat("\n\n------------ NUKI OPENER ------------");
     if(_nukiOpener == nullptr || !_preferences->getBool(preference_opener_enabled, false)) _response.concat("\nOpener enabled: No");
     else
@@ -3605,6 +3110,21 @@ void WebCfgServer::buildInfoHtml(AsyncWebServerRequest *request)
         _response.concat(_nukiOpener->firmwareVersion().c_str());
         _response.concat("\nHardware version: ");
         _response.concat(_nukiOpener->hardwareVersion().c_str());
+        _response.concat("\nActions (attempts / retries / failed / superseded): ");
+        _response.concat(_nukiOpener->lockActionAttempts());
+        _response.concat(" / ");
+        _response.concat(_nukiOpener->lockActionRetries());
+        _response.concat(" / ");
+        _response.concat(_nukiOpener->lockActionsFailed());
+        _response.concat(" / ");
+        _response.concat(_nukiOpener->lockActionsSuperseded());
+        appendLatencyInfo("Action dispatch", _nukiOpener->lockActionDispatchLatency());
+        appendLatencyInfo("Action dispatch during bulk read", _nukiOpener->lockActionBulkReadDispatchLatency());
+        _response.concat("\nBulk reads postponed for actions: ");
+        _response.concat(_nukiOpener->bulkReadsPostponed());
+        appendLatencyInfo("Action command", _nukiOpener->lockActionCommandLatency());
+        appendLatencyInfo("Action state publish", _nukiOpener->lockActionStateLatency());
+        appendLatencyInfo("BLE queue wait", _nukiOpener->bleWaitLatency());
         _response.concat("\nOpener valid PIN set: ");
         _response.concat(_nukiOpener->isPaired() ? _nukiOpener->isPinValid() ? "Yes" : "No" : "-");
         _response.concat("\nOpener has keypad: ");
@@ -3743,13 +3263,15 @@ void WebCfgServer::buildInfoHtml(AsyncWebServerRequest *request)
             }
         }
     }
+}
 
+void WebCfgServer::buildInfoGpioHtml()
+{
     _response.concat("\n\n------------ GPIO ------------\n");
     String gpioStr = "";
     _gpio->getConfigurationText(gpioStr, _gpio->pinConfiguration());
     _response.concat(gpioStr);
     _response.concat("</pre></body></html>");
-    sendResponse(request);
 }
 
 void WebCfgServer::processUnpair(AsyncWebServerRequest *request, bool opener)
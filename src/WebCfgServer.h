@@ -4,14 +4,18 @@
 #include <AsyncTCP.h>
 #include <DNSServer.h>
 #include <ESPAsyncWebServer.h>
+#include <functional>
+#include <memory>
 #include "esp_ota_ops.h"
 #include "Config.h"
+#include "OtaWriter.h"
 
 #ifndef NUKI_HUB_UPDATER
 #include "NukiWrapper.h"
 #include "NukiNetworkLock.h"
 #include "NukiOpenerWrapper.h"
 #include "Gpio.h"
+#include "ConfigJsonReader.h"
 
 extern TaskHandle_t nukiTaskHandle;
 
@@ -33,6 +37,56 @@ enum class TokenType
 
 extern TaskHandle_t networkTaskHandle;
 
+// Page streamed by a chunked response, taken from a fixed pool of WEBCFG_MAX_RESPONSES. Sections are rendered
+// one at a time when the previous chunk has been sent, so only the largest section is held in memory.
+struct WebCfgRenderContext
+{
+    bool inUse = false;
+    std::vector<std::function<void()>> sections;
+    size_t nextSection = 0;
+    String chunk;
+    size_t chunkOffset = 0;
+};
+
+#ifndef NUKI_HUB_UPDATER
+#define WEBCFG_IMPORT_PAIRING_KEYS 8
+
+enum class WebCfgImportType : uint8_t
+{
+    Remove,
+    Bool,
+    Int,
+    String,
+    Bytes
+};
+
+struct WebCfgImportValue
+{
+    const char* preference;
+    WebCfgImportType type;
+    String value;
+};
+
+// Configuration import in progress. Members are validated and staged while the document is parsed,
+// nothing is written to the preferences until the whole document has been read successfully.
+struct WebCfgImport
+{
+    explicit WebCfgImport(AsyncWebServerRequest* owner)
+    : request(owner),
+      reader(CONFIG_IMPORT_MAX_VALUE_LENGTH)
+    {}
+
+    AsyncWebServerRequest* request;
+    ConfigJsonReader reader;
+    std::vector<WebCfgImportValue> values;
+    String pairing[WEBCFG_IMPORT_PAIRING_KEYS];
+    bool pairingSet[WEBCFG_IMPORT_PAIRING_KEYS] = {false};
+    size_t bytes = 0;
+    size_t stagedBytes = 0;
+    String error;
+};
+#endif
+
 class WebCfgServer
 {
 public:
@@ -44,15 +98,34 @@ public:
     ~WebCfgServer() = default;
 
     void initialize();
+    #ifndef NUKI_HUB_UPDATER
+    void update();
+    #endif
 
 private:
     #ifndef NUKI_HUB_UPDATER
     void sendSettings(AsyncWebServerRequest *request);
+    String exportPreference(const char* key, const bool isBool);
+    void appendSettingsMember(const bool first, const char* key, const String& value, const bool quoted = true);
+    void appendPairingMembers(const char* preferencesNamespace, const char* suffix);
+    void sendApiStatus(AsyncWebServerRequest *request);
+    void sendApiConfig(AsyncWebServerRequest *request);
+    void handleApiBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+    void processApiAction(AsyncWebServerRequest *request, bool opener);
+    void liveStateToJson(JsonDocument& json);
     bool processArgs(AsyncWebServerRequest *request, String& message);
     bool processImport(AsyncWebServerRequest *request, String& message);
+    void handleImportUpload(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final);
+    void feedImport(WebCfgImport& import, const char* data, const size_t len);
+    void processImportMember(WebCfgImport& import, const String& key, const String& value);
+    void commitImportValue(const WebCfgImportValue& value);
+    bool finishImport(WebCfgImport& import, String& message);
     void processGpioArgs(AsyncWebServerRequest *request);
     void buildHtml(AsyncWebServerRequest *request);
     void buildAccLvlHtml(AsyncWebServerRequest *request);
+    void buildAccLvlGeneralHtml();
+    void buildAccLvlLockHtml();
+    void buildAccLvlOpenerHtml();
     void buildCredHtml(AsyncWebServerRequest *request);
     void buildImportExportHtml(AsyncWebServerRequest *request);
     void buildMqttConfigHtml(AsyncWebServerRequest *request);
@@ -60,10 +133,18 @@ private:
     void buildAdvancedConfigHtml(AsyncWebServerRequest *request);
     void buildNukiConfigHtml(AsyncWebServerRequest *request);
     void buildGpioConfigHtml(AsyncWebServerRequest *request);
+    void buildGpioPinsHtml();
+    void buildGpioScriptHtml();
     #ifndef CONFIG_IDF_TARGET_ESP32H2
     void buildConfigureWifiHtml(AsyncWebServerRequest *request);
     #endif
     void buildInfoHtml(AsyncWebServerRequest *request);
+    void buildInfoSystemHtml();
+    void buildInfoNetworkHtml();
+    void buildInfoLockHtml();
+    void buildInfoOpenerHtml();
+    void buildInfoGpioHtml();
+    void appendLatencyInfo(const char* stage, const LatencyStats& stats);
     void buildCustomNetworkConfigHtml(AsyncWebServerRequest *request);
     void processUnpair(AsyncWebServerRequest *request, bool opener);
     void processUpdate(AsyncWebServerRequest *request);
@@ -94,9 +175,17 @@ private:
     bool _pinsConfigured = false;
     bool _brokerConfigured = false;
     bool _rebootRequired = false;
+
+    AsyncEventSource* _events = nullptr;
+    JsonDocument _liveState; // last values pushed to the event source clients
+    uint32_t _liveLockRevision = 0;
+    uint32_t _liveOpenerRevision = 0;
+    int _liveMqttState = -1;
+    WebCfgImport* _import = nullptr; // streamed file upload, owned until the import request completes
     #endif
 
-    String _response;
+    String _response; // scratch buffer, handed over to a render context by sendResponse()
+    WebCfgRenderContext _renderContexts[WEBCFG_MAX_RESPONSES];
     String generateConfirmCode();
     String _confirmCode = "----";
     void buildConfirmHtml(AsyncWebServerRequest *request, const String &message, uint32_t redirectDelay = 5, bool redirect = false);    
@@ -109,6 +198,8 @@ private:
     void handleOtaUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final);
     void printProgress(size_t prg, size_t sz);
     void sendResponse(AsyncWebServerRequest *request);
+    void sendResponse(AsyncWebServerRequest *request, std::vector<std::function<void()>> sections, const char* contentType = "text/html");
+    size_t renderChunk(WebCfgRenderContext& context, uint8_t *buffer, size_t maxlen);
     
     AsyncWebServer* _asyncServer = nullptr;
     NukiNetwork* _network = nullptr;
@@ -122,6 +213,7 @@ private:
     uint32_t _transferredSize = 0;
     int64_t _otaStartTs = 0;
     size_t _otaContentLen = 0;
+    OtaWriter _otaWriter;
     String _hostname;
     bool _enabled = true;
 };
@@ -0,0 +1,272 @@
+#include "WebCfgSettings.h"
+#include "PreferencesKeys.h"
+#include "MqttTopicHash.h"
+#include "Config.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const WebCfgSetting settings[] =
+    {
+        { "MQTTSERVER", preference_mqtt_broker, WebCfgSettingType::String, WEBCFG_SETTING_RESTART, 0 },
+        { "MQTTPORT", preference_mqtt_broker_port, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART, 0 },
+        { "MQTTPATH", preference_mqtt_lock_path, WebCfgSettingType::String, WEBCFG_SETTING_RESTART, 0 },
+        { "MQTTOPPATH", preference_mqtt_opener_path, WebCfgSettingType::String, WEBCFG_SETTING_RESTART, 0 },
+        { "MQTTCA", preference_mqtt_ca, WebCfgSettingType::String, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_REDACTED, 0 },
+        { "MQTTCRT", preference_mqtt_crt, WebCfgSettingType::String, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_REDACTED, 0 },
+        { "MQTTKEY", preference_mqtt_key, WebCfgSettingType::String, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_REDACTED, 0 },
+        { "NWCUSTPHY", preference_network_custom_phy, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWCUSTADDR", preference_network_custom_addr, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWCUSTIRQ", preference_network_custom_irq, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWCUSTRST", preference_network_custom_rst, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWCUSTCS", preference_network_custom_cs, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWCUSTSCK", preference_network_custom_sck, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWCUSTMISO", preference_network_custom_miso, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWCUSTMOSI", preference_network_custom_mosi, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWCUSTPWR", preference_network_custom_pwr, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWCUSTMDIO", preference_network_custom_mdio, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWCUSTMDC", preference_network_custom_mdc, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWCUSTCLK", preference_network_custom_clk, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART | WEBCFG_SETTING_NETWORK_RECONFIGURE, 0 },
+        { "NWHWWIFIFB", preference_network_wifi_fallback_disabled, WebCfgSettingType::Bool, 0, 0 },
+        { "RSSI", preference_rssi_publish_interval, WebCfgSettingType::Int, 0, 60 },
+        { "OPENERCONT", preference_opener_continuous_mode, WebCfgSettingType::Bool, 0, 0 },
+        { "HASSCUURL", preference_mqtt_hass_cu_url, WebCfgSettingType::String, 0, 0 },
+        { "BESTRSSI", preference_find_best_rssi, WebCfgSettingType::Bool, 0, 0 },
+        { "HOSTNAME", preference_hostname, WebCfgSettingType::String, WEBCFG_SETTING_RESTART, 0 },
+        { "NETTIMEOUT", preference_network_timeout, WebCfgSettingType::Int, 0, 60 },
+        { "RSTDISC", preference_restart_on_disconnect, WebCfgSettingType::Bool, 0, 0 },
+        { "RECNWTMQTTDIS", preference_recon_netw_on_mqtt_discon, WebCfgSettingType::Bool, 0, 0 },
+        { "MQTTLOG", preference_mqtt_log_enabled, WebCfgSettingType::Bool, WEBCFG_SETTING_RESTART, 0 },
+        { "WEBLOG", preference_webserial_enabled, WebCfgSettingType::Bool, WEBCFG_SETTING_RESTART, 0 },
+        { "CHECKUPDATE", preference_check_updates, WebCfgSettingType::Bool, 0, 0 },
+        { "UPDATEMQTT", preference_update_from_mqtt, WebCfgSettingType::Bool, WEBCFG_SETTING_RESTART, 0 },
+        { "HYBRIDTIMER", preference_query_interval_hybrid_lockstate, WebCfgSettingType::Int, 0, 600 },
+        { "HYBRIDRETRY", preference_official_hybrid_retry, WebCfgSettingType::Bool, 0, 0 },
+        { "DISNONJSON", preference_disable_non_json, WebCfgSettingType::Bool, WEBCFG_SETTING_RESTART, 0 },
+        { "DHCPENA", preference_ip_dhcp_enabled, WebCfgSettingType::Bool, WEBCFG_SETTING_RESTART, 1 },
+        { "IPADDR", preference_ip_address, WebCfgSettingType::String, WEBCFG_SETTING_RESTART, 0 },
+        { "IPSUB", preference_ip_subnet, WebCfgSettingType::String, WEBCFG_SETTING_RESTART, 0 },
+        { "IPGTW", preference_ip_gateway, WebCfgSettingType::String, WEBCFG_SETTING_RESTART, 0 },
+        { "DNSSRV", preference_ip_dns_server, WebCfgSettingType::String, WEBCFG_SETTING_RESTART, 0 },
+        { "TXPWR", preference_ble_tx_power, WebCfgSettingType::Int, 0, 9, WebCfgAcl::None, -12, 9 },
+        { "TSKNTWK", preference_task_size_network, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART, NETWORK_TASK_SIZE, WebCfgAcl::None, 12288, 32768 },
+        { "TSKNUKI", preference_task_size_nuki, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART, NUKI_TASK_SIZE, WebCfgAcl::None, 8192, 32768 },
+        { "ALMAX", preference_authlog_max_entries, WebCfgSettingType::Int, 0, MAX_AUTHLOG, WebCfgAcl::None, 1, 50 },
+        { "KPMAX", preference_keypad_max_entries, WebCfgSettingType::Int, 0, MAX_KEYPAD, WebCfgAcl::None, 1, 100 },
+        { "TCMAX", preference_timecontrol_max_entries, WebCfgSettingType::Int, 0, MAX_TIMECONTROL, WebCfgAcl::None, 1, 50 },
+        { "AUTHMAX", preference_auth_max_entries, WebCfgSettingType::Int, 0, MAX_AUTH, WebCfgAcl::None, 1, 50 },
+        { "BUFFSIZE", preference_buffer_size, WebCfgSettingType::Int, WEBCFG_SETTING_RESTART, CHAR_BUFFER_SIZE, WebCfgAcl::None, 4096, 32768 },
+        { "LSTINT", preference_query_interval_lockstate, WebCfgSettingType::Int, 0, 1800 },
+        { "CFGINT", preference_query_interval_configuration, WebCfgSettingType::Int, 0, 3600 },
+        { "BATINT", preference_query_interval_battery, WebCfgSettingType::Int, 0, 1800 },
+        { "KPINT", preference_query_interval_keypad, WebCfgSettingType::Int, 0, 1800 },
+        { "NRTRY", preference_command_nr_of_retries, WebCfgSettingType::Int, 0, 3 },
+        { "TRYDLY", preference_command_retry_delay, WebCfgSettingType::Int, 0, 100 },
+        { "RSBC", preference_restart_ble_beacon_lost, WebCfgSettingType::Int, 0, 60 },
+        { "BTLPRST", preference_enable_bootloop_reset, WebCfgSettingType::Bool, 0, 0 },
+        { "OTAUPD", preference_ota_updater_url, WebCfgSettingType::String, WEBCFG_SETTING_RESTART, 0 },
+        { "OTAMAIN", preference_ota_main_url, WebCfgSettingType::String, WEBCFG_SETTING_RESTART, 0 },
+        { "SHOWSECRETS", preference_show_secrets, WebCfgSettingType::Bool, 0, 0 },
+        { "CONFPUB", preference_conf_info_enabled, WebCfgSettingType::Bool, 0, 1 },
+        { "KPPUB", preference_keypad_info_enabled, WebCfgSettingType::Bool, 0, 0 },
+        { "KPCODE", preference_keypad_publish_code, WebCfgSettingType::Bool, 0, 0 },
+        { "KPENA", preference_keypad_control_enabled, WebCfgSettingType::Bool, WEBCFG_SETTING_RESTART, 0 },
+        { "TCPUB", preference_timecontrol_info_enabled, WebCfgSettingType::Bool, 0, 0 },
+        { "AUTHPUB", preference_auth_info_enabled, WebCfgSettingType::Bool, 0, 0 },
+        { "KPPER", preference_keypad_topic_per_entry, WebCfgSettingType::Bool, 0, 0 },
+        { "TCPER", preference_timecontrol_topic_per_entry, WebCfgSettingType::Bool, 0, 0 },
+        { "TCENA", preference_timecontrol_control_enabled, WebCfgSettingType::Bool, WEBCFG_SETTING_RESTART, 0 },
+        { "AUTHPER", preference_auth_topic_per_entry, WebCfgSettingType::Bool, 0, 0 },
+        { "AUTHENA", preference_auth_control_enabled, WebCfgSettingType::Bool, WEBCFG_SETTING_RESTART, 0 },
+        { "PUBAUTH", preference_publish_authdata, WebCfgSettingType::Bool, 0, 0 },
+        { "ACLLCKLCK", nullptr, WebCfgSettingType::Acl, 0, 0, WebCfgAcl::Actions },
+        { "ACLLCKUNLCK", nullptr, WebCfgSettingType::Acl, 0, 1, WebCfgAcl::Actions },
+        { "ACLLCKUNLTCH", nullptr, WebCfgSettingType::Acl, 0, 2, WebCfgAcl::Actions },
+        { "ACLLCKLNG", nullptr, WebCfgSettingType::Acl, 0, 3, WebCfgAcl::Actions },
+        { "ACLLCKLNGU", nullptr, WebCfgSettingType::Acl, 0, 4, WebCfgAcl::Actions },
+        { "ACLLCKFLLCK", nullptr, WebCfgSettingType::Acl, 0, 5, WebCfgAcl::Actions },
+        { "ACLLCKFOB1", nullptr, WebCfgSettingType::Acl, 0, 6, WebCfgAcl::Actions },
+        { "ACLLCKFOB2", nullptr, WebCfgSettingType::Acl, 0, 7, WebCfgAcl::Actions },
+        { "ACLLCKFOB3", nullptr, WebCfgSettingType::Acl, 0, 8, WebCfgAcl::Actions },
+        { "ACLOPNUNLCK", nullptr, WebCfgSettingType::Acl, 0, 9, WebCfgAcl::Actions },
+        { "ACLOPNLCK", nullptr, WebCfgSettingType::Acl, 0, 10, WebCfgAcl::Actions },
+        { "ACLOPNUNLTCH", nullptr, WebCfgSettingType::Acl, 0, 11, WebCfgAcl::Actions },
+        { "ACLOPNUNLCKCM", nullptr, WebCfgSettingType::Acl, 0, 12, WebCfgAcl::Actions },
+        { "ACLOPNLCKCM", nullptr, WebCfgSettingType::Acl, 0, 13, WebCfgAcl::Actions },
+        { "ACLOPNFOB1", nullptr, WebCfgSettingType::Acl, 0, 14, WebCfgAcl::Actions },
+        { "ACLOPNFOB2", nullptr, WebCfgSettingType::Acl, 0, 15, WebCfgAcl::Actions },
+        { "ACLOPNFOB3", nullptr, WebCfgSettingType::Acl, 0, 16, WebCfgAcl::Actions },
+        { "CONFLCKNAME", nullptr, WebCfgSettingType::Acl, 0, 0, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKLAT", nullptr, WebCfgSettingType::Acl, 0, 1, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKLONG", nullptr, WebCfgSettingType::Acl, 0, 2, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKAUNL", nullptr, WebCfgSettingType::Acl, 0, 3, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKPRENA", nullptr, WebCfgSettingType::Acl, 0, 4, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKBTENA", nullptr, WebCfgSettingType::Acl, 0, 5, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKLEDENA", nullptr, WebCfgSettingType::Acl, 0, 6, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKLEDBR", nullptr, WebCfgSettingType::Acl, 0, 7, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKTZOFF", nullptr, WebCfgSettingType::Acl, 0, 8, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKDSTM", nullptr, WebCfgSettingType::Acl, 0, 9, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKFOB1", nullptr, WebCfgSettingType::Acl, 0, 10, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKFOB2", nullptr, WebCfgSettingType::Acl, 0, 11, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKFOB3", nullptr, WebCfgSettingType::Acl, 0, 12, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKSGLLCK", nullptr, WebCfgSettingType::Acl, 0, 13, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKADVM", nullptr, WebCfgSettingType::Acl, 0, 14, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKTZID", nullptr, WebCfgSettingType::Acl, 0, 15, WebCfgAcl::BasicLockConfig },
+        { "CONFLCKUPOD", nullptr, WebCfgSettingType::Acl, 0, 0, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKLPOD", nullptr, WebCfgSettingType::Acl, 0, 1, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKSLPOD", nullptr, WebCfgSettingType::Acl, 0, 2, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKUTLTOD", nullptr, WebCfgSettingType::Acl, 0, 3, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKLNGT", nullptr, WebCfgSettingType::Acl, 0, 4, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKSBPA", nullptr, WebCfgSettingType::Acl, 0, 5, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKDBPA", nullptr, WebCfgSettingType::Acl, 0, 6, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKDC", nullptr, WebCfgSettingType::Acl, 0, 7, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKBATT", nullptr, WebCfgSettingType::Acl, 0, 8, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKABTD", nullptr, WebCfgSettingType::Acl, 0, 9, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKUNLD", nullptr, WebCfgSettingType::Acl, 0, 10, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKALT", nullptr, WebCfgSettingType::Acl, 0, 11, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKAUNLD", nullptr, WebCfgSettingType::Acl, 0, 12, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKNMENA", nullptr, WebCfgSettingType::Acl, 0, 13, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKNMST", nullptr, WebCfgSettingType::Acl, 0, 14, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKNMET", nullptr, WebCfgSettingType::Acl, 0, 15, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKNMALENA", nullptr, WebCfgSettingType::Acl, 0, 16, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKNMAULD", nullptr, WebCfgSettingType::Acl, 0, 17, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKNMLOS", nullptr, WebCfgSettingType::Acl, 0, 18, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKALENA", nullptr, WebCfgSettingType::Acl, 0, 19, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKIALENA", nullptr, WebCfgSettingType::Acl, 0, 20, WebCfgAcl::AdvancedLockConfig },
+        { "CONFLCKAUENA", nullptr, WebCfgSettingType::Acl, 0, 21, WebCfgAcl::AdvancedLockConfig },
+        { "CONFOPNNAME", nullptr, WebCfgSettingType::Acl, 0, 0, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNLAT", nullptr, WebCfgSettingType::Acl, 0, 1, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNLONG", nullptr, WebCfgSettingType::Acl, 0, 2, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNPRENA", nullptr, WebCfgSettingType::Acl, 0, 3, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNBTENA", nullptr, WebCfgSettingType::Acl, 0, 4, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNLEDENA", nullptr, WebCfgSettingType::Acl, 0, 5, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNTZOFF", nullptr, WebCfgSettingType::Acl, 0, 6, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNDSTM", nullptr, WebCfgSettingType::Acl, 0, 7, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNFOB1", nullptr, WebCfgSettingType::Acl, 0, 8, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNFOB2", nullptr, WebCfgSettingType::Acl, 0, 9, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNFOB3", nullptr, WebCfgSettingType::Acl, 0, 10, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNOPM", nullptr, WebCfgSettingType::Acl, 0, 11, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNADVM", nullptr, WebCfgSettingType::Acl, 0, 12, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNTZID", nullptr, WebCfgSettingType::Acl, 0, 13, WebCfgAcl::BasicOpenerConfig },
+        { "CONFOPNICID", nullptr, WebCfgSettingType::Acl, 0, 0, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNBUSMS", nullptr, WebCfgSettingType::Acl, 0, 1, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNSCDUR", nullptr, WebCfgSettingType::Acl, 0, 2, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNESD", nullptr, WebCfgSettingType::Acl, 0, 3, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNRESD", nullptr, WebCfgSettingType::Acl, 0, 4, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNESDUR", nullptr, WebCfgSettingType::Acl, 0, 5, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNDRTOAR", nullptr, WebCfgSettingType::Acl, 0, 6, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNRTOT", nullptr, WebCfgSettingType::Acl, 0, 7, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNDRBSUP", nullptr, WebCfgSettingType::Acl, 0, 8, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNDRBSUPDUR", nullptr, WebCfgSettingType::Acl, 0, 9, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNSRING", nullptr, WebCfgSettingType::Acl, 0, 10, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNSOPN", nullptr, WebCfgSettingType::Acl, 0, 11, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNSRTO", nullptr, WebCfgSettingType::Acl, 0, 12, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNSCM", nullptr, WebCfgSettingType::Acl, 0, 13, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNSCFRM", nullptr, WebCfgSettingType::Acl, 0, 14, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNSLVL", nullptr, WebCfgSettingType::Acl, 0, 15, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNSBPA", nullptr, WebCfgSettingType::Acl, 0, 16, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNDBPA", nullptr, WebCfgSettingType::Acl, 0, 17, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNBATT", nullptr, WebCfgSettingType::Acl, 0, 18, WebCfgAcl::AdvancedOpenerConfig },
+        { "CONFOPNABTD", nullptr, WebCfgSettingType::Acl, 0, 19, WebCfgAcl::AdvancedOpenerConfig },
+        { "REGAPP", preference_register_as_app, WebCfgSettingType::Bool, 0, 0 },
+        { "REGAPPOPN", preference_register_opener_as_app, WebCfgSettingType::Bool, 0, 0 },
+        { "LOCKENA", preference_lock_enabled, WebCfgSettingType::Bool, WEBCFG_SETTING_RESTART, 1 },
+        { "OPENA", preference_opener_enabled, WebCfgSettingType::Bool, WEBCFG_SETTING_RESTART, 0 }
+    };
+
+    constexpr size_t settingsCount = sizeof(settings) / sizeof(settings[0]);
+
+    struct SettingIndex
+    {
+        uint32_t hash;
+        const WebCfgSetting* setting;
+    };
+
+    SettingIndex settingsIndex[settingsCount];
+    SettingIndex preferencesIndex[settingsCount];
+    size_t preferencesCount = 0;
+    bool settingsIndexBuilt = false;
+
+    bool compareIndex(const SettingIndex& a, const SettingIndex& b)
+    {
+        return a.hash < b.hash;
+    }
+
+    void buildIndex()
+    {
+        for(size_t i = 0; i < settingsCount; i++)
+        {
+            settingsIndex[i] = { mqttTopicHash(settings[i].key), &settings[i] };
+            if(settings[i].preference != nullptr) preferencesIndex[preferencesCount++] = { mqttTopicHash(settings[i].preference), &settings[i] };
+        }
+        std::sort(settingsIndex, settingsIndex + settingsCount, compareIndex);
+        std::sort(preferencesIndex, preferencesIndex + preferencesCount, compareIndex);
+        settingsIndexBuilt = true;
+    }
+
+    const SettingIndex* findIndex(const SettingIndex* index, const size_t count, const char* name, const uint32_t hash)
+    {
+        const SettingIndex* entry = std::lower_bound(index, index + count, hash, [](const SettingIndex& a, const uint32_t& h) { return a.hash < h; });
+
+        for(; entry < index + count && entry->hash == hash; entry++)
+        {
+            const char* entryName = index == settingsIndex ? entry->setting->key : entry->setting->preference;
+            if(strcmp(entryName, name) == 0) return entry;
+        }
+
+        return nullptr;
+    }
+}
+
+const WebCfgSetting* findWebCfgSetting(const char* key)
+{
+    if(!settingsIndexBuilt) buildIndex();
+
+    const SettingIndex* entry = findIndex(settingsIndex, settingsCount, key, mqttTopicHash(key));
+    return entry != nullptr ? entry->setting : nullptr;
+}
+
+const WebCfgSetting* findWebCfgSettingByPreference(const char* preference)
+{
+    if(!settingsIndexBuilt) buildIndex();
+
+    const SettingIndex* entry = findIndex(preferencesIndex, preferencesCount, preference, mqttTopicHash(preference));
+    return entry != nullptr ? entry->setting : nullptr;
+}
+
+bool validWebCfgSetting(const WebCfgSetting& setting, const String& value)
+{
+    switch(setting.type)
+    {
+        case WebCfgSettingType::Int:
+            return setting.min == setting.max || (value.toInt() >= setting.min && value.toInt() <= setting.max);
+        case WebCfgSettingType::Bool:
+            return value == "0" || value == "1";
+        default:
+            return true;
+    }
+}
+
+bool applyWebCfgSetting(Preferences* preferences, const WebCfgSetting& setting, const String& value)
+{
+    if(!validWebCfgSetting(setting, value)) return false;
+
+    switch(setting.type)
+    {
+        case WebCfgSettingType::String:
+            if(preferences->getString(setting.preference, "") == value) return false;
+            preferences->putString(setting.preference, value);
+            return true;
+        case WebCfgSettingType::Int:
+            if(preferences->getInt(setting.preference, setting.value) == value.toInt()) return false;
+            preferences->putInt(setting.preference, value.toInt());
+            return true;
+        case WebCfgSettingType::Bool:
+            if(preferences->getBool(setting.preference, setting.value != 0) == (value == "1")) return false;
+            preferences->putBool(setting.preference, (value == "1"));
+            return true;
+        default:
+            return false;
+    }
+}
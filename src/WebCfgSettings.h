@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <Arduino.h>
+#include <Preferences.h>
+
+#define WEBCFG_SETTING_RESTART 0x01
+#define WEBCFG_SETTING_NETWORK_RECONFIGURE 0x02
+#define WEBCFG_SETTING_REDACTED 0x04
+
+enum class WebCfgSettingType : uint8_t
+{
+    String,
+    Int,
+    Bool,
+    Acl
+};
+
+enum class WebCfgAcl : uint8_t
+{
+    Actions,
+    BasicLockConfig,
+    AdvancedLockConfig,
+    BasicOpenerConfig,
+    AdvancedOpenerConfig,
+    None
+};
+
+// Form field of the configuration pages that maps 1:1 onto a preference, or onto one entry of an ACL bitmap
+struct WebCfgSetting
+{
+    const char* key;
+    const char* preference;
+    WebCfgSettingType type;
+    uint8_t flags;
+    int32_t value; // default of the preference, index into the bitmap for Acl
+    WebCfgAcl acl = WebCfgAcl::None;
+    int32_t min = 0; // bounds of an Int setting, values outside are rejected, unbounded if min == max
+    int32_t max = 0;
+};
+
+// Looks up a form key by its hash, nullptr if the key needs special handling
+const WebCfgSetting* findWebCfgSetting(const char* key);
+
+// Looks up the setting stored in a preference, used by the configuration import and export
+const WebCfgSetting* findWebCfgSettingByPreference(const char* preference);
+
+// Returns false if the value is outside the bounds of the setting
+bool validWebCfgSetting(const WebCfgSetting& setting, const String& value);
+
+// Writes the value if it is valid and differs from the stored one, returns true if it was changed
+bool applyWebCfgSetting(Preferences* preferences, const WebCfgSetting& setting, const String& value);
@@ -4,7 +4,7 @@
 #include "esp_crt_bundle.h"
 #include "esp_ota_ops.h"
 #include "esp_http_client.h"
-#include "esp_https_ota.h"
+#include "OtaWriter.h"
 #include <esp_task_wdt.h>
 #include "Config.h"
 
@@ -15,6 +15,8 @@
 #include "Gpio.h"
 #include "CharBuffer.h"
 #include "NukiDeviceId.h"
+#include "NukiScheduler.h"
+#include "BleArbiter.h"
 #include "WebCfgServer.h"
 #include "Logger.h"
 #include "PreferencesKeys.h"
@@ -35,12 +37,15 @@ NukiOfficial* nukiOfficial = nullptr;
 NukiOpenerWrapper* nukiOpener = nullptr;
 NukiDeviceId* deviceIdLock = nullptr;
 NukiDeviceId* deviceIdOpener = nullptr;
+NukiScheduler nukiScheduler;
+NukiScheduler nukiOpenerScheduler;
 Gpio* gpio = nullptr;
 
 bool lockEnabled = false;
 bool openerEnabled = false;
 
 TaskHandle_t nukiTaskHandle = nullptr;
+TaskHandle_t nukiOpenerTaskHandle = nullptr;
 
 int64_t restartTs = ((2^64) - (5 * 1000 * 60000)) / 1000;
 
@@ -149,6 +154,7 @@ void networkTask(void *pvParameters)
         }
 #endif
         if(connected && openerEnabled) networkOpener->update();
+        if(webCfgServer != nullptr) webCfgServer->update();
 #endif
 
         if((esp_timer_get_time() / 1000) - networkLoopTs > 120000)
@@ -158,7 +164,11 @@ void networkTask(void *pvParameters)
         }
 
         esp_task_wdt_reset();
+#ifndef NUKI_HUB_UPDATER
+        network->waitForNetworkEvent(100);
+#else
         delay(100);
+#endif
     }
 }
 
@@ -170,14 +180,14 @@ void nukiTask(void *pvParameters)
 
     while(true)
     {
+        nukiScheduler.waitForWork();
         bleScanner->update();
-        delay(20);
 
         bool needsPairing = (lockEnabled && !nuki->isPaired()) || (openerEnabled && !nukiOpener->isPaired());
 
         if (needsPairing)
         {
-            delay(5000);
+            if(lockEnabled && !nuki->isPaired()) delay(5000);
         }
         else if (!whiteListed)
         {
@@ -196,14 +206,16 @@ void nukiTask(void *pvParameters)
         {
             nuki->update();
         }
-        if(openerEnabled)
-        {
-            nukiOpener->update();
-        }
 
         if((esp_timer_get_time() / 1000) - nukiLoopTs > 120000)
         {
-            Log->println("nukiTask is running");
+            Log->print("nukiTask is running, wakeups: ");
+            Log->print(nukiScheduler.wakeups());
+            Log->print(" (timed: ");
+            Log->print(nukiScheduler.timedWakeups());
+            Log->print("), last wake latency: ");
+            Log->print((long)nukiScheduler.lastWakeLatency());
+            Log->println("us");
             nukiLoopTs = esp_timer_get_time() / 1000;
         }
 
@@ -211,6 +223,24 @@ void nukiTask(void *pvParameters)
     }
 }
 
+// The opener gets its own worker so slow lock transfers don't delay it, BleArbiter serializes the BLE transactions
+void nukiOpenerTask(void *pvParameters)
+{
+    while(true)
+    {
+        nukiOpenerScheduler.waitForWork();
+
+        if(!nukiOpener->isPaired())
+        {
+            delay(5000);
+        }
+
+        nukiOpener->update();
+
+        esp_task_wdt_reset();
+    }
+}
+
 void bootloopDetection()
 {
     uint64_t cmp = IS_VALID_DETECT;
@@ -295,6 +325,75 @@ esp_err_t _http_event_handler(esp_http_client_event_t *evt)
     return ESP_OK;
 }
 
+// Downloads the image into the writer, continuing at writer.bytesReceived() when a previous attempt was interrupted.
+// Returns true when the complete image has been received.
+bool downloadOta(OtaWriter& writer, const String& url)
+{
+    esp_http_client_config_t config = {
+        .url = url.c_str(),
+        .event_handler = _http_event_handler,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+        .keep_alive_enable = true,
+    };
+
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    if(client == nullptr) return false;
+
+    int status = 0;
+
+    for(int redirects = 0; redirects <= OTA_MAX_REDIRECTS; redirects++)
+    {
+        if(writer.bytesReceived() > 0)
+        {
+            char range[24];
+            snprintf(range, sizeof(range), "bytes=%u-", (unsigned int)writer.bytesReceived());
+            esp_http_client_set_header(client, "Range", range);
+        }
+
+        if(esp_http_client_open(client, 0) != ESP_OK)
+        {
+            esp_http_client_cleanup(client);
+            return false;
+        }
+
+        esp_http_client_fetch_headers(client);
+        status = esp_http_client_get_status_code(client);
+        if(status < 300 || status >= 400) break;
+
+        esp_http_client_flush_response(client, NULL);
+        esp_http_client_set_redirection(client);
+        esp_http_client_close(client);
+    }
+
+    if(!writer.resume(status))
+    {
+        Log->print(F("Unexpected HTTP status for OTA download: "));
+        Log->println(status);
+        esp_http_client_cleanup(client);
+        return false;
+    }
+
+    bool complete = false;
+    uint8_t* buffer = (uint8_t*)malloc(OTA_DOWNLOAD_BUFFER_SIZE);
+
+    while(buffer != nullptr)
+    {
+        int len = esp_http_client_read(client, (char*)buffer, OTA_DOWNLOAD_BUFFER_SIZE);
+        if(len < 0) break;
+        if(len == 0)
+        {
+            complete = esp_http_client_is_complete_data_received(client);
+            break;
+        }
+        if(!writer.write(buffer, len)) break;
+        esp_task_wdt_reset();
+    }
+
+    free(buffer);
+    esp_http_client_cleanup(client);
+    return complete;
+}
+
 void otaTask(void *pvParameter)
 {
     uint8_t partitionType = checkPartition();
@@ -311,43 +410,38 @@ void otaTask(void *pvParameter)
         preferences->putString(preference_ota_main_url, "");
     }
     Log->println("Starting OTA task");
-    esp_http_client_config_t config = {
-        .url = updateUrl.c_str(),
-        .event_handler = _http_event_handler,
-        .crt_bundle_attach = esp_crt_bundle_attach,
-        .keep_alive_enable = true,
-    };
-
-    esp_https_ota_config_t ota_config = {
-        .http_config = &config,
-    };
     Log->print(F("Attempting to download update from "));
-    Log->println(config.url);
+    Log->println(updateUrl);
 
     int retryMax = 3;
     int retryCount = 0;
+    OtaWriter writer;
 
-    while (retryCount <= retryMax)
+    if(writer.begin())
     {
-        esp_err_t ret = esp_https_ota(&ota_config);
-        if (ret == ESP_OK) {
-            Log->println("OTA Succeeded, Rebooting...");
-            esp_ota_set_boot_partition(esp_ota_get_next_update_partition(NULL));
-            restartEsp(RestartReason::OTACompleted);
-            break;
-        } else {
-            Log->println("Firmware upgrade failed, retrying in 5 seconds");
+        while (retryCount <= retryMax)
+        {
+            if (downloadOta(writer, updateUrl) && writer.end()) {
+                Log->println("OTA Succeeded, Rebooting...");
+                esp_ota_set_boot_partition(esp_ota_get_next_update_partition(NULL));
+                restartEsp(RestartReason::OTACompleted);
+                break;
+            }
+
+            // The writer is closed when the image itself was rejected, downloading it again won't help
+            if(!writer.active()) break;
+
+            Log->print(F("Firmware download interrupted after "));
+            Log->print(writer.bytesReceived());
+            Log->println(F(" bytes, resuming in 5 seconds"));
             retryCount++;
             esp_task_wdt_reset();
             delay(5000);
-            continue;
-        }
-        while (1) {
-            vTaskDelay(1000 / portTICK_PERIOD_MS);
         }
     }
 
     Log->println("Firmware upgrade failed, restarting");
+    writer.abort();
     esp_ota_set_boot_partition(esp_ota_get_next_update_partition(NULL));
     restartEsp(RestartReason::OTAAborted);
 }
@@ -374,6 +468,13 @@ void setupTasks(bool ota)
         #ifndef NUKI_HUB_UPDATER
         xTaskCreatePinnedToCore(nukiTask, "nuki", preferences->getInt(preference_task_size_nuki, NUKI_TASK_SIZE), NULL, 2, &nukiTaskHandle, 0);
         esp_task_wdt_add(nukiTaskHandle);
+        nukiScheduler.initialize(nukiTaskHandle);
+        if(openerEnabled)
+        {
+            xTaskCreatePinnedToCore(nukiOpenerTask, "nukiOpener", preferences->getInt(preference_task_size_nuki, NUKI_TASK_SIZE), NULL, 2, &nukiOpenerTaskHandle, 0);
+            esp_task_wdt_add(nukiOpenerTaskHandle);
+            nukiOpenerScheduler.initialize(nukiOpenerTaskHandle);
+        }
         #endif
     }
 }
@@ -464,6 +565,8 @@ void setup()
     lockEnabled = preferences->getBool(preference_lock_enabled);
     openerEnabled = preferences->getBool(preference_opener_enabled);
 
+    BleArbiter::initialize();
+
     const String mqttLockPath = preferences->getString(preference_mqtt_lock_path);
 
     nukiOfficial = new NukiOfficial(preferences);
@@ -471,26 +574,27 @@ void setup()
     network = new NukiNetwork(preferences, gpio, mqttLockPath, CharBuffer::get(), buffer_size);
     network->initialize();
 
-    networkLock = new NukiNetworkLock(network, nukiOfficial, preferences, CharBuffer::get(), buffer_size);
+    // nukiTask and nukiOpenerTask publish concurrently, the shared buffer is only used by the HA discovery path of NukiNetwork
+    networkLock = new NukiNetworkLock(network, nukiOfficial, preferences, new char[buffer_size], buffer_size);
     networkLock->initialize();
 
     if(openerEnabled)
     {
-        networkOpener = new NukiNetworkOpener(network, preferences, CharBuffer::get(), buffer_size);
+        networkOpener = new NukiNetworkOpener(network, preferences, new char[buffer_size], buffer_size);
         networkOpener->initialize();
     }
 
     Log->println(lockEnabled ? F("Nuki Lock enabled") : F("Nuki Lock disabled"));
     if(lockEnabled)
     {
-        nuki = new NukiWrapper("NukiHub", deviceIdLock, bleScanner, networkLock, nukiOfficial, gpio, preferences);
+        nuki = new NukiWrapper("NukiHub", deviceIdLock, bleScanner, networkLock, nukiOfficial, gpio, preferences, &nukiScheduler);
         nuki->initialize(firstStart);
     }
 
     Log->println(openerEnabled ? F("Nuki Opener enabled") : F("Nuki Opener disabled"));
     if(openerEnabled)
     {
-        nukiOpener = new NukiOpenerWrapper("NukiHub", deviceIdOpener, bleScanner, networkOpener, gpio, preferences);
+        nukiOpener = new NukiOpenerWrapper("NukiHub", deviceIdOpener, bleScanner, networkOpener, gpio, preferences, &nukiOpenerScheduler);
         nukiOpener->initialize();
     }
 
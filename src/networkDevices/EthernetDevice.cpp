@@ -176,6 +176,7 @@ void EthernetDevice::onNetworkEvent(arduino_event_id_t event, arduino_event_info
             break;
         case ARDUINO_EVENT_ETH_CONNECTED:
             Log->println("ETH Connected");
+            markReconnectPhase(ReconnectPhase::Association);
             if(!localIP().equals("0.0.0.0"))
             {
                 _connected = true;
@@ -198,6 +199,8 @@ void EthernetDevice::onNetworkEvent(arduino_event_id_t event, arduino_event_info
             {
                 _preferences->putBool(preference_ntw_reconfigure, false);
             }
+            markReconnectPhase(ReconnectPhase::Ip);
+            notifyConnected();
             break;
         case ARDUINO_EVENT_ETH_LOST_IP:
             Log->println("ETH Lost IP");
@@ -251,6 +254,7 @@ ReconnectStatus EthernetDevice::reconnect(bool force)
 
 void EthernetDevice::onDisconnected()
 {
+    markDisconnected();
     if(_preferences->getBool(preference_restart_on_disconnect, false) && ((esp_timer_get_time() / 1000) > 60000)) restartEsp(RestartReason::RestartOnDisconnectWatchdog);
     reconnect();
 }
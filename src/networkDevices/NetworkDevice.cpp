@@ -1,4 +1,5 @@
 #include <Arduino.h>
+#include "esp_timer.h"
 #include "NetworkDevice.h"
 #include "../Logger.h"
 
@@ -8,6 +9,71 @@ void NetworkDevice::printError()
     Log->println(ESP.getFreeHeap());
 }
 
+void NetworkDevice::setConnectedCallback(std::function<void()> connectedCallback)
+{
+    _connectedCallback = connectedCallback;
+}
+
+void NetworkDevice::notifyConnected()
+{
+    if(_connectedCallback != nullptr) _connectedCallback();
+}
+
+void NetworkDevice::markDisconnected()
+{
+    // A reconnect in progress keeps timing from the first drop
+    if(_reconnectStartTs != -1) return;
+
+    _reconnectStartTs = esp_timer_get_time() / 1000;
+    for(size_t i = 0; i < (size_t)ReconnectPhase::Count; i++) _reconnectPhases[i] = -1;
+}
+
+void NetworkDevice::markReconnectPhase(const ReconnectPhase& phase, int64_t ts)
+{
+    if(_reconnectStartTs == -1 || phase >= ReconnectPhase::Count) return;
+
+    if(ts == -1) ts = esp_timer_get_time() / 1000;
+    if(ts < _reconnectStartTs) return;
+
+    _reconnectPhases[(size_t)phase] = ts - _reconnectStartTs;
+
+    if(phase != ReconnectPhase::Connack) return;
+
+    Log->print(F("Reconnect phases (ms after drop):"));
+    for(size_t i = 0; i < (size_t)ReconnectPhase::Count; i++)
+    {
+        if(_reconnectPhases[i] == -1) continue;
+        Log->print(F(" "));
+        Log->print(reconnectPhaseName((ReconnectPhase)i));
+        Log->print(F(" "));
+        Log->print((uint32_t)_reconnectPhases[i]);
+    }
+    Log->println();
+    _reconnectStartTs = -1;
+}
+
+const int64_t NetworkDevice::reconnectPhaseDuration(const ReconnectPhase& phase) const
+{
+    return phase < ReconnectPhase::Count ? _reconnectPhases[(size_t)phase] : -1;
+}
+
+const char* NetworkDevice::reconnectPhaseName(const ReconnectPhase& phase)
+{
+    switch(phase)
+    {
+        case ReconnectPhase::Association:
+            return "association";
+        case ReconnectPhase::Ip:
+            return "IP";
+        case ReconnectPhase::Tcp:
+            return "TCP";
+        case ReconnectPhase::Connack:
+            return "CONNACK";
+        default:
+            return "unknown";
+    }
+}
+
 #ifndef NUKI_HUB_UPDATER
 void NetworkDevice::update()
 {
@@ -68,6 +134,17 @@ bool NetworkDevice::mqttConnected() const
     return getMqttClient()->connected();
 }
 
+int64_t NetworkDevice::mqttTcpConnectedTs() const
+{
+    uint32_t ts = getMqttClient()->tcpConnectedTime();
+    return ts == 0 ? -1 : ts;
+}
+
+size_t NetworkDevice::mqttQueueSize()
+{
+    return getMqttClient()->queueSize();
+}
+
 void NetworkDevice::mqttSetServer(const char *host, uint16_t port)
 {
     if (_useEncryption)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #ifndef NUKI_HUB_UPDATER
 #include "espMqttClient.h"
 #include "MqttClientSetup.h"
@@ -13,6 +14,16 @@ enum class ReconnectStatus
     CriticalFailure = 2
 };
 
+// Steps of getting back online after the link or the MQTT connection dropped
+enum class ReconnectPhase : uint8_t
+{
+    Association,
+    Ip,
+    Tcp,
+    Connack,
+    Count
+};
+
 class NetworkDevice
 {
 public:
@@ -37,6 +48,14 @@ public:
     virtual String localIP() = 0;
     virtual String BSSIDstr() = 0;
 
+    // Invoked from the network event task when an IP address has been assigned
+    void setConnectedCallback(std::function<void()> connectedCallback);
+
+    void markDisconnected();
+    void markReconnectPhase(const ReconnectPhase& phase, int64_t ts = -1); // ts in ms, esp_timer based, now if -1
+    const int64_t reconnectPhaseDuration(const ReconnectPhase& phase) const; // ms after the drop of the last reconnect, -1 if not reached
+    static const char* reconnectPhaseName(const ReconnectPhase& phase);
+
     #ifndef NUKI_HUB_UPDATER
     virtual void mqttSetClientId(const char* clientId);
     virtual void mqttSetCleanSession(bool cleanSession);
@@ -44,6 +63,8 @@ public:
     virtual uint16_t mqttPublish(const char* topic, uint8_t qos, bool retain, const char* payload);
     virtual uint16_t mqttPublish(const char* topic, uint8_t qos, bool retain, const uint8_t* payload, size_t length);
     virtual bool mqttConnected() const;
+    virtual int64_t mqttTcpConnectedTs() const;
+    virtual size_t mqttQueueSize();
     virtual void mqttSetServer(const char* host, uint16_t port);
     virtual bool mqttConnect();
     virtual bool mqttDisconnect(bool force);
@@ -58,6 +79,12 @@ public:
     #endif
 
 protected:
+    void notifyConnected();
+
+    std::function<void()> _connectedCallback = nullptr;
+    int64_t _reconnectStartTs = -1;
+    int64_t _reconnectPhases[(size_t)ReconnectPhase::Count] = {-1, -1, -1, -1};
+
     #ifndef NUKI_HUB_UPDATER
     espMqttClient *_mqttClient = nullptr;
     espMqttClientSecure *_mqttClientSecure = nullptr;
@@ -10,6 +10,16 @@
 
 RTC_NOINIT_ATTR char WiFiDevice_reconfdetect[17];
 
+// AP of the last connection, lets a reconnect join it directly instead of scanning all channels
+struct WifiFastReconnectCache
+{
+    uint32_t detect;
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+
+RTC_NOINIT_ATTR WifiFastReconnectCache WifiDevice_fastReconnect;
+
 WifiDevice::WifiDevice(const String& hostname, Preferences* preferences, const IPConfiguration* ipConfiguration)
 : NetworkDevice(hostname, ipConfiguration),
   _preferences(preferences),
@@ -116,6 +126,7 @@ void WifiDevice::initialize()
     else {
         Log->print(F("Wi-Fi connected: "));
         Log->println(WiFi.localIP().toString());
+        storeFastReconnect();
 
         if(connectedFromPortal)
         {
@@ -131,6 +142,10 @@ void WifiDevice::initialize()
         {
             onDisconnected();
         }
+        else if(event == ARDUINO_EVENT_WIFI_STA_CONNECTED)
+        {
+            markReconnectPhase(ReconnectPhase::Association);
+        }
         else if(event == ARDUINO_EVENT_WIFI_STA_GOT_IP)
         {
             onConnected();
@@ -159,6 +174,21 @@ ReconnectStatus WifiDevice::reconnect(bool force)
 {
     _wm.setFindBestRSSI(_preferences->getBool(preference_find_best_rssi));
 
+    if(_fastReconnectPending)
+    {
+        // Started by the disconnect event, give it the chance to finish before falling back to a scan
+        while(!isConnected() && _fastReconnectPending && (esp_timer_get_time() / 1000) < _fastReconnectDeadline)
+        {
+            delay(20);
+        }
+
+        if(isConnected()) return ReconnectStatus::Success;
+
+        Log->println(F("Wi-Fi fast reconnect timed out"));
+        _fastReconnectPending = false;
+        WifiDevice_fastReconnect.detect = 0;
+    }
+
     if((!isConnected() || force) && !_isReconnecting)
     {
         _isReconnecting = true;
@@ -183,17 +213,67 @@ ReconnectStatus WifiDevice::reconnect(bool force)
 void WifiDevice::onConnected()
 {
     _isReconnecting = false;
+    _fastReconnectPending = false;
+    storeFastReconnect();
+    markReconnectPhase(ReconnectPhase::Ip);
     _wm.setEnableConfigPortal(_startAp || !_preferences->getBool(preference_network_wifi_fallback_disabled, false));
+    notifyConnected();
 }
 
 void WifiDevice::onDisconnected()
 {
     _disconnectTs = (esp_timer_get_time() / 1000);
+    markDisconnected();
     if(_preferences->getBool(preference_restart_on_disconnect, false) && ((esp_timer_get_time() / 1000) > 60000)) restartEsp(RestartReason::RestartOnDisconnectWatchdog);
     _wm.setEnableConfigPortal(false);
+
+    if(_isReconnecting) return;
+
+    if(_fastReconnectPending)
+    {
+        // The direct connection to the cached AP failed, don't try it again until the next successful connection
+        Log->println(F("Wi-Fi fast reconnect failed"));
+        _fastReconnectPending = false;
+        WifiDevice_fastReconnect.detect = 0;
+    }
+    else if(startFastReconnect())
+    {
+        return;
+    }
+
     reconnect();
 }
 
+bool WifiDevice::startFastReconnect()
+{
+    if(WifiDevice_fastReconnect.detect != WIFI_FAST_RECONNECT_DETECT) return false;
+
+    String ssid = _wm.getWiFiSSID(true);
+    if(ssid.length() == 0) return false;
+    String pass = _wm.getWiFiPass(true);
+
+    Log->print(F("Wi-Fi fast reconnect to "));
+    Log->print(ssid);
+    Log->print(F(", channel "));
+    Log->println(WifiDevice_fastReconnect.channel);
+
+    // Doesn't block, the result arrives as connected or disconnected event
+    _fastReconnectPending = true;
+    _fastReconnectDeadline = (esp_timer_get_time() / 1000) + WIFI_FAST_RECONNECT_TIMEOUT;
+    WiFi.begin(ssid.c_str(), pass.c_str(), WifiDevice_fastReconnect.channel, WifiDevice_fastReconnect.bssid);
+    return true;
+}
+
+void WifiDevice::storeFastReconnect()
+{
+    uint8_t* bssid = WiFi.BSSID();
+    if(bssid == nullptr) return;
+
+    memcpy(WifiDevice_fastReconnect.bssid, bssid, sizeof(WifiDevice_fastReconnect.bssid));
+    WifiDevice_fastReconnect.channel = WiFi.channel();
+    WifiDevice_fastReconnect.detect = WIFI_FAST_RECONNECT_DETECT;
+}
+
 int8_t WifiDevice::signalStrength()
 {
     return WiFi.RSSI();
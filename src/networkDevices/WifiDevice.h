@@ -34,6 +34,8 @@ private:
 
     void onDisconnected();
     void onConnected();
+    bool startFastReconnect();
+    void storeFastReconnect();
 
     WiFiManager _wm;
     Preferences* _preferences = nullptr;
@@ -42,6 +44,8 @@ private:
     bool _isReconnecting = false;
     char* _path;
     int64_t _disconnectTs = 0;
+    bool _fastReconnectPending = false;
+    int64_t _fastReconnectDeadline = 0;
 
     #ifndef NUKI_HUB_UPDATER
     char _ca[TLS_CA_MAX_SIZE] = {0};
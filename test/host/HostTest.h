@@ -0,0 +1,19 @@
+#pragma once
+
+// Minimal checks for the host tests, every failed check is reported and makes the test exit non-zero
+
+#include <cstdio>
+
+inline int hostTestFailures = 0;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if(!(condition)) \
+        { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++hostTestFailures; \
+        } \
+    } while(0)
+
+#define HOST_TEST_RESULT() (hostTestFailures == 0 ? 0 : 1)
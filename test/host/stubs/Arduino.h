@@ -0,0 +1,175 @@
+#pragma once
+
+// Minimal stand-in for the parts of the Arduino core used by the host build
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include "esp_attr.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+class String : public std::string
+{
+public:
+    String() = default;
+    String(const char* str) : std::string(str != nullptr ? str : "") {}
+    String(const std::string& str) : std::string(str) {}
+    explicit String(const char c) : std::string(1, c) {}
+    explicit String(const int value, const int base = 10) : String((long long)value, base) {}
+    explicit String(const unsigned int value, const int base = 10) : String((unsigned long long)value, base) {}
+    explicit String(const long value, const int base = 10) : String((long long)value, base) {}
+    explicit String(const unsigned long value, const int base = 10) : String((unsigned long long)value, base) {}
+    explicit String(const long long value, const int base = 10) : std::string(base == 10 ? std::to_string(value) : toBase((unsigned long long)value, base)) {}
+    explicit String(const unsigned long long value, const int base = 10) : std::string(toBase(value, base)) {}
+    explicit String(const double value, const unsigned int decimals = 2)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+        assign(buffer);
+    }
+
+    void concat(const char c) { push_back(c); }
+    void concat(const char* str) { append(str); }
+    void concat(const String& str) { append(str); }
+    void concat(const int value) { append(std::to_string(value)); }
+    void concat(const unsigned int value) { append(std::to_string(value)); }
+    void concat(const long value) { append(std::to_string(value)); }
+    void concat(const unsigned long value) { append(std::to_string(value)); }
+    void concat(const long long value) { append(std::to_string(value)); }
+    void concat(const unsigned long long value) { append(std::to_string(value)); }
+    void concat(const double value) { append(String(value)); }
+
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return atof(c_str()); }
+    double toDouble() const { return atof(c_str()); }
+    char charAt(const unsigned int index) const { return index < length() ? at(index) : 0; }
+    bool equals(const String& other) const { return *this == other; }
+    bool equals(const char* other) const { return compare(other) == 0; }
+    bool startsWith(const String& prefix) const { return rfind(prefix, 0) == 0; }
+    bool endsWith(const String& suffix) const { return length() >= suffix.length() && compare(length() - suffix.length(), suffix.length(), suffix) == 0; }
+    int indexOf(const char c, const unsigned int from = 0) const { const size_t pos = find(c, from); return pos == npos ? -1 : (int)pos; }
+    int indexOf(const String& str, const unsigned int from = 0) const { const size_t pos = find(str, from); return pos == npos ? -1 : (int)pos; }
+    int lastIndexOf(const char c) const { const size_t pos = rfind(c); return pos == npos ? -1 : (int)pos; }
+    String substring(const unsigned int from) const { return from < length() ? String(substr(from)) : String(); }
+    String substring(const unsigned int from, const unsigned int to) const { return from < length() && to > from ? String(substr(from, to - from)) : String(); }
+    void toLowerCase() { std::transform(std::string::begin(), std::string::end(), std::string::begin(), ::tolower); }
+    void toUpperCase() { std::transform(std::string::begin(), std::string::end(), std::string::begin(), ::toupper); }
+    char* begin() { return &(*this)[0]; }
+    char* end() { return begin() + length(); }
+    const char* begin() const { return c_str(); }
+    const char* end() const { return c_str() + length(); }
+    void trim()
+    {
+        const size_t first = find_first_not_of(" \t\r\n");
+        if(first == npos) { clear(); return; }
+        *this = String(substr(first, find_last_not_of(" \t\r\n") - first + 1));
+    }
+    void replace(const String& from, const String& to)
+    {
+        if(from.empty()) return;
+        for(size_t pos = find(from); pos != npos; pos = find(from, pos + to.length())) std::string::replace(pos, from.length(), to);
+    }
+    void toCharArray(char* buffer, const unsigned int size) const
+    {
+        if(size == 0) return;
+        const size_t len = std::min((size_t)size - 1, length());
+        memcpy(buffer, data(), len);
+        buffer[len] = 0;
+    }
+
+    bool operator==(const char* other) const { return compare(other) == 0; }
+    bool operator!=(const char* other) const { return compare(other) != 0; }
+
+private:
+    static std::string toBase(unsigned long long value, const int base)
+    {
+        if(base == 10) return std::to_string(value);
+        std::string out;
+        do
+        {
+            out.insert(out.begin(), "0123456789abcdefghijklmnopqrstuvwxyz"[value % base]);
+            value /= base;
+        } while(value > 0);
+        return out;
+    }
+};
+
+inline String operator+(const String& a, const String& b) { return String(static_cast<const std::string&>(a) + static_cast<const std::string&>(b)); }
+inline String operator+(const String& a, const char* b) { return String(static_cast<const std::string&>(a) + b); }
+inline String operator+(const char* a, const String& b) { return String(std::string(a) + static_cast<const std::string&>(b)); }
+inline String operator+(const String& a, const char b) { return String(static_cast<const std::string&>(a) + b); }
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define F(str) (str)
+#define PROGMEM
+
+using std::min;
+using std::max;
+
+#ifndef millis // espMqttClient defines it as a macro on Linux
+inline unsigned long millis() { return (unsigned long)(esp_timer_get_time() / 1000); }
+#endif
+inline unsigned long micros() { return (unsigned long)esp_timer_get_time(); }
+inline void delay(const uint32_t ms) { vTaskDelay(ms); }
+inline long random(const long max) { return max > 0 ? rand() % max : 0; }
+inline long random(const long min, const long max) { return max > min ? min + rand() % (max - min) : min; }
+
+// stdlib_noniso of the Arduino core
+inline char* itoa(const int value, char* str, const int base) { snprintf(str, 34, base == 16 ? "%x" : "%d", value); return str; }
+inline char* ltoa(const long value, char* str, const int base) { snprintf(str, 34, base == 16 ? "%lx" : "%ld", value); return str; }
+inline char* utoa(const unsigned int value, char* str, const int base) { snprintf(str, 34, base == 16 ? "%x" : "%u", value); return str; }
+inline char* ultoa(const unsigned long value, char* str, const int base) { snprintf(str, 34, base == 16 ? "%lx" : "%lu", value); return str; }
+inline char* dtostrf(const double value, const signed char width, const unsigned char precision, char* str)
+{
+    sprintf(str, "%*.*f", width, precision, value);
+    return str;
+}
+
+// GPIO, the levels and interrupt handlers live in HostArduino.cpp so tests can drive the inputs
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define ONLOW 0x04
+#define ONHIGH 0x05
+#define HOST_GPIO_PIN_COUNT 64
+
+void pinMode(const uint8_t pin, const uint8_t mode);
+void digitalWrite(const uint8_t pin, const uint8_t value);
+int digitalRead(const uint8_t pin);
+void attachInterrupt(const uint8_t pin, void (*handler)(void), const int mode);
+void detachInterrupt(const uint8_t pin);
+
+void hostSetGpioInput(const uint8_t pin, const uint8_t value); // sets the level and runs the attached handler on a matching edge
+uint8_t hostGpioMode(const uint8_t pin);
+
+class EspClass
+{
+public:
+    uint32_t getFreeHeap() { return 200000; }
+    uint32_t getMinFreeHeap() { return 150000; }
+    uint32_t getMaxAllocHeap() { return 100000; }
+    uint32_t getHeapSize() { return 300000; }
+    uint32_t getPsramSize() { return 0; }
+    uint32_t getFreePsram() { return 0; }
+    uint64_t getEfuseMac() { return 0x123456789abcULL; }
+    void restart(); // counted in hostRestartCount
+};
+
+extern EspClass ESP;
+extern int hostRestartCount;
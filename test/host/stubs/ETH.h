@@ -0,0 +1,20 @@
+#pragma once
+
+#include "NetworkClient.h"
+#include "sdkconfig.h"
+
+typedef enum
+{
+    ETH_PHY_LAN8720,
+    ETH_PHY_TLK110,
+    ETH_PHY_RTL8201,
+    ETH_PHY_DP83848,
+    ETH_PHY_KSZ8041,
+    ETH_PHY_KSZ8081,
+    ETH_PHY_W5500,
+    ETH_PHY_DM9051,
+    ETH_PHY_MAX
+} eth_phy_type_t;
+
+typedef int arduino_event_id_t;
+typedef struct {} arduino_event_info_t;
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "NetworkClient.h"
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_MOVED_PERMANENTLY 301
+
+enum followRedirects_t
+{
+    HTTPC_DISABLE_FOLLOW_REDIRECTS,
+    HTTPC_STRICT_FOLLOW_REDIRECTS,
+    HTTPC_FORCE_FOLLOW_REDIRECTS
+};
+
+inline int hostHttpRequests = 0; // begin() calls, so tests can tell a request was attempted
+
+// Every request fails, there is no network on the host
+class HTTPClient
+{
+public:
+    bool begin(NetworkClient&, const char*) { ++hostHttpRequests; return false; }
+    bool begin(NetworkClient&, const String&) { ++hostHttpRequests; return false; }
+    void end() {}
+    int GET() { return -1; }
+    void setFollowRedirects(const followRedirects_t) {}
+    void useHTTP10(const bool) {}
+    Stream& getStream() { return _stream; }
+
+private:
+    Stream _stream;
+};
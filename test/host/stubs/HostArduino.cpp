@@ -0,0 +1,90 @@
+#include <Arduino.h>
+#include "RestartReason.h"
+
+EspClass ESP;
+
+// RTC memory and globals of main.cpp
+int restartReason = 0;
+uint64_t restartReasonValidDetect = 0;
+bool rebuildGpioRequested = false;
+RestartReason currentRestartReason = RestartReason::NotApplicable;
+bool restartReason_isValid = false;
+bool forceEnableWebServer = false;
+
+// Certificate bundle embedded by the firmware build
+extern const uint8_t hostCertBundleStart[] asm("_binary_x509_crt_bundle_start");
+extern const uint8_t hostCertBundleEnd[] asm("_binary_x509_crt_bundle_end");
+const uint8_t hostCertBundleStart[1] = { 0 };
+const uint8_t hostCertBundleEnd[1] = { 0 };
+
+int hostRestartCount = 0;
+
+void EspClass::restart()
+{
+    // A test can't survive a restart, count it instead
+    ++hostRestartCount;
+}
+
+namespace
+{
+    struct Pin
+    {
+        uint8_t mode = 0;
+        uint8_t level = LOW;
+        void (*handler)(void) = nullptr;
+        int interruptMode = 0;
+    };
+
+    Pin pins[HOST_GPIO_PIN_COUNT];
+}
+
+void pinMode(const uint8_t pin, const uint8_t mode)
+{
+    if(pin < HOST_GPIO_PIN_COUNT) pins[pin].mode = mode;
+}
+
+void digitalWrite(const uint8_t pin, const uint8_t value)
+{
+    if(pin < HOST_GPIO_PIN_COUNT) pins[pin].level = value;
+}
+
+int digitalRead(const uint8_t pin)
+{
+    return pin < HOST_GPIO_PIN_COUNT ? pins[pin].level : LOW;
+}
+
+void attachInterrupt(const uint8_t pin, void (*handler)(void), const int mode)
+{
+    if(pin >= HOST_GPIO_PIN_COUNT) return;
+    pins[pin].handler = handler;
+    pins[pin].interruptMode = mode;
+}
+
+void detachInterrupt(const uint8_t pin)
+{
+    if(pin < HOST_GPIO_PIN_COUNT) pins[pin].handler = nullptr;
+}
+
+void hostSetGpioInput(const uint8_t pin, const uint8_t value)
+{
+    if(pin >= HOST_GPIO_PIN_COUNT) return;
+
+    Pin& state = pins[pin];
+    const bool rising = state.level == LOW && value == HIGH;
+    const bool falling = state.level == HIGH && value == LOW;
+    state.level = value;
+
+    if(state.handler == nullptr) return;
+    if((rising && (state.interruptMode == RISING || state.interruptMode == CHANGE)) ||
+       (falling && (state.interruptMode == FALLING || state.interruptMode == CHANGE)))
+    {
+        hostInIsrContext = true;
+        state.handler();
+        hostInIsrContext = false;
+    }
+}
+
+uint8_t hostGpioMode(const uint8_t pin)
+{
+    return pin < HOST_GPIO_PIN_COUNT ? pins[pin].mode : 0;
+}
@@ -0,0 +1,4 @@
+#include <Print.h>
+
+Print hostLog;
+Print* Log = &hostLog;
@@ -0,0 +1,235 @@
+#include "HostNetworkDevice.h"
+#include "util/NetworkDeviceInstantiator.h"
+#include "esp_timer.h"
+
+HostNetworkDevice* hostNetworkDevice = nullptr;
+
+// The host network is always configured by DHCP, the Linux IPAddress of espMqttClient can't parse addresses
+IPConfiguration::IPConfiguration(Preferences* preferences)
+: _preferences(preferences)
+{
+}
+
+bool IPConfiguration::dhcpEnabled() const
+{
+    return true;
+}
+
+const IPAddress IPConfiguration::ipAddress() const
+{
+    return _ipAddress;
+}
+
+const IPAddress IPConfiguration::subnet() const
+{
+    return _subnet;
+}
+
+const IPAddress IPConfiguration::defaultGateway() const
+{
+    return _gateway;
+}
+
+const IPAddress IPConfiguration::dnsServer() const
+{
+    return _dnsServer;
+}
+
+NetworkDevice* NetworkDeviceInstantiator::Create(NetworkDeviceType, String hostname, Preferences*, IPConfiguration* ipConfiguration)
+{
+    hostNetworkDevice = new HostNetworkDevice(hostname, ipConfiguration);
+    return hostNetworkDevice;
+}
+
+HostNetworkDevice::HostNetworkDevice(const String& hostname, const IPConfiguration* ipConfiguration)
+: NetworkDevice(hostname, ipConfiguration)
+{
+}
+
+const String HostNetworkDevice::deviceName() const
+{
+    return "Host";
+}
+
+void HostNetworkDevice::initialize()
+{
+    notifyConnected();
+}
+
+ReconnectStatus HostNetworkDevice::reconnect(bool)
+{
+    return _linkUp ? ReconnectStatus::Success : ReconnectStatus::Failure;
+}
+
+void HostNetworkDevice::update()
+{
+    espMqttClientTypes::OnConnectCallback onConnect;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        if(_connectRequested && _linkUp)
+        {
+            _connectRequested = false;
+            _connected = true;
+            _connectedTs = esp_timer_get_time() / 1000;
+            onConnect = _onConnect;
+        }
+    }
+    if(onConnect) onConnect(false);
+
+    if(!_paused) transmit(transmitPerUpdate);
+}
+
+bool HostNetworkDevice::isConnected()
+{
+    return _linkUp;
+}
+
+void HostNetworkDevice::mqttSetClientId(const char*)
+{
+}
+
+uint16_t HostNetworkDevice::mqttPublish(const char* topic, uint8_t qos, bool retain, const char* payload)
+{
+    return mqttPublish(topic, qos, retain, (const uint8_t*)payload, strlen(payload));
+}
+
+uint16_t HostNetworkDevice::mqttPublish(const char* topic, uint8_t, bool retain, const uint8_t* payload, size_t length)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if(!_connected) return 0;
+
+    _outgoing.push_back({ topic, std::string((const char*)payload, length), retain });
+    if(++_nextPacketId == 0) _nextPacketId = 1;
+    return _nextPacketId;
+}
+
+bool HostNetworkDevice::mqttConnected() const
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return _connected;
+}
+
+size_t HostNetworkDevice::mqttQueueSize()
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return _outgoing.size();
+}
+
+bool HostNetworkDevice::mqttConnect()
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _connectRequested = true;
+    return true;
+}
+
+bool HostNetworkDevice::mqttDisconnect(bool)
+{
+    dropConnection();
+    return true;
+}
+
+void HostNetworkDevice::mqttOnMessage(espMqttClientTypes::OnMessageCallback callback)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _onMessage = callback;
+}
+
+void HostNetworkDevice::mqttOnConnect(espMqttClientTypes::OnConnectCallback callback)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _onConnect = callback;
+}
+
+void HostNetworkDevice::mqttOnDisconnect(espMqttClientTypes::OnDisconnectCallback callback)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _onDisconnect = callback;
+}
+
+uint16_t HostNetworkDevice::mqttSubscribe(const char* topic, uint8_t)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _subscriptions.push_back(topic);
+    return _subscriptions.size();
+}
+
+void HostNetworkDevice::setLinkUp(const bool up)
+{
+    _linkUp = up;
+    if(!up) dropConnection();
+}
+
+void HostNetworkDevice::setBrokerPaused(const bool paused)
+{
+    _paused = paused;
+}
+
+void HostNetworkDevice::transmit(const size_t count)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    for(size_t i = 0; i < count && !_outgoing.empty(); i++)
+    {
+        HostMqttMessage& message = _outgoing.front();
+        if(message.retain) _retained[message.topic] = message.payload;
+        _published.push_back(std::move(message));
+        _outgoing.pop_front();
+    }
+}
+
+void HostNetworkDevice::dropConnection()
+{
+    espMqttClientTypes::OnDisconnectCallback onDisconnect;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        if(!_connected) return;
+        _connected = false;
+        _connectedTs = -1;
+        _outgoing.clear();
+        onDisconnect = _onDisconnect;
+    }
+    if(onDisconnect) onDisconnect(espMqttClientTypes::DisconnectReason::TCP_DISCONNECTED);
+}
+
+void HostNetworkDevice::injectMessage(const std::string& topic, const std::string& payload, const size_t fragmentSize)
+{
+    espMqttClientTypes::OnMessageCallback onMessage;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        onMessage = _onMessage;
+    }
+    if(!onMessage) return;
+
+    const espMqttClientTypes::MessageProperties properties = { 0, false, false, 0 };
+    const size_t step = fragmentSize == 0 ? payload.size() : fragmentSize;
+    size_t index = 0;
+    do
+    {
+        const size_t len = std::min(step, payload.size() - index);
+        onMessage(properties, topic.c_str(), (const uint8_t*)payload.data() + index, len, index, payload.size());
+        index += len;
+    } while(index < payload.size());
+}
+
+std::vector<HostMqttMessage> HostNetworkDevice::published() const
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return _published;
+}
+
+std::map<std::string, std::string> HostNetworkDevice::retained() const
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return _retained;
+}
+
+std::vector<std::string> HostNetworkDevice::subscriptions() const
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return _subscriptions;
+}
+
+void HostNetworkDevice::clearPublished()
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _published.clear();
+}
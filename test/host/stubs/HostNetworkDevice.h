@@ -0,0 +1,88 @@
+#pragma once
+
+// Fake network device, NetworkDeviceInstantiator::Create() returns it on the host. It stands in for the link
+// and for the broker: publishes wait in an outgoing queue until update() transmits them, so a test can hold
+// the queue back or inspect what reached the broker, and injectMessage() delivers to the subscriptions.
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "networkDevices/NetworkDevice.h"
+
+struct HostMqttMessage
+{
+    std::string topic;
+    std::string payload;
+    bool retain;
+};
+
+class HostNetworkDevice : public NetworkDevice
+{
+public:
+    explicit HostNetworkDevice(const String& hostname, const IPConfiguration* ipConfiguration);
+
+    const String deviceName() const override;
+    void initialize() override;
+    ReconnectStatus reconnect(bool force = false) override;
+    void reconfigure() override {}
+    bool supportsEncryption() override { return false; }
+    void update() override;
+    bool isConnected() override;
+    int8_t signalStrength() override { return -50; }
+    String localIP() override { return "192.168.1.2"; }
+    String BSSIDstr() override { return ""; }
+
+    void mqttSetClientId(const char* clientId) override;
+    void mqttSetCleanSession(bool) override {}
+    void mqttSetKeepAlive(uint16_t) override {}
+    uint16_t mqttPublish(const char* topic, uint8_t qos, bool retain, const char* payload) override;
+    uint16_t mqttPublish(const char* topic, uint8_t qos, bool retain, const uint8_t* payload, size_t length) override;
+    bool mqttConnected() const override;
+    int64_t mqttTcpConnectedTs() const override { return _connectedTs; }
+    size_t mqttQueueSize() override;
+    void mqttSetServer(const char*, uint16_t) override {}
+    bool mqttConnect() override;
+    bool mqttDisconnect(bool force) override;
+    void setWill(const char*, uint8_t, bool, const char*) override {}
+    void mqttSetCredentials(const char*, const char*) override {}
+    void mqttOnMessage(espMqttClientTypes::OnMessageCallback callback) override;
+    void mqttOnConnect(espMqttClientTypes::OnConnectCallback callback) override;
+    void mqttOnDisconnect(espMqttClientTypes::OnDisconnectCallback callback) override;
+    void disableMqtt() override {}
+    uint16_t mqttSubscribe(const char* topic, uint8_t qos) override;
+
+    // Test side
+    void setLinkUp(const bool up);
+    void setBrokerPaused(const bool paused); // stops transmitting, the outgoing queue only grows
+    void transmit(const size_t count = SIZE_MAX); // moves queued publishes to the broker
+    void dropConnection(); // the broker closes the session, queued publishes are lost like with a clean session
+    // Delivers a message to the subscriptions, split into fragments of fragmentSize bytes if given
+    void injectMessage(const std::string& topic, const std::string& payload, const size_t fragmentSize = 0);
+
+    std::vector<HostMqttMessage> published() const; // everything the broker received, in order
+    std::map<std::string, std::string> retained() const; // retained value per topic
+    std::vector<std::string> subscriptions() const;
+    void clearPublished();
+
+    size_t transmitPerUpdate = SIZE_MAX;
+
+private:
+    mutable std::recursive_mutex _mutex;
+    bool _linkUp = true;
+    bool _connected = false;
+    bool _connectRequested = false;
+    bool _paused = false;
+    int64_t _connectedTs = -1;
+    uint16_t _nextPacketId = 1;
+    std::deque<HostMqttMessage> _outgoing;
+    std::vector<HostMqttMessage> _published;
+    std::map<std::string, std::string> _retained;
+    std::vector<std::string> _subscriptions;
+    espMqttClientTypes::OnMessageCallback _onMessage;
+    espMqttClientTypes::OnConnectCallback _onConnect;
+    espMqttClientTypes::OnDisconnectCallback _onDisconnect;
+};
+
+extern HostNetworkDevice* hostNetworkDevice; // the device created last
@@ -0,0 +1,4 @@
+#pragma once
+
+// espMqttClient brings its own IPAddress on Linux, IPConfiguration is provided by HostNetworkDevice.cpp as it has no fromString()
+#include "Transport/ClientPosixIPAddress.h"
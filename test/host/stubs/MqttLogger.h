@@ -0,0 +1,9 @@
+#pragma once
+
+#include <Print.h>
+#include <espMqttClient.h>
+
+// The host build logs to stdout only
+class MqttLogger : public Print
+{
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+// Network stand-ins, the host build talks to the fake broker in HostNetworkDevice.cpp instead
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+class Stream
+{
+public:
+    virtual ~Stream() = default;
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual size_t readBytes(char*, size_t) { return 0; }
+};
+
+class NetworkClient : public Stream
+{
+public:
+    virtual ~NetworkClient() = default;
+    virtual int connect(const char*, uint16_t) { return 0; }
+    virtual void stop() {}
+    virtual uint8_t connected() { return 0; }
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "NetworkClient.h"
+
+class NetworkClientSecure : public NetworkClient
+{
+public:
+    void setInsecure() {}
+    void setCACert(const char*) {}
+    void setCertificate(const char*) {}
+    void setPrivateKey(const char*) {}
+    void setCACertBundle(const uint8_t*, const size_t) {}
+};
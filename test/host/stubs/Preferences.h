@@ -0,0 +1,45 @@
+#pragma once
+
+// In-memory stand-in for the NVS backed Preferences of the Arduino core
+
+#include <Arduino.h>
+#include <map>
+
+class Preferences
+{
+public:
+    bool begin(const char*, const bool = false) { return true; }
+    void end() {}
+
+    bool isKey(const char* key) { return _values.count(key) != 0; }
+    bool remove(const char* key) { return _values.erase(key) != 0; }
+    bool clear() { _values.clear(); return true; }
+
+    String getString(const char* key, const String& defaultValue = String()) { return isKey(key) ? String(_values[key]) : defaultValue; }
+    size_t putString(const char* key, const String& value) { _values[key] = value; return value.length(); }
+
+    int32_t getInt(const char* key, const int32_t defaultValue = 0) { return isKey(key) ? atoi(_values[key].c_str()) : defaultValue; }
+    size_t putInt(const char* key, const int32_t value) { _values[key] = std::to_string(value); return sizeof(value); }
+
+    uint32_t getUInt(const char* key, const uint32_t defaultValue = 0) { return isKey(key) ? strtoul(_values[key].c_str(), nullptr, 10) : defaultValue; }
+    size_t putUInt(const char* key, const uint32_t value) { _values[key] = std::to_string(value); return sizeof(value); }
+
+    bool getBool(const char* key, const bool defaultValue = false) { return isKey(key) ? _values[key] == "1" : defaultValue; }
+    size_t putBool(const char* key, const bool value) { _values[key] = value ? "1" : "0"; return 1; }
+
+    size_t getBytesLength(const char* key) { return isKey(key) ? _values[key].size() : 0; }
+    size_t getBytes(const char* key, void* buffer, const size_t length)
+    {
+        if(!isKey(key) || _values[key].size() > length) return 0;
+        memcpy(buffer, _values[key].data(), _values[key].size());
+        return _values[key].size();
+    }
+    size_t putBytes(const char* key, const void* value, const size_t length)
+    {
+        _values[key].assign((const char*)value, length);
+        return length;
+    }
+
+private:
+    std::map<std::string, std::string> _values;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+// Stand-in for the Arduino Print class, output goes to stdout
+
+#include <Arduino.h>
+#include <iostream>
+#include <type_traits>
+
+class Print
+{
+public:
+    template<typename T>
+    size_t print(const T& value)
+    {
+        // Enums go through the integer overloads of the Arduino Print
+        if constexpr(std::is_enum<T>::value) std::cout << (int)value;
+        else std::cout << value;
+        return 0;
+    }
+
+    template<typename T>
+    size_t println(const T& value)
+    {
+        print(value);
+        std::cout << std::endl;
+        return 0;
+    }
+
+    size_t println()
+    {
+        std::cout << std::endl;
+        return 0;
+    }
+};
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "NetworkClient.h"
+
+typedef NetworkClient WiFiClient;
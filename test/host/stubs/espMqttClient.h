@@ -0,0 +1,22 @@
+#pragma once
+
+#include_next <espMqttClient.h>
+
+// The library has no TLS transport on Linux, NetworkDevice only needs the type
+class espMqttClientSecure : public MqttClientSetup<espMqttClientSecure>
+{
+public:
+    espMqttClientSecure()
+    : MqttClientSetup(espMqttClientTypes::UseInternalTask::NO)
+    {
+        _transport = &_client;
+    }
+
+    espMqttClientSecure& setInsecure() { return *this; }
+    espMqttClientSecure& setCACert(const char*) { return *this; }
+    espMqttClientSecure& setCertificate(const char*) { return *this; }
+    espMqttClientSecure& setPrivateKey(const char*) { return *this; }
+
+protected:
+    espMqttClientInternals::ClientPosix _client;
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+typedef enum
+{
+    ESP_PWR_LVL_N12 = 0,
+    ESP_PWR_LVL_N9 = 1,
+    ESP_PWR_LVL_N6 = 2,
+    ESP_PWR_LVL_N3 = 3,
+    ESP_PWR_LVL_N0 = 4,
+    ESP_PWR_LVL_P3 = 5,
+    ESP_PWR_LVL_P6 = 6,
+    ESP_PWR_LVL_P9 = 7
+} esp_power_level_t;
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdlib>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+inline void* heap_caps_aligned_alloc(const size_t alignment, const size_t size, const uint32_t caps)
+{
+    // No PSRAM on the host, like a board without it
+    if(caps & MALLOC_CAP_SPIRAM) return nullptr;
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+inline void heap_caps_free(void* ptr)
+{
+    free(ptr);
+}
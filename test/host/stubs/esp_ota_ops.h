@@ -0,0 +1,87 @@
+#pragma once
+
+// File backed stand-in for the OTA partition API. The image is written to hostOtaPartitionPath, the checks of
+// the real implementation that matter to the writer (image magic, writes after end or abort) are emulated.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstddef>
+
+typedef int esp_err_t;
+typedef uint32_t esp_ota_handle_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_OTA_VALIDATE_FAILED 0x1503
+#define OTA_WITH_SEQUENTIAL_WRITES 0xfffffffe
+
+struct esp_partition_t
+{
+    const char* label;
+    size_t size;
+};
+
+inline const char* hostOtaPartitionPath = "ota_partition.bin";
+inline esp_partition_t hostOtaPartition = { "ota_0", 0x1e0000 };
+inline FILE* hostOtaFile = nullptr;
+inline esp_ota_handle_t hostOtaHandle = 0;
+inline size_t hostOtaWritten = 0;
+inline bool hostOtaBootSet = false;
+
+inline const esp_partition_t* esp_ota_get_next_update_partition(const esp_partition_t*)
+{
+    return &hostOtaPartition;
+}
+
+inline esp_err_t esp_ota_begin(const esp_partition_t* partition, size_t, esp_ota_handle_t* handle)
+{
+    if(partition != &hostOtaPartition) return ESP_ERR_INVALID_ARG;
+    if(hostOtaFile != nullptr) fclose(hostOtaFile);
+
+    hostOtaFile = fopen(hostOtaPartitionPath, "wb");
+    if(hostOtaFile == nullptr) return ESP_FAIL;
+
+    hostOtaWritten = 0;
+    hostOtaBootSet = false;
+    *handle = ++hostOtaHandle;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_ota_write(esp_ota_handle_t handle, const void* data, size_t size)
+{
+    if(handle != hostOtaHandle || hostOtaFile == nullptr) return ESP_ERR_INVALID_ARG;
+    if(hostOtaWritten == 0 && size > 0 && ((const uint8_t*)data)[0] != 0xe9) return ESP_ERR_OTA_VALIDATE_FAILED;
+    if(hostOtaWritten + size > hostOtaPartition.size) return ESP_ERR_INVALID_ARG;
+    if(fwrite(data, 1, size, hostOtaFile) != size) return ESP_FAIL;
+
+    hostOtaWritten += size;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_ota_end(esp_ota_handle_t handle)
+{
+    if(handle != hostOtaHandle || hostOtaFile == nullptr) return ESP_ERR_INVALID_ARG;
+
+    fclose(hostOtaFile);
+    hostOtaFile = nullptr;
+    ++hostOtaHandle;
+    return hostOtaWritten > 0 ? ESP_OK : ESP_ERR_OTA_VALIDATE_FAILED;
+}
+
+inline esp_err_t esp_ota_abort(esp_ota_handle_t handle)
+{
+    if(handle != hostOtaHandle || hostOtaFile == nullptr) return ESP_ERR_INVALID_ARG;
+
+    fclose(hostOtaFile);
+    hostOtaFile = nullptr;
+    ++hostOtaHandle;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_ota_set_boot_partition(const esp_partition_t* partition)
+{
+    if(partition != &hostOtaPartition) return ESP_ERR_INVALID_ARG;
+    hostOtaBootSet = true;
+    return ESP_OK;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+inline size_t esp_psram_get_size()
+{
+    return 0;
+}
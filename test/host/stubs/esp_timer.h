@@ -0,0 +1,10 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Microseconds since boot, the same clock the millis() of espMqttClient uses on Linux
+inline int64_t esp_timer_get_time()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
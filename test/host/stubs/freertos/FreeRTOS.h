@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define configTICK_RATE_HZ 1000
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+// Set by a test thread to take the ISR code paths
+inline thread_local bool hostInIsrContext = false;
+
+inline BaseType_t xPortInIsrContext()
+{
+    return hostInIsrContext ? pdTRUE : pdFALSE;
+}
+
+#define portYIELD_FROM_ISR() do {} while(0)
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "task.h"
+#include <mutex>
+
+#define portMAX_DELAY 0xffffffffUL
+
+// Mutexes and binary semaphores, the holder is tracked for xSemaphoreGetMutexHolder()
+struct HostSemaphore
+{
+    std::recursive_timed_mutex mutex;
+    std::mutex countMutex;
+    std::condition_variable given;
+    TaskHandle_t holder = nullptr;
+    uint32_t depth = 0;
+    uint32_t count = 0;
+};
+
+typedef HostSemaphore* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex()
+{
+    return new HostSemaphore();
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return new HostSemaphore();
+}
+
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, const TickType_t ticksToWait)
+{
+    if(ticksToWait == portMAX_DELAY) semaphore->mutex.lock();
+    else if(!semaphore->mutex.try_lock_for(std::chrono::milliseconds(ticksToWait))) return pdFALSE;
+
+    semaphore->holder = xTaskGetCurrentTaskHandle();
+    ++semaphore->depth;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore)
+{
+    if(--semaphore->depth == 0) semaphore->holder = nullptr;
+    semaphore->mutex.unlock();
+    return pdTRUE;
+}
+
+inline TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t semaphore)
+{
+    return semaphore->holder;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+    return new HostSemaphore();
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, const TickType_t ticksToWait)
+{
+    std::unique_lock<std::mutex> lock(semaphore->countMutex);
+    auto available = [semaphore]() { return semaphore->count > 0; };
+
+    if(ticksToWait == portMAX_DELAY) semaphore->given.wait(lock, available);
+    else if(!semaphore->given.wait_for(lock, std::chrono::milliseconds(ticksToWait), available)) return pdFALSE;
+
+    --semaphore->count;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    {
+        std::lock_guard<std::mutex> lock(semaphore->countMutex);
+        if(semaphore->count > 0) return pdFALSE;
+        semaphore->count = 1;
+    }
+    semaphore->given.notify_one();
+    return pdTRUE;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    delete semaphore;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "FreeRTOS.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Every thread is a task, the task notification value is emulated with a condition variable
+struct HostTask
+{
+    std::mutex mutex;
+    std::condition_variable notified;
+    uint32_t notifications = 0;
+};
+
+typedef HostTask* TaskHandle_t;
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    // Never freed, a notification may still be given after the thread has ended
+    static thread_local HostTask* task = new HostTask();
+    return task;
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        ++task->notifications;
+    }
+    task->notified.notify_one();
+    return pdTRUE;
+}
+
+inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken)
+{
+    xTaskNotifyGive(task);
+    if(higherPriorityTaskWoken != nullptr) *higherPriorityTaskWoken = pdTRUE;
+}
+
+inline uint32_t ulTaskNotifyTake(const BaseType_t clearCountOnExit, const TickType_t ticksToWait)
+{
+    HostTask* task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> lock(task->mutex);
+
+    task->notified.wait_for(lock, std::chrono::milliseconds(ticksToWait), [task]() { return task->notifications > 0; });
+
+    const uint32_t value = task->notifications;
+    if(value > 0) task->notifications = clearCountOnExit == pdTRUE ? 0 : value - 1;
+    return value;
+}
+
+inline void vTaskDelay(const TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
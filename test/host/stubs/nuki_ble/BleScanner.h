@@ -0,0 +1,12 @@
+#pragma once
+
+// Stand-in for BleScanner, the scripted devices in NukiBle.h never scan
+namespace BleScanner
+{
+    class Scanner
+    {
+    public:
+        void initialize(const char* = "", const bool = false, const int = 0, const int = 0) {}
+        void update() {}
+    };
+}
@@ -0,0 +1,193 @@
+#include "NukiBle.h"
+#include "NukiLock.h"
+#include "NukiOpener.h"
+#include "Arduino.h"
+
+namespace Nuki
+{
+    NukiBle::NukiBle(const std::string& deviceName, const uint32_t deviceId)
+    : _deviceName(deviceName),
+      _deviceId(deviceId)
+    {
+    }
+
+    PairingResult NukiBle::pairNuki(const AuthorizationIdType)
+    {
+        respond("pairNuki");
+        return pairingAccepted ? PairingResult::Success : PairingResult::Pairing;
+    }
+
+    bool NukiBle::unPairNuki()
+    {
+        respond("unPairNuki");
+        return true;
+    }
+
+    bool NukiBle::saveSecurityPincode(const uint32_t pin)
+    {
+        _savedPin = pin;
+        return true;
+    }
+
+    CmdResult NukiBle::verifySecurityPin()
+    {
+        const CmdResult result = respond("verifySecurityPin");
+        if(result != CmdResult::Success) return result;
+        return devicePin != 0 && _savedPin == devicePin ? CmdResult::Success : CmdResult::Failed;
+    }
+
+    void NukiBle::queueResult(const CmdResult result, const size_t count)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _results.insert(_results.end(), count, result);
+    }
+
+    void NukiBle::notify(const EventType eventType)
+    {
+        if(_eventHandler != nullptr) _eventHandler->notify(eventType);
+    }
+
+    std::vector<std::string> NukiBle::requests() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _requests;
+    }
+
+    size_t NukiBle::requestCount(const std::string& name) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return std::count(_requests.begin(), _requests.end(), name);
+    }
+
+    void NukiBle::clearRequests()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _requests.clear();
+    }
+
+    CmdResult NukiBle::respond(const char* request)
+    {
+        if(responseDelayMs > 0) delay(responseDelayMs);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _requests.push_back(request);
+        if(_results.empty()) return CmdResult::Success;
+
+        const CmdResult result = _results.front();
+        _results.pop_front();
+        return result;
+    }
+}
+
+NukiLock::NukiLock* hostNukiLock = nullptr;
+NukiOpener::NukiOpener* hostNukiOpener = nullptr;
+
+namespace NukiLock
+{
+    NukiLock::NukiLock(const std::string& deviceName, const uint32_t deviceId)
+    : ScriptedDevice(deviceName, deviceId)
+    {
+        keyTurnerState.nukiState = State::DoorMode;
+        keyTurnerState.lockState = LockState::Locked;
+        keyTurnerState.lastLockActionCompletionStatus = CompletionStatus::Success;
+        config.nukiId = deviceId;
+        strncpy(config.name, deviceName.c_str(), sizeof(config.name) - 1);
+        config.firmwareVersion[0] = 4;
+        config.hardwareRevision[0] = 5;
+        config.timeZoneId = Nuki::TimeZoneId::Europe_Berlin;
+        batteryReport.batteryVoltage = 7800;
+        hostNukiLock = this;
+    }
+
+    Nuki::CmdResult NukiLock::lockAction(const LockAction lockAction, const uint32_t, const uint8_t, const char*, const uint8_t)
+    {
+        const Nuki::CmdResult result = respond("lockAction");
+        if(result != Nuki::CmdResult::Success) return result;
+
+        switch(lockAction)
+        {
+            case LockAction::Lock:
+            case LockAction::FullLock:
+                keyTurnerState.lockState = LockState::Locked;
+                break;
+            case LockAction::Unlock:
+                keyTurnerState.lockState = LockState::Unlocked;
+                break;
+            case LockAction::Unlatch:
+                keyTurnerState.lockState = LockState::Unlatched;
+                break;
+            case LockAction::LockNgo:
+            case LockAction::LockNgoUnlatch:
+                keyTurnerState.lockState = LockState::UnlockedLnga;
+                break;
+            default:
+                break;
+        }
+        keyTurnerState.lastLockAction = lockAction;
+        keyTurnerState.lastLockActionTrigger = Trigger::System;
+        keyTurnerState.lastLockActionCompletionStatus = CompletionStatus::Success;
+        addLogEntry(LoggingType::LockAction, 1, "Nuki Hub", lockAction);
+
+        notify(Nuki::EventType::KeyTurnerStatusUpdated);
+        return result;
+    }
+
+    Nuki::CmdResult NukiLock::setTime(const char* request, unsigned char (&field)[2], const unsigned char value[2])
+    {
+        const Nuki::CmdResult result = respond(request);
+        if(result == Nuki::CmdResult::Success) memcpy(field, value, sizeof(field));
+        return result;
+    }
+}
+
+namespace NukiOpener
+{
+    NukiOpener::NukiOpener(const std::string& deviceName, const uint32_t deviceId)
+    : ScriptedDevice(deviceName, deviceId)
+    {
+        openerState.nukiState = State::DoorMode;
+        openerState.lockState = LockState::Locked;
+        openerState.lastLockActionCompletionStatus = CompletionStatus::Success;
+        config.nukiId = deviceId;
+        strncpy(config.name, deviceName.c_str(), sizeof(config.name) - 1);
+        config.firmwareVersion[0] = 1;
+        config.hardwareRevision[0] = 2;
+        config.timeZoneId = Nuki::TimeZoneId::Europe_Berlin;
+        batteryReport.batteryVoltage = 5600;
+        hostNukiOpener = this;
+    }
+
+    Nuki::CmdResult NukiOpener::lockAction(const LockAction lockAction, const uint32_t, const uint8_t, const char*, const uint8_t)
+    {
+        const Nuki::CmdResult result = respond("lockAction");
+        if(result != Nuki::CmdResult::Success) return result;
+
+        switch(lockAction)
+        {
+            case LockAction::ActivateRTO:
+                openerState.lockState = LockState::RTOactive;
+                break;
+            case LockAction::DeactivateRTO:
+                openerState.lockState = LockState::Locked;
+                break;
+            case LockAction::ElectricStrikeActuation:
+                openerState.lockState = LockState::Open;
+                break;
+            case LockAction::ActivateCM:
+                openerState.nukiState = State::ContinuousMode;
+                break;
+            case LockAction::DeactivateCM:
+                openerState.nukiState = State::DoorMode;
+                break;
+            default:
+                break;
+        }
+        openerState.lastLockAction = lockAction;
+        openerState.lastLockActionTrigger = Trigger::System;
+        openerState.lastLockActionCompletionStatus = CompletionStatus::Success;
+        addLogEntry(LoggingType::LockAction, 1, "Nuki Hub", lockAction);
+
+        notify(Nuki::EventType::KeyTurnerStatusUpdated);
+        return result;
+    }
+}
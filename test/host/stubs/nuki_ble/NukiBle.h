@@ -0,0 +1,368 @@
+#pragma once
+
+// Scripted stand-in for the BLE connection of NukiBleEsp32. Every request is recorded and answered with
+// CmdResult::Success unless the test queued other results, the device keeps its state in plain members the
+// test can set and inspect. Requests may come from the nuki task and the test thread, so they are serialized.
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "esp_bt.h"
+#include "BleScanner.h"
+#include "NukiConstants.h"
+#include "NukiDataTypes.h"
+
+namespace Nuki
+{
+    class NukiBle
+    {
+    public:
+        NukiBle(const std::string& deviceName, const uint32_t deviceId);
+        virtual ~NukiBle() = default;
+
+        void initialize() {}
+        void registerBleScanner(BleScanner::Scanner*) {}
+        void setEventHandler(SmartlockEventHandler* handler) { _eventHandler = handler; }
+        void setConnectTimeout(const uint8_t) {}
+        void setDisconnectTimeout(const uint32_t) {}
+        void setPower(const esp_power_level_t) {}
+        void updateConnectionState() {}
+
+        PairingResult pairNuki(const AuthorizationIdType idType = AuthorizationIdType::Bridge);
+        bool unPairNuki();
+        BLEAddress getBleAddress() const { return BLEAddress(bleAddress); }
+        int getRssi() const { return rssi; }
+        int64_t getLastReceivedBeaconTs() const { return lastReceivedBeaconTs; }
+
+        bool saveSecurityPincode(const uint32_t pin);
+        uint32_t getSecurityPincode() const { return _savedPin; }
+        CmdResult verifySecurityPin();
+
+        // Test side
+        void queueResult(const CmdResult result, const size_t count = 1); // answers the next requests
+        void notify(const EventType eventType = EventType::KeyTurnerStatusUpdated); // like a beacon announcing a change
+        std::vector<std::string> requests() const; // name of every request in call order
+        size_t requestCount(const std::string& name) const;
+        void clearRequests();
+
+        std::string bleAddress = "aa:bb:cc:dd:ee:ff";
+        int rssi = -60;
+        int64_t lastReceivedBeaconTs = 0;
+        bool pairingAccepted = true;
+        uint32_t devicePin = 0; // security PIN verifySecurityPin() accepts, 0 accepts none
+        uint32_t responseDelayMs = 0; // BLE round trip of every request
+
+    protected:
+        CmdResult respond(const char* request);
+
+        // The state structs are packed like on the air, so setters assign their field in apply()
+        template<typename Apply>
+        CmdResult change(const char* request, Apply apply)
+        {
+            const CmdResult result = respond(request);
+            if(result == CmdResult::Success) apply();
+            return result;
+        }
+
+        template<typename Entry, typename List>
+        static void copyPage(const List& entries, std::list<Entry>& page, const uint16_t offset, const uint16_t count)
+        {
+            page.clear();
+            auto it = entries.begin();
+            for(uint16_t i = 0; i < offset && it != entries.end(); i++) ++it;
+            for(uint16_t i = 0; i < count && it != entries.end(); i++, ++it) page.push_back(*it);
+        }
+
+        SmartlockEventHandler* _eventHandler = nullptr;
+        const std::string _deviceName;
+        const uint32_t _deviceId;
+        uint32_t _savedPin = 0;
+
+    private:
+        mutable std::mutex _mutex;
+        std::deque<CmdResult> _results;
+        std::vector<std::string> _requests;
+    };
+
+    // Logs, keypad codes, authorizations and time control entries, the same for the lock and the opener
+    template<typename Types>
+    class ScriptedDevice : public NukiBle
+    {
+    public:
+        using LogEntry = typename Types::LogEntry;
+        using KeypadEntry = typename Types::KeypadEntry;
+        using NewKeypadEntry = typename Types::NewKeypadEntry;
+        using UpdatedKeypadEntry = typename Types::UpdatedKeypadEntry;
+        using AuthorizationEntry = typename Types::AuthorizationEntry;
+        using NewAuthorizationEntry = typename Types::NewAuthorizationEntry;
+        using UpdatedAuthorizationEntry = typename Types::UpdatedAuthorizationEntry;
+        using TimeControlEntry = typename Types::TimeControlEntry;
+        using NewTimeControlEntry = typename Types::NewTimeControlEntry;
+        using LockAction = typename Types::LockAction;
+        using LoggingType = typename Types::LoggingType;
+        using Config = typename Types::Config;
+        using AdvancedConfig = typename Types::AdvancedConfig;
+        using BatteryReport = typename Types::BatteryReport;
+
+        using NukiBle::NukiBle;
+
+        CmdResult requestConfig(Config* out) { return read("requestConfig", config, out); }
+        CmdResult requestAdvancedConfig(AdvancedConfig* out) { return read("requestAdvancedConfig", advancedConfig, out); }
+        CmdResult requestBatteryReport(BatteryReport* out) { return read("requestBatteryReport", batteryReport, out); }
+
+        CmdResult setName(const std::string& name)
+        {
+            const CmdResult result = respond("setName");
+            if(result == CmdResult::Success) strncpy(config.name, name.c_str(), sizeof(config.name) - 1);
+            return result;
+        }
+        CmdResult setLatitude(const float value) { return change("setLatitude", [&]() { config.latitude = value; }); }
+        CmdResult setLongitude(const float value) { return change("setLongitude", [&]() { config.longitude = value; }); }
+        CmdResult enablePairing(const bool enable) { return change("enablePairing", [&]() { config.pairingEnabled = (uint8_t)enable; }); }
+        CmdResult enableButton(const bool enable) { return change("enableButton", [&]() { config.buttonEnabled = (uint8_t)enable; }); }
+        CmdResult enableDst(const bool enable) { return change("enableDst", [&]() { config.dstMode = (uint8_t)enable; }); }
+        CmdResult setTimeZoneOffset(const int16_t value) { return change("setTimeZoneOffset", [&]() { config.timeZoneOffset = value; }); }
+        CmdResult setTimeZoneId(const TimeZoneId value) { return change("setTimeZoneId", [&]() { config.timeZoneId = value; }); }
+        CmdResult setAdvertisingMode(const AdvertisingMode value) { return change("setAdvertisingMode", [&]() { config.advertisingMode = value; }); }
+        CmdResult setFobAction(const uint8_t fobActionNr, const uint8_t fobAction)
+        {
+            uint8_t* actions[] = { &config.fobAction1, &config.fobAction2, &config.fobAction3 };
+            if(fobActionNr < 1 || fobActionNr > 3) return CmdResult::Failed;
+            return change("setFobAction", [&]() { *actions[fobActionNr - 1] = fobAction; });
+        }
+        CmdResult setBatteryType(const BatteryType value) { return change("setBatteryType", [&]() { advancedConfig.batteryType = value; }); }
+        CmdResult enableAutoBatteryTypeDetection(const bool enable) { return change("enableAutoBatteryTypeDetection", [&]() { advancedConfig.automaticBatteryTypeDetection = (uint8_t)enable; }); }
+        CmdResult setSingleButtonPressAction(const decltype(AdvancedConfig::singleButtonPressAction) value) { return change("setSingleButtonPressAction", [&]() { advancedConfig.singleButtonPressAction = value; }); }
+        CmdResult setDoubleButtonPressAction(const decltype(AdvancedConfig::doubleButtonPressAction) value) { return change("setDoubleButtonPressAction", [&]() { advancedConfig.doubleButtonPressAction = value; }); }
+
+        CmdResult retrieveLogEntries(const uint32_t startIndex, const uint16_t count, const uint8_t sortOrder, const bool totalCount)
+        {
+            (void)totalCount;
+            const CmdResult result = respond("retrieveLogEntries");
+            if(result != CmdResult::Success) return result;
+
+            // log is kept in ascending index order, sort order 1 returns the newest entries first
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            _retrievedLog.clear();
+            if(sortOrder == 1)
+            {
+                for(auto it = log.rbegin(); it != log.rend() && _retrievedLog.size() < count; ++it)
+                {
+                    if(startIndex == 0 || it->index <= startIndex) _retrievedLog.push_back(*it);
+                }
+            }
+            else
+            {
+                for(auto it = log.begin(); it != log.end() && _retrievedLog.size() < count; ++it)
+                {
+                    if(it->index >= startIndex) _retrievedLog.push_back(*it);
+                }
+            }
+            return result;
+        }
+        void getLogEntries(std::list<LogEntry>* out)
+        {
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            *out = _retrievedLog;
+        }
+
+        CmdResult retrieveKeypadEntries(const uint16_t offset, const uint16_t count)
+        {
+            const CmdResult result = respond("retrieveKeypadEntries");
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            if(result == CmdResult::Success) copyPage(keypadEntries, _retrievedKeypad, offset, count);
+            return result;
+        }
+        void getKeypadEntries(std::list<KeypadEntry>* out)
+        {
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            *out = _retrievedKeypad;
+        }
+        CmdResult addKeypadEntry(const NewKeypadEntry& entry)
+        {
+            const CmdResult result = respond("addKeypadEntry");
+            if(result != CmdResult::Success) return result;
+
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            KeypadEntry added = KeypadEntry();
+            added.codeId = keypadEntries.empty() ? 1 : keypadEntries.back().codeId + 1;
+            added.code = entry.code;
+            memcpy(added.name, entry.name, sizeof(added.name));
+            added.enabled = 1;
+            added.timeLimited = entry.timeLimited;
+            added.allowedWeekdays = entry.allowedWeekdays;
+            keypadEntries.push_back(added);
+            return result;
+        }
+        CmdResult updateKeypadEntry(const UpdatedKeypadEntry& entry)
+        {
+            const CmdResult result = respond("updateKeypadEntry");
+            if(result != CmdResult::Success) return result;
+
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            for(KeypadEntry& existing : keypadEntries)
+            {
+                if(existing.codeId != entry.codeId) continue;
+                existing.code = entry.code;
+                memcpy(existing.name, entry.name, sizeof(existing.name));
+                existing.enabled = entry.enabled;
+                existing.timeLimited = entry.timeLimited;
+                existing.allowedWeekdays = entry.allowedWeekdays;
+            }
+            return result;
+        }
+        CmdResult deleteKeypadEntry(const uint16_t codeId)
+        {
+            const CmdResult result = respond("deleteKeypadEntry");
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            if(result == CmdResult::Success) keypadEntries.remove_if([codeId](const KeypadEntry& entry) { return entry.codeId == codeId; });
+            return result;
+        }
+
+        CmdResult retrieveAuthorizationEntries(const uint16_t offset, const uint16_t count)
+        {
+            const CmdResult result = respond("retrieveAuthorizationEntries");
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            if(result == CmdResult::Success) copyPage(authorizationEntries, _retrievedAuthorizations, offset, count);
+            return result;
+        }
+        void getAuthorizationEntries(std::list<AuthorizationEntry>* out)
+        {
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            *out = _retrievedAuthorizations;
+        }
+        CmdResult addAuthorizationEntry(const NewAuthorizationEntry& entry)
+        {
+            const CmdResult result = respond("addAuthorizationEntry");
+            if(result != CmdResult::Success) return result;
+
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            AuthorizationEntry added = AuthorizationEntry();
+            added.authId = authorizationEntries.empty() ? 1 : authorizationEntries.back().authId + 1;
+            added.idType = entry.idType;
+            memcpy(added.name, entry.name, sizeof(added.name));
+            added.enabled = 1;
+            added.remoteAllowed = entry.remoteAllowed;
+            added.timeLimited = entry.timeLimited;
+            added.allowedWeekdays = entry.allowedWeekdays;
+            authorizationEntries.push_back(added);
+            return result;
+        }
+        CmdResult updateAuthorizationEntry(const UpdatedAuthorizationEntry& entry)
+        {
+            const CmdResult result = respond("updateAuthorizationEntry");
+            if(result != CmdResult::Success) return result;
+
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            for(AuthorizationEntry& existing : authorizationEntries)
+            {
+                if(existing.authId != entry.authId) continue;
+                memcpy(existing.name, entry.name, sizeof(existing.name));
+                existing.enabled = entry.enabled;
+                existing.remoteAllowed = entry.remoteAllowed;
+                existing.timeLimited = entry.timeLimited;
+                existing.allowedWeekdays = entry.allowedWeekdays;
+            }
+            return result;
+        }
+        CmdResult deleteAuthorizationEntry(const uint32_t authId)
+        {
+            const CmdResult result = respond("deleteAuthorizationEntry");
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            if(result == CmdResult::Success) authorizationEntries.remove_if([authId](const AuthorizationEntry& entry) { return entry.authId == authId; });
+            return result;
+        }
+
+        CmdResult retrieveTimeControlEntries()
+        {
+            const CmdResult result = respond("retrieveTimeControlEntries");
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            if(result == CmdResult::Success) _retrievedTimeControl.assign(timeControlEntries.begin(), timeControlEntries.end());
+            return result;
+        }
+        void getTimeControlEntries(std::list<TimeControlEntry>* out)
+        {
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            *out = _retrievedTimeControl;
+        }
+        CmdResult addTimeControlEntry(const NewTimeControlEntry& entry)
+        {
+            const CmdResult result = respond("addTimeControlEntry");
+            if(result != CmdResult::Success) return result;
+
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            TimeControlEntry added = TimeControlEntry();
+            added.entryId = timeControlEntries.empty() ? 1 : timeControlEntries.back().entryId + 1;
+            added.enabled = 1;
+            added.weekdays = entry.weekdays;
+            added.timeHour = entry.timeHour;
+            added.timeMin = entry.timeMin;
+            added.lockAction = entry.lockAction;
+            timeControlEntries.push_back(added);
+            return result;
+        }
+        CmdResult updateTimeControlEntry(const TimeControlEntry& entry)
+        {
+            const CmdResult result = respond("updateTimeControlEntry");
+            if(result != CmdResult::Success) return result;
+
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            for(TimeControlEntry& existing : timeControlEntries)
+            {
+                if(existing.entryId == entry.entryId) existing = entry;
+            }
+            return result;
+        }
+        CmdResult removeTimeControlEntry(const uint8_t entryId)
+        {
+            const CmdResult result = respond("removeTimeControlEntry");
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            if(result == CmdResult::Success) timeControlEntries.remove_if([entryId](const TimeControlEntry& entry) { return entry.entryId == entryId; });
+            return result;
+        }
+
+        // Test side, appends a log entry with the next index
+        void addLogEntry(const LoggingType type, const uint32_t authId, const char* name, const LockAction action)
+        {
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            LogEntry entry = LogEntry();
+            entry.index = log.empty() ? 1 : log.back().index + 1;
+            entry.timeStampYear = 2024;
+            entry.timeStampMonth = 1;
+            entry.timeStampDay = 1;
+            entry.authId = authId;
+            strncpy((char*)entry.name, name, sizeof(entry.name));
+            entry.loggingType = type;
+            entry.data[0] = (uint8_t)action;
+            log.push_back(entry);
+        }
+
+        Config config = Config();
+        AdvancedConfig advancedConfig = AdvancedConfig();
+        BatteryReport batteryReport = BatteryReport();
+        std::vector<LogEntry> log; // ascending index
+        std::list<KeypadEntry> keypadEntries;
+        std::list<AuthorizationEntry> authorizationEntries;
+        std::list<TimeControlEntry> timeControlEntries;
+
+    protected:
+        template<typename T>
+        CmdResult read(const char* request, const T& value, T* out)
+        {
+            const CmdResult result = respond(request);
+            if(result == CmdResult::Success) *out = value;
+            return result;
+        }
+
+    private:
+        std::mutex _entriesMutex;
+        std::list<LogEntry> _retrievedLog;
+        std::list<KeypadEntry> _retrievedKeypad;
+        std::list<AuthorizationEntry> _retrievedAuthorizations;
+        std::list<TimeControlEntry> _retrievedTimeControl;
+    };
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+// Host stand-in for the constants of NukiBleEsp32 (lib/nuki_ble), only what src/ uses
+
+#include <cstdint>
+
+namespace Nuki
+{
+    enum class CmdResult : uint8_t
+    {
+        Success = 1,
+        Failed = 2,
+        TimeOut = 3,
+        Working = 4,
+        NotPaired = 5,
+        Lock_Busy = 6,
+        Error = 99
+    };
+
+    enum class PairingResult
+    {
+        Pairing,
+        Success,
+        Timeout
+    };
+
+    enum class AuthorizationIdType : uint8_t
+    {
+        App = 0,
+        Bridge = 1,
+        Fob = 2,
+        Keypad = 3
+    };
+
+    enum class EventType
+    {
+        KeyTurnerStatusUpdated,
+        KeyTurnerStatusReset,
+        ERROR_BAD_PIN,
+        BLE_ERROR_ON_DISCONNECT
+    };
+
+    enum class AdvertisingMode : uint8_t
+    {
+        Automatic = 0x00,
+        Normal = 0x01,
+        Slow = 0x02,
+        Slowest = 0x03
+    };
+
+    enum class BatteryType : uint8_t
+    {
+        Alkali = 0x00,
+        Accumulators = 0x01,
+        Lithium = 0x02
+    };
+
+    enum class DoorSensorState : uint8_t
+    {
+        Unavailable = 0x00,
+        Deactivated = 0x01,
+        DoorClosed = 0x02,
+        DoorOpened = 0x03,
+        DoorStateUnknown = 0x04,
+        Calibrating = 0x05,
+        Uncalibrated = 0x10,
+        Tampered = 0xF0,
+        Unknown = 0xFF
+    };
+
+    enum class TimeZoneId : uint16_t
+    {
+        Africa_Cairo = 0,
+        Africa_Lagos = 1,
+        Africa_Maputo = 2,
+        Africa_Nairobi = 3,
+        America_Anchorage = 4,
+        America_Argentina_Buenos_Aires = 5,
+        America_Chicago = 6,
+        America_Denver = 7,
+        America_Halifax = 8,
+        America_Los_Angeles = 9,
+        America_Manaus = 10,
+        America_Mexico_City = 11,
+        America_New_York = 12,
+        America_Phoenix = 13,
+        America_Regina = 14,
+        America_Santiago = 15,
+        America_Sao_Paulo = 16,
+        America_St_Johns = 17,
+        Asia_Bangkok = 18,
+        Asia_Dubai = 19,
+        Asia_Hong_Kong = 20,
+        Asia_Jerusalem = 21,
+        Asia_Karachi = 22,
+        Asia_Kathmandu = 23,
+        Asia_Kolkata = 24,
+        Asia_Riyadh = 25,
+        Asia_Seoul = 26,
+        Asia_Shanghai = 27,
+        Asia_Tehran = 28,
+        Asia_Tokyo = 29,
+        Asia_Yangon = 30,
+        Australia_Adelaide = 31,
+        Australia_Brisbane = 32,
+        Australia_Darwin = 33,
+        Australia_Hobart = 34,
+        Australia_Perth = 35,
+        Australia_Sydney = 36,
+        Europe_Berlin = 37,
+        Europe_Helsinki = 38,
+        Europe_Istanbul = 39,
+        Europe_London = 40,
+        Europe_Moscow = 41,
+        Pacific_Auckland = 42,
+        Pacific_Guam = 43,
+        Pacific_Honolulu = 44,
+        Pacific_Pago_Pago = 45,
+        None = 65535
+    };
+
+    class SmartlockEventHandler
+    {
+    public:
+        virtual ~SmartlockEventHandler() = default;
+        virtual void notify(EventType eventType) = 0;
+    };
+}
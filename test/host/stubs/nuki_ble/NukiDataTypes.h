@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// BLE address as reported by NimBLE
+class BLEAddress
+{
+public:
+    explicit BLEAddress(const std::string& address = "00:00:00:00:00:00") : _address(address) {}
+    std::string toString() const { return _address; }
+
+private:
+    std::string _address;
+};
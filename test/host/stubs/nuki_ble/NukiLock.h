@@ -0,0 +1,66 @@
+#pragma once
+
+#include "NukiBle.h"
+#include "NukiLockConstants.h"
+
+namespace NukiLock
+{
+    struct Types
+    {
+        using LogEntry = NukiLock::LogEntry;
+        using KeypadEntry = NukiLock::KeypadEntry;
+        using NewKeypadEntry = NukiLock::NewKeypadEntry;
+        using UpdatedKeypadEntry = NukiLock::UpdatedKeypadEntry;
+        using AuthorizationEntry = NukiLock::AuthorizationEntry;
+        using NewAuthorizationEntry = NukiLock::NewAuthorizationEntry;
+        using UpdatedAuthorizationEntry = NukiLock::UpdatedAuthorizationEntry;
+        using TimeControlEntry = NukiLock::TimeControlEntry;
+        using NewTimeControlEntry = NukiLock::NewTimeControlEntry;
+        using LockAction = NukiLock::LockAction;
+        using LoggingType = NukiLock::LoggingType;
+        using Config = NukiLock::Config;
+        using AdvancedConfig = NukiLock::AdvancedConfig;
+        using BatteryReport = NukiLock::BatteryReport;
+    };
+
+    // Scripted smart lock, a lock action moves the state right away and announces it like a beacon would
+    class NukiLock : public Nuki::ScriptedDevice<Types>
+    {
+    public:
+        NukiLock(const std::string& deviceName, const uint32_t deviceId);
+
+        Nuki::CmdResult lockAction(const LockAction lockAction, const uint32_t nukiAppId = 1, const uint8_t flags = 0,
+                                   const char* nameSuffix = nullptr, const uint8_t nameSuffixLen = 0);
+        Nuki::CmdResult requestKeyTurnerState(KeyTurnerState* out) { return read("requestKeyTurnerState", keyTurnerState, out); }
+
+        Nuki::CmdResult enableLedFlash(const bool enable) { return change("enableLedFlash", [&]() { config.ledEnabled = (uint8_t)enable; }); }
+        Nuki::CmdResult setLedBrightness(const uint8_t value) { return change("setLedBrightness", [&]() { config.ledBrightness = value; }); }
+        Nuki::CmdResult enableAutoUnlatch(const bool enable) { return change("enableAutoUnlatch", [&]() { config.autoUnlatch = (uint8_t)enable; }); }
+        Nuki::CmdResult enableSingleLock(const bool enable) { return change("enableSingleLock", [&]() { config.singleLock = (uint8_t)enable; }); }
+        Nuki::CmdResult setUnlockedPositionOffsetDegrees(const int16_t value) { return change("setUnlockedPositionOffsetDegrees", [&]() { advancedConfig.unlockedPositionOffsetDegrees = value; }); }
+        Nuki::CmdResult setLockedPositionOffsetDegrees(const int16_t value) { return change("setLockedPositionOffsetDegrees", [&]() { advancedConfig.lockedPositionOffsetDegrees = value; }); }
+        Nuki::CmdResult setSingleLockedPositionOffsetDegrees(const int16_t value) { return change("setSingleLockedPositionOffsetDegrees", [&]() { advancedConfig.singleLockedPositionOffsetDegrees = value; }); }
+        Nuki::CmdResult setUnlockedToLockedTransitionOffsetDegrees(const int16_t value) { return change("setUnlockedToLockedTransitionOffsetDegrees", [&]() { advancedConfig.unlockedToLockedTransitionOffsetDegrees = value; }); }
+        Nuki::CmdResult setLockNgoTimeout(const uint8_t value) { return change("setLockNgoTimeout", [&]() { advancedConfig.lockNgoTimeout = value; }); }
+        Nuki::CmdResult enableDetachedCylinder(const bool enable) { return change("enableDetachedCylinder", [&]() { advancedConfig.detachedCylinder = (uint8_t)enable; }); }
+        Nuki::CmdResult setUnlatchDuration(const uint8_t value) { return change("setUnlatchDuration", [&]() { advancedConfig.unlatchDuration = value; }); }
+        Nuki::CmdResult setAutoLockTimeOut(const uint16_t value) { return change("setAutoLockTimeOut", [&]() { advancedConfig.autoLockTimeOut = value; }); }
+        Nuki::CmdResult disableAutoUnlock(const bool disable) { return change("disableAutoUnlock", [&]() { advancedConfig.autoUnLockDisabled = (uint8_t)disable; }); }
+        Nuki::CmdResult enableAutoLock(const bool enable) { return change("enableAutoLock", [&]() { advancedConfig.autoLockEnabled = (uint8_t)enable; }); }
+        Nuki::CmdResult enableImmediateAutoLock(const bool enable) { return change("enableImmediateAutoLock", [&]() { advancedConfig.immediateAutoLockEnabled = (uint8_t)enable; }); }
+        Nuki::CmdResult enableAutoUpdate(const bool enable) { return change("enableAutoUpdate", [&]() { advancedConfig.autoUpdateEnabled = (uint8_t)enable; }); }
+        Nuki::CmdResult enableNightMode(const bool enable) { return change("enableNightMode", [&]() { advancedConfig.nightModeEnabled = (uint8_t)enable; }); }
+        Nuki::CmdResult setNightModeStartTime(const unsigned char value[2]) { return setTime("setNightModeStartTime", advancedConfig.nightModeStartTime, value); }
+        Nuki::CmdResult setNightModeEndTime(const unsigned char value[2]) { return setTime("setNightModeEndTime", advancedConfig.nightModeEndTime, value); }
+        Nuki::CmdResult enableNightModeAutoLock(const bool enable) { return change("enableNightModeAutoLock", [&]() { advancedConfig.nightModeAutoLockEnabled = (uint8_t)enable; }); }
+        Nuki::CmdResult disableNightModeAutoUnlock(const bool disable) { return change("disableNightModeAutoUnlock", [&]() { advancedConfig.nightModeAutoUnlockDisabled = (uint8_t)disable; }); }
+        Nuki::CmdResult enableNightModeImmediateLockOnStart(const bool enable) { return change("enableNightModeImmediateLockOnStart", [&]() { advancedConfig.nightModeImmediateLockOnStart = (uint8_t)enable; }); }
+
+        KeyTurnerState keyTurnerState;
+
+    private:
+        Nuki::CmdResult setTime(const char* request, unsigned char (&field)[2], const unsigned char value[2]);
+    };
+}
+
+extern NukiLock::NukiLock* hostNukiLock; // the lock created last, NukiWrapper keeps its own by value
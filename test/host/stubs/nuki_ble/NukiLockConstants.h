@@ -0,0 +1,662 @@
+#pragma once
+
+// Host stand-in for the smart lock constants and data types of NukiBleEsp32, only what src/ uses
+
+#include <cstdint>
+#include <cstring>
+#include "NukiConstants.h"
+
+namespace NukiLock
+{
+    using Nuki::DoorSensorState;
+
+    enum class LockAction : uint8_t
+    {
+        Unlock = 0x01,
+        Lock = 0x02,
+        Unlatch = 0x03,
+        LockNgo = 0x04,
+        LockNgoUnlatch = 0x05,
+        FullLock = 0x06,
+        FobAction1 = 0x81,
+        FobAction2 = 0x82,
+        FobAction3 = 0x83
+    };
+
+    enum class LockState : uint8_t
+    {
+        Uncalibrated = 0x00,
+        Locked = 0x01,
+        Unlocking = 0x02,
+        Unlocked = 0x03,
+        Locking = 0x04,
+        Unlatched = 0x05,
+        UnlockedLnga = 0x06,
+        Unlatching = 0x07,
+        Calibration = 0xFC,
+        BootRun = 0xFD,
+        MotorBlocked = 0xFE,
+        Undefined = 0xFF
+    };
+
+    enum class State : uint8_t
+    {
+        Uninitialized = 0x00,
+        PairingMode = 0x01,
+        DoorMode = 0x02,
+        MaintenanceMode = 0x04
+    };
+
+    enum class Trigger : uint8_t
+    {
+        System = 0x00,
+        Manual = 0x01,
+        Button = 0x02,
+        Automatic = 0x03,
+        AutoLock = 0x06,
+        HomeKit = 0xAB,
+        MQTT = 0xAC,
+        Undefined = 0xFF
+    };
+
+    enum class CompletionStatus : uint8_t
+    {
+        Success = 0x00,
+        MotorBlocked = 0x01,
+        Canceled = 0x02,
+        TooRecent = 0x03,
+        Busy = 0x04,
+        LowMotorVoltage = 0x05,
+        ClutchFailure = 0x06,
+        MotorPowerFailure = 0x07,
+        IncompleteFailure = 0x08,
+        OtherError = 0xFE,
+        Unknown = 0xFF
+    };
+
+    enum class ButtonPressAction : uint8_t
+    {
+        NoAction = 0x00,
+        Intelligent = 0x01,
+        Unlock = 0x02,
+        Lock = 0x03,
+        Unlatch = 0x04,
+        LockNgo = 0x05,
+        ShowStatus = 0x06
+    };
+
+    enum class LoggingType : uint8_t
+    {
+        LoggingEnabled = 0x01,
+        LockAction = 0x02,
+        Calibration = 0x03,
+        InitializationRun = 0x04,
+        KeypadAction = 0x05,
+        DoorSensor = 0x06,
+        DoorSensorLoggingEnabled = 0x07
+    };
+
+    struct __attribute__((packed)) KeyTurnerState
+    {
+        State nukiState = State::Uninitialized;
+        LockState lockState = LockState::Undefined;
+        Trigger trigger = Trigger::Undefined;
+        uint16_t currentTimeYear = 0;
+        uint8_t currentTimeMonth = 0;
+        uint8_t currentTimeDay = 0;
+        uint8_t currentTimeHour = 0;
+        uint8_t currentTimeMinute = 0;
+        uint8_t currentTimeSecond = 0;
+        int16_t timeZoneOffset = 0;
+        uint8_t criticalBatteryState = 0;
+        uint8_t configUpdateCount = 0;
+        uint8_t lockNgoTimer = 0;
+        LockAction lastLockAction = LockAction::Unlock;
+        Trigger lastLockActionTrigger = Trigger::Undefined;
+        CompletionStatus lastLockActionCompletionStatus = CompletionStatus::Unknown;
+        DoorSensorState doorSensorState = DoorSensorState::Unavailable;
+        uint16_t nightModeActive = 0;
+        uint8_t accessoryBatteryState = 0;
+    };
+
+    struct __attribute__((packed)) BatteryReport
+    {
+        uint16_t batteryDrain;
+        uint16_t batteryVoltage;
+        uint8_t criticalBatteryState;
+        LockAction lockAction;
+        uint16_t startVoltage;
+        uint16_t lowestVoltage;
+        uint16_t lockDistance;
+        int8_t startTemperature;
+        uint16_t maxTurnCurrent;
+        uint16_t batteryResistance;
+    };
+
+    struct __attribute__((packed)) Config
+    {
+        uint32_t nukiId;
+        char name[32];
+        float latitude;
+        float longitude;
+        uint8_t autoUnlatch;
+        uint8_t pairingEnabled;
+        uint8_t buttonEnabled;
+        uint8_t ledEnabled;
+        uint8_t ledBrightness;
+        uint16_t currentTimeYear;
+        uint8_t currentTimeMonth;
+        uint8_t currentTimeDay;
+        uint8_t currentTimeHour;
+        uint8_t currentTimeMinute;
+        uint8_t currentTimeSecond;
+        int16_t timeZoneOffset;
+        uint8_t dstMode;
+        uint8_t hasFob;
+        uint8_t fobAction1;
+        uint8_t fobAction2;
+        uint8_t fobAction3;
+        uint8_t singleLock;
+        Nuki::AdvertisingMode advertisingMode;
+        uint8_t hasKeypad;
+        unsigned char firmwareVersion[3];
+        unsigned char hardwareRevision[2];
+        uint8_t homeKitStatus;
+        Nuki::TimeZoneId timeZoneId;
+        uint8_t deviceType;
+        uint8_t wifiCapable;
+        uint8_t hasKeypadV2;
+    };
+
+    struct __attribute__((packed)) AdvancedConfig
+    {
+        uint16_t totalDegrees;
+        int16_t unlockedPositionOffsetDegrees;
+        int16_t lockedPositionOffsetDegrees;
+        int16_t singleLockedPositionOffsetDegrees;
+        int16_t unlockedToLockedTransitionOffsetDegrees;
+        uint8_t lockNgoTimeout;
+        ButtonPressAction singleButtonPressAction;
+        ButtonPressAction doubleButtonPressAction;
+        uint8_t detachedCylinder;
+        Nuki::BatteryType batteryType;
+        uint8_t automaticBatteryTypeDetection;
+        uint8_t unlatchDuration;
+        uint16_t autoLockTimeOut;
+        uint8_t autoUnLockDisabled;
+        uint8_t nightModeEnabled;
+        unsigned char nightModeStartTime[2];
+        unsigned char nightModeEndTime[2];
+        int16_t nightModeTimeZoneOffset;
+        uint8_t nightModeAutoLockEnabled;
+        uint8_t nightModeAutoUnlockDisabled;
+        uint8_t nightModeImmediateLockOnStart;
+        uint8_t autoLockEnabled;
+        uint8_t immediateAutoLockEnabled;
+        uint8_t autoUpdateEnabled;
+    };
+
+    struct __attribute__((packed)) LogEntry
+    {
+        uint32_t index;
+        uint16_t timeStampYear;
+        uint8_t timeStampMonth;
+        uint8_t timeStampDay;
+        uint8_t timeStampHour;
+        uint8_t timeStampMinute;
+        uint8_t timeStampSecond;
+        uint32_t authId;
+        uint8_t name[32];
+        LoggingType loggingType;
+        uint8_t data[5];
+    };
+
+    struct __attribute__((packed)) KeypadEntry
+    {
+        uint16_t codeId;
+        uint32_t code;
+        uint8_t name[20];
+        uint8_t enabled;
+        uint16_t dateCreatedYear;
+        uint8_t dateCreatedMonth;
+        uint8_t dateCreatedDay;
+        uint8_t dateCreatedHour;
+        uint8_t dateCreatedMin;
+        uint8_t dateCreatedSec;
+        uint16_t dateLastActiveYear;
+        uint8_t dateLastActiveMonth;
+        uint8_t dateLastActiveDay;
+        uint8_t dateLastActiveHour;
+        uint8_t dateLastActiveMin;
+        uint8_t dateLastActiveSec;
+        uint16_t lockCount;
+        uint8_t timeLimited;
+        uint16_t allowedFromYear;
+        uint8_t allowedFromMonth;
+        uint8_t allowedFromDay;
+        uint8_t allowedFromHour;
+        uint8_t allowedFromMin;
+        uint8_t allowedFromSec;
+        uint16_t allowedUntilYear;
+        uint8_t allowedUntilMonth;
+        uint8_t allowedUntilDay;
+        uint8_t allowedUntilHour;
+        uint8_t allowedUntilMin;
+        uint8_t allowedUntilSec;
+        uint8_t allowedWeekdays;
+        uint8_t allowedFromTimeHour;
+        uint8_t allowedFromTimeMin;
+        uint8_t allowedUntilTimeHour;
+        uint8_t allowedUntilTimeMin;
+    };
+
+    struct __attribute__((packed)) NewKeypadEntry
+    {
+        uint32_t code;
+        uint8_t name[20];
+        uint8_t timeLimited;
+        uint16_t allowedFromYear;
+        uint8_t allowedFromMonth;
+        uint8_t allowedFromDay;
+        uint8_t allowedFromHour;
+        uint8_t allowedFromMin;
+        uint8_t allowedFromSec;
+        uint16_t allowedUntilYear;
+        uint8_t allowedUntilMonth;
+        uint8_t allowedUntilDay;
+        uint8_t allowedUntilHour;
+        uint8_t allowedUntilMin;
+        uint8_t allowedUntilSec;
+        uint8_t allowedWeekdays;
+        uint8_t allowedFromTimeHour;
+        uint8_t allowedFromTimeMin;
+        uint8_t allowedUntilTimeHour;
+        uint8_t allowedUntilTimeMin;
+    };
+
+    struct __attribute__((packed)) UpdatedKeypadEntry
+    {
+        uint16_t codeId;
+        uint32_t code;
+        uint8_t name[20];
+        uint8_t enabled;
+        uint8_t timeLimited;
+        uint16_t allowedFromYear;
+        uint8_t allowedFromMonth;
+        uint8_t allowedFromDay;
+        uint8_t allowedFromHour;
+        uint8_t allowedFromMin;
+        uint8_t allowedFromSec;
+        uint16_t allowedUntilYear;
+        uint8_t allowedUntilMonth;
+        uint8_t allowedUntilDay;
+        uint8_t allowedUntilHour;
+        uint8_t allowedUntilMin;
+        uint8_t allowedUntilSec;
+        uint8_t allowedWeekdays;
+        uint8_t allowedFromTimeHour;
+        uint8_t allowedFromTimeMin;
+        uint8_t allowedUntilTimeHour;
+        uint8_t allowedUntilTimeMin;
+    };
+
+    struct __attribute__((packed)) TimeControlEntry
+    {
+        uint8_t entryId;
+        uint8_t enabled;
+        uint8_t weekdays;
+        uint8_t timeHour;
+        uint8_t timeMin;
+        LockAction lockAction;
+    };
+
+    struct __attribute__((packed)) NewTimeControlEntry
+    {
+        uint8_t weekdays;
+        uint8_t timeHour;
+        uint8_t timeMin;
+        LockAction lockAction;
+    };
+
+    struct __attribute__((packed)) AuthorizationEntry
+    {
+        uint32_t authId;
+        uint8_t idType;
+        uint8_t name[32];
+        uint8_t enabled;
+        uint8_t remoteAllowed;
+        uint16_t createdYear;
+        uint8_t createdMonth;
+        uint8_t createdDay;
+        uint8_t createdHour;
+        uint8_t createdMinute;
+        uint8_t createdSecond;
+        uint16_t lastActYear;
+        uint8_t lastActMonth;
+        uint8_t lastActDay;
+        uint8_t lastActHour;
+        uint8_t lastActMinute;
+        uint8_t lastActSecond;
+        uint16_t lockCount;
+        uint8_t timeLimited;
+        uint16_t allowedFromYear;
+        uint8_t allowedFromMonth;
+        uint8_t allowedFromDay;
+        uint8_t allowedFromHour;
+        uint8_t allowedFromMinute;
+        uint8_t allowedFromSecond;
+        uint16_t allowedUntilYear;
+        uint8_t allowedUntilMonth;
+        uint8_t allowedUntilDay;
+        uint8_t allowedUntilHour;
+        uint8_t allowedUntilMinute;
+        uint8_t allowedUntilSecond;
+        uint8_t allowedWeekdays;
+        uint8_t allowedFromTimeHour;
+        uint8_t allowedFromTimeMin;
+        uint8_t allowedUntilTimeHour;
+        uint8_t allowedUntilTimeMin;
+    };
+
+    struct __attribute__((packed)) NewAuthorizationEntry
+    {
+        uint8_t name[32];
+        uint8_t idType;
+        uint8_t sharedKey[32];
+        uint8_t remoteAllowed;
+        uint8_t timeLimited;
+        uint16_t allowedFromYear;
+        uint8_t allowedFromMonth;
+        uint8_t allowedFromDay;
+        uint8_t allowedFromHour;
+        uint8_t allowedFromMinute;
+        uint8_t allowedFromSecond;
+        uint16_t allowedUntilYear;
+        uint8_t allowedUntilMonth;
+        uint8_t allowedUntilDay;
+        uint8_t allowedUntilHour;
+        uint8_t allowedUntilMinute;
+        uint8_t allowedUntilSecond;
+        uint8_t allowedWeekdays;
+        uint8_t allowedFromTimeHour;
+        uint8_t allowedFromTimeMin;
+        uint8_t allowedUntilTimeHour;
+        uint8_t allowedUntilTimeMin;
+    };
+
+    struct __attribute__((packed)) UpdatedAuthorizationEntry
+    {
+        uint32_t authId;
+        uint8_t name[32];
+        uint8_t enabled;
+        uint8_t remoteAllowed;
+        uint8_t timeLimited;
+        uint16_t allowedFromYear;
+        uint8_t allowedFromMonth;
+        uint8_t allowedFromDay;
+        uint8_t allowedFromHour;
+        uint8_t allowedFromMinute;
+        uint8_t allowedFromSecond;
+        uint16_t allowedUntilYear;
+        uint8_t allowedUntilMonth;
+        uint8_t allowedUntilDay;
+        uint8_t allowedUntilHour;
+        uint8_t allowedUntilMinute;
+        uint8_t allowedUntilSecond;
+        uint8_t allowedWeekdays;
+        uint8_t allowedFromTimeHour;
+        uint8_t allowedFromTimeMin;
+        uint8_t allowedUntilTimeHour;
+        uint8_t allowedUntilTimeMin;
+    };
+
+    inline void cmdResultToString(const Nuki::CmdResult value, char* str)
+    {
+        switch(value)
+        {
+            case Nuki::CmdResult::Success:
+                strcpy(str, "success");
+                break;
+            case Nuki::CmdResult::Failed:
+                strcpy(str, "failed");
+                break;
+            case Nuki::CmdResult::TimeOut:
+                strcpy(str, "timeOut");
+                break;
+            case Nuki::CmdResult::Working:
+                strcpy(str, "working");
+                break;
+            case Nuki::CmdResult::NotPaired:
+                strcpy(str, "notPaired");
+                break;
+            case Nuki::CmdResult::Lock_Busy:
+                strcpy(str, "lockBusy");
+                break;
+            case Nuki::CmdResult::Error:
+                strcpy(str, "error");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void lockactionToString(const LockAction value, char* str)
+    {
+        switch(value)
+        {
+            case LockAction::Unlock:
+                strcpy(str, "Unlock");
+                break;
+            case LockAction::Lock:
+                strcpy(str, "Lock");
+                break;
+            case LockAction::Unlatch:
+                strcpy(str, "Unlatch");
+                break;
+            case LockAction::LockNgo:
+                strcpy(str, "LockNgo");
+                break;
+            case LockAction::LockNgoUnlatch:
+                strcpy(str, "LockNgoUnlatch");
+                break;
+            case LockAction::FullLock:
+                strcpy(str, "FullLock");
+                break;
+            case LockAction::FobAction1:
+                strcpy(str, "FobAction1");
+                break;
+            case LockAction::FobAction2:
+                strcpy(str, "FobAction2");
+                break;
+            case LockAction::FobAction3:
+                strcpy(str, "FobAction3");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void lockstateToString(const LockState value, char* str)
+    {
+        switch(value)
+        {
+            case LockState::Uncalibrated:
+                strcpy(str, "uncalibrated");
+                break;
+            case LockState::Locked:
+                strcpy(str, "locked");
+                break;
+            case LockState::Unlocking:
+                strcpy(str, "unlocking");
+                break;
+            case LockState::Unlocked:
+                strcpy(str, "unlocked");
+                break;
+            case LockState::Locking:
+                strcpy(str, "locking");
+                break;
+            case LockState::Unlatched:
+                strcpy(str, "unlatched");
+                break;
+            case LockState::UnlockedLnga:
+                strcpy(str, "unlockedLnga");
+                break;
+            case LockState::Unlatching:
+                strcpy(str, "unlatching");
+                break;
+            case LockState::Calibration:
+                strcpy(str, "calibration");
+                break;
+            case LockState::BootRun:
+                strcpy(str, "bootRun");
+                break;
+            case LockState::MotorBlocked:
+                strcpy(str, "motorBlocked");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void triggerToString(const Trigger value, char* str)
+    {
+        switch(value)
+        {
+            case Trigger::System:
+                strcpy(str, "system");
+                break;
+            case Trigger::Manual:
+                strcpy(str, "manual");
+                break;
+            case Trigger::Button:
+                strcpy(str, "button");
+                break;
+            case Trigger::Automatic:
+                strcpy(str, "automatic");
+                break;
+            case Trigger::AutoLock:
+                strcpy(str, "autoLock");
+                break;
+            case Trigger::HomeKit:
+                strcpy(str, "homeKit");
+                break;
+            case Trigger::MQTT:
+                strcpy(str, "mqtt");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void completionStatusToString(const CompletionStatus value, char* str)
+    {
+        switch(value)
+        {
+            case CompletionStatus::Success:
+                strcpy(str, "success");
+                break;
+            case CompletionStatus::MotorBlocked:
+                strcpy(str, "motorBlocked");
+                break;
+            case CompletionStatus::Canceled:
+                strcpy(str, "canceled");
+                break;
+            case CompletionStatus::TooRecent:
+                strcpy(str, "tooRecent");
+                break;
+            case CompletionStatus::Busy:
+                strcpy(str, "busy");
+                break;
+            case CompletionStatus::LowMotorVoltage:
+                strcpy(str, "lowMotorVoltage");
+                break;
+            case CompletionStatus::ClutchFailure:
+                strcpy(str, "clutchFailure");
+                break;
+            case CompletionStatus::MotorPowerFailure:
+                strcpy(str, "motorPowerFailure");
+                break;
+            case CompletionStatus::IncompleteFailure:
+                strcpy(str, "incompleteFailure");
+                break;
+            case CompletionStatus::OtherError:
+                strcpy(str, "otherError");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void doorSensorStateToString(const DoorSensorState value, char* str)
+    {
+        switch(value)
+        {
+            case DoorSensorState::Unavailable:
+                strcpy(str, "unavailable");
+                break;
+            case DoorSensorState::Deactivated:
+                strcpy(str, "deactivated");
+                break;
+            case DoorSensorState::DoorClosed:
+                strcpy(str, "doorClosed");
+                break;
+            case DoorSensorState::DoorOpened:
+                strcpy(str, "doorOpened");
+                break;
+            case DoorSensorState::DoorStateUnknown:
+                strcpy(str, "doorStateUnknown");
+                break;
+            case DoorSensorState::Calibrating:
+                strcpy(str, "calibrating");
+                break;
+            case DoorSensorState::Uncalibrated:
+                strcpy(str, "uncalibrated");
+                break;
+            case DoorSensorState::Tampered:
+                strcpy(str, "tampered");
+                break;
+            case DoorSensorState::Unknown:
+                strcpy(str, "unknown");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void loggingTypeToString(const LoggingType value, char* str)
+    {
+        switch(value)
+        {
+            case LoggingType::LoggingEnabled:
+                strcpy(str, "LoggingEnabled");
+                break;
+            case LoggingType::LockAction:
+                strcpy(str, "LockAction");
+                break;
+            case LoggingType::Calibration:
+                strcpy(str, "Calibration");
+                break;
+            case LoggingType::InitializationRun:
+                strcpy(str, "InitializationRun");
+                break;
+            case LoggingType::KeypadAction:
+                strcpy(str, "KeypadAction");
+                break;
+            case LoggingType::DoorSensor:
+                strcpy(str, "DoorSensor");
+                break;
+            case LoggingType::DoorSensorLoggingEnabled:
+                strcpy(str, "DoorSensorLoggingEnabled");
+                break;
+            default:
+                strcpy(str, "Unknown");
+                break;
+        }
+    }
+}
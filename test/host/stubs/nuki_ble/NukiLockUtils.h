@@ -0,0 +1,5 @@
+#pragma once
+
+// The string helpers of the smart lock are declared along with the constants in the host stand-in
+
+#include "NukiLockConstants.h"
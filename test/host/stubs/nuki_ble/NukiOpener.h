@@ -0,0 +1,59 @@
+#pragma once
+
+#include "NukiBle.h"
+#include "NukiOpenerConstants.h"
+
+namespace NukiOpener
+{
+    struct Types
+    {
+        using LogEntry = NukiOpener::LogEntry;
+        using KeypadEntry = NukiOpener::KeypadEntry;
+        using NewKeypadEntry = NukiOpener::NewKeypadEntry;
+        using UpdatedKeypadEntry = NukiOpener::UpdatedKeypadEntry;
+        using AuthorizationEntry = NukiOpener::AuthorizationEntry;
+        using NewAuthorizationEntry = NukiOpener::NewAuthorizationEntry;
+        using UpdatedAuthorizationEntry = NukiOpener::UpdatedAuthorizationEntry;
+        using TimeControlEntry = NukiOpener::TimeControlEntry;
+        using NewTimeControlEntry = NukiOpener::NewTimeControlEntry;
+        using LockAction = NukiOpener::LockAction;
+        using LoggingType = NukiOpener::LoggingType;
+        using Config = NukiOpener::Config;
+        using AdvancedConfig = NukiOpener::AdvancedConfig;
+        using BatteryReport = NukiOpener::BatteryReport;
+    };
+
+    // Scripted opener, a lock action moves the state right away and announces it like a beacon would
+    class NukiOpener : public Nuki::ScriptedDevice<Types>
+    {
+    public:
+        NukiOpener(const std::string& deviceName, const uint32_t deviceId);
+
+        Nuki::CmdResult lockAction(const LockAction lockAction, const uint32_t nukiAppId = 1, const uint8_t flags = 0,
+                                   const char* nameSuffix = nullptr, const uint8_t nameSuffixLen = 0);
+        Nuki::CmdResult requestOpenerState(OpenerState* out) { return read("requestOpenerState", openerState, out); }
+
+        Nuki::CmdResult enableLedFlash(const bool enable) { return change("enableLedFlash", [&]() { config.ledFlashEnabled = (uint8_t)enable; }); }
+        Nuki::CmdResult setOperatingMode(const uint8_t value) { return change("setOperatingMode", [&]() { config.operatingMode = value; }); }
+        Nuki::CmdResult setIntercomID(const uint16_t value) { return change("setIntercomID", [&]() { advancedConfig.intercomID = value; }); }
+        Nuki::CmdResult setBusModeSwitch(const bool value) { return change("setBusModeSwitch", [&]() { advancedConfig.busModeSwitch = (uint8_t)value; }); }
+        Nuki::CmdResult setShortCircuitDuration(const uint16_t value) { return change("setShortCircuitDuration", [&]() { advancedConfig.shortCircuitDuration = value; }); }
+        Nuki::CmdResult setElectricStrikeDelay(const uint16_t value) { return change("setElectricStrikeDelay", [&]() { advancedConfig.electricStrikeDelay = value; }); }
+        Nuki::CmdResult enableRandomElectricStrikeDelay(const bool enable) { return change("enableRandomElectricStrikeDelay", [&]() { advancedConfig.randomElectricStrikeDelay = (uint8_t)enable; }); }
+        Nuki::CmdResult setElectricStrikeDuration(const uint16_t value) { return change("setElectricStrikeDuration", [&]() { advancedConfig.electricStrikeDuration = value; }); }
+        Nuki::CmdResult disableRtoAfterRing(const bool disable) { return change("disableRtoAfterRing", [&]() { advancedConfig.disableRtoAfterRing = (uint8_t)disable; }); }
+        Nuki::CmdResult setRtoTimeout(const uint8_t value) { return change("setRtoTimeout", [&]() { advancedConfig.rtoTimeout = value; }); }
+        Nuki::CmdResult setDoorbellSuppression(const uint8_t value) { return change("setDoorbellSuppression", [&]() { advancedConfig.doorbellSuppression = value; }); }
+        Nuki::CmdResult setDoorbellSuppressionDuration(const uint16_t value) { return change("setDoorbellSuppressionDuration", [&]() { advancedConfig.doorbellSuppressionDuration = value; }); }
+        Nuki::CmdResult setSoundRing(const uint8_t value) { return change("setSoundRing", [&]() { advancedConfig.soundRing = value; }); }
+        Nuki::CmdResult setSoundOpen(const uint8_t value) { return change("setSoundOpen", [&]() { advancedConfig.soundOpen = value; }); }
+        Nuki::CmdResult setSoundRto(const uint8_t value) { return change("setSoundRto", [&]() { advancedConfig.soundRto = value; }); }
+        Nuki::CmdResult setSoundCm(const uint8_t value) { return change("setSoundCm", [&]() { advancedConfig.soundCm = value; }); }
+        Nuki::CmdResult enableSoundConfirmation(const bool enable) { return change("enableSoundConfirmation", [&]() { advancedConfig.soundConfirmation = (uint8_t)enable; }); }
+        Nuki::CmdResult setSoundLevel(const uint8_t value) { return change("setSoundLevel", [&]() { advancedConfig.soundLevel = value; }); }
+
+        OpenerState openerState;
+    };
+}
+
+extern NukiOpener::NukiOpener* hostNukiOpener; // the opener created last
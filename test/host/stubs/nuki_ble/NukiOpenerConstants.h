@@ -0,0 +1,437 @@
+#pragma once
+
+// Host stand-in for the opener constants and data types of NukiBleEsp32, only what src/ uses
+
+#include <cstdint>
+#include <cstring>
+#include "NukiConstants.h"
+#include "NukiLockConstants.h"
+
+namespace NukiOpener
+{
+    using Nuki::DoorSensorState;
+    using Nuki::EventType;
+    using Nuki::PairingResult;
+    using Nuki::SmartlockEventHandler;
+
+    // Keypad codes and authorizations are the same for both devices
+    using NukiLock::KeypadEntry;
+    using NukiLock::NewKeypadEntry;
+    using NukiLock::UpdatedKeypadEntry;
+    using NukiLock::AuthorizationEntry;
+    using NukiLock::NewAuthorizationEntry;
+    using NukiLock::UpdatedAuthorizationEntry;
+
+    enum class LockAction : uint8_t
+    {
+        ActivateRTO = 0x01,
+        DeactivateRTO = 0x02,
+        ElectricStrikeActuation = 0x03,
+        ActivateCM = 0x04,
+        DeactivateCM = 0x05,
+        FobAction1 = 0x81,
+        FobAction2 = 0x82,
+        FobAction3 = 0x83
+    };
+
+    enum class LockState : uint8_t
+    {
+        Uncalibrated = 0x00,
+        Locked = 0x01,
+        RTOactive = 0x03,
+        Open = 0x05,
+        Opening = 0x07,
+        BootRun = 0xFD,
+        Undefined = 0xFF
+    };
+
+    enum class State : uint8_t
+    {
+        Uninitialized = 0x00,
+        PairingMode = 0x01,
+        DoorMode = 0x02,
+        ContinuousMode = 0x03,
+        MaintenanceMode = 0x04
+    };
+
+    enum class Trigger : uint8_t
+    {
+        System = 0x00,
+        Manual = 0x01,
+        Button = 0x02,
+        Automatic = 0x03,
+        AutoLock = 0x06,
+        HomeKit = 0xAB,
+        MQTT = 0xAC,
+        Undefined = 0xFF
+    };
+
+    enum class CompletionStatus : uint8_t
+    {
+        Success = 0x00,
+        Canceled = 0x02,
+        TooRecent = 0x03,
+        Busy = 0x04,
+        Incomplete = 0x08,
+        OtherError = 0xFE,
+        Unknown = 0xFF
+    };
+
+    enum class ButtonPressAction : uint8_t
+    {
+        NoAction = 0x00,
+        ToggleRTO = 0x01,
+        ActivateRTO = 0x02,
+        DeactivateRTO = 0x03,
+        ToggleCM = 0x04,
+        ActivateCM = 0x05,
+        DectivateCM = 0x06,
+        Open = 0x07
+    };
+
+    enum class LoggingType : uint8_t
+    {
+        LoggingEnabled = 0x01,
+        LockAction = 0x02,
+        Calibration = 0x03,
+        InitializationRun = 0x04,
+        KeypadAction = 0x05,
+        DoorbellRecognition = 0x06
+    };
+
+    struct __attribute__((packed)) OpenerState
+    {
+        State nukiState = State::Uninitialized;
+        LockState lockState = LockState::Undefined;
+        Trigger trigger = Trigger::Undefined;
+        uint16_t currentTimeYear = 0;
+        uint8_t currentTimeMonth = 0;
+        uint8_t currentTimeDay = 0;
+        uint8_t currentTimeHour = 0;
+        uint8_t currentTimeMinute = 0;
+        uint8_t currentTimeSecond = 0;
+        int16_t timeZoneOffset = 0;
+        uint8_t criticalBatteryState = 0;
+        uint8_t configUpdateCount = 0;
+        uint8_t ringToOpenTimer = 0;
+        LockAction lastLockAction = LockAction::ActivateRTO;
+        Trigger lastLockActionTrigger = Trigger::Undefined;
+        CompletionStatus lastLockActionCompletionStatus = CompletionStatus::Unknown;
+        DoorSensorState doorSensorState = DoorSensorState::Unavailable;
+    };
+
+    struct __attribute__((packed)) BatteryReport
+    {
+        uint16_t batteryDrain;
+        uint16_t batteryVoltage;
+        uint8_t criticalBatteryState;
+        LockAction lockAction;
+        uint16_t startVoltage;
+        uint16_t lowestVoltage;
+    };
+
+    struct __attribute__((packed)) Config
+    {
+        uint32_t nukiId;
+        char name[32];
+        float latitude;
+        float longitude;
+        uint8_t capabilities;
+        uint8_t pairingEnabled;
+        uint8_t buttonEnabled;
+        uint8_t ledFlashEnabled;
+        uint16_t currentTimeYear;
+        uint8_t currentTimeMonth;
+        uint8_t currentTimeDay;
+        uint8_t currentTimeHour;
+        uint8_t currentTimeMinute;
+        uint8_t currentTimeSecond;
+        int16_t timeZoneOffset;
+        uint8_t dstMode;
+        uint8_t hasFob;
+        uint8_t fobAction1;
+        uint8_t fobAction2;
+        uint8_t fobAction3;
+        uint8_t operatingMode;
+        Nuki::AdvertisingMode advertisingMode;
+        uint8_t hasKeypad;
+        unsigned char firmwareVersion[3];
+        unsigned char hardwareRevision[2];
+        Nuki::TimeZoneId timeZoneId;
+        uint8_t hasKeypadV2;
+    };
+
+    struct __attribute__((packed)) AdvancedConfig
+    {
+        uint16_t intercomID;
+        uint8_t busModeSwitch;
+        uint16_t shortCircuitDuration;
+        uint16_t electricStrikeDelay;
+        uint8_t randomElectricStrikeDelay;
+        uint16_t electricStrikeDuration;
+        uint8_t disableRtoAfterRing;
+        uint8_t rtoTimeout;
+        uint8_t doorbellSuppression;
+        uint16_t doorbellSuppressionDuration;
+        uint8_t soundRing;
+        uint8_t soundOpen;
+        uint8_t soundRto;
+        uint8_t soundCm;
+        uint8_t soundConfirmation;
+        uint8_t soundLevel;
+        ButtonPressAction singleButtonPressAction;
+        ButtonPressAction doubleButtonPressAction;
+        Nuki::BatteryType batteryType;
+        uint8_t automaticBatteryTypeDetection;
+    };
+
+    struct __attribute__((packed)) LogEntry
+    {
+        uint32_t index;
+        uint16_t timeStampYear;
+        uint8_t timeStampMonth;
+        uint8_t timeStampDay;
+        uint8_t timeStampHour;
+        uint8_t timeStampMinute;
+        uint8_t timeStampSecond;
+        uint32_t authId;
+        uint8_t name[32];
+        LoggingType loggingType;
+        uint8_t data[5];
+    };
+
+    struct __attribute__((packed)) TimeControlEntry
+    {
+        uint8_t entryId;
+        uint8_t enabled;
+        uint8_t weekdays;
+        uint8_t timeHour;
+        uint8_t timeMin;
+        LockAction lockAction;
+    };
+
+    struct __attribute__((packed)) NewTimeControlEntry
+    {
+        uint8_t weekdays;
+        uint8_t timeHour;
+        uint8_t timeMin;
+        LockAction lockAction;
+    };
+
+    inline void cmdResultToString(const Nuki::CmdResult value, char* str)
+    {
+        switch(value)
+        {
+            case Nuki::CmdResult::Success:
+                strcpy(str, "success");
+                break;
+            case Nuki::CmdResult::Failed:
+                strcpy(str, "failed");
+                break;
+            case Nuki::CmdResult::TimeOut:
+                strcpy(str, "timeOut");
+                break;
+            case Nuki::CmdResult::Working:
+                strcpy(str, "working");
+                break;
+            case Nuki::CmdResult::NotPaired:
+                strcpy(str, "notPaired");
+                break;
+            case Nuki::CmdResult::Lock_Busy:
+                strcpy(str, "lockBusy");
+                break;
+            case Nuki::CmdResult::Error:
+                strcpy(str, "error");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void lockactionToString(const LockAction value, char* str)
+    {
+        switch(value)
+        {
+            case LockAction::ActivateRTO:
+                strcpy(str, "ActivateRTO");
+                break;
+            case LockAction::DeactivateRTO:
+                strcpy(str, "DeactivateRTO");
+                break;
+            case LockAction::ElectricStrikeActuation:
+                strcpy(str, "ElectricStrikeActuation");
+                break;
+            case LockAction::ActivateCM:
+                strcpy(str, "ActivateCM");
+                break;
+            case LockAction::DeactivateCM:
+                strcpy(str, "DeactivateCM");
+                break;
+            case LockAction::FobAction1:
+                strcpy(str, "FobAction1");
+                break;
+            case LockAction::FobAction2:
+                strcpy(str, "FobAction2");
+                break;
+            case LockAction::FobAction3:
+                strcpy(str, "FobAction3");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void lockstateToString(const LockState value, char* str)
+    {
+        switch(value)
+        {
+            case LockState::Uncalibrated:
+                strcpy(str, "uncalibrated");
+                break;
+            case LockState::Locked:
+                strcpy(str, "locked");
+                break;
+            case LockState::RTOactive:
+                strcpy(str, "RTOactive");
+                break;
+            case LockState::Open:
+                strcpy(str, "open");
+                break;
+            case LockState::Opening:
+                strcpy(str, "opening");
+                break;
+            case LockState::BootRun:
+                strcpy(str, "bootRun");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void triggerToString(const Trigger value, char* str)
+    {
+        switch(value)
+        {
+            case Trigger::System:
+                strcpy(str, "system");
+                break;
+            case Trigger::Manual:
+                strcpy(str, "manual");
+                break;
+            case Trigger::Button:
+                strcpy(str, "button");
+                break;
+            case Trigger::Automatic:
+                strcpy(str, "automatic");
+                break;
+            case Trigger::AutoLock:
+                strcpy(str, "autoLock");
+                break;
+            case Trigger::HomeKit:
+                strcpy(str, "homeKit");
+                break;
+            case Trigger::MQTT:
+                strcpy(str, "mqtt");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void completionStatusToString(const CompletionStatus value, char* str)
+    {
+        switch(value)
+        {
+            case CompletionStatus::Success:
+                strcpy(str, "success");
+                break;
+            case CompletionStatus::Canceled:
+                strcpy(str, "canceled");
+                break;
+            case CompletionStatus::TooRecent:
+                strcpy(str, "tooRecent");
+                break;
+            case CompletionStatus::Busy:
+                strcpy(str, "busy");
+                break;
+            case CompletionStatus::Incomplete:
+                strcpy(str, "incomplete");
+                break;
+            case CompletionStatus::OtherError:
+                strcpy(str, "otherError");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void doorSensorStateToString(const DoorSensorState value, char* str)
+    {
+        switch(value)
+        {
+            case DoorSensorState::Unavailable:
+                strcpy(str, "unavailable");
+                break;
+            case DoorSensorState::Deactivated:
+                strcpy(str, "deactivated");
+                break;
+            case DoorSensorState::DoorClosed:
+                strcpy(str, "doorClosed");
+                break;
+            case DoorSensorState::DoorOpened:
+                strcpy(str, "doorOpened");
+                break;
+            case DoorSensorState::DoorStateUnknown:
+                strcpy(str, "doorStateUnknown");
+                break;
+            case DoorSensorState::Calibrating:
+                strcpy(str, "calibrating");
+                break;
+            case DoorSensorState::Uncalibrated:
+                strcpy(str, "uncalibrated");
+                break;
+            case DoorSensorState::Tampered:
+                strcpy(str, "tampered");
+                break;
+            case DoorSensorState::Unknown:
+                strcpy(str, "unknown");
+                break;
+            default:
+                strcpy(str, "undefined");
+                break;
+        }
+    }
+
+    inline void loggingTypeToString(const LoggingType value, char* str)
+    {
+        switch(value)
+        {
+            case LoggingType::LoggingEnabled:
+                strcpy(str, "LoggingEnabled");
+                break;
+            case LoggingType::LockAction:
+                strcpy(str, "LockAction");
+                break;
+            case LoggingType::Calibration:
+                strcpy(str, "Calibration");
+                break;
+            case LoggingType::InitializationRun:
+                strcpy(str, "InitializationRun");
+                break;
+            case LoggingType::KeypadAction:
+                strcpy(str, "KeypadAction");
+                break;
+            case LoggingType::DoorbellRecognition:
+                strcpy(str, "DoorbellRecognition");
+                break;
+            default:
+                strcpy(str, "Unknown");
+                break;
+        }
+    }
+}
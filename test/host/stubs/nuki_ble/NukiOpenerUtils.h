@@ -0,0 +1,5 @@
+#pragma once
+
+// The string helpers of the opener are declared along with the constants in the host stand-in
+
+#include "NukiOpenerConstants.h"
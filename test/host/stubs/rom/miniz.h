@@ -0,0 +1,71 @@
+#pragma once
+
+// The tinfl API of the ESP32 ROM implemented on top of the host zlib. The inflate state is released when the
+// stream ends or fails, a decompressor abandoned in between leaks it, which is fine for the tests.
+
+#include <cstdint>
+#include <cstddef>
+#include <zlib.h>
+
+typedef uint8_t mz_uint8;
+typedef uint32_t mz_uint32;
+
+#define TINFL_LZ_DICT_SIZE 32768
+#define TINFL_FLAG_PARSE_ZLIB_HEADER 1
+#define TINFL_FLAG_HAS_MORE_INPUT 2
+
+enum tinfl_status
+{
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2
+};
+
+struct tinfl_decompressor
+{
+    z_stream stream;
+    bool initialized;
+    bool finished;
+    tinfl_status finalStatus;
+};
+
+#define tinfl_init(r) do { (r)->initialized = false; (r)->finished = false; } while(0)
+
+inline tinfl_status tinfl_decompress(tinfl_decompressor* r, const mz_uint8* in, size_t* inSize, mz_uint8*, mz_uint8* out, size_t* outSize, const mz_uint32 flags)
+{
+    if(r->finished)
+    {
+        *inSize = 0;
+        *outSize = 0;
+        return r->finalStatus;
+    }
+
+    if(!r->initialized)
+    {
+        r->stream = z_stream();
+        const int windowBits = (flags & TINFL_FLAG_PARSE_ZLIB_HEADER) ? 15 : -15;
+        if(inflateInit2(&r->stream, windowBits) != Z_OK) return TINFL_STATUS_FAILED;
+        r->initialized = true;
+    }
+
+    r->stream.next_in = const_cast<mz_uint8*>(in);
+    r->stream.avail_in = (uInt)*inSize;
+    r->stream.next_out = out;
+    r->stream.avail_out = (uInt)*outSize;
+
+    const int ret = inflate(&r->stream, Z_NO_FLUSH);
+
+    *inSize -= r->stream.avail_in;
+    *outSize -= r->stream.avail_out;
+
+    if(ret == Z_STREAM_END || (ret < 0 && ret != Z_BUF_ERROR))
+    {
+        inflateEnd(&r->stream);
+        r->finished = true;
+        r->finalStatus = ret == Z_STREAM_END ? TINFL_STATUS_DONE : TINFL_STATUS_FAILED;
+        return r->finalStatus;
+    }
+
+    return r->stream.avail_out == 0 ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+}
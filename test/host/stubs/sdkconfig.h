@@ -0,0 +1,3 @@
+#pragma once
+
+// Host build, none of the ESP32 targets in src/Config.h is selected
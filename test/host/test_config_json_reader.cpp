@@ -0,0 +1,87 @@
+#include "HostTest.h"
+#include "ConfigJsonReader.h"
+#include <vector>
+
+namespace
+{
+    std::vector<String> readChunked(const char* document, const size_t chunkSize, ConfigJsonReader& reader)
+    {
+        std::vector<String> members;
+        const size_t length = strlen(document);
+
+        for(size_t offset = 0; offset < length; offset += chunkSize)
+        {
+            reader.feed(document + offset, std::min(chunkSize, length - offset), [&members](const String& key, const String& value, const bool isNull)
+            {
+                members.push_back(key + "=" + (isNull ? String("<null>") : value));
+            });
+        }
+
+        return members;
+    }
+
+    void testChunkBoundaries()
+    {
+        const char* document = "\xef\xbb\xbf{\n  \"a\": \"x\\\"y\\n\\u00e9\",\n  \"b\": 12,\n  \"c\": null, \"d\": true, \"e\": \"\"\n}\n";
+
+        // Every chunk size splits escapes, literals and the BOM at a different position
+        for(size_t chunkSize = 1; chunkSize <= strlen(document); chunkSize++)
+        {
+            ConfigJsonReader reader(100);
+            std::vector<String> members = readChunked(document, chunkSize, reader);
+
+            CHECK(reader.complete());
+            CHECK(!reader.error());
+            CHECK(members.size() == 5);
+            if(members.size() != 5) continue;
+            CHECK(members[0] == "a=x\"y\n\xc3\xa9");
+            CHECK(members[1] == "b=12");
+            CHECK(members[2] == "c=<null>");
+            CHECK(members[3] == "d=true");
+            CHECK(members[4] == "e=");
+        }
+    }
+
+    void testInvalidDocuments()
+    {
+        const char* invalid[] = { "{\"a\":1,}", "{\"a\":{}}", "[1]", "{\"a\" 1}", "{\"a\":1}x", "{\"a\":\"\x01\"}" };
+
+        for(const char* document : invalid)
+        {
+            ConfigJsonReader reader(100);
+            readChunked(document, strlen(document), reader);
+            CHECK(!reader.complete());
+            CHECK(reader.error());
+        }
+    }
+
+    void testIncompleteDocument()
+    {
+        ConfigJsonReader reader(100);
+        std::vector<String> members = readChunked("{\"a\": \"1\", \"b\": \"2", 4, reader);
+
+        CHECK(!reader.complete());
+        CHECK(!reader.error());
+        CHECK(members.size() == 1);
+    }
+
+    void testValueLength()
+    {
+        ConfigJsonReader reader(3);
+        readChunked("{\"a\":\"abcd\"}", 2, reader);
+        CHECK(reader.error());
+
+        ConfigJsonReader empty(3);
+        readChunked("{}", 1, empty);
+        CHECK(empty.complete());
+    }
+}
+
+int main()
+{
+    testChunkBoundaries();
+    testInvalidDocuments();
+    testIncompleteDocument();
+    testValueLength();
+    return HOST_TEST_RESULT();
+}
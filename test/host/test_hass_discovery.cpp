@@ -0,0 +1,181 @@
+#include "HostTest.h"
+#include "HostNetworkDevice.h"
+#include "CharBuffer.h"
+#include "Gpio.h"
+#include "NukiNetwork.h"
+#include "NukiNetworkLock.h"
+#include "NukiNetworkOpener.h"
+#include "NukiOfficial.h"
+#include "PreferencesKeys.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Publishes the discovery of a lock and an opener through NukiNetwork and compares every document that reaches the
+// broker with data/hass_discovery_baseline.txt, one "<topic> <payload>" line per document. The order within one
+// publish doesn't matter to Home Assistant, so each phase is sorted and ends with a "--" line. The baseline was
+// recorded from the publishHassTopic() and JsonDocument based publishers the entity tables replaced.
+// Pass a path to write the documents there instead, to record a new baseline.
+namespace
+{
+    Preferences* preferences = nullptr;
+    NukiNetwork* network = nullptr;
+    NukiNetworkLock* networkLock = nullptr;
+    NukiNetworkOpener* networkOpener = nullptr;
+
+    void setAcl(const uint32_t value)
+    {
+        uint32_t aclPrefs[17];
+        uint32_t basicLockConfigAclPrefs[16];
+        uint32_t advancedLockConfigAclPrefs[22];
+        uint32_t basicOpenerConfigAclPrefs[14];
+        uint32_t advancedOpenerConfigAclPrefs[20];
+
+        for(uint32_t& acl : aclPrefs) acl = value;
+        for(uint32_t& acl : basicLockConfigAclPrefs) acl = value;
+        for(uint32_t& acl : advancedLockConfigAclPrefs) acl = value;
+        for(uint32_t& acl : basicOpenerConfigAclPrefs) acl = value;
+        for(uint32_t& acl : advancedOpenerConfigAclPrefs) acl = value;
+
+        preferences->putBytes(preference_acl, (byte*)(&aclPrefs), sizeof(aclPrefs));
+        preferences->putBytes(preference_conf_lock_basic_acl, (byte*)(&basicLockConfigAclPrefs), sizeof(basicLockConfigAclPrefs));
+        preferences->putBytes(preference_conf_lock_advanced_acl, (byte*)(&advancedLockConfigAclPrefs), sizeof(advancedLockConfigAclPrefs));
+        preferences->putBytes(preference_conf_opener_basic_acl, (byte*)(&basicOpenerConfigAclPrefs), sizeof(basicOpenerConfigAclPrefs));
+        preferences->putBytes(preference_conf_opener_advanced_acl, (byte*)(&advancedOpenerConfigAclPrefs), sizeof(advancedOpenerConfigAclPrefs));
+    }
+
+    void loop()
+    {
+        network->update();
+        hostNetworkDevice->transmit();
+    }
+
+    // Discovery documents are paced by a token bucket, runs the network until nothing was sent for a while
+    void flushDiscovery()
+    {
+        uint32_t handled = network->hassDocumentsSent() + network->hassDocumentsSkipped();
+        int idleLoops = 0;
+
+        while(idleLoops < 30)
+        {
+            loop();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+            const uint32_t current = network->hassDocumentsSent() + network->hassDocumentsSkipped();
+            idleLoops = current == handled ? idleLoops + 1 : 0;
+            handled = current;
+        }
+    }
+
+    void collectDiscovery(std::vector<std::string>& documents)
+    {
+        flushDiscovery();
+
+        std::vector<std::string> phase;
+        for(const HostMqttMessage& message : hostNetworkDevice->published())
+        {
+            if(message.topic.rfind("homeassistant/", 0) == 0) phase.push_back(message.topic + " " + message.payload);
+        }
+        hostNetworkDevice->clearPublished();
+
+        std::sort(phase.begin(), phase.end());
+        documents.insert(documents.end(), phase.begin(), phase.end());
+        documents.push_back("--");
+    }
+
+    void setup()
+    {
+        preferences = new Preferences();
+        initPreferences(preferences);
+        preferences->putString(preference_mqtt_broker, "broker.local");
+        preferences->putString(preference_mqtt_lock_path, "nuki");
+        preferences->putString(preference_mqtt_opener_path, "nukiopener");
+        preferences->putString(preference_mqtt_hass_discovery, "homeassistant");
+        preferences->putBool(preference_mqtt_log_enabled, true);
+        preferences->putBool(preference_official_hybrid_enabled, true);
+        preferences->putBool(preference_check_updates, true);
+        preferences->putBool(preference_update_from_mqtt, true);
+        preferences->putBool(preference_conf_info_enabled, true);
+        setAcl(1);
+
+        CharBuffer::initialize(CHAR_BUFFER_SIZE);
+
+        Gpio* gpio = new Gpio(preferences);
+        network = new NukiNetwork(preferences, gpio, preferences->getString(preference_mqtt_lock_path), CharBuffer::get(), CHAR_BUFFER_SIZE);
+        network->initialize();
+
+        networkLock = new NukiNetworkLock(network, new NukiOfficial(preferences), preferences, new char[CHAR_BUFFER_SIZE], CHAR_BUFFER_SIZE);
+        networkLock->initialize();
+        networkOpener = new NukiNetworkOpener(network, preferences, new char[CHAR_BUFFER_SIZE], CHAR_BUFFER_SIZE);
+        networkOpener->initialize();
+
+        for(int i = 0; i < 3; i++) loop();
+        CHECK(hostNetworkDevice->mqttConnected());
+        hostNetworkDevice->clearPublished();
+    }
+
+    void publishDiscovery(const bool hasAccessories)
+    {
+        networkLock->publishHASSConfig("SmartLock", "nuki", "Front door", "abc123", "4.1.2", "5.0", hasAccessories, hasAccessories, hasAccessories, "lock", "unlock", "unlatch");
+        networkOpener->publishHASSConfig("Opener", "nukiopener", "Entrance", "def456", "1.8.3", "6.0", hasAccessories, hasAccessories, "deactivateRTO", "activateRTO", "electricStrikeActuation");
+    }
+
+    std::vector<std::string> publishAll()
+    {
+        std::vector<std::string> documents;
+
+        // Every optional entity enabled
+        publishDiscovery(true);
+        collectDiscovery(documents);
+
+        // Disabled entities are removed, only the changed documents are sent again
+        preferences->putBool(preference_mqtt_log_enabled, false);
+        preferences->putBool(preference_check_updates, false);
+        network->readSettings();
+        setAcl(0);
+        publishDiscovery(false);
+        collectDiscovery(documents);
+
+        networkLock->removeHASSConfig("abc123");
+        networkOpener->removeHASSConfig("def456");
+        collectDiscovery(documents);
+
+        return documents;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    setup();
+    const std::vector<std::string> documents = publishAll();
+
+    if(argc > 1)
+    {
+        std::ofstream out(argv[1]);
+        for(const std::string& document : documents) out << document << "\n";
+        return 0;
+    }
+
+    std::ifstream baseline(HASS_DISCOVERY_BASELINE);
+    CHECK(baseline.is_open());
+
+    std::string line;
+    size_t index = 0;
+    while(std::getline(baseline, line))
+    {
+        if(index >= documents.size() || documents[index] != line)
+        {
+            fprintf(stderr, "expected: %s\npublished: %s\n", line.c_str(), index < documents.size() ? documents[index].c_str() : "(nothing)");
+            CHECK(false);
+            break;
+        }
+        ++index;
+    }
+    CHECK(index == documents.size());
+    fprintf(stderr, "%zu discovery documents\n", documents.size() - 3);
+
+    return HOST_TEST_RESULT();
+}
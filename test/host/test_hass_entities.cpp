@@ -0,0 +1,78 @@
+#include "HostTest.h"
+#include "HassEntities.h"
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// data/hass_entities_baseline.txt holds the documents of the JsonDocument based createHassJson() that was used
+// before the entity tables, one "<device>/<object id> <json>" line per entity in table order
+namespace
+{
+    const char* availabilityTopic = "nuki/lock/maintenance/mqttConnectionState";
+
+    struct KnownChange
+    {
+        const char* id;
+        const char* baseline;
+        const char* current;
+    };
+
+    // The baseline passed "min" twice where "max" was meant, so the maximum replaced the minimum
+    const KnownChange knownChanges[] =
+    {
+        { "opener/electric_strike_delay", "\"min\":\"30000\"", "\"min\":\"0\",\"max\":\"30000\"" },
+        { "opener/electric_strike_duration", "\"min\":\"30000\"", "\"min\":\"1000\",\"max\":\"30000\"" },
+        { "opener/rto_timeout", "\"min\":\"60\"", "\"min\":\"5\",\"max\":\"60\"" },
+        { "opener/doorbell_suppression_duration", "\"min\":\"10000\"", "\"min\":\"500\",\"max\":\"10000\"" },
+    };
+
+    void applyKnownChanges(const std::string& id, std::string& line)
+    {
+        for(const KnownChange& change : knownChanges)
+        {
+            if(id != change.id) continue;
+
+            const size_t pos = line.find(change.baseline);
+            CHECK(pos != std::string::npos);
+            if(pos != std::string::npos) line.replace(pos, strlen(change.baseline), change.current);
+        }
+    }
+
+    void compare(std::ifstream& baseline, const char* device, const HassEntity* entities, const size_t count,
+                 const char* deviceType, const char* baseTopic, const char* name)
+    {
+        char buffer[2048];
+
+        for(size_t i = 0; i < count; i++)
+        {
+            std::string line;
+            CHECK(std::getline(baseline, line));
+
+            const std::string id = std::string(device) + "/" + entities[i].objectId;
+            applyKnownChanges(id, line);
+
+            const size_t length = serializeHassEntity(entities[i], buffer, sizeof(buffer), "abc123", name, baseTopic, deviceType, availabilityTopic, "nuki");
+            const std::string generated = id + " " + std::string(buffer, length);
+
+            if(generated != line)
+            {
+                fprintf(stderr, "expected: %s\ngenerated: %s\n", line.c_str(), generated.c_str());
+            }
+            CHECK(generated == line);
+        }
+    }
+}
+
+int main()
+{
+    std::ifstream baseline(HASS_ENTITIES_BASELINE);
+    CHECK(baseline.is_open());
+
+    compare(baseline, "lock", hassLockEntities, sizeof(hassLockEntities) / sizeof(hassLockEntities[0]), "SmartLock", "nuki/lock", "Nuki Lock");
+    compare(baseline, "opener", hassOpenerEntities, sizeof(hassOpenerEntities) / sizeof(hassOpenerEntities[0]), "Opener", "nuki/opener", "Nuki Opener");
+
+    std::string line;
+    CHECK(!std::getline(baseline, line)); // every baseline entity is still published
+
+    return HOST_TEST_RESULT();
+}
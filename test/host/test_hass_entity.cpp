@@ -0,0 +1,100 @@
+#include "HostTest.h"
+#include "HassEntity.h"
+#include <ArduinoJson.h>
+#include <string>
+
+namespace
+{
+    const char* const modes[] = { "on", "off", nullptr };
+
+    const HassEntity entity =
+    {
+        "select", "mode", "_mode", "Mode \"quoted\"", "~/state", "", "", "config", "~/action",
+        HassAcl::None, 0,
+        { { "ic", "mdi:lock" }, { "en", "false" } },
+        "options", modes
+    };
+
+    const HassEntity hubEntity =
+    {
+        "update", "update", "_update", "Update", "/info/version", "", "", "", "/maintenance/update",
+        HassAcl::None, 0,
+        { { "l_ver_t", "/info/latest", true }, { "pl_inst", "1" } },
+        nullptr, nullptr, true
+    };
+
+    void testSerialize()
+    {
+        char buffer[1024];
+        const size_t length = serializeHassEntity(entity, buffer, sizeof(buffer), "abc123", "My\tLock", "nuki/lock", "SmartLock", "nuki/lock/maintenance/mqttConnectionState", "nuki");
+
+        CHECK(length == strlen(buffer));
+        CHECK(std::string(buffer) ==
+              "{\"dev\":{\"ids\":[\"nuki_abc123\"],\"mf\":\"Nuki\",\"mdl\":\"SmartLock\",\"name\":\"My\\tLock\"},"
+              "\"~\":\"nuki/lock\",\"name\":\"Mode \\\"quoted\\\"\",\"unique_id\":\"abc123_mode\",\"stat_t\":\"~/state\","
+              "\"ent_cat\":\"config\",\"cmd_t\":\"~/action\",\"avty\":{\"t\":\"nuki/lock/maintenance/mqttConnectionState\"},"
+              "\"ic\":\"mdi:lock\",\"en\":false,\"options\":[\"on\",\"off\"]}");
+
+        JsonDocument json;
+        CHECK(deserializeJson(json, buffer) == DeserializationError::Ok);
+        CHECK(json["en"].is<bool>());
+        CHECK(json["dev"]["name"] == "My\tLock");
+    }
+
+    void testHubTopics()
+    {
+        char buffer[1024];
+        serializeHassEntity(hubEntity, buffer, sizeof(buffer), "abc123", "Lock", "nuki/lock", "SmartLock", "avty", "nukihub");
+
+        JsonDocument json;
+        CHECK(deserializeJson(json, buffer) == DeserializationError::Ok);
+        CHECK(json["stat_t"] == "nukihub/info/version");
+        CHECK(json["cmd_t"] == "nukihub/maintenance/update");
+        CHECK(json["l_ver_t"] == "nukihub/info/latest");
+        CHECK(json["pl_inst"] == "1");
+    }
+
+    void testLock()
+    {
+        HassLock lock = { "abc123", "Front door", "nuki", "SmartLock", "4.1", "5.0", "http://nukihub", "~/avty", "lock", "unlock", nullptr };
+        char buffer[1024];
+        const size_t length = serializeHassLock(lock, buffer, sizeof(buffer));
+        CHECK(length == strlen(buffer));
+
+        JsonDocument json;
+        CHECK(deserializeJson(json, buffer) == DeserializationError::Ok);
+        CHECK(json["name"].isNull());
+        CHECK(json["dev"]["sw"] == "4.1");
+        CHECK(json["dev"]["cu"] == "http://nukihub");
+        CHECK(json["unique_id"] == "abc123_lock");
+        CHECK(!json["pl_open"].is<const char*>());
+        CHECK(json["opt"] == "false");
+
+        lock.openAction = "unlatch";
+        serializeHassLock(lock, buffer, sizeof(buffer));
+        CHECK(deserializeJson(json, buffer) == DeserializationError::Ok);
+        CHECK(json["pl_open"] == "unlatch");
+
+        CHECK(serializeHassLock(lock, buffer, 100) == 0);
+    }
+
+    void testBufferTooSmall()
+    {
+        char buffer[1024];
+        const size_t length = serializeHassEntity(entity, buffer, sizeof(buffer), "abc123", "Lock", "nuki/lock", "SmartLock", "avty", "nuki");
+
+        // One byte is needed for the terminating NUL
+        CHECK(serializeHassEntity(entity, buffer, length, "abc123", "Lock", "nuki/lock", "SmartLock", "avty", "nuki") == 0);
+        CHECK(serializeHassEntity(entity, buffer, length + 1, "abc123", "Lock", "nuki/lock", "SmartLock", "avty", "nuki") == length);
+        CHECK(serializeHassEntity(entity, buffer, 10, "abc123", "Lock", "nuki/lock", "SmartLock", "avty", "nuki") == 0);
+    }
+}
+
+int main()
+{
+    testSerialize();
+    testHubTopics();
+    testLock();
+    testBufferTooSmall();
+    return HOST_TEST_RESULT();
+}
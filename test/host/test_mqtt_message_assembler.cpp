@@ -0,0 +1,118 @@
+#include "HostTest.h"
+#include "MqttMessageAssembler.h"
+#include "Config.h"
+#include <string>
+
+namespace
+{
+    std::string createPayload(const size_t size)
+    {
+        std::string payload;
+        for(size_t i = 0; i < size; i++) payload.push_back("{\"code\":123456,\"name\":\"Keypad\"}"[i % 31]);
+        return payload;
+    }
+
+    // Delivers the payload in fragments of fragmentSize bytes like espMqttClient, returns the last result
+    const char* deliver(MqttMessageAssembler& assembler, const std::string& payload, const size_t fragmentSize)
+    {
+        const char* message = nullptr;
+        size_t index = 0;
+
+        do
+        {
+            size_t len = std::min(fragmentSize, payload.size() - index);
+            size_t total = payload.size();
+            message = assembler.append((const uint8_t*)payload.data() + index, len, index, total);
+            index += len;
+        } while(index < payload.size());
+
+        return message;
+    }
+
+    void testInOrder()
+    {
+        MqttMessageAssembler assembler(MQTT_RX_PAYLOAD_BUFFER_SIZE);
+
+        // Single fragment, small fragments and payloads over 800 bytes, the size the receivers used to be limited to
+        for(const size_t size : { (size_t)0, (size_t)1, (size_t)5, (size_t)799, (size_t)800, (size_t)801, (size_t)1500, (size_t)3000 })
+        {
+            for(const size_t fragmentSize : { (size_t)1, (size_t)7, (size_t)256, (size_t)1024, (size_t)MQTT_RX_PAYLOAD_BUFFER_SIZE })
+            {
+                const std::string payload = createPayload(size);
+                const char* message = deliver(assembler, payload, fragmentSize);
+
+                CHECK(message != nullptr);
+                CHECK(assembler.length() == size);
+                CHECK(message != nullptr && payload == message);
+            }
+        }
+    }
+
+    void testIncompleteMessage()
+    {
+        MqttMessageAssembler assembler(MQTT_RX_PAYLOAD_BUFFER_SIZE);
+        const std::string payload = createPayload(1000);
+
+        size_t len = 400;
+        size_t index = 0;
+        size_t total = payload.size();
+        CHECK(assembler.append((const uint8_t*)payload.data(), len, index, total) == nullptr);
+    }
+
+    void testBufferSize()
+    {
+        MqttMessageAssembler assembler(MQTT_RX_PAYLOAD_BUFFER_SIZE);
+
+        // The largest payload that is accepted, the terminator doesn't count against it
+        const std::string largest = createPayload(MQTT_RX_PAYLOAD_BUFFER_SIZE);
+        const char* message = deliver(assembler, largest, 1460);
+        CHECK(message != nullptr && largest == message);
+        CHECK(!assembler.overflow());
+
+        // One byte more is dropped, the next message is delivered unchanged
+        const std::string oversized = createPayload(MQTT_RX_PAYLOAD_BUFFER_SIZE + 1);
+        CHECK(deliver(assembler, oversized, 1460) == nullptr);
+        CHECK(assembler.overflow());
+
+        const std::string next = "unlock";
+        message = deliver(assembler, next, 1460);
+        CHECK(message != nullptr && next == message);
+        CHECK(!assembler.overflow());
+
+        // Same after a much larger message, which mustn't have been written past the buffer
+        CHECK(deliver(assembler, createPayload(MQTT_RX_PAYLOAD_BUFFER_SIZE * 4), 1460) == nullptr);
+        message = deliver(assembler, largest, 512);
+        CHECK(message != nullptr && largest == message);
+    }
+
+    void testMissingFragment()
+    {
+        MqttMessageAssembler assembler(MQTT_RX_PAYLOAD_BUFFER_SIZE);
+        const std::string payload = createPayload(2000);
+
+        // The second fragment is lost, the later ones don't line up and the message is dropped
+        const char* message = nullptr;
+        for(size_t index = 0; index < payload.size(); index += 500)
+        {
+            if(index == 500) continue;
+            size_t len = 500;
+            size_t start = index;
+            size_t total = payload.size();
+            message = assembler.append((const uint8_t*)payload.data() + index, len, start, total);
+        }
+        CHECK(message == nullptr);
+
+        const std::string next = "{\"action\":\"lock\"}";
+        message = deliver(assembler, next, 4);
+        CHECK(message != nullptr && next == message);
+    }
+}
+
+int main()
+{
+    testInOrder();
+    testIncompleteMessage();
+    testBufferSize();
+    testMissingFragment();
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,190 @@
+#include "HostTest.h"
+#include "HostNetworkDevice.h"
+#include "CharBuffer.h"
+#include "Config.h"
+#include "Gpio.h"
+#include "NukiNetwork.h"
+#include "PreferencesKeys.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Publishes through NukiNetwork into the fake broker while a second thread plays networkTask. The broker takes a few
+// messages per network loop, so publishers run into the pending queue and the backpressure of mqttPublish().
+namespace
+{
+    Preferences* preferences = nullptr;
+    NukiNetwork* network = nullptr;
+    std::thread networkThread;
+    std::atomic<bool> running(true);
+
+    const char* eventTopic = "nuki/test/event";
+    const char* stateTopic = "nuki/test/state";
+
+    int64_t now()
+    {
+        return esp_timer_get_time() / 1000;
+    }
+
+    // Like main.cpp, update() sets the network task handle on the first call from this thread
+    void networkTask()
+    {
+        while(running)
+        {
+            network->update();
+            network->waitForNetworkEvent(100);
+        }
+    }
+
+    bool waitFor(const std::function<bool()>& condition, const int64_t timeout)
+    {
+        const int64_t end = now() + timeout;
+        while(!condition())
+        {
+            if(now() > end) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    bool drained()
+    {
+        return network->publishQueueDepth() == 0 && hostNetworkDevice->mqttQueueSize() == 0;
+    }
+
+    std::vector<std::string> publishedPayloads(const char* topic)
+    {
+        std::vector<std::string> payloads;
+        for(const HostMqttMessage& message : hostNetworkDevice->published())
+        {
+            if(message.topic == topic) payloads.push_back(message.payload);
+        }
+        return payloads;
+    }
+
+    void setup()
+    {
+        preferences = new Preferences();
+        initPreferences(preferences);
+        preferences->putString(preference_mqtt_broker, "broker.local");
+        preferences->putString(preference_mqtt_lock_path, "nuki");
+
+        CharBuffer::initialize(CHAR_BUFFER_SIZE);
+
+        network = new NukiNetwork(preferences, new Gpio(preferences), preferences->getString(preference_mqtt_lock_path), CharBuffer::get(), CHAR_BUFFER_SIZE);
+        network->initialize();
+        hostNetworkDevice->transmitPerUpdate = 5;
+
+        networkThread = std::thread(networkTask);
+        CHECK(waitFor([]() { return hostNetworkDevice->mqttConnected(); }, 5000));
+        CHECK(waitFor(drained, 5000));
+    }
+
+    void testOrderWithoutDrops()
+    {
+        // Ten times the pending limit, the publisher is held back until the network task drained the queue
+        const int events = MQTT_MAX_PENDING_PUBLISHES * 10;
+        const uint32_t droppedBefore = network->publishesDropped();
+        const uint32_t throttledBefore = network->publishesThrottled();
+        hostNetworkDevice->clearPublished();
+
+        const int64_t start = now();
+        for(int i = 0; i < events; i++)
+        {
+            network->publishString(nullptr, eventTopic, std::to_string(i).c_str(), false);
+            if(i % 10 == 9) network->publishString(nullptr, stateTopic, std::to_string(i).c_str(), true);
+        }
+        const int64_t duration = now() - start;
+
+        CHECK(waitFor(drained, 5000));
+        CHECK(network->publishesDropped() == droppedBefore);
+        CHECK(network->publishesThrottled() > throttledBefore);
+
+        const std::vector<std::string> received = publishedPayloads(eventTopic);
+        CHECK(received.size() == events);
+        bool ordered = received.size() == events;
+        for(size_t i = 0; ordered && i < received.size(); i++) ordered = received[i] == std::to_string(i);
+        CHECK(ordered);
+
+        const std::vector<std::string> states = publishedPayloads(stateTopic);
+        CHECK(!states.empty() && states.back() == std::to_string(events - 1));
+        CHECK(hostNetworkDevice->retained()[stateTopic] == std::to_string(events - 1));
+
+        // The network task is woken by the waiting publisher instead of sleeping out its loop delay, paced by
+        // the 100 ms delay this would take more than 20 seconds
+        fprintf(stderr, "%d events through the pending queue in %lld ms\n", events, (long long)duration);
+        CHECK(duration < 5000);
+    }
+
+    void testRetainedCoalescing()
+    {
+        const uint32_t coalescedBefore = network->publishesCoalesced();
+        hostNetworkDevice->clearPublished();
+        hostNetworkDevice->setBrokerPaused(true);
+
+        // The outbox takes the first messages, the rest waits in the pending queue
+        for(int i = 0; i < MQTT_PUBLISH_QUEUE_THRESHOLD; i++)
+        {
+            network->publishString(nullptr, (std::string("nuki/test/fill") + std::to_string(i)).c_str(), "1", true);
+        }
+
+        // A waiting retained value is replaced in place, but not across an event of the same topic
+        for(int i = 0; i < 25; i++) network->publishString(nullptr, stateTopic, std::to_string(i).c_str(), true);
+        network->publishString(nullptr, stateTopic, "event", false);
+        for(int i = 25; i < 50; i++) network->publishString(nullptr, stateTopic, std::to_string(i).c_str(), true);
+
+        CHECK(network->publishQueueDepth() == 3);
+        CHECK(network->publishesCoalesced() - coalescedBefore == 48);
+
+        hostNetworkDevice->setBrokerPaused(false);
+        CHECK(waitFor(drained, 5000));
+
+        const std::vector<std::string> states = publishedPayloads(stateTopic);
+        CHECK(states == std::vector<std::string>({ "24", "event", "49" }));
+        CHECK(hostNetworkDevice->retained()[stateTopic] == "49");
+        CHECK(publishedPayloads("nuki/test/fill0").size() == 1);
+    }
+
+    void testDisconnectReleasesPublisher()
+    {
+        const uint32_t throttledBefore = network->publishesThrottled();
+        hostNetworkDevice->setBrokerPaused(true);
+
+        std::atomic<bool> done(false);
+        std::thread publisher([&done]()
+        {
+            for(int i = 0; i < MQTT_PUBLISH_QUEUE_THRESHOLD + MQTT_MAX_PENDING_PUBLISHES + 1; i++)
+            {
+                network->publishString(nullptr, eventTopic, std::to_string(i).c_str(), false);
+            }
+            done = true;
+        });
+
+        CHECK(waitFor([throttledBefore]() { return network->publishesThrottled() > throttledBefore && network->publishQueueDepth() > MQTT_MAX_PENDING_PUBLISHES; }, 1000));
+        CHECK(!done);
+
+        // The queue can't drain while disconnected, the publisher returns right away instead of at the timeout
+        const int64_t start = now();
+        hostNetworkDevice->dropConnection();
+        CHECK(waitFor([&done]() { return done.load(); }, MQTT_PUBLISH_BACKPRESSURE_TIMEOUT));
+        CHECK(now() - start < MQTT_PUBLISH_BACKPRESSURE_TIMEOUT / 2);
+        publisher.join();
+
+        hostNetworkDevice->setBrokerPaused(false);
+    }
+}
+
+int main()
+{
+    setup();
+    testOrderWithoutDrops();
+    testRetainedCoalescing();
+    testDisconnectReleasesPublisher();
+
+    running = false;
+    networkThread.join();
+    return HOST_TEST_RESULT();
+}
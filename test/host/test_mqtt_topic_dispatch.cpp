@@ -0,0 +1,360 @@
+#include "HostTest.h"
+#include "HostNetworkDevice.h"
+#include "CharBuffer.h"
+#include "Gpio.h"
+#include "HTTPClient.h"
+#include "MqttTopics.h"
+#include "NukiNetwork.h"
+#include "NukiNetworkLock.h"
+#include "NukiNetworkOpener.h"
+#include "NukiOfficial.h"
+#include "NukiPublisher.h"
+#include "PreferencesKeys.h"
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern uint32_t NukiNetworkLock_lastRollingLog;
+extern uint32_t NukiNetworkOpener_lastRollingLog;
+
+// Every topic NukiNetworkLock and NukiNetworkOpener subscribe to has to reach its case of the hashed topic switch.
+// Messages go through the fake broker and NukiNetwork, the callbacks record which handler received them.
+namespace
+{
+    Preferences* preferences = nullptr;
+    NukiNetwork* network = nullptr;
+    NukiOfficial* nukiOfficial = nullptr;
+    NukiNetworkLock* networkLock = nullptr;
+    NukiNetworkOpener* networkOpener = nullptr;
+
+    std::vector<std::string> dispatched; // "<device> <handler> <value>" per callback
+    int restartCountBefore = 0;
+    int httpRequestsBefore = 0;
+
+    template<const char* device>
+    struct Recorder
+    {
+        static void record(const char* handler, const std::string& value)
+        {
+            dispatched.push_back(std::string(device) + " " + handler + " " + value);
+        }
+
+        static LockActionResult lockAction(const char* value) { record("action", value); return LockActionResult::Success; }
+        static void config(const char* value) { record("config", value); }
+        static void keypadJson(const char* value) { record("keypadJson", value); }
+        static void timeControl(const char* value) { record("timeControl", value); }
+        static void auth(const char* value) { record("auth", value); }
+        static void official(const char* path, const char* value) { record("official", std::string(path) + "=" + value); }
+        static void keypad(const char* command, const uint& id, const String& name, const String& code, const int& enabled)
+        {
+            record("keypad", std::string(command) + " " + std::to_string(id) + " " + name + " " + code + " " + std::to_string(enabled));
+        }
+    };
+
+    constexpr char lockDevice[] = "lock";
+    constexpr char openerDevice[] = "opener";
+    typedef Recorder<lockDevice> LockRecorder;
+    typedef Recorder<openerDevice> OpenerRecorder;
+
+    void setup()
+    {
+        preferences = new Preferences();
+        initPreferences(preferences);
+        preferences->putString(preference_mqtt_broker, "broker.local");
+        preferences->putString(preference_mqtt_lock_path, "nuki");
+        preferences->putString(preference_mqtt_opener_path, "nukiopener");
+        preferences->putUInt(preference_nuki_id_lock, 0x1234abcd);
+
+        // Everything that adds subscriptions
+        preferences->putBool(preference_update_from_mqtt, true);
+        preferences->putBool(preference_keypad_control_enabled, true);
+        preferences->putBool(preference_timecontrol_control_enabled, true);
+        preferences->putBool(preference_auth_control_enabled, true);
+        preferences->putBool(preference_publish_authdata, true);
+        preferences->putBool(preference_official_hybrid_enabled, true);
+
+        const size_t bufferSize = CHAR_BUFFER_SIZE;
+        CharBuffer::initialize(bufferSize);
+
+        Gpio* gpio = new Gpio(preferences);
+        nukiOfficial = new NukiOfficial(preferences);
+
+        network = new NukiNetwork(preferences, gpio, preferences->getString(preference_mqtt_lock_path), CharBuffer::get(), bufferSize);
+        network->initialize();
+
+        networkLock = new NukiNetworkLock(network, nukiOfficial, preferences, new char[bufferSize], bufferSize);
+        networkLock->initialize();
+        networkLock->setLockActionReceivedCallback(LockRecorder::lockAction);
+        networkLock->setOfficialUpdateReceivedCallback(LockRecorder::official);
+        networkLock->setConfigUpdateReceivedCallback(LockRecorder::config);
+        networkLock->setKeypadCommandReceivedCallback(LockRecorder::keypad);
+        networkLock->setKeypadJsonCommandReceivedCallback(LockRecorder::keypadJson);
+        networkLock->setTimeControlCommandReceivedCallback(LockRecorder::timeControl);
+        networkLock->setAuthCommandReceivedCallback(LockRecorder::auth);
+
+        networkOpener = new NukiNetworkOpener(network, preferences, new char[bufferSize], bufferSize);
+        networkOpener->initialize();
+        networkOpener->setLockActionReceivedCallback(OpenerRecorder::lockAction);
+        networkOpener->setConfigUpdateReceivedCallback(OpenerRecorder::config);
+        networkOpener->setKeypadCommandReceivedCallback(OpenerRecorder::keypad);
+        networkOpener->setKeypadJsonCommandReceivedCallback(OpenerRecorder::keypadJson);
+        networkOpener->setTimeControlCommandReceivedCallback(OpenerRecorder::timeControl);
+        networkOpener->setAuthCommandReceivedCallback(OpenerRecorder::auth);
+
+        for(int i = 0; i < 3; i++)
+        {
+            network->update();
+            hostNetworkDevice->transmit();
+        }
+        CHECK(hostNetworkDevice->mqttConnected());
+
+        // NukiNetwork ignores messages and lock actions for the first seconds after the connect
+        std::this_thread::sleep_for(std::chrono::milliseconds(6100));
+    }
+
+    struct Route
+    {
+        std::string topic;
+        std::string payload;
+        std::function<bool()> handled; // checked after the message was delivered
+    };
+
+    std::function<bool()> recorded(const std::string& expected)
+    {
+        return [expected]() { return dispatched.size() == 1 && dispatched[0] == expected; };
+    }
+
+    // The keypad command carries whatever the field topics left behind
+    std::function<bool()> recordedPrefix(const std::string& expected)
+    {
+        return [expected]() { return dispatched.size() == 1 && dispatched[0].rfind(expected, 0) == 0; };
+    }
+
+    std::function<bool()> counted(const int& counter, const int& before)
+    {
+        return [&counter, &before]() { return counter == before + 1 && dispatched.empty(); };
+    }
+
+    template<typename Receiver>
+    std::function<bool()> queried(Receiver* receiver, const uint8_t command)
+    {
+        return [receiver, command]() { return (receiver->queryCommands() & command) != 0 && dispatched.empty(); };
+    }
+
+    // The keypad fields are only stored, the next keypad action passes them to the callback
+    std::function<bool()> keypadField(const std::string& prefix, const std::string& expected)
+    {
+        return [prefix, expected]()
+        {
+            if(!dispatched.empty()) return false;
+            hostNetworkDevice->injectMessage(prefix + mqtt_topic_keypad_command_action, "check");
+            return dispatched.size() == 1 && dispatched[0].find(expected) != std::string::npos;
+        };
+    }
+
+    std::vector<Route> deviceRoutes(const std::string& prefix, const std::string& device, uint32_t& lastRollingLog, const bool isLock)
+    {
+        auto querying = [&](const uint8_t command) -> std::function<bool()>
+        {
+            if(isLock) return queried(networkLock, command);
+            return queried(networkOpener, command);
+        };
+
+        std::vector<Route> routes =
+        {
+            { prefix + mqtt_topic_lock_action, "unlock", recorded(device + " action unlock") },
+            { prefix + mqtt_topic_config_action, "{\"ledEnabled\":\"1\"}", recorded(device + " config {\"ledEnabled\":\"1\"}") },
+            { prefix + mqtt_topic_query_config, "1", querying(QUERY_COMMAND_CONFIG) },
+            { prefix + mqtt_topic_query_lockstate, "1", querying(QUERY_COMMAND_LOCKSTATE) },
+            { prefix + mqtt_topic_query_battery, "1", querying(QUERY_COMMAND_BATTERY) },
+            { prefix + mqtt_topic_query_keypad, "1", querying(QUERY_COMMAND_KEYPAD) },
+            { prefix + mqtt_topic_keypad_command_id, "42", keypadField(prefix, " 42 ") },
+            { prefix + mqtt_topic_keypad_command_name, "Garden", keypadField(prefix, " Garden ") },
+            { prefix + mqtt_topic_keypad_command_code, "135792", keypadField(prefix, " 135792 ") },
+            { prefix + mqtt_topic_keypad_command_enabled, "0", keypadField(prefix, " 0") },
+            { prefix + mqtt_topic_keypad_command_action, "add", recordedPrefix(device + " keypad add ") },
+            { prefix + mqtt_topic_keypad_json_action, "{\"action\":\"delete\"}", recorded(device + " keypadJson {\"action\":\"delete\"}") },
+            { prefix + mqtt_topic_timecontrol_action, "{\"action\":\"add\"}", recorded(device + " timeControl {\"action\":\"add\"}") },
+            { prefix + mqtt_topic_auth_action, "{\"action\":\"update\"}", recorded(device + " auth {\"action\":\"update\"}") },
+            { prefix + mqtt_topic_lock_log_rolling_last, "17", [&lastRollingLog]() { return lastRollingLog == 17 && dispatched.empty(); } },
+        };
+        return routes;
+    }
+
+    std::vector<Route> lockOnlyRoutes()
+    {
+        std::vector<Route> routes =
+        {
+            { std::string("nuki") + mqtt_topic_reset, "1", counted(hostRestartCount, restartCountBefore) },
+            { std::string("nuki") + mqtt_topic_update, "1", counted(hostHttpRequests, httpRequestsBefore) },
+            { std::string("nuki") + mqtt_topic_webserver_action, "0", [&]() { return !preferences->getBool(preference_webserver_enabled, true) && dispatched.empty(); } },
+        };
+
+        for(const char* offTopic : nukiOfficial->getOffTopics())
+        {
+            routes.push_back({ std::string(nukiOfficial->getMqttPath()) + offTopic, "1", recorded(std::string("lock official ") + offTopic + "=1") });
+        }
+        return routes;
+    }
+
+    void testEverySubscriptionDispatched()
+    {
+        std::vector<Route> routes = deviceRoutes("nuki", "lock", NukiNetworkLock_lastRollingLog, true);
+        std::vector<Route> openerRoutes = deviceRoutes("nukiopener", "opener", NukiNetworkOpener_lastRollingLog, false);
+        std::vector<Route> lockRoutes = lockOnlyRoutes();
+        routes.insert(routes.end(), openerRoutes.begin(), openerRoutes.end());
+        routes.insert(routes.end(), lockRoutes.begin(), lockRoutes.end());
+
+        const std::vector<std::string> subscriptions = hostNetworkDevice->subscriptions();
+        CHECK(subscriptions.size() == routes.size());
+
+        for(const std::string& topic : subscriptions)
+        {
+            const Route* route = nullptr;
+            for(const Route& candidate : routes)
+            {
+                if(candidate.topic == topic) route = &candidate;
+            }
+
+            if(route == nullptr)
+            {
+                fprintf(stderr, "no route for subscribed topic %s\n", topic.c_str());
+                ++hostTestFailures;
+                continue;
+            }
+
+            dispatched.clear();
+            restartCountBefore = hostRestartCount;
+            httpRequestsBefore = hostHttpRequests;
+            hostNetworkDevice->injectMessage(route->topic, route->payload);
+            if(!route->handled())
+            {
+                fprintf(stderr, "%s (%s) not dispatched to its handler\n", topic.c_str(), route->payload.c_str());
+                for(const std::string& entry : dispatched) fprintf(stderr, "  dispatched: %s\n", entry.c_str());
+                ++hostTestFailures;
+            }
+        }
+    }
+
+    void testUnknownTopics()
+    {
+        // Prefixes, extensions and topics of the other device don't reach a handler
+        dispatched.clear();
+        for(const char* topic : { "nuki/lock/actio", "nuki/lock/action/x", "nuki/lock/actionx", "nukiopener/lock/actio", "nuki/opener/lock/action", "other/lock/action" })
+        {
+            hostNetworkDevice->injectMessage(topic, "unlock");
+        }
+        CHECK(dispatched.empty());
+
+        hostNetworkDevice->injectMessage("nukiopener/lock/action", "electricStrikeActuation");
+        CHECK(dispatched.size() == 1 && dispatched[0] == "opener action electricStrikeActuation");
+    }
+
+    void testInternedTopics()
+    {
+        NukiPublisher publisher(network, "nuki");
+        publisher.internTopics({ mqtt_topic_lock_state, mqtt_topic_lock_json, mqtt_topic_battery_level });
+
+        // Matched by content, a copy of the constant finds the same path
+        const std::string copy = mqtt_topic_lock_state;
+        const char* path = publisher.internedPath(copy.c_str());
+        CHECK(path != nullptr && strcmp(path, "nuki/lock/state") == 0);
+        CHECK(publisher.internedPath(mqtt_topic_lock_state) == path);
+        CHECK(publisher.internedPath(mqtt_topic_battery_level) != nullptr && strcmp(publisher.internedPath(mqtt_topic_battery_level), "nuki/battery/level") == 0);
+
+        CHECK(publisher.internedPath(mqtt_topic_lock_trigger) == nullptr);
+        CHECK(publisher.internedPath("/lock/stat") == nullptr);
+        CHECK(publisher.internedPath("/lock/state/") == nullptr);
+
+        // Interned or not, the broker receives the prefixed topic
+        hostNetworkDevice->clearPublished();
+        publisher.publishString(copy.c_str(), "locked", true);
+        publisher.publishString(mqtt_topic_lock_trigger, "manual", true);
+        for(int i = 0; i < 100 && network->publishQueueDepth() > 0; i++)
+        {
+            network->update();
+            hostNetworkDevice->transmit();
+        }
+
+        CHECK(network->publishQueueDepth() == 0);
+        CHECK(hostNetworkDevice->retained()["nuki/lock/state"] == "locked");
+        CHECK(hostNetworkDevice->retained()["nuki/lock/trigger"] == "manual");
+    }
+
+    // The comparePrefixedPath() chain the receivers used before the hashed switch: every candidate topic is
+    // prefixed into a stack buffer and compared until one matches
+    bool dispatchByChain(const char* prefix, const std::vector<std::string>& suffixes, const char* topic)
+    {
+        for(const std::string& suffix : suffixes)
+        {
+            char prefixedPath[500];
+            size_t prefixLen = strlen(prefix);
+            memcpy(prefixedPath, prefix, prefixLen);
+            memcpy(prefixedPath + prefixLen, suffix.c_str(), suffix.length() + 1);
+            if(strcmp(topic, prefixedPath) == 0) return true;
+        }
+        return false;
+    }
+
+    void benchmarkDispatch()
+    {
+        // Subscribed topics with a payload every handler ignores, plus topics nobody handles
+        std::vector<std::string> topics;
+        std::vector<std::string> lockSuffixes;
+        std::vector<std::string> openerSuffixes;
+        for(const std::string& topic : hostNetworkDevice->subscriptions())
+        {
+            if(topic.rfind("nukiopener/", 0) == 0) openerSuffixes.push_back(topic.substr(strlen("nukiopener")));
+            else if(topic.rfind(nukiOfficial->getMqttPath(), 0) != 0) lockSuffixes.push_back(topic.substr(strlen("nuki")));
+            else continue;
+            topics.push_back(topic);
+        }
+        topics.push_back("nuki/lock/state");
+        topics.push_back("nukiopener/lock/state");
+
+        char payload[] = "--";
+        const int rounds = 20000;
+        const size_t messages = rounds * topics.size();
+        size_t matched = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for(int round = 0; round < rounds; round++)
+        {
+            for(const std::string& topic : topics)
+            {
+                matched += dispatchByChain("nuki", lockSuffixes, topic.c_str());
+                matched += dispatchByChain("nukiopener", openerSuffixes, topic.c_str());
+            }
+        }
+        const double chainNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / messages;
+
+        // Both receivers see every message, like in NukiNetwork::onMqttDataReceived()
+        dispatched.clear();
+        start = std::chrono::steady_clock::now();
+        for(int round = 0; round < rounds; round++)
+        {
+            for(const std::string& topic : topics)
+            {
+                networkLock->onMqttDataReceived(topic.c_str(), (byte*)payload, 2);
+                networkOpener->onMqttDataReceived(topic.c_str(), (byte*)payload, 2);
+            }
+        }
+        const double switchNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / messages;
+
+        printf("dispatch of %zu topics: comparePrefixedPath chain %.0f ns, hashed switch %.0f ns per message\n", topics.size(), chainNs, switchNs);
+        CHECK(matched == rounds * (topics.size() - 2));
+        CHECK(dispatched.empty());
+    }
+}
+
+int main()
+{
+    setup();
+    testEverySubscriptionDispatched();
+    testUnknownTopics();
+    testInternedTopics();
+    benchmarkDispatch();
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,223 @@
+#include "HostTest.h"
+#include "NukiScheduler.h"
+#include "Config.h"
+#include "esp_timer.h"
+#include <atomic>
+#include <thread>
+
+namespace
+{
+    int64_t nowMs()
+    {
+        return esp_timer_get_time() / 1000;
+    }
+
+    // Runs waitForWork() on its own thread, like nukiTask, and returns how long it was blocked in ms
+    template<typename Action>
+    int64_t timedWait(NukiScheduler& scheduler, Action action)
+    {
+        std::atomic<bool> ready(false);
+        int64_t waited = 0;
+
+        std::thread worker([&]()
+        {
+            scheduler.initialize(xTaskGetCurrentTaskHandle());
+            ready = true;
+            const int64_t start = nowMs();
+            scheduler.waitForWork();
+            waited = nowMs() - start;
+        });
+
+        while(!ready) std::this_thread::yield();
+        action();
+        worker.join();
+        return waited;
+    }
+
+    void testDeadline()
+    {
+        NukiScheduler scheduler;
+        scheduler.scheduleAt(nowMs() + 200);
+        scheduler.scheduleAt(nowMs() + 50); // the earliest deadline wins
+        scheduler.scheduleAt(nowMs() + 500);
+
+        const int64_t waited = timedWait(scheduler, []() {});
+
+        CHECK(waited >= 45 && waited < 200);
+        CHECK(scheduler.timedWakeups() == 1);
+        CHECK(scheduler.wakeups() == 1);
+    }
+
+    void testExpiredDeadline()
+    {
+        NukiScheduler scheduler;
+        scheduler.scheduleAt(nowMs() - 10);
+
+        CHECK(timedWait(scheduler, []() {}) < 20);
+        CHECK(scheduler.timedWakeups() == 0);
+    }
+
+    void testIdle()
+    {
+        // Without a deadline the task sleeps for NUKI_TASK_MAX_IDLE_TIME, one wakeup per second when idle
+        NukiScheduler scheduler;
+        const int64_t waited = timedWait(scheduler, []() {});
+
+        CHECK(waited >= NUKI_TASK_MAX_IDLE_TIME - 5 && waited < NUKI_TASK_MAX_IDLE_TIME + 200);
+        CHECK(scheduler.timedWakeups() == 1);
+    }
+
+    void testWake()
+    {
+        NukiScheduler scheduler;
+        scheduler.scheduleAt(nowMs() + 1000);
+
+        const int64_t waited = timedWait(scheduler, [&scheduler]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            scheduler.wake();
+        });
+
+        CHECK(waited >= 15 && waited < 500);
+        CHECK(scheduler.timedWakeups() == 0);
+        CHECK(scheduler.lastWakeLatency() > 0 && scheduler.lastWakeLatency() < 100000);
+        printf("wake latency: %lld us\n", (long long)scheduler.lastWakeLatency());
+    }
+
+    void testWakeFromIsr()
+    {
+        NukiScheduler scheduler;
+        scheduler.scheduleAt(nowMs() + 1000);
+
+        const int64_t waited = timedWait(scheduler, [&scheduler]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            hostInIsrContext = true;
+            scheduler.wake();
+            hostInIsrContext = false;
+        });
+
+        CHECK(waited < 500);
+        CHECK(scheduler.timedWakeups() == 0);
+    }
+
+    void testWakeBeforeWait()
+    {
+        // Work posted while the task was busy must not be lost
+        NukiScheduler scheduler;
+        scheduler.scheduleAt(nowMs() + 1000);
+
+        std::thread worker([&scheduler]()
+        {
+            scheduler.initialize(xTaskGetCurrentTaskHandle());
+            scheduler.wake();
+            const int64_t start = nowMs();
+            scheduler.waitForWork();
+            CHECK(nowMs() - start < 20);
+        });
+        worker.join();
+
+        CHECK(scheduler.timedWakeups() == 0);
+    }
+
+    void testPostponedDeadline()
+    {
+        // A wake doesn't consume the deadline of the wrapper, update() schedules it again before the next wait
+        NukiScheduler scheduler;
+        std::atomic<int> wakeups(0);
+        int64_t secondWait = 0;
+
+        std::thread worker([&]()
+        {
+            scheduler.initialize(xTaskGetCurrentTaskHandle());
+            const int64_t deadline = nowMs() + 100;
+            scheduler.scheduleAt(deadline);
+            scheduler.waitForWork();
+            ++wakeups;
+
+            scheduler.scheduleAt(deadline);
+            const int64_t start = nowMs();
+            scheduler.waitForWork();
+            secondWait = nowMs() - start;
+            ++wakeups;
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        scheduler.wake();
+        worker.join();
+
+        CHECK(wakeups == 2);
+        CHECK(secondWait >= 50 && secondWait < 200);
+        CHECK(scheduler.timedWakeups() == 1);
+    }
+
+    void testWakeupsPerMinute()
+    {
+        // Periodic refresh every 100 ms with no other work, nukiTask used to wake every 20 ms
+        NukiScheduler scheduler;
+        const int64_t duration = 500;
+
+        std::thread worker([&]()
+        {
+            scheduler.initialize(xTaskGetCurrentTaskHandle());
+            const int64_t end = nowMs() + duration;
+            int64_t next = nowMs() + 100;
+
+            while(nowMs() < end)
+            {
+                if(nowMs() >= next) next += 100;
+                scheduler.scheduleAt(next);
+                scheduler.waitForWork();
+            }
+        });
+        worker.join();
+
+        const uint32_t perMinute = scheduler.wakeups() * 60000 / duration;
+        printf("wakeups per minute: %u\n", perMinute);
+        CHECK(scheduler.wakeups() >= 4 && scheduler.wakeups() <= 7);
+    }
+
+    void testWakeAll()
+    {
+        NukiScheduler first;
+        NukiScheduler second;
+        std::atomic<int> ready(0);
+        int64_t waited[2] = { 0, 0 };
+
+        auto run = [&](NukiScheduler& scheduler, int64_t& result)
+        {
+            scheduler.initialize(xTaskGetCurrentTaskHandle());
+            scheduler.scheduleAt(nowMs() + 1000);
+            ++ready;
+            const int64_t start = nowMs();
+            scheduler.waitForWork();
+            result = nowMs() - start;
+        };
+
+        std::thread a([&]() { run(first, waited[0]); });
+        std::thread b([&]() { run(second, waited[1]); });
+        while(ready < 2) std::this_thread::yield();
+
+        NukiScheduler::wakeAll();
+        a.join();
+        b.join();
+
+        CHECK(waited[0] < 500);
+        CHECK(waited[1] < 500);
+    }
+}
+
+int main()
+{
+    // wakeAll() only knows the first NUKI_SCHEDULER_MAX_INSTANCES schedulers, like nukiTask and nukiOpenerTask
+    testWakeAll();
+    testDeadline();
+    testExpiredDeadline();
+    testIdle();
+    testWake();
+    testWakeFromIsr();
+    testWakeBeforeWait();
+    testPostponedDeadline();
+    testWakeupsPerMinute();
+    return HOST_TEST_RESULT();
+}
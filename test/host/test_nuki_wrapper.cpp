@@ -0,0 +1,163 @@
+#include "HostTest.h"
+#include "HostNetworkDevice.h"
+#include "NukiLock.h"
+#include "CharBuffer.h"
+#include "Gpio.h"
+#include "NukiDeviceId.h"
+#include "NukiNetwork.h"
+#include "NukiNetworkLock.h"
+#include "NukiOfficial.h"
+#include "NukiScheduler.h"
+#include "NukiWrapper.h"
+#include "PreferencesKeys.h"
+#include "MqttTopics.h"
+#include <chrono>
+#include <string>
+#include <thread>
+
+// Runs NukiNetwork, NukiNetworkLock and NukiWrapper wired like in main.cpp against the scripted lock of
+// stubs/nuki_ble and the fake broker of HostNetworkDevice, the test thread plays networkTask and nukiTask.
+namespace
+{
+    Preferences* preferences = nullptr;
+    NukiNetwork* network = nullptr;
+    NukiNetworkLock* networkLock = nullptr;
+    NukiWrapper* nuki = nullptr;
+    NukiScheduler nukiScheduler;
+
+    // One pass of networkTask and nukiTask, then the broker receives everything that was queued
+    void loop(const int count = 1)
+    {
+        for(int i = 0; i < count; i++)
+        {
+            if(network->update()) networkLock->update();
+            nuki->update();
+            hostNetworkDevice->transmit();
+        }
+    }
+
+    std::string lastPublished(const std::string& topic)
+    {
+        std::string payload;
+        for(const HostMqttMessage& message : hostNetworkDevice->published())
+        {
+            if(message.topic == topic) payload = message.payload;
+        }
+        return payload;
+    }
+
+    void setup()
+    {
+        preferences = new Preferences();
+        preferences->begin("nukihub", false);
+        const bool firstStart = initPreferences(preferences);
+        preferences->putString(preference_mqtt_broker, "broker.local");
+        preferences->putString(preference_mqtt_lock_path, "nuki");
+
+        char16_t buffer_size = preferences->getInt(preference_buffer_size, 4096);
+        CharBuffer::initialize(buffer_size);
+
+        Gpio* gpio = new Gpio(preferences);
+        BleScanner::Scanner* bleScanner = new BleScanner::Scanner();
+        NukiDeviceId* deviceIdLock = new NukiDeviceId(preferences, preference_device_id_lock);
+        NukiOfficial* nukiOfficial = new NukiOfficial(preferences);
+
+        network = new NukiNetwork(preferences, gpio, preferences->getString(preference_mqtt_lock_path), CharBuffer::get(), buffer_size);
+        network->initialize();
+
+        networkLock = new NukiNetworkLock(network, nukiOfficial, preferences, new char[buffer_size], buffer_size);
+        networkLock->initialize();
+
+        nuki = new NukiWrapper("NukiHub", deviceIdLock, bleScanner, networkLock, nukiOfficial, gpio, preferences, &nukiScheduler);
+        nuki->initialize(firstStart);
+    }
+
+    void testStartup()
+    {
+        loop(3);
+
+        CHECK(hostNetworkDevice->mqttConnected());
+        CHECK(nuki->isPaired());
+        CHECK(hostNukiLock->requestCount("pairNuki") == 1);
+        CHECK(hostNukiLock->requestCount("requestKeyTurnerState") >= 1);
+        CHECK(hostNukiLock->requestCount("requestConfig") >= 1);
+        CHECK(lastPublished("nuki/lock/state") == "locked");
+        CHECK(lastPublished("nuki/maintenance/mqttConnectionState") == "online");
+
+        bool subscribed = false;
+        for(const std::string& topic : hostNetworkDevice->subscriptions()) subscribed |= topic == "nuki/lock/action";
+        CHECK(subscribed);
+
+        // Lock actions that arrive right after connecting are retained leftovers and ignored
+        hostNetworkDevice->injectMessage("nuki/lock/action", "unlock");
+        loop();
+        CHECK(hostNukiLock->requestCount("lockAction") == 0);
+    }
+
+    void testLockAction()
+    {
+        // NukiNetwork ignores messages for the first seconds after the connect
+        std::this_thread::sleep_for(std::chrono::milliseconds(6100));
+
+        // Arrives in fragments, NukiNetwork passes the joined payload to the receivers
+        hostNukiLock->clearRequests();
+        hostNetworkDevice->injectMessage("nuki/lock/action", "unlock", 2);
+        loop(2);
+
+        CHECK(hostNukiLock->requestCount("lockAction") == 1);
+        CHECK(hostNukiLock->keyTurnerState.lockState == NukiLock::LockState::Unlocked);
+        CHECK(nuki->keyTurnerState().lockState == NukiLock::LockState::Unlocked);
+        CHECK(lastPublished("nuki/lock/state") == "unlocked");
+        CHECK(lastPublished("nuki/lock/action") == "ack");
+        CHECK(lastPublished("nuki/lock/commandResult") == "success");
+    }
+
+    void testLockActionRetry()
+    {
+        // The first attempt fails, the action is retried after the retry delay and succeeds
+        hostNukiLock->clearRequests();
+        hostNukiLock->queueResult(Nuki::CmdResult::Failed);
+        hostNetworkDevice->injectMessage("nuki/lock/action", "lock");
+
+        loop();
+        CHECK(hostNukiLock->requestCount("lockAction") == 1);
+        CHECK(hostNukiLock->keyTurnerState.lockState == NukiLock::LockState::Unlocked);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(preferences->getInt(preference_command_retry_delay) + 50));
+        loop(2);
+
+        CHECK(hostNukiLock->requestCount("lockAction") == 2);
+        CHECK(hostNukiLock->keyTurnerState.lockState == NukiLock::LockState::Locked);
+        CHECK(lastPublished("nuki/lock/state") == "locked");
+        CHECK(nuki->lockActionRetries() == 1);
+
+        // Nothing is pending anymore, so no further attempts
+        std::this_thread::sleep_for(std::chrono::milliseconds(preferences->getInt(preference_command_retry_delay) + 50));
+        loop(2);
+        CHECK(hostNukiLock->requestCount("lockAction") == 2);
+    }
+
+    void testAccessDenied()
+    {
+        uint32_t aclPrefs[17] = {0};
+        preferences->putBytes(preference_acl, (byte*)(&aclPrefs), sizeof(aclPrefs));
+
+        hostNukiLock->clearRequests();
+        hostNetworkDevice->injectMessage("nuki/lock/action", "unlock");
+        loop();
+
+        CHECK(hostNukiLock->requestCount("lockAction") == 0);
+        CHECK(lastPublished("nuki/lock/action") == "denied");
+        CHECK(hostNukiLock->keyTurnerState.lockState == NukiLock::LockState::Locked);
+    }
+}
+
+int main()
+{
+    setup();
+    testStartup();
+    testLockAction();
+    testLockActionRetry();
+    testAccessDenied();
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,245 @@
+#include "HostTest.h"
+#include "OtaWriter.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+namespace
+{
+    typedef std::vector<uint8_t> Bytes;
+
+    // Firmware-like image, larger than the inflate window and only partly compressible
+    Bytes createImage()
+    {
+        Bytes image(200 * 1024);
+        std::mt19937 random(42);
+
+        for(size_t i = 0; i < image.size(); i++)
+        {
+            image[i] = (i % 1024) < 700 ? (uint8_t)("nuki_hub firmware "[i % 18]) : (uint8_t)random();
+        }
+        image[0] = 0xe9;
+        return image;
+    }
+
+    Bytes compress(const Bytes& data, const int windowBits, const bool gzipHeaderFields = false)
+    {
+        z_stream stream = z_stream();
+        CHECK(deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+
+        gz_header header = gz_header();
+        char name[] = "nuki_hub.bin";
+        char comment[] = "host test";
+        Bytef extra[] = { 'N', 'H', 2, 0, 1, 2 };
+        if(gzipHeaderFields)
+        {
+            // Exercises every optional gzip header field the writer has to skip
+            header.name = (Bytef*)name;
+            header.comment = (Bytef*)comment;
+            header.extra = extra;
+            header.extra_len = sizeof(extra);
+            header.hcrc = 1;
+            CHECK(deflateSetHeader(&stream, &header) == Z_OK);
+        }
+
+        Bytes out(deflateBound(&stream, data.size()) + 256);
+        stream.next_in = const_cast<Bytef*>(data.data());
+        stream.avail_in = data.size();
+        stream.next_out = out.data();
+        stream.avail_out = out.size();
+        CHECK(deflate(&stream, Z_FINISH) == Z_STREAM_END);
+        out.resize(stream.total_out);
+        deflateEnd(&stream);
+        return out;
+    }
+
+    Bytes readPartition()
+    {
+        std::ifstream file(hostOtaPartitionPath, std::ios::binary);
+        return Bytes(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Feeds the input in chunks of the given sizes, repeated until the input is consumed
+    bool feed(OtaWriter& writer, const Bytes& input, const std::vector<size_t>& chunkSizes)
+    {
+        size_t offset = 0;
+        size_t chunk = 0;
+
+        while(offset < input.size())
+        {
+            const size_t len = std::min(chunkSizes[chunk++ % chunkSizes.size()], input.size() - offset);
+            if(!writer.write(input.data() + offset, len)) return false;
+            offset += len;
+        }
+
+        return true;
+    }
+
+    void testFormats()
+    {
+        const Bytes image = createImage();
+
+        struct Case
+        {
+            const char* name;
+            OtaImageFormat format;
+            Bytes input;
+        };
+
+        const Case cases[] =
+        {
+            { "raw", OtaImageFormat::Raw, image },
+            { "zlib", OtaImageFormat::Zlib, compress(image, 15) },
+            { "gzip", OtaImageFormat::Gzip, compress(image, 31) },
+            { "gzip with header fields", OtaImageFormat::Gzip, compress(image, 31, true) },
+        };
+
+        std::mt19937 random(7);
+        std::vector<size_t> randomSizes;
+        for(int i = 0; i < 64; i++) randomSizes.push_back(1 + random() % 3000);
+
+        // Chunk boundaries fall into the magic, the gzip header, deflate blocks and the trailer
+        const std::vector<std::vector<size_t>> chunkings = { { 1 }, { 2 }, { 3 }, { 7 }, { 1, 9, 1 }, { 1000 }, { 4096 }, { 65536 }, randomSizes };
+
+        for(const Case& test : cases)
+        {
+            for(const std::vector<size_t>& chunkSizes : chunkings)
+            {
+                OtaWriter writer;
+                CHECK(writer.begin());
+                CHECK(feed(writer, test.input, chunkSizes));
+                CHECK(writer.format() == test.format);
+                CHECK(writer.end());
+                CHECK(hostOtaBootSet);
+                CHECK(writer.bytesReceived() == test.input.size());
+                CHECK(writer.bytesWritten() == image.size());
+
+                if(readPartition() != image)
+                {
+                    fprintf(stderr, "%s image differs with chunks of %zu bytes\n", test.name, chunkSizes[0]);
+                    ++hostTestFailures;
+                }
+            }
+        }
+    }
+
+    void testRawDeflateRejected()
+    {
+        // A bare deflate stream has no signature, compressed images are expected as gzip or zlib
+        OtaWriter writer;
+        CHECK(writer.begin());
+        CHECK(!feed(writer, compress(createImage(), -15), { 1024 }));
+        CHECK(!writer.active());
+        CHECK(strcmp(writer.error(), "Unknown image format") == 0);
+    }
+
+    void testInvalidImages()
+    {
+        const Bytes image = createImage();
+
+        Bytes corrupt = compress(image, 15);
+        for(size_t i = corrupt.size() / 2; i < corrupt.size() / 2 + 64; i++) corrupt[i] ^= 0x5a;
+
+        OtaWriter writer;
+        CHECK(writer.begin());
+        const bool written = feed(writer, corrupt, { 512 });
+        CHECK(!written || !writer.end());
+        CHECK(!writer.active());
+
+        Bytes truncated = compress(image, 31);
+        truncated.resize(truncated.size() / 2);
+        CHECK(writer.begin());
+        CHECK(feed(writer, truncated, { 512 }));
+        CHECK(!writer.end());
+        CHECK(strcmp(writer.error(), "Compressed image incomplete") == 0);
+
+        // Inflated data has to be an image as well
+        Bytes text(4096, 'x');
+        CHECK(writer.begin());
+        CHECK(!feed(writer, compress(text, 15), { 512 }));
+        CHECK(strcmp(writer.error(), "Invalid image") == 0);
+    }
+
+    // Mirrors downloadOta(): sends a Range header when resuming, the connection drops after dropAfter bytes
+    struct Server
+    {
+        const Bytes& body;
+        bool supportsRange;
+        size_t bytesSent = 0;
+
+        bool download(OtaWriter& writer, const size_t dropAfter)
+        {
+            const size_t range = writer.bytesReceived();
+            const int status = range > 0 && supportsRange ? 206 : 200;
+            const size_t offset = status == 206 ? range : 0;
+
+            if(!writer.resume(status)) return false;
+
+            const size_t end = std::min(body.size(), offset + dropAfter);
+            for(size_t pos = offset; pos < end; pos += 1460)
+            {
+                const size_t len = std::min((size_t)1460, end - pos);
+                bytesSent += len;
+                if(!writer.write(body.data() + pos, len)) return false;
+            }
+
+            return end == body.size();
+        }
+    };
+
+    void testResume()
+    {
+        const Bytes image = createImage();
+        const Bytes gzip = compress(image, 31);
+
+        for(const Bytes* body : { &image, &gzip })
+        {
+            // Every attempt is interrupted after a third of the body, the download continues where it stopped
+            Server server = { *body, true };
+            OtaWriter writer;
+            CHECK(writer.begin());
+
+            int attempts = 0;
+            while(!server.download(writer, body->size() / 3 + 1) && writer.active() && attempts < 10) ++attempts;
+
+            CHECK(attempts == 2);
+            CHECK(server.bytesSent == body->size());
+            CHECK(writer.bytesReceived() == body->size());
+            CHECK(writer.end());
+            CHECK(readPartition() == image);
+        }
+
+        // Without Range support the image starts over, the complete body is sent again
+        Server server = { gzip, false };
+        OtaWriter writer;
+        CHECK(writer.begin());
+        CHECK(!server.download(writer, gzip.size() / 2));
+        CHECK(writer.bytesReceived() == gzip.size() / 2);
+        CHECK(server.download(writer, gzip.size()));
+        CHECK(server.bytesSent == gzip.size() / 2 + gzip.size());
+        CHECK(writer.end());
+        CHECK(readPartition() == image);
+
+        // Anything else doesn't touch the partial image
+        CHECK(writer.begin());
+        CHECK(writer.write(gzip.data(), 100));
+        CHECK(!writer.resume(404));
+        CHECK(writer.active());
+        CHECK(writer.bytesReceived() == 100);
+        writer.abort();
+    }
+}
+
+int main()
+{
+    testFormats();
+    testRawDeflateRejected();
+    testInvalidImages();
+    testResume();
+    remove(hostOtaPartitionPath);
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,67 @@
+#include "HostTest.h"
+#include "Packets/PacketPool.h"
+#include <vector>
+
+using espMqttClientInternals::PacketPool;
+
+namespace
+{
+    void testSizeClasses()
+    {
+        CHECK(PacketPool::numClasses() == 3);
+
+        void* small = PacketPool::malloc(EMC_PACKET_POOL_SMALL_SIZE);
+        void* medium = PacketPool::malloc(EMC_PACKET_POOL_SMALL_SIZE + 1);
+        void* large = PacketPool::malloc(EMC_PACKET_POOL_LARGE_SIZE);
+        void* heap = PacketPool::malloc(EMC_PACKET_POOL_LARGE_SIZE + 1);
+
+        CHECK(PacketPool::classStats(0).inUse == 1);
+        CHECK(PacketPool::classStats(1).inUse == 1);
+        CHECK(PacketPool::classStats(2).inUse == 1);
+        CHECK(PacketPool::heapInUse() == 1);
+
+        PacketPool::free(small);
+        PacketPool::free(medium);
+        PacketPool::free(large);
+        PacketPool::free(heap);
+        PacketPool::free(nullptr);
+
+        for(size_t i = 0; i < PacketPool::numClasses(); i++) CHECK(PacketPool::classStats(i).inUse == 0);
+        CHECK(PacketPool::heapInUse() == 0);
+        CHECK(PacketPool::heapAllocations() == 1);
+    }
+
+    void testExhaustion()
+    {
+        std::vector<void*> blocks;
+
+        // Small requests spill into the larger classes once their own class is empty, then onto the heap
+        const size_t pooled = EMC_PACKET_POOL_SMALL_COUNT + EMC_PACKET_POOL_MEDIUM_COUNT + EMC_PACKET_POOL_LARGE_COUNT;
+        for(size_t i = 0; i < pooled + 2; i++) blocks.push_back(PacketPool::malloc(16));
+
+        CHECK(PacketPool::classStats(0).inUse == EMC_PACKET_POOL_SMALL_COUNT);
+        CHECK(PacketPool::classStats(1).inUse == EMC_PACKET_POOL_MEDIUM_COUNT);
+        CHECK(PacketPool::classStats(2).inUse == EMC_PACKET_POOL_LARGE_COUNT);
+        CHECK(PacketPool::classStats(0).exhausted > 0);
+        CHECK(PacketPool::heapInUse() == 2);
+
+        for(void* block : blocks) PacketPool::free(block);
+
+        CHECK(PacketPool::classStats(0).inUse == 0);
+        CHECK(PacketPool::classStats(0).peakInUse == EMC_PACKET_POOL_SMALL_COUNT);
+        CHECK(PacketPool::heapInUse() == 0);
+
+        // Freed blocks are reused
+        void* block = PacketPool::malloc(16);
+        CHECK(block != nullptr);
+        CHECK(PacketPool::classStats(0).inUse == 1);
+        PacketPool::free(block);
+    }
+}
+
+int main()
+{
+    testSizeClasses();
+    testExhaustion();
+    return HOST_TEST_RESULT();
+}
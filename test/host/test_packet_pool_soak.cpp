@@ -0,0 +1,191 @@
+#include "HostTest.h"
+#include "Packets/Packet.h"
+#include "Packets/PacketPool.h"
+#include "HassEntities.h"
+#include "Config.h"
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+using espMqttClientInternals::Packet;
+using espMqttClientInternals::PacketPool;
+using espMqttClientInternals::PacketPoolStats;
+
+// Replays the publish mix of a lock and opener through the packet pool: discovery after every (re)connect, then
+// state updates, JSON documents and the occasional authorization log. Packets stay in the outbox until the broker
+// acknowledges them, NukiNetwork only hands over publishes while the outbox is below MQTT_PUBLISH_QUEUE_THRESHOLD.
+namespace
+{
+    const int MQTT_SUBSCRIPTIONS = 40;
+
+    struct PublishKind
+    {
+        const char* topic;
+        size_t minPayload;
+        size_t maxPayload;
+        uint32_t weight;
+    };
+
+    const PublishKind publishMix[] =
+    {
+        { "nuki/lock/state", 6, 12, 30 },
+        { "nuki/lock/binaryState", 6, 8, 10 },
+        { "nuki/lock/trigger", 6, 10, 5 },
+        { "nuki/lock/rssi", 2, 4, 20 },
+        { "nuki/maintenance/uptime", 1, 6, 10 },
+        { "nuki/lock/json", 250, 420, 8 },
+        { "nuki/battery/basicJson", 80, 140, 4 },
+        { "nuki/configuration/basicJson", 700, 1000, 2 },
+        { "nuki/keypad/json", 400, 1200, 1 },
+        { "nuki/lock/log", 1500, 4000, 1 }, // larger than the largest class, always on the heap
+    };
+
+    struct Outbox
+    {
+        std::deque<Packet*> packets;
+        uint16_t packetId = 1;
+        uint32_t oversized = 0;
+        std::mt19937 random = std::mt19937(12);
+
+        void acknowledge(size_t count)
+        {
+            while(count-- > 0 && !packets.empty())
+            {
+                delete packets.front();
+                packets.pop_front();
+            }
+        }
+
+        void publish(const char* topic, const std::string& payload, const size_t threshold)
+        {
+            // The broker acknowledges some packets per network loop, the rest waits for backpressure
+            acknowledge(random() % 3);
+            while(packets.size() >= threshold) acknowledge(1);
+
+            espMqttClientTypes::Error error;
+            packets.push_back(new Packet(error, packetId++, topic, (const uint8_t*)payload.data(), payload.size(), 1, true));
+            CHECK(error == espMqttClientTypes::Error::SUCCESS);
+            if(packets.back()->size() > EMC_PACKET_POOL_LARGE_SIZE) ++oversized;
+        }
+
+        void receive()
+        {
+            // Inbound QoS 1 messages queue a PUBACK until the next loop
+            espMqttClientTypes::Error error;
+            packets.push_back(new Packet(error, espMqttClientInternals::PacketType.PUBACK, packetId++));
+        }
+    };
+
+    void connect(Outbox& outbox, const size_t threshold)
+    {
+        // NukiNetwork subscribes every topic of the lock, the opener and the official MQTT API right after connecting,
+        // the packets stay in the outbox until the broker acknowledged them
+        espMqttClientTypes::Error error;
+        for(int i = 0; i < MQTT_SUBSCRIPTIONS; i++)
+        {
+            const std::string topic = std::string(i % 2 == 0 ? "nuki/lock" : "nuki/opener") + "/keypad/command/subscription_" + std::to_string(i);
+            outbox.packets.push_back(new Packet(error, outbox.packetId++, topic.c_str(), 1));
+        }
+
+        char buffer[CHAR_BUFFER_SIZE];
+        for(const HassEntity& entity : hassLockEntities)
+        {
+            const size_t length = serializeHassEntity(entity, buffer, sizeof(buffer), "abc123", "Nuki Lock", "nuki/lock", "SmartLock", "nuki/lock/maintenance/mqttConnectionState", "nuki");
+            outbox.publish((std::string("homeassistant/") + entity.component + "/abc123_" + entity.objectId + "/config").c_str(), std::string(buffer, length), threshold);
+        }
+        for(const HassEntity& entity : hassOpenerEntities)
+        {
+            const size_t length = serializeHassEntity(entity, buffer, sizeof(buffer), "def456", "Nuki Opener", "nuki/opener", "Opener", "nuki/opener/maintenance/mqttConnectionState", "nuki");
+            outbox.publish((std::string("homeassistant/") + entity.component + "/def456_" + entity.objectId + "/config").c_str(), std::string(buffer, length), threshold);
+        }
+    }
+
+    struct Snapshot
+    {
+        std::vector<PacketPoolStats> classes;
+        uint32_t heapAllocations;
+    };
+
+    Snapshot snapshot()
+    {
+        Snapshot result;
+        for(size_t i = 0; i < PacketPool::numClasses(); i++) result.classes.push_back(PacketPool::classStats(i));
+        result.heapAllocations = PacketPool::heapAllocations();
+        return result;
+    }
+
+    // Returns the heap fallbacks per size class during the soak
+    std::vector<uint32_t> soak(const char* name, const size_t threshold, const uint32_t publishes)
+    {
+        const Snapshot before = snapshot();
+        Outbox outbox;
+
+        uint32_t totalWeight = 0;
+        for(const PublishKind& kind : publishMix) totalWeight += kind.weight;
+
+        for(uint32_t i = 0; i < publishes; i++)
+        {
+            if(i % 20000 == 0) connect(outbox, threshold);
+
+            uint32_t pick = outbox.random() % totalWeight;
+            const PublishKind* kind = publishMix;
+            while(pick >= kind->weight) pick -= (kind++)->weight;
+
+            const size_t length = kind->minPayload + outbox.random() % (kind->maxPayload - kind->minPayload + 1);
+            outbox.publish(kind->topic, std::string(length, 'x'), threshold);
+
+            if(outbox.random() % 50 == 0) outbox.receive();
+        }
+        outbox.acknowledge(SIZE_MAX);
+
+        const Snapshot after = snapshot();
+        std::vector<uint32_t> fallbacks;
+        uint32_t pooledFallbacks = 0;
+
+        fprintf(stderr, "%s, outbox limit %zu, %u publishes\n", name, threshold, publishes);
+        for(size_t i = 0; i < after.classes.size(); i++)
+        {
+            const PacketPoolStats& stats = after.classes[i];
+            fallbacks.push_back(stats.heapFallbacks - before.classes[i].heapFallbacks);
+            pooledFallbacks += fallbacks.back();
+            fprintf(stderr, "  %4zu bytes x %2zu: peak %2zu, allocations %7u, exhausted %6u, heap fallbacks %u\n", stats.blockSize, stats.blocks,
+                   stats.peakInUse, stats.allocations - before.classes[i].allocations, stats.exhausted - before.classes[i].exhausted, fallbacks.back());
+        }
+        fprintf(stderr, "  larger than every class: %u\n", outbox.oversized);
+
+        CHECK(after.heapAllocations - before.heapAllocations == pooledFallbacks + outbox.oversized);
+        CHECK(PacketPool::heapInUse() == 0);
+        return fallbacks;
+    }
+
+    void testPoolSize()
+    {
+        size_t poolSize = 0;
+        for(size_t i = 0; i < PacketPool::numClasses(); i++) poolSize += PacketPool::classStats(i).blockSize * PacketPool::classStats(i).blocks;
+        fprintf(stderr, "pool size: %zu bytes\n", poolSize);
+        CHECK(poolSize < 16 * 1024);
+    }
+
+    void testSoak()
+    {
+        // With the outbox limited by the publish queue threshold the pool runs short around a reconnect, while the
+        // subscriptions are outstanding and discovery fills the large class, the JSON state documents never leave it
+        const uint32_t publishes = 100000;
+        const std::vector<uint32_t> fallbacks = soak("backpressure", MQTT_PUBLISH_QUEUE_THRESHOLD, publishes);
+        CHECK(fallbacks[1] == 0);
+        CHECK(fallbacks[0] + fallbacks[1] + fallbacks[2] < publishes / 1000);
+
+        // Without it the JSON documents and discovery bursts outgrow the pool, reported for comparison only
+        soak("no backpressure", 64, publishes);
+    }
+}
+
+int main()
+{
+    // espMqttClient logs every packet allocation on non-Arduino builds, the report goes to stderr
+    freopen("/dev/null", "w", stdout);
+    testPoolSize();
+    testSoak();
+    return HOST_TEST_RESULT();
+}
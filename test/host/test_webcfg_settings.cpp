@@ -0,0 +1,65 @@
+#include "HostTest.h"
+#include "WebCfgSettings.h"
+#include "PreferencesKeys.h"
+#include "MqttTopicHash.h"
+
+namespace
+{
+    void testLookup()
+    {
+        const WebCfgSetting* setting = findWebCfgSetting("MQTTSERVER");
+        CHECK(setting != nullptr && strcmp(setting->preference, preference_mqtt_broker) == 0);
+
+        setting = findWebCfgSetting("CONFOPNABTD");
+        CHECK(setting != nullptr && setting->type == WebCfgSettingType::Acl && setting->acl == WebCfgAcl::AdvancedOpenerConfig);
+
+        // Handled outside of the table
+        CHECK(findWebCfgSetting("MQTTUSER") == nullptr);
+        CHECK(findWebCfgSetting("MQTTSERVE") == nullptr);
+
+        setting = findWebCfgSettingByPreference(preference_buffer_size);
+        CHECK(setting != nullptr && strcmp(setting->key, "BUFFSIZE") == 0);
+        CHECK(findWebCfgSettingByPreference(preference_mqtt_user) == nullptr);
+
+        setting = findWebCfgSettingByPreference(preference_mqtt_ca);
+        CHECK(setting != nullptr && (setting->flags & WEBCFG_SETTING_REDACTED) != 0);
+    }
+
+    void testApply()
+    {
+        Preferences preferences;
+        const WebCfgSetting* setting = findWebCfgSetting("TXPWR");
+        CHECK(setting != nullptr);
+        if(setting == nullptr) return;
+
+        CHECK(!applyWebCfgSetting(&preferences, *setting, "9")); // same as the default
+        CHECK(!applyWebCfgSetting(&preferences, *setting, "10"));
+        CHECK(!applyWebCfgSetting(&preferences, *setting, "-13"));
+        CHECK(applyWebCfgSetting(&preferences, *setting, "-12"));
+        CHECK(!applyWebCfgSetting(&preferences, *setting, "-12"));
+        CHECK(preferences.getInt(preference_ble_tx_power, 9) == -12);
+
+        setting = findWebCfgSetting("LOCKENA");
+        CHECK(setting != nullptr);
+        if(setting == nullptr) return;
+
+        CHECK(!validWebCfgSetting(*setting, "on"));
+        CHECK(applyWebCfgSetting(&preferences, *setting, "0"));
+        CHECK(!preferences.getBool(preference_lock_enabled, true));
+    }
+
+    void testTopicHash()
+    {
+        static_assert(mqttTopicHash("") == 2166136261u, "FNV-1a offset basis");
+        CHECK(mqttTopicHash("a") == 0xe40c292cu);
+        CHECK(mqttPayloadHash("a", 1) == mqttTopicHash("a"));
+    }
+}
+
+int main()
+{
+    testLookup();
+    testApply();
+    testTopicHash();
+    return HOST_TEST_RESULT();
+}